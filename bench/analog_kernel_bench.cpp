@@ -0,0 +1,121 @@
+/**
+ * 模拟输入换算基准
+ *
+ * 对比逐通道路径（convertAnalogToCurrent → convertCurrentToPressure → evaluatePressureStatus）
+ * 与 AnalogKernel 的整块实现：先逐项核对结果完全相同，再统计每块耗时。
+ *
+ * 用法：analog_kernel_bench [每组迭代次数]
+ */
+#include "ethercat/AnalogKernel.h"
+#include "ethercat/EtherCATMaster.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t SNAPSHOT_COUNT = 256;     // 轮流换算的快照数，避免只测同一组数据
+
+struct Result {
+    float currents[MAX_ANALOG_CHANNELS];
+    float pressures[MAX_ANALOG_CHANNELS];
+    uint8_t statuses[MAX_ANALOG_CHANNELS];
+};
+
+// 原始值覆盖整个 int16 范围，状态字随机置位，使每种状态码都会出现
+std::vector<ProcessImageSnapshot> makeSnapshots(uint32_t channels) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> raw(-32768, 32767);
+    std::uniform_int_distribution<int> word(0, 0xFFFF);
+    std::vector<ProcessImageSnapshot> snapshots(SNAPSHOT_COUNT);
+    for (auto& snapshot : snapshots) {
+        std::memset(&snapshot, 0, sizeof(snapshot));
+        snapshot.cycle = 1;
+        snapshot.analog_count = channels;
+        for (uint32_t i = 0; i < channels; i++) {
+            snapshot.analog_raw[i] = static_cast<int16_t>(raw(rng));
+            // 约一半通道状态字清零，保证正常状态也有足够样本
+            snapshot.analog_status[i] = (rng() & 0x01) ? static_cast<uint16_t>(word(rng)) : 0;
+        }
+        snapshot.analog_stale = (static_cast<uint64_t>(rng()) << 32 | rng()) & (static_cast<uint64_t>(rng()) << 32 | rng());
+    }
+    return snapshots;
+}
+
+void convertPerChannel(EtherCATMaster& master, const ProcessImageSnapshot& snapshot, Result& out) {
+    for (size_t i = 0; i < snapshot.analog_count; i++) {
+        float current = master.convertAnalogToCurrent(snapshot.analog_raw[i]);
+        out.currents[i] = current;
+        out.pressures[i] = master.convertCurrentToPressure(current);
+        out.statuses[i] = static_cast<uint8_t>(EtherCATMaster::evaluatePressureStatus(snapshot, i));
+    }
+}
+
+void convertWithKernel(const AnalogKernel& kernel, const ProcessImageSnapshot& snapshot, Result& out) {
+    kernel.convert(snapshot.analog_raw, snapshot.analog_status, snapshot.analog_stale, snapshot.analog_count,
+                   out.currents, out.pressures, out.statuses);
+}
+
+bool sameResult(const Result& a, const Result& b, size_t count) {
+    return std::memcmp(a.currents, b.currents, count * sizeof(float)) == 0 &&
+           std::memcmp(a.pressures, b.pressures, count * sizeof(float)) == 0 &&
+           std::memcmp(a.statuses, b.statuses, count) == 0;
+}
+
+template <typename Fn>
+double measureNsPerBlock(const std::vector<ProcessImageSnapshot>& snapshots, size_t iterations, Fn&& fn) {
+    Result out;
+    volatile float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < iterations; n++) {
+        fn(snapshots[n % snapshots.size()], out);
+        sink = sink + out.pressures[0];
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    EtherCATMaster master;
+    auto kernels = availableAnalogKernels();
+
+    std::printf("默认内核: %s，每组 %zu 次\n", EtherCATMaster::getAnalogKernelName(), iterations);
+    int failures = 0;
+    for (uint32_t channels : {4u, 16u, 64u}) {
+        auto snapshots = makeSnapshots(channels);
+
+        // 逐项核对：各实现与逐通道路径的电流、压力和状态必须按位相同
+        for (const auto& kernel : kernels) {
+            for (const auto& snapshot : snapshots) {
+                Result expected, actual;
+                convertPerChannel(master, snapshot, expected);
+                convertWithKernel(kernel, snapshot, actual);
+                if (!sameResult(expected, actual, channels)) {
+                    std::printf("✗ %s 在 %u 通道时与逐通道结果不一致\n", kernel.name, channels);
+                    failures++;
+                    break;
+                }
+            }
+        }
+
+        double baseline = measureNsPerBlock(snapshots, iterations,
+            [&](const ProcessImageSnapshot& s, Result& out) { convertPerChannel(master, s, out); });
+        std::printf("%2u 通道  逐通道   %8.1f ns/块\n", channels, baseline);
+        for (const auto& kernel : kernels) {
+            double ns = measureNsPerBlock(snapshots, iterations,
+                [&](const ProcessImageSnapshot& s, Result& out) { convertWithKernel(kernel, s, out); });
+            std::printf("%2u 通道  %-8s %8.1f ns/块  %5.2fx\n", channels, kernel.name, ns, baseline / ns);
+        }
+    }
+    if (failures == 0) {
+        std::printf("✓ 全部实现与逐通道结果一致\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+#ifndef ANALOGKERNEL_H
+#define ANALOGKERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 模拟输入批量换算内核
+ *
+ * 一次遍历整块 EL3074 原始值和状态字，同时得到电流 (mA)、压力 (bar) 和状态码
+ * （取值同 EtherCATMaster::PressureStatus）。stale 的 bit i 表示通道 i 采样停滞，count 不超过 64。
+ *
+ * 逐项结果与单通道的 convertAnalogToCurrent / convertAnalogToPressure / evaluatePressureStatus 完全相同：
+ * 向量实现按相同顺序做同样的单精度乘、除、加，不使用 FMA 和倒数近似。
+ * x86 上按 CPU 在运行时选择 AVX2（每次 16 通道）或 SSE2（每次 8 通道），其余平台和尾部通道走标量实现；
+ * 指令集通过函数属性启用，不需要额外的编译选项。
+ */
+using AnalogKernelFn = void (*)(const int16_t* raw, const uint16_t* status_words, uint64_t stale, size_t count,
+                                float* currents, float* pressures, uint8_t* statuses);
+
+struct AnalogKernel {
+    const char* name;
+    AnalogKernelFn convert;
+};
+
+// 当前 CPU 上最快的实现（AVX2 > SSE2 > 标量），首次调用时选定
+const AnalogKernel& analogKernel();
+
+// 当前 CPU 上可用的全部实现，标量实现在第一个（基准测试逐个比较）
+std::vector<AnalogKernel> availableAnalogKernels();
+
+#endif // ANALOGKERNEL_H
@@ -0,0 +1,89 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+
+/**
+ * @brief 主站和测试使用的时钟
+ *
+ * 周期线程的截止时间、测试的等待和超时、统计中的时间都经由该接口，
+ * 替换为 VirtualClock 后可以快于实时地运行模拟测试。
+ */
+class Clock {
+public:
+    virtual ~Clock() {}
+
+    virtual int64_t nowNs() const = 0;                  // 单调时间(ns)
+    virtual int64_t wallNs() const = 0;                 // 墙上时间(ns since epoch)，用于日志和事件时间戳
+    virtual void sleepUntil(int64_t deadline_ns) = 0;   // 按单调时间的绝对截止时间等待
+    void sleepFor(int64_t duration_ns) { sleepUntil(nowNs() + duration_ns); }
+    virtual bool isVirtual() const { return false; }
+
+    // 参与虚拟时间推进的线程（系统时钟上为空操作）
+    // addParticipant() 在创建线程之前调用，线程内 enterParticipant()，退出前 leaveParticipant()
+    virtual void addParticipant() {}
+    virtual void enterParticipant() {}
+    virtual void leaveParticipant() {}
+};
+
+// CLOCK_MONOTONIC / CLOCK_REALTIME
+class SystemClock : public Clock {
+public:
+    int64_t nowNs() const override;
+    int64_t wallNs() const override;
+    void sleepUntil(int64_t deadline_ns) override;
+};
+
+/**
+ * @brief 离散事件虚拟时钟
+ *
+ * 时间只在所有参与线程都在 sleepUntil() 中等待时推进，并直接跳到最早的截止时间，
+ * 因此等待不消耗实际时间，而各线程看到的逻辑时序与实时运行相同。
+ * 未参与的线程（例如界面线程）也可以按虚拟时间等待，但不会阻止时间推进；
+ * 没有参与线程时，任何等待都会立即推进时间。
+ *
+ * 参与线程不能在时钟之外无限期阻塞（例如等待只有时间推进后才会就绪的 future），
+ * 否则时间停止推进。
+ */
+class VirtualClock : public Clock {
+public:
+    VirtualClock();                                     // 起点取当前实际时间
+    VirtualClock(int64_t start_ns, int64_t wall_start_ns);
+
+    int64_t nowNs() const override { return now_ns.load(std::memory_order_acquire); }
+    int64_t wallNs() const override { return wall_offset_ns + nowNs(); }
+    void sleepUntil(int64_t deadline_ns) override;
+    bool isVirtual() const override { return true; }
+
+    void addParticipant() override;
+    void enterParticipant() override;
+    void leaveParticipant() override;
+
+    void advance(int64_t duration_ns);                  // 手动推进，唤醒到期的等待者
+    uint64_t getAdvanceCount() const;                   // 时间推进的次数（调试和基准用）
+
+private:
+    struct Sleeper {
+        int64_t deadline_ns;
+        bool participant;
+        bool woken;
+    };
+
+    void advanceToLocked(int64_t target_ns);
+    void tryAdvanceLocked();
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<int64_t> now_ns;
+    int64_t wall_offset_ns;
+    int participants;                                   // 已计数的参与线程
+    int sleeping_participants;                          // 正在等待的参与线程
+    std::list<Sleeper*> sleepers;
+    uint64_t advance_count;
+};
+
+#endif // CLOCK_H
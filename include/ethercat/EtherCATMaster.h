@@ -1,24 +1,10 @@
 #ifndef ETHERCATMASTER_H
 #define ETHERCATMASTER_H
 
-// 仅在Linux + WITH_IGH_ETHERCAT时包含真正的EtherCAT头文件
-#if defined(__linux__) && WITH_IGH_ETHERCAT
-#include <ecrt.h>
-#else
-// 为非Linux平台或无EtherCAT环境定义占位类型
-struct ec_master_t;
-struct ec_domain_t;
-struct ec_slave_config_t;
-struct ec_master_state_t {
-    unsigned int slaves_responding;
-    unsigned int al_states;
-    unsigned int link_up;
-};
-struct ec_domain_state_t {
-    unsigned int working_counter;
-    unsigned int wc_state;
-};
-#endif
+#include "ethercat/FieldbusBackend.h"
+#include "ethercat/Clock.h"
+#include "ethercat/PdoLayout.h"
+#include "ethercat/SlaveTopology.h"
 
 #include <string>
 #include <vector>
@@ -33,23 +19,29 @@ struct ec_domain_state_t {
 #include <condition_variable>
 #include <fstream>
 #include <deque>
+#include <array>
+#include <future>
+
+#include "ethercat/LatencyHistogram.h"
+#include "ethercat/SeqLock.h"
+#include "ethercat/LockFreeQueue.h"
 
 // 从站配置
 // EK1100 耦合器 (位置 0)
 constexpr uint16_t EK1100_VENDOR_ID = 0x00000002;
 constexpr uint32_t EK1100_PRODUCT_CODE = 0x044c2c52;
 
-// EL1008 数字输入 (位置 1)
-constexpr uint16_t EL1008_VENDOR_ID = 0x00000002;
-constexpr uint32_t EL1008_PRODUCT_CODE = 0x03f03052;
+// EL1008 数字输入 (位置 1)，PDO 布局见 PdoLayout.h
+constexpr uint16_t EL1008_VENDOR_ID = El1008::vendor_id;
+constexpr uint32_t EL1008_PRODUCT_CODE = El1008::product_code;
 
 // EL3074 模拟输入 (位置 2)
-constexpr uint16_t EL3074_VENDOR_ID = 0x00000002;
-constexpr uint32_t EL3074_PRODUCT_CODE = 0x0c023052;
+constexpr uint16_t EL3074_VENDOR_ID = El3074::vendor_id;
+constexpr uint32_t EL3074_PRODUCT_CODE = El3074::product_code;
 
 // EL2634 继电器输出 (位置 3)
-constexpr uint16_t EL2634_VENDOR_ID = 0x00000002;
-constexpr uint32_t EL2634_PRODUCT_CODE = 0x0a4a3052;
+constexpr uint16_t EL2634_VENDOR_ID = El2634::vendor_id;
+constexpr uint32_t EL2634_PRODUCT_CODE = El2634::product_code;
 
 // EL6001 RS232接口 (位置 4) - 不需要PDO配置
 constexpr uint16_t EL6001_VENDOR_ID = 0x00000002;
@@ -68,6 +60,68 @@ constexpr float OVERLOAD_PRESSURE = 200.0f;     // 过载压力 200 bar
 constexpr float BURST_PRESSURE = 800.0f;        // 爆破压力 800 bar
 constexpr int16_t ADC_MAX_VALUE = 32767;        // ADC最大值
 
+// 压力通道标定（PressureCalibration.h）
+constexpr size_t CALIBRATION_TABLE_SIZE = 65536;    // 每通道查表覆盖全部 int16 原始值
+constexpr size_t CALIBRATION_MAX_POINTS = 64;       // 分段线性每通道的标定点上限
+constexpr size_t CALIBRATION_MAX_POLY_TERMS = 6;    // 多项式系数上限（5 次）
+
+// EL3074 状态字（每通道过程值之前的 16 位，位置由端子描述在编译期给出）
+constexpr uint16_t AI_STATUS_UNDERRANGE = PdoLayout<El3074>::statusMask(0x01);     // 低于测量范围 (< 4mA)
+constexpr uint16_t AI_STATUS_OVERRANGE = PdoLayout<El3074>::statusMask(0x02);      // 超出测量范围 (> 20mA)
+constexpr uint16_t AI_STATUS_LIMIT1 = PdoLayout<El3074>::statusMask(0x03);         // 限值 1 比较结果
+constexpr uint16_t AI_STATUS_LIMIT2 = PdoLayout<El3074>::statusMask(0x05);         // 限值 2 比较结果
+constexpr uint32_t AI_STATUS_LIMIT2_SHIFT = PdoLayout<El3074>::statusShift(0x05);
+constexpr uint16_t AI_STATUS_ERROR = PdoLayout<El3074>::statusMask(0x07);          // 通道错误（断线等）
+constexpr uint16_t AI_STATUS_TXPDO_STATE = PdoLayout<El3074>::statusMask(0x0f);    // 过程数据无效
+constexpr uint16_t AI_STATUS_TXPDO_TOGGLE = PdoLayout<El3074>::statusMask(0x10);   // 每个新采样翻转一次
+constexpr uint16_t AI_STATUS_FAULT = AI_STATUS_ERROR | AI_STATUS_TXPDO_STATE;
+constexpr uint16_t AI_LIMIT_ABOVE = 2;          // 限值字段：0 未启用，1 低于，2 高于，3 等于
+constexpr int64_t ANALOG_STALE_TIMEOUT_NS = 100000000;  // TxPDO Toggle 超过 100ms 未翻转视为采样停滞
+
+// 过程数据通道容量：每个域可由多个同类端子按通道号拼接，实际通道数由拓扑决定
+constexpr size_t MAX_ANALOG_CHANNELS = 64;      // EL3074 模拟输入（16 个端子）
+constexpr size_t MAX_DIGITAL_INPUTS = 64;       // EL1008 数字输入，位图为 64 位
+constexpr size_t MAX_RELAY_CHANNELS = 8;        // EL2634 继电器输出，命令和输出位为 8 位
+constexpr size_t PRESSURE_TARGET_CHANNELS = 8;  // 周期内压力目标监视可选的通道（模拟输入 1-8）
+constexpr size_t LEG_CHANNEL_COUNT = 4;         // 支撑/收回测试监视的支腿压力（模拟输入 1-4）
+
+// 周期线程相关常量
+constexpr int64_t DEFAULT_CYCLE_PERIOD_NS = 10000000;  // 默认周期 10ms
+constexpr int64_t MIN_CYCLE_PERIOD_NS = 250000;        // 最小周期 250µs
+constexpr size_t MAX_PREFAULT_STACK_SIZE = 1024 * 1024; // 栈预缺页上限 1MB
+
+// 过程数据域相关常量
+constexpr uint32_t MAX_DOMAIN_DIVIDER = 1000;           // 域交换分频上限
+constexpr size_t DOMAIN_IMAGE_MAX_SIZE = 32;            // 域快照保存的最大字节数
+
+// 周期内钩子相关常量
+constexpr size_t MAX_CYCLE_HOOKS = 8;                   // 可注册的钩子数量上限
+constexpr int64_t DEFAULT_CYCLE_HOOK_BUDGET_NS = 50000; // 默认执行预算 50µs
+constexpr uint32_t CYCLE_HOOK_MAX_VIOLATIONS = 3;       // 连续超预算达到该次数后自动禁用
+
+// 继电器命令队列相关常量
+constexpr size_t RELAY_COMMAND_QUEUE_SIZE = 64;         // 待发送/待确认命令上限
+constexpr size_t RELAY_COMMAND_POOL_SIZE = RELAY_COMMAND_QUEUE_SIZE * 2; // 预分配的命令槽：排队、已发送和待完成的命令之和
+constexpr int64_t RELAY_CONFIRM_TIMEOUT_NS = 100000000; // WKC确认超时 100ms
+constexpr int RELAY_SHUTDOWN_TIMEOUT_MS = 500;          // 停止前关闭全部继电器时等待确认的上限
+
+// CoE SDO 请求相关常量
+constexpr size_t MAX_SDO_REQUESTS = 32;                 // 可预先创建的 SDO 请求数
+constexpr size_t SDO_REQUEST_MAX_SIZE = 64;             // 单个请求的数据长度上限
+constexpr size_t SDO_OPERATION_QUEUE_SIZE = 32;         // 待发起/进行中的读写操作上限
+constexpr uint32_t DEFAULT_SDO_TIMEOUT_MS = 1000;       // 后端传输超时
+
+// 总线中断与热重配置相关常量
+constexpr size_t MAX_MONITORED_SLAVES = 31;             // 按配置顺序监视在线/OP 状态的从站数
+constexpr int64_t BUS_RECONFIGURE_DELAY_NS = 2000000000LL;  // 从站回到总线后仍未进入 OP 超过 2s 则重新配置
+
+// 启动与热启动相关常量
+constexpr int DEFAULT_OPERATIONAL_TIMEOUT_MS = 5000;    // start() 等待必需从站全部进入 OP 的时限
+constexpr size_t SLAVE_STATE_EVENT_QUEUE_SIZE = 256;    // 启动期间从站状态变化事件（周期线程 -> 监督线程）
+constexpr uint16_t SLAVE_STATE_ALL = 0xFFFF;            // 后端不提供逐从站状态时，事件表示全部从站的汇总状态
+constexpr char WARM_START_CACHE_MAGIC[4] = {'E', 'C', 'W', 'S'};
+constexpr uint16_t WARM_START_CACHE_VERSION = 1;
+
 // 主站状态枚举
 enum class MasterStatus {
     STATUS_UNINITIALIZED,   // 未初始化
@@ -156,6 +210,8 @@ struct ReliabilityTestStats {
     std::deque<float> recent_support_times;            // 最近100个支撑耗时
     std::deque<float> recent_retract_times;            // 最近100个收回耗时
     std::vector<LogEntry> critical_logs;               // 关键日志（错误、警告等）
+    int bus_interruptions;                             // 测试期间的总线中断次数
+    int64_t bus_downtime_ms;                           // 总线中断累计时长(ms)
     
     ReliabilityTestStats() 
         : total_cycles(0)
@@ -169,7 +225,9 @@ struct ReliabilityTestStats {
         , max_support_failures(0)
         , max_retract_failures(0)
         , avg_support_time_ms(0.0f)
-        , avg_retract_time_ms(0.0f) {
+        , avg_retract_time_ms(0.0f)
+        , bus_interruptions(0)
+        , bus_downtime_ms(0) {
     }
     
     // 获取最近N个周期的统计数据
@@ -202,9 +260,11 @@ struct ReliabilityTestStats {
         return (total_success * 100.0f) / total_operations;
     }
     
-    std::chrono::duration<double> getElapsedTime() const {
+    // now 为运行中测试的当前时间（主站使用虚拟时钟时由主站传入）
+    std::chrono::duration<double> getElapsedTime(
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) const {
         if (end_time.time_since_epoch().count() == 0) {
-            return std::chrono::steady_clock::now() - start_time;
+            return now - start_time;
         }
         return end_time - start_time;
     }
@@ -286,13 +346,17 @@ struct TestResult {
     std::string message;                   // 测试消息
     std::vector<float> final_pressures;    // 最终压力值
     std::vector<std::string> logs;         // 测试日志
-    int elapsed_time_ms;                   // 耗时(毫秒)
+    int elapsed_time_ms;                   // 耗时(毫秒)，达到目标时计到越过阈值的周期
+    uint64_t target_cycle;                 // 越过目标压力的周期号（0 表示未达到）
+    int64_t target_timestamp_ns;           // 越过目标压力的回帧时刻 (CLOCK_MONOTONIC)
     ReliabilityTestStats stats;            // 可靠性测试统计
     
     TestResult() 
         : status(TestStatus::TEST_IDLE)
         , success(false)
-        , elapsed_time_ms(0) {
+        , elapsed_time_ms(0)
+        , target_cycle(0)
+        , target_timestamp_ns(0) {
     }
 };
 
@@ -321,6 +385,324 @@ struct MasterStateInfo {
     }
 };
 
+// 总线中断统计：从站丢失或链路断开到全部已配置从站回到 OP 为一次中断
+struct BusInterruptionStats {
+    bool active;                            // 当前是否处于中断中
+    uint64_t count;                         // 中断次数
+    uint64_t reconfigurations;              // 热重配置次数（后端未能自行恢复时重建主站配置）
+    uint64_t lost_cycle;                    // 最近一次中断开始时的总线周期
+    uint64_t recovered_cycle;               // 最近一次恢复时的总线周期
+    int64_t last_downtime_ms;               // 最近一次中断的时长
+    int64_t total_downtime_ms;              // 累计中断时长
+    std::vector<uint16_t> lost_positions;   // 最近一次中断中离线过的从站位置
+    
+    BusInterruptionStats()
+        : active(false)
+        , count(0)
+        , reconfigurations(0)
+        , lost_cycle(0)
+        , recovered_cycle(0)
+        , last_downtime_ms(0)
+        , total_downtime_ms(0) {
+    }
+};
+
+// 启动期间从站 AL 状态的一次变化（周期线程逐周期采样，直到必需从站全部进入 OP）
+struct SlaveStateTransition {
+    uint16_t position;              // 从站位置，SLAVE_STATE_ALL 为全部从站的汇总状态
+    std::string name;
+    uint8_t from_state;             // AL 状态，0 表示离线
+    uint8_t to_state;
+    uint64_t cycle;                 // 观察到变化的周期
+    int64_t elapsed_us;             // 距周期线程启动的时间
+};
+
+// initialize() 和 start() 各阶段的耗时（µs，单调时钟）
+struct StartupTiming {
+    int64_t request_master_us;
+    int64_t scan_us;                // 总线扫描和拓扑比对
+    int64_t configure_us;           // 创建域、配置从站和注册 PDO
+    int64_t activate_us;            // 激活主站（原始套接字后端包括邮箱/PDO 分配/SM/FMMU 和进入 SAFEOP）
+    int64_t time_to_op_us;          // 周期线程启动到必需从站全部进入 OP，未进入时为 -1
+    int64_t total_us;               // initialize() 开始到进入 OP 或等待超时
+    uint64_t op_cycle;              // 进入 OP 的周期
+    bool warm_start;                // 配置指纹与热启动缓存一致，后端沿用了缓存的从站配置
+    uint64_t fingerprint;           // 本次的配置指纹
+    std::vector<SlaveStateTransition> transitions;
+    
+    StartupTiming()
+        : request_master_us(0)
+        , scan_us(0)
+        , configure_us(0)
+        , activate_us(0)
+        , time_to_op_us(-1)
+        , total_us(0)
+        , op_cycle(0)
+        , warm_start(false)
+        , fingerprint(0) {
+    }
+};
+
+// 周期超时（处理结束时已过下一周期截止时间）后的处理策略
+enum class OverrunPolicy {
+    OVERRUN_BURST_CATCH_UP,         // 连续补跑错过的周期（旧行为）
+    OVERRUN_SKIP_AND_REALIGN,       // 丢弃错过的周期，对齐到下一个周期边界
+    OVERRUN_DEGRADE_SAFE_OUTPUTS    // 对齐周期边界，并将继电器全部断开直到 clearSafeOutputs()
+};
+
+// 过程数据域：每组从站一个域，各自按基础周期的整数倍交换
+enum class ProcessDomainId {
+    DOMAIN_ANALOG_IN = 0,   // EL3074 压力通道
+    DOMAIN_DIGITAL_IN,      // EL1008 数字输入
+    DOMAIN_RELAY_OUT,       // EL2634 继电器输出
+    COUNT
+};
+
+constexpr size_t PROCESS_DOMAIN_COUNT = static_cast<size_t>(ProcessDomainId::COUNT);
+static_assert(PROCESS_DOMAIN_COUNT == TOPOLOGY_DOMAIN_COUNT, "拓扑文件的 Domain 名称须与 ProcessDomainId 对应");
+
+// 周期线程启动选项（传给 start()）
+struct RealtimeOptions {
+    int64_t cycle_period_ns;         // 周期长度(ns)，不小于 MIN_CYCLE_PERIOD_NS
+    bool realtime;                   // 是否启用实时模式（SCHED_FIFO/CPU绑定/内存锁定）
+    int sched_priority;              // SCHED_FIFO 优先级 (1-99)
+    int cpu_core;                    // 绑定的CPU核心，-1 表示不绑定
+    bool lock_memory;                // 是否 mlockall 锁定进程内存
+    size_t prefault_stack_size;      // 周期线程启动时预缺页的栈大小(字节)
+    OverrunPolicy overrun_policy;    // 周期超时处理策略
+    std::array<uint32_t, PROCESS_DOMAIN_COUNT> domain_dividers; // 各域交换周期 = cycle_period_ns × 分频，按 ProcessDomainId 索引
+
+    RealtimeOptions()
+        : cycle_period_ns(DEFAULT_CYCLE_PERIOD_NS)
+        , realtime(false)
+        , sched_priority(80)
+        , cpu_core(-1)
+        , lock_memory(true)
+        , prefault_stack_size(64 * 1024)
+        , overrun_policy(OverrunPolicy::OVERRUN_BURST_CATCH_UP)
+        , domain_dividers() {
+        domain_dividers.fill(1);
+    }
+};
+
+// 周期超时统计（周期线程写入，任意线程通过 getCycleOverrunStats() 读取一致副本）
+struct CycleOverrunStats {
+    uint64_t overrun_count;             // 超时的周期数
+    uint64_t skipped_cycles;            // 按策略丢弃的周期数（补跑策略下为0）
+    uint64_t consecutive_overruns;      // 当前连续超时次数
+    uint64_t max_consecutive_overruns;  // 最长连续超时次数
+    uint64_t first_overrun_cycle;       // 首次超时的周期号（0 表示尚未发生）
+    uint64_t last_overrun_cycle;        // 最近一次超时的周期号
+    int64_t first_overrun_time_ns;      // 首次超时时刻 (CLOCK_REALTIME)
+    int64_t last_overrun_time_ns;       // 最近一次超时时刻 (CLOCK_REALTIME)
+    int64_t last_overrun_ns;            // 最近一次超出截止时间的量
+    int64_t max_overrun_ns;             // 最大超出量
+    uint64_t dropped_events;            // 事件队列满而未写入日志的事件数
+    bool safe_outputs_active;           // 是否处于安全输出状态
+
+    CycleOverrunStats()
+        : overrun_count(0), skipped_cycles(0), consecutive_overruns(0), max_consecutive_overruns(0)
+        , first_overrun_cycle(0), last_overrun_cycle(0), first_overrun_time_ns(0), last_overrun_time_ns(0)
+        , last_overrun_ns(0), max_overrun_ns(0), dropped_events(0), safe_outputs_active(false) {
+    }
+};
+
+// 周期计时指标（每个指标一个直方图）
+enum class CycleMetric {
+    WAKEUP_LATENCY = 0,     // 唤醒延迟：实际唤醒时刻 - 截止时刻
+    RECEIVE,                // ecrt_master_receive 耗时
+    DOMAIN_PROCESS,         // ecrt_domain_process 耗时
+    PUBLISH_SNAPSHOT,       // 发布输入快照耗时
+    USER_HOOKS,             // 周期内钩子总耗时
+    WRITE_OUTPUTS,          // 继电器命令和 SDO 请求处理 + writeRelayOutputs 耗时
+    SEND,                   // ecrt_domain_queue + ecrt_master_send 耗时
+    CYCLE_EXECUTION,        // 整个 processCycle 耗时
+    PERIOD_ERROR,           // 相邻两次唤醒间隔与标称周期之差的绝对值
+    COUNT
+};
+
+constexpr size_t CYCLE_METRIC_COUNT = static_cast<size_t>(CycleMetric::COUNT);
+
+// 过程数据输入快照：由周期线程每周期发布一次，读者无锁、无堆分配地获取一致副本
+struct ProcessImageSnapshot {
+    uint64_t cycle;                                   // 周期计数（0 表示尚未发布）
+    int64_t timestamp_ns;                             // 采样时刻 (CLOCK_MONOTONIC)
+    uint64_t analog_cycle;                            // 模拟输入域最近一次交换的周期
+    uint64_t digital_cycle;                           // 数字输入域最近一次交换的周期
+    uint32_t analog_count;                            // 有效的模拟输入通道数（前 analog_count 项）
+    uint32_t digital_count;                           // 有效的数字输入通道数
+    int16_t analog_raw[MAX_ANALOG_CHANNELS];          // EL3074 原始值
+    uint16_t analog_status[MAX_ANALOG_CHANNELS];      // EL3074 状态字，位定义见 AI_STATUS_*
+    uint64_t analog_new_sample;                       // bit i：本次交换通道 i+1 的 TxPDO Toggle 翻转（新采样）
+    uint64_t analog_stale;                            // bit i：通道 i+1 的 TxPDO Toggle 超过 ANALOG_STALE_TIMEOUT_NS 未翻转
+    uint64_t digital_inputs;                          // EL1008 输入，bit i 对应通道 i+1
+
+    bool isValid() const { return cycle != 0; }
+    bool digitalInput(size_t index) const { return (digital_inputs >> index) & 0x01; }
+    // 硬件报告的通道故障或采样停滞，该通道的原始值不可用
+    bool analogFault(size_t index) const {
+        return (analog_status[index] & AI_STATUS_FAULT) != 0 || ((analog_stale >> index) & 0x01) != 0;
+    }
+};
+
+// 单个域的过程映像快照：该域每次交换后由周期线程发布
+struct DomainSnapshot {
+    uint64_t cycle;                         // 交换时的基础周期号（0 表示尚未交换）
+    int64_t timestamp_ns;                   // 回帧处理时刻 (CLOCK_MONOTONIC)
+    uint64_t exchange_count;                // 交换次数
+    uint64_t wkc_error_count;               // WKC 不完整的交换次数
+    uint32_t working_counter;
+    uint32_t wc_state;                      // ec_wc_state_t
+    uint32_t image_size;                    // image 中的有效字节数
+    uint8_t image[DOMAIN_IMAGE_MAX_SIZE];   // 域数据原始字节
+
+    bool isValid() const { return cycle != 0; }
+};
+
+// 周期内压力目标监视的判定方式
+enum class PressureTargetMode {
+    TARGET_ALL_ABOVE,       // 所选通道全部 >= 目标压力（支撑）
+    TARGET_ALL_BELOW        // 所选通道全部 < 目标压力（收回）
+};
+
+// 压力目标越过事件：周期线程在越过阈值的周期发布
+struct PressureTargetEvent {
+    uint32_t arm_id;                            // 对应 armPressureTarget() 的返回值
+    uint64_t cycle;                             // 越过阈值的周期号
+    int64_t timestamp_ns;                       // 回帧处理时刻 (CLOCK_MONOTONIC)
+    uint8_t relay_outputs;                      // 断开后的继电器输出位
+    int16_t analog_raw[PRESSURE_TARGET_CHANNELS];   // 越过阈值时模拟输入 1-8 的原始值
+};
+
+// 周期内钩子的上下文：只在钩子调用期间有效
+struct CycleHookContext {
+    uint64_t cycle;                         // 基础周期号
+    int64_t timestamp_ns;                   // 本周期回帧处理时刻 (CLOCK_MONOTONIC)
+    const ProcessImageSnapshot* inputs;     // 本周期合并输入（只读）
+    bool analog_updated;                    // 模拟输入域本周期是否交换
+    bool digital_updated;                   // 数字输入域本周期是否交换
+    bool relay_due;                         // 继电器域本周期是否写出
+    uint8_t relay_outputs;                  // 继电器输出位，可修改；继电器域到期时写出
+};
+
+// 周期内钩子：在周期线程中执行，必须短小、不分配内存、不加锁、不做I/O
+using CycleHookFunction = void (*)(CycleHookContext& context, void* user_data);
+
+// 周期内钩子的执行统计
+struct CycleHookStats {
+    std::string name;
+    int64_t budget_ns;              // 执行预算
+    bool enabled;
+    bool disabled_by_budget;        // 是否因连续超预算被自动禁用
+    uint64_t calls;                 // 调用次数
+    uint64_t budget_violations;     // 超预算次数
+    int64_t last_ns;                // 最近一次耗时
+    int64_t max_ns;                 // 最大耗时
+    double mean_ns;                 // 平均耗时
+
+    CycleHookStats()
+        : budget_ns(0), enabled(false), disabled_by_budget(false)
+        , calls(0), budget_violations(0), last_ns(0), max_ns(0), mean_ns(0.0) {
+    }
+};
+
+// 继电器命令完成状态
+enum class RelayCommandStatus {
+    RELAY_CMD_PENDING,      // 尚未完成
+    RELAY_CMD_CONFIRMED,    // 已发送且域WKC确认
+    RELAY_CMD_TIMEOUT,      // 已发送但在超时内未得到WKC确认
+    RELAY_CMD_REJECTED,     // 未入队（主站未运行/参数错误/队列已满）
+    RELAY_CMD_CANCELLED     // 主站停止时尚未完成
+};
+
+// 继电器命令完成结果
+struct RelayCommandResult {
+    uint64_t command_id;            // 命令序号
+    RelayCommandStatus status;
+    uint8_t outputs;                // 命令生效后的继电器输出位
+    uint64_t sent_cycle;            // 输出随哪个周期的帧发送（0 表示未发送）
+    uint64_t confirmed_cycle;       // 哪个周期的域WKC确认了该帧（0 表示未确认）
+
+    RelayCommandResult()
+        : command_id(0), status(RelayCommandStatus::RELAY_CMD_PENDING)
+        , outputs(0), sent_cycle(0), confirmed_cycle(0) {
+    }
+
+    bool confirmed() const { return status == RelayCommandStatus::RELAY_CMD_CONFIRMED; }
+};
+
+using RelayCommandCallback = std::function<void(const RelayCommandResult& result)>;
+
+// SDO 读写完成状态
+enum class SdoRequestStatus {
+    SDO_PENDING,            // 尚未完成
+    SDO_SUCCESS,            // 传输成功
+    SDO_ERROR,              // 从站中止、超时或从站不可达
+    SDO_REJECTED,           // 未发起（主站未运行/请求不可用/长度不符/队列已满）
+    SDO_CANCELLED           // 主站停止或重新配置时尚未完成
+};
+
+// SDO 读写完成结果
+struct SdoRequestResult {
+    int request_id;                                 // createSdoRequest() 的返回值
+    uint64_t operation_id;                          // 读写操作序号
+    bool write;
+    uint16_t position;
+    uint16_t index;
+    uint8_t subindex;
+    SdoRequestStatus status;
+    uint64_t issued_cycle;                          // 发起传输的周期号（0 表示未发起）
+    uint64_t completed_cycle;                       // 周期线程发现传输结束的周期号
+    size_t size;                                    // 写入或读到的字节数
+    std::array<uint8_t, SDO_REQUEST_MAX_SIZE> data; // 写入或读到的数据
+
+    SdoRequestResult()
+        : request_id(-1), operation_id(0), write(false), position(0), index(0), subindex(0)
+        , status(SdoRequestStatus::SDO_PENDING), issued_cycle(0), completed_cycle(0), size(0), data() {
+    }
+
+    bool succeeded() const { return status == SdoRequestStatus::SDO_SUCCESS; }
+    // 前 size 个字节（最多 4 个）按小端解释的整数
+    uint32_t value() const {
+        uint32_t result = 0;
+        for (size_t i = 0; i < size && i < 4; i++) {
+            result |= static_cast<uint32_t>(data[i]) << (8 * i);
+        }
+        return result;
+    }
+};
+
+using SdoRequestCallback = std::function<void(const SdoRequestResult& result)>;
+
+// 单个指标的统计摘要（单位 ns）
+struct CycleMetricSummary {
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    double mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+
+    CycleMetricSummary()
+        : count(0), min_ns(0), max_ns(0), mean_ns(0.0), p50_ns(0), p99_ns(0), p999_ns(0) {
+    }
+};
+
+// 所有周期计时指标的摘要
+struct CycleTimingReport {
+    int64_t cycle_period_ns;                                      // 标称周期
+    std::array<CycleMetricSummary, CYCLE_METRIC_COUNT> metrics;   // 按 CycleMetric 索引
+
+    CycleTimingReport() : cycle_period_ns(0) {}
+
+    const CycleMetricSummary& operator[](CycleMetric metric) const {
+        return metrics[static_cast<size_t>(metric)];
+    }
+};
+
+class PressureCalibrationSet;
+
 class EtherCATMaster {
 public:
     EtherCATMaster();
@@ -330,25 +712,96 @@ public:
     EtherCATMaster(const EtherCATMaster&) = delete;
     EtherCATMaster& operator=(const EtherCATMaster&) = delete;
 
+    // 现场总线后端：默认 IgH（无 IgH 时为模拟总线），仅在 initialize() 前切换
+    // resource 为原始套接字后端的网卡名或回放后端的记录文件路径
+    bool setFieldbusBackend(FieldbusBackendType type, const std::string& resource = "");
+    std::string getFieldbusBackendName() const { return backend->getName(); }
+    FieldbusBackendType getFieldbusBackendType() const { return backend->getType(); }
+    
+    // 过程数据记录：把当前后端每周期的域数据和WKC写入文件，可用 BACKEND_REPLAY 回放
+    // 在 setFieldbusBackend() 之后、initialize() 之前调用
+    bool enableProcessImageRecording(const std::string& path);
+    bool isReplayFinished() const { return backend->isReplayFinished(); }
+    
+    // 从站拓扑和 PDO 映射：默认为内置的试验台拓扑，initialize() 前可从拓扑文件加载
+    // cache_path 为空时缓存写在 path + ".cache"
+    bool loadTopology(const std::string& path, const std::string& cache_path = "");
+    const SlaveTopology& getTopology() const { return topology; }
+    // initialize() 时总线扫描与拓扑的比对结果；后端不支持扫描时 scanned 为 false。热重配置会改写，返回副本
+    TopologyCheck getTopologyCheck() const;
+    // 各域的通道数，由拓扑绑定的端子数决定（initialize() 之后有效，热重配置后可能变化）
+    size_t getAnalogChannelCount() const { return analog_channel_count; }
+    size_t getDigitalInputCount() const { return digital_input_count; }
+    size_t getRelayChannelCount() const { return relay_channel_count; }
+    
+    // 时钟：周期截止时间、测试等待和超时、统计和日志时间都经由该时钟，默认为系统时钟
+    // 仅在 start() 前切换；VirtualClock 用于模拟/回放后端下快于实时地运行测试
+    bool setClock(std::shared_ptr<Clock> clock);
+    std::shared_ptr<Clock> getClock() const { return clock; }
+
+    // 热启动缓存：initialize() 前设置，路径为空时不使用。配置指纹（拓扑中写入从站的配置和后端）与缓存一致时，
+    // 把后端上次导出的从站配置交回后端，跳过重复的 SII 读取和 PDO 分配写入；必需从站全部进入 OP 后更新缓存
+    void setWarmStartCache(const std::string& path) { warm_start_cache_path = path; }
+    // 最近一次 initialize()/start() 的分阶段耗时和启动期间各从站的状态变化
+    StartupTiming getStartupTiming() const;
+
     bool initialize();
-    bool start();
+    bool start(const RealtimeOptions& options = RealtimeOptions());
     void stop();
+    const RealtimeOptions& getRealtimeOptions() const { return rt_options; }
     void processCycle();
 
     // EL2634 继电器控制 - PDO方式 (同步版本)
     bool setRelayChannel(uint8_t channel, bool state);
+    bool setRelayChannelConfirmed(uint8_t channel, bool state, int timeout_ms = 200,
+                                  RelayCommandResult* result = nullptr);  // 等待WKC确认
     bool setAllRelays(bool state);
     bool toggleRelayChannel(uint8_t channel);
     
+    // EL2634 继电器控制 - 命令队列方式
+    // mask 中置位的通道设置为 value 中对应位；toggle 为 true 时翻转 mask 中的通道
+    // 周期线程在周期边界取出命令，完成时通过 future 和/或回调返回发送与确认的周期号
+    std::future<RelayCommandResult> submitRelayCommand(uint8_t mask, uint8_t value,
+                                                       RelayCommandCallback callback = nullptr,
+                                                       bool toggle = false);
+    uint8_t getRelayStates() const { return relay_states.load(); }
+    
+    // CoE SDO 请求：initialize() 之前按对象预先创建（从站位置、索引、子索引、对象长度），返回请求ID，失败返回-1；
+    // 主站配置时为在位的从站创建后端请求，热重配置时随之重建。读写由周期线程发起并随周期帧推进，
+    // 调用线程和周期线程都不等待传输；完成时通过 future 和/或回调返回。同一请求的多次读写按提交顺序依次进行
+    int createSdoRequest(uint16_t position, uint16_t index, uint8_t subindex, size_t size,
+                         uint32_t timeout_ms = DEFAULT_SDO_TIMEOUT_MS);
+    std::future<SdoRequestResult> readSdo(int request_id, SdoRequestCallback callback = nullptr);
+    // size 须等于创建时的对象长度
+    std::future<SdoRequestResult> writeSdo(int request_id, const uint8_t* data, size_t size,
+                                           SdoRequestCallback callback = nullptr);
+    std::future<SdoRequestResult> writeSdoValue(int request_id, uint32_t value,
+                                                SdoRequestCallback callback = nullptr);  // 按对象长度小端写入
+    size_t getSdoRequestCount() const { return sdo_request_count; }
+    bool isSdoRequestAvailable(int request_id) const;   // 后端已为该请求创建传输（initialize() 之后有效）
+    
+    // 周期内压力目标监视：周期线程在所选通道越过阈值的同一周期断开 relay_mask 中的继电器
+    // channel_mask 的 bit i 对应模拟输入 i+1（只能选择前 PRESSURE_TARGET_CHANNELS 个通道）
+    // 返回布防ID（0 表示失败）；同一时刻只有一个监视生效，重新布防会替换之前的监视
+    uint32_t armPressureTarget(PressureTargetMode mode, float target_pressure, uint8_t relay_mask,
+                               uint8_t channel_mask = 0x0F);
+    void disarmPressureTarget();
+    bool getPressureTargetEvent(uint32_t arm_id, PressureTargetEvent& event) const;  // 尚未越过时返回 false
+    
     // EL2634 继电器控制 - PDO方式 (异步版本)
     void setRelayChannelAsync(uint8_t channel, bool state, 
                              std::function<void(bool)> callback = nullptr);
     void setAllRelaysAsync(bool state, 
                           std::function<void(bool)> callback = nullptr);
     
+    // 过程数据快照（所有输入通道在同一周期采样，无锁）
+    ProcessImageSnapshot getProcessImageSnapshot() const { return input_snapshot.load(); }
+    DomainSnapshot getDomainSnapshot(ProcessDomainId id) const;
+    static std::string getProcessDomainName(ProcessDomainId id);
+    
     // EL1008 数字输入读取 - PDO方式
     bool readDigitalInput(uint8_t channel);
-    std::vector<bool> readAllDigitalInputs();
+    uint64_t readAllDigitalInputs();                    // 位图，bit i 对应通道 i+1；主站未运行时为 0
     
     // EL3074 模拟输入读取 - PDO方式
     float readAnalogInput(uint8_t channel);
@@ -367,29 +820,54 @@ public:
         std::function<void(const std::vector<float>&, 
                           const std::vector<std::string>&)> callback);
 
-    // 压力传感器状态检查
+    // 压力传感器状态检查（由 EL3074 状态位决定）
     enum PressureStatus {
         PRESSURE_NORMAL = 0,     // 正常范围 0-100 bar
-        PRESSURE_ZERO_DRIFT,     // 零点漂移 (< 4mA)
-        PRESSURE_OVER_RANGE,     // 超量程 100-200 bar
-        PRESSURE_OVERLOAD,       // 过载 > 200 bar
-        PRESSURE_SENSOR_ERROR,   // 传感器故障
-        PRESSURE_OUT_OF_RANGE    // 超出可测量范围
+        PRESSURE_ZERO_DRIFT,     // 零点漂移 (< 4mA，Underrange)
+        PRESSURE_OVER_RANGE,     // 超量程 (> 20mA，Overrange)
+        PRESSURE_OVERLOAD,       // 过载（Limit 2 高于限值，需将限值 2 设为过载压力）
+        PRESSURE_SENSOR_ERROR,   // 传感器故障（Error 或 TxPDO State）
+        PRESSURE_OUT_OF_RANGE,   // 超出可测量范围
+        PRESSURE_STALE           // 采样停滞（TxPDO Toggle 未翻转）
     };
 
     PressureStatus checkPressureStatus(uint8_t channel);
+    // 按快照中同一周期的状态位判断，不做浮点换算
+    static PressureStatus evaluatePressureStatus(const ProcessImageSnapshot& snapshot, size_t index);
     std::string getPressureStatusString(PressureStatus status);
 
     // 模拟量转换函数
     float convertAnalogToCurrent(int16_t analog_value);
     float convertCurrentToPressure(float current_value);
     float convertAnalogToPressure(int16_t analog_value);
-
-    // 状态检查函数
-    bool checkForZeroDrift(int16_t analog_value);
-    bool checkForOverload(float pressure_value);
-    bool checkForSensorError(int16_t analog_value);
+    // 批量换算 count 个通道，逐项结果与单通道版本相同
+    void convertAnalogToCurrent(const int16_t* analog_values, float* currents, size_t count);
+    void convertAnalogToPressure(const int16_t* analog_values, float* pressures, size_t count);
+    
+    // 按通道换算压力：已标定的通道查表，其余与 convertAnalogToPressure 相同；批量版本第 i 项为通道 i+1
+    float convertChannelToPressure(size_t index, int16_t analog_value);
+    void convertChannelsToPressure(const int16_t* analog_values, float* pressures, size_t count);
     
+    // 压力通道标定：加载标定文件并在调用线程编译成每通道 64K 项的查表，再原子地替换当前标定，
+    // 运行中也可调用。周期线程和各换算函数不加锁，直接查表
+    bool loadPressureCalibration(const std::string& path);
+    void clearPressureCalibration();
+    uint64_t getCalibratedChannelMask() const;          // bit i：通道 i+1 使用标定查表
+    std::string getPressureCalibrationSource() const;   // 当前标定文件，未标定时为空
+    
+    // 快照中全部模拟输入一次换算为电流、压力和状态（AnalogKernel.h，按 CPU 选用 AVX2/SSE2/标量），
+    // 逐项结果与上面的单通道换算和 evaluatePressureStatus 相同；已标定通道的压力随后由查表覆盖
+    struct AnalogBlock {
+        uint32_t count;                                 // 有效通道数，等于快照的 analog_count
+        float currents[MAX_ANALOG_CHANNELS];
+        float pressures[MAX_ANALOG_CHANNELS];
+        uint8_t statuses[MAX_ANALOG_CHANNELS];          // PressureStatus
+        
+        PressureStatus status(size_t index) const { return static_cast<PressureStatus>(statuses[index]); }
+    };
+    void convertAnalogBlock(const ProcessImageSnapshot& snapshot, AnalogBlock& block) const;
+    static const char* getAnalogKernelName();
+
     // 状态监控
     void printMasterState();
     void printSlaveStates();
@@ -397,6 +875,23 @@ public:
     void checkDomainState();
     void checkMasterState();
     
+    // 周期计时统计（无锁采集，任意线程可查询）
+    CycleTimingReport getCycleTimingReport() const;
+    LatencyHistogram::Snapshot getCycleHistogram(CycleMetric metric) const;
+    void resetCycleTiming();                            // 请求周期线程在下一周期清零（含超时统计）
+    CycleOverrunStats getCycleOverrunStats() const;
+    bool isSafeOutputsActive() const { return safe_outputs_active; }
+    void clearSafeOutputs();                            // 退出超时触发的安全输出状态
+    
+    // 周期内钩子：在 ecrt_domain_process 之后、ecrt_domain_queue 之前按注册顺序执行
+    int registerCycleHook(const std::string& name, CycleHookFunction function, void* user_data = nullptr,
+                          int64_t budget_ns = DEFAULT_CYCLE_HOOK_BUDGET_NS);  // 仅在 start() 前调用，返回钩子ID，失败返回-1
+    void clearCycleHooks();                             // 仅在主站未运行时调用
+    bool setCycleHookEnabled(int hook_id, bool enabled);  // 任意时刻调用；重新启用会清除自动禁用状态
+    size_t getCycleHookCount() const { return cycle_hook_count; }
+    CycleHookStats getCycleHookStats(int hook_id) const;
+    static std::string getCycleMetricName(CycleMetric metric);
+    
     bool isRunning() const { return running; }
     bool isInitialized() const { return initialized; }
     
@@ -404,11 +899,16 @@ public:
     bool checkMasterHealth();                           // 检查主站健康状态
     MasterStatus getMasterStatus() const;               // 获取主站状态
     MasterStateInfo getMasterStateInfo() const;         // 获取详细的主站状态信息
-    bool waitForOperational(int timeout_ms = 5000);     // 等待主站进入运行状态
+    bool waitForOperational(int timeout_ms = DEFAULT_OPERATIONAL_TIMEOUT_MS);  // 等待必需从站全部进入 OP
     bool isOperational() const;                         // 检查主站是否运行正常
     std::string getMasterStatusString() const;          // 获取状态字符串
     void printHealthStatus();                           // 打印健康状态
     bool verifyOperation(const std::string& operation_name);  // 验证操作可行性
+    
+    // 总线中断检测：监督线程发现从站丢失时置为未就绪，全部已配置从站回到 OP 后恢复；
+    // 后端未能自行恢复时停住周期线程重建主站配置（热重配置），不需要重启程序
+    bool isBusReady() const { return bus_ready; }
+    BusInterruptionStats getBusInterruptionStats() const;
 
     // 新增：UI友好的异步测试函数
     void startSupportTestAsync(float target_pressure = 22.0f, 
@@ -454,27 +954,274 @@ public:
     void setHotkeyCallback(std::function<void(int)> callback); // 设置快捷键回调
 
 private:
-    ec_master_t* master;
-    ec_domain_t* domain;
-    ec_master_state_t master_state;
-    ec_domain_state_t domain_state;
+    std::unique_ptr<FieldbusBackend> backend;
+    std::shared_ptr<Clock> clock;
+    ec_master_state_t master_state;                     // 上次报告的主站状态（仅监督线程）
     
-    std::vector<ec_slave_config_t*> slave_configs;
+    SlaveTopology topology;
+    // 配置结果：initialize() 和热重配置（监督线程）时写入，写入和其他线程的读取都持有 config_mutex；
+    // 周期线程不加锁读取，热重配置期间周期线程已停住
+    TopologyCheck topology_check;
+    std::vector<size_t> slave_configs;                  // 已配置从站在拓扑中的下标（与后端的配置顺序相同）
+    mutable std::mutex config_mutex;
+    std::atomic<unsigned int> expected_slaves;          // expectedSlaveCount() 的结果，随 topology_check 发布
+    std::atomic<bool> domains_attached;                 // 各域数据指针有效（activate() 之后到热重配置或停止之前）
     
-    // PDO 数据指针
-    uint8_t* domain_data;
+    // 过程数据域（偏移量相对于所属域的数据指针）
+    struct ProcessDomain {
+        int domain;                         // 后端域句柄，-1 表示未创建
+        uint8_t* data;
+        size_t size;
+        uint32_t divider;                   // 每 divider 个基础周期交换一次
+        bool exchanging;                    // 上一周期已排队，本周期处理回帧（仅周期线程）
+        uint64_t exchange_count;            // 仅周期线程
+        uint64_t wkc_error_count;           // 仅周期线程
+        SeqLock<DomainSnapshot> snapshot;
+        std::atomic<uint64_t> published_state;  // 原始状态字，见 publishDomainState
+        ec_domain_state_t reported_state;   // 上次报告的域状态（仅监督线程）
+
+        ProcessDomain()
+            : domain(-1), data(nullptr), size(0), divider(1), exchanging(false)
+            , exchange_count(0), wkc_error_count(0), published_state(0), reported_state() {
+        }
+    };
+    std::array<ProcessDomain, PROCESS_DOMAIN_COUNT> domains;
+    ProcessDomain& processDomain(ProcessDomainId id) { return domains[static_cast<size_t>(id)]; }
+    // 仅周期线程（热重配置会改写数据指针），其他线程以 domains_attached 判断域数据是否可用
+    uint8_t* domainData(ProcessDomainId id) const { return domains[static_cast<size_t>(id)].data; }
+    bool isDomainDue(const ProcessDomain& d) const { return (cycle_count - 1) % d.divider == 0; }
     
-    // 从站偏移量
-    unsigned int off_dig_in[8];  // EL1008 8个数字输入
-    unsigned int off_ai_val[4];  // EL3074 4个模拟输入值
-    unsigned int off_relay_out[4]; // EL2634 4个继电器输出
+    // 端子过程映像（偏移量相对于所属域的数据指针，端子内通道访问在编译期展开）
+    TerminalArray<El3074> analog_terminals;     // 模拟输入域
+    TerminalArray<El1008> digital_terminals;    // 数字输入域
+    TerminalArray<El2634> relay_terminals;      // 继电器输出域
+    std::atomic<size_t> analog_channel_count;   // 各域的通道数（configureSlaves() 时由拓扑确定）
+    std::atomic<size_t> digital_input_count;
+    std::atomic<size_t> relay_channel_count;
+    std::atomic<uint8_t> relay_channel_mask;    // 已绑定的继电器通道
+    template <typename T>
+    bool bindTerminals(ProcessDomainId domain, TerminalArray<T>& images, size_t max_channels,
+                       const std::vector<bool>& skipped,
+                       std::vector<ec_pdo_entry_reg_t>& regs);   // 按拓扑绑定生成该域的注册项
+    template <typename T>
+    bool verifyTerminals(ProcessDomainId domain, const TerminalArray<T>& images);   // 注册后检查布局
     
-    // 继电器状态缓存（用于确保状态一致性）
+    // 继电器状态缓存（仅周期线程写入，其他线程只读）
     std::atomic<uint8_t> relay_states;
     
+    // 继电器命令：槽在构造时预分配，队列中只传递槽号。调用线程取空闲槽并填写，周期线程只读写
+    // mask/value/toggle/result，promise 和回调只由调用线程和监督线程访问；监督线程完成通知后归还空闲槽
+    struct RelayCommandSlot {
+        uint8_t mask;
+        uint8_t value;
+        bool toggle;
+        RelayCommandResult result;
+        std::promise<RelayCommandResult> promise;
+        RelayCommandCallback callback;
+    };
+    std::array<RelayCommandSlot, RELAY_COMMAND_POOL_SIZE> relay_slots;
+    LockFreeQueue<uint16_t, RELAY_COMMAND_POOL_SIZE> relay_free_slots;                // 监督线程 -> 调用线程
+    LockFreeQueue<uint16_t, RELAY_COMMAND_QUEUE_SIZE> relay_command_queue;            // 调用线程 -> 周期线程
+    LockFreeQueue<uint16_t, RELAY_COMMAND_POOL_SIZE> relay_completion_queue;          // 周期线程 -> 监督线程（容量等于槽数，不会满）
+    std::array<uint16_t, RELAY_COMMAND_QUEUE_SIZE> relay_in_flight;                   // 已发送待确认（仅周期线程）
+    size_t relay_in_flight_count;
+    uint8_t relay_output_image;                         // 本周期写出的继电器位（仅周期线程）
+    int64_t relay_confirm_timeout_cycles;
+    std::atomic<uint64_t> next_relay_command_id;
+    void confirmRelayCommands(const ec_domain_state_t* ds); // 周期线程：确认/超时已发送的命令（ds 为空表示本周期无继电器回帧）
+    void applyRelayCommands();                          // 周期线程：继电器域排队前取出新命令
+    void completeRelayCommand(uint16_t slot);        // 完成 future/回调并归还槽
+    void dispatchRelayCompletions();                    // 监督线程：完成 future/回调并释放
+    void cancelPendingRelayCommands();                  // 停止后清理未完成命令
+    bool deenergizeRelaysForStop();                     // 停止前关闭全部继电器并等待WKC确认（线程仍在运行）
+    // 按主站时钟等待命令完成；虚拟时钟下轮询，避免参与线程在时钟之外阻塞而使时间停止
+    bool waitRelayCommand(std::future<RelayCommandResult>& future, int timeout_ms);
+    std::chrono::steady_clock::time_point clockNow() const;    // 主站时钟的当前时间（测试计时和统计）
+    
+    // SDO 请求：表项在 initialize() 之前创建，backend_request 由配置线程写入（周期线程停住或未运行时）
+    struct SdoRequestSlot {
+        uint16_t position;
+        uint16_t index;
+        uint8_t subindex;
+        size_t size;
+        uint32_t timeout_ms;
+        std::atomic<int> backend_request;               // 后端请求句柄，-1 表示从站未配置或后端不支持
+    };
+    // 一次读写：调用线程创建，周期线程发起和查询，监督线程完成通知并释放
+    struct SdoOperation {
+        SdoRequestResult result;
+        std::promise<SdoRequestResult> promise;
+        SdoRequestCallback callback;
+    };
+    std::array<SdoRequestSlot, MAX_SDO_REQUESTS> sdo_requests;
+    size_t sdo_request_count;
+    LockFreeQueue<SdoOperation*, SDO_OPERATION_QUEUE_SIZE> sdo_operation_queue;        // 调用线程 -> 周期线程
+    LockFreeQueue<SdoOperation*, SDO_OPERATION_QUEUE_SIZE * 2> sdo_completion_queue;   // 周期线程 -> 监督线程
+    std::array<SdoOperation*, SDO_OPERATION_QUEUE_SIZE> sdo_in_flight;                 // 按提交顺序（仅周期线程）
+    size_t sdo_in_flight_count;
+    std::array<SdoOperation*, MAX_SDO_REQUESTS> sdo_active;     // 各请求正在传输的操作（仅周期线程）
+    std::atomic<uint64_t> next_sdo_operation_id;
+    void createBackendSdoRequests(uint16_t position, size_t config);   // configureSlaves()：为已配置的从站创建
+    std::future<SdoRequestResult> submitSdoOperation(SdoOperation* operation);
+    void advanceSdoRequests();                          // 周期线程：查询进行中的传输，空闲的请求发起下一个操作
+    void completeSdoOperation(SdoOperation* operation);
+    void dispatchSdoCompletions();                      // 监督线程：完成 future/回调并释放
+    void cancelPendingSdoOperations();                  // 停止后清理未完成操作
+    
+    // 监督线程（非实时，负责完成通知、健康检查和状态变化报告）
+    std::thread supervisor_thread;
+    void supervisorThreadFunc();
+    
+    // 周期线程发布的原始状态字，监督线程和调用线程只读，不直接访问 ecrt
+    // 域状态: bit0-31 working_counter, bit32-39 wc_state（每个域一个，见 ProcessDomain）
+    // 主站状态: bit0-31 slaves_responding, bit32-39 al_states, bit40 link_up
+    // bit63 置位表示已采样
+    std::atomic<uint64_t> published_master_state;
+    void publishDomainState(ProcessDomain& d, const ec_domain_state_t& ds);
+    void publishMasterState();                          // 周期线程：采样主站状态
+    bool loadDomainState(const ProcessDomain& d, ec_domain_state_t& ds) const;
+    bool loadMasterState(ec_master_state_t& ms) const;
+    
+    // 已配置从站的状态字（按配置顺序）: bit i 在线, bit 32+i 处于 OP，i < MAX_MONITORED_SLAVES；
+    // bit63 置位表示已采样，后端不支持逐从站状态时保持为 0
+    std::atomic<uint64_t> published_slave_states;
+    
+    // 总线中断与热重配置（状态仅监督线程访问，统计由 state_mutex 保护）
+    std::atomic<bool> bus_ready;                        // 没有未恢复的中断，测试据此在周期边界暂停
+    std::atomic<uint64_t> bus_interruption_count;       // 测试据此判断一个阶段内是否发生过中断
+    bool bus_interrupted;
+    std::chrono::steady_clock::time_point bus_lost_time;
+    uint64_t bus_lost_cycle;
+    std::chrono::steady_clock::time_point bus_reconfigure_time;  // 重配置计时起点（从站回到总线或上次重配置）
+    bool bus_reconfigure_armed;                         // 已开始重配置计时
+    uint32_t bus_offline_slaves;                        // 上次报告时离线的已配置从站（按配置顺序的位图）
+    BusInterruptionStats bus_stats;
+    void checkBusState();                               // 监督线程：检测中断、恢复和重配置时机
+    bool reconfigureBus();                              // 监督线程：停住周期线程后重建主站配置
+    
+    // 热重配置期间周期线程只保持周期节拍，不访问后端
+    std::atomic<bool> cycle_park_requested;             // 监督线程请求
+    std::atomic<bool> cycle_parked;                     // 周期线程确认已停住
+    void resumeAfterReconfigure();                      // 周期线程：恢复后的第一个周期前调用
+    
     bool initialized;
     std::atomic<bool> running;
     std::thread process_thread;
+    RealtimeOptions rt_options;                         // 周期线程配置（start()时确定）
+    bool memory_locked;                                 // 是否已执行 mlockall
+    
+    // 输入快照（仅周期线程写入）
+    SeqLock<ProcessImageSnapshot> input_snapshot;
+    ProcessImageSnapshot input_snapshot_rt;             // 周期线程的工作副本，未交换的域保留上次的值
+    uint64_t cycle_count;                               // 已执行的基础周期数（仅周期线程访问）
+    uint64_t analog_toggle_rt;                          // 上次交换时各通道的 TxPDO Toggle（仅周期线程）
+    std::array<uint32_t, MAX_ANALOG_CHANNELS> analog_unchanged_rt;     // Toggle 连续未翻转的交换次数
+    uint32_t analog_stale_exchanges;                    // 判定停滞的交换次数（start() 按周期和分频换算）
+    void publishInputSnapshot(int64_t timestamp_ns, bool analog_updated, bool digital_updated);
+    void publishDomainSnapshot(ProcessDomain& d, const ec_domain_state_t& ds, int64_t timestamp_ns);
+    
+    // 周期计时直方图（仅周期线程写入）
+    std::array<LatencyHistogram, CYCLE_METRIC_COUNT> cycle_histograms;
+    std::atomic<bool> cycle_timing_reset_requested;     // 由读者请求、周期线程执行复位
+    void recordCycleMetric(CycleMetric metric, int64_t value_ns);
+    
+    // 启动计时和从站进入 OP 的跟踪
+    struct SlaveStateEvent {
+        uint16_t config;                // 按配置顺序，SLAVE_STATE_ALL 为汇总状态
+        uint8_t from_state;
+        uint8_t to_state;
+        bool all_operational;           // 必需从站已全部进入 OP（不带状态变化）
+        uint64_t cycle;
+        int64_t elapsed_ns;
+    };
+    std::string warm_start_cache_path;
+    StartupTiming startup_timing;                       // state_mutex 保护
+    int64_t startup_begin_ns;                           // initialize() 开始
+    int64_t cycle_start_ns;                             // 周期线程启动时刻，从站状态变化和进入 OP 的计时起点
+    std::atomic<bool> startup_tracking;                 // 周期线程逐周期采样从站状态
+    std::array<uint8_t, MAX_MONITORED_SLAVES> startup_states_rt;  // 周期线程上次看到的各从站 AL 状态
+    uint8_t startup_master_state_rt;                    // 后端不支持逐从站状态时上次看到的汇总状态
+    uint32_t startup_required_mask;                     // 必需从站（按配置顺序），start() 时确定
+    LockFreeQueue<SlaveStateEvent, SLAVE_STATE_EVENT_QUEUE_SIZE> slave_state_event_queue;
+    std::promise<uint64_t> startup_op_promise;          // 监督线程在必需从站全部进入 OP 时完成，值为周期
+    std::shared_future<uint64_t> startup_op_future;
+    bool startup_op_reported;                           // 仅监督线程访问
+    bool trackStartupStates();                          // 周期线程：全部进入 OP 时返回 true 并停止跟踪
+    void dispatchSlaveStateEvents();                    // 监督线程：写入日志和启动计时
+    uint64_t configurationFingerprint() const;
+    bool loadWarmStartCache(uint64_t fingerprint);
+    void saveWarmStartCache(uint64_t fingerprint, const std::vector<uint8_t>& data);
+    
+    // 周期超时检测（统计仅周期线程写入，通过顺序锁发布）
+    struct CycleOverrunEvent {
+        bool run_ended;                 // false: 连续超时开始；true: 连续超时结束
+        bool safe_outputs_entered;      // 本次超时使输出进入安全状态
+        uint64_t cycle;                 // 周期号
+        int64_t time_ns;                // 发生时刻 (CLOCK_REALTIME)
+        int64_t overrun_ns;             // 开始：本次超出量；结束：本轮最大超出量
+        uint64_t run_length;            // 结束：本轮连续超时次数
+        uint64_t skipped_cycles;        // 结束：本轮丢弃的周期数
+    };
+    CycleOverrunStats overrun_stats_rt;                 // 周期线程的工作副本
+    SeqLock<CycleOverrunStats> overrun_stats;
+    int64_t overrun_run_max_ns;                         // 当前这轮连续超时的最大超出量
+    uint64_t overrun_run_skipped;                       // 当前这轮连续超时丢弃的周期数
+    std::atomic<bool> safe_outputs_active;
+    LockFreeQueue<CycleOverrunEvent, 64> overrun_event_queue; // 周期线程 -> 监督线程
+    void handleCycleOverrun(int64_t overrun_ns, int64_t& next_cycle_ns);
+    void endCycleOverrunRun();
+    void pushCycleOverrunEvent(const CycleOverrunEvent& event);
+    void dispatchCycleOverrunEvents();                  // 监督线程：写入测试日志
+    
+    // 周期内压力目标监视
+    // 请求字: bit0-23 原始阈值(int24), bit24-31 继电器掩码, bit32-39 通道掩码,
+    //         bit40 判定方式(1=低于), bit41 已布防, bit48-63 布防ID
+    // 目标字: bit0-31 目标压力(float)，供已标定的通道查表比较, bit48-63 布防ID（与请求字一致时有效）
+    std::atomic<uint64_t> pressure_target_request;
+    std::atomic<uint64_t> pressure_target_level;
+    std::atomic<uint32_t> next_pressure_target_id;
+    uint32_t pressure_target_fired_id;                  // 已触发的布防ID（仅周期线程）
+    SeqLock<PressureTargetEvent> pressure_target_event;
+    int32_t pressureToRawThreshold(float target_pressure);  // 满足 压力 >= 目标 的最小原始值
+    void evaluatePressureTarget(int64_t timestamp_ns);  // 周期线程：输入快照发布后调用
+    
+    // 压力通道标定：当前标定以原子指针发布，读者在使用期间计入 calibration_readers；
+    // 被替换的标定先放入 retired_calibrations，观察到读者数为 0 后释放（替换方和监视线程）
+    std::atomic<const PressureCalibrationSet*> calibration;
+    mutable std::atomic<uint32_t> calibration_readers;
+    std::mutex calibration_mutex;                       // 只在替换/释放之间互斥，读者不加锁
+    std::vector<std::unique_ptr<const PressureCalibrationSet>> retired_calibrations;
+    const PressureCalibrationSet* acquireCalibration() const;
+    void releaseCalibration() const;
+    void swapCalibration(std::unique_ptr<const PressureCalibrationSet> next);
+    void reclaimCalibrations();
+    
+    // 周期内钩子（注册只在主站未运行时进行，周期线程运行期间表项不变）
+    struct CycleHook {
+        std::string name;
+        CycleHookFunction function;
+        void* user_data;
+        int64_t budget_ns;
+        uint32_t consecutive_violations;    // 仅周期线程
+        std::atomic<bool> enabled;
+        std::atomic<bool> disabled_by_budget;
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> budget_violations;
+        std::atomic<uint64_t> total_ns;
+        std::atomic<int64_t> last_ns;
+        std::atomic<int64_t> max_ns;
+
+        CycleHook()
+            : function(nullptr), user_data(nullptr), budget_ns(0), consecutive_violations(0)
+            , enabled(false), disabled_by_budget(false), calls(0), budget_violations(0)
+            , total_ns(0), last_ns(0), max_ns(0) {
+        }
+    };
+    std::array<CycleHook, MAX_CYCLE_HOOKS> cycle_hooks;
+    size_t cycle_hook_count;
+    LockFreeQueue<uint32_t, 16> cycle_hook_event_queue;   // 被自动禁用的钩子ID：周期线程 -> 监督线程
+    void runCycleHooks(int64_t timestamp_ns, bool analog_updated, bool digital_updated, bool relay_due);
+    void dispatchCycleHookEvents();                     // 监督线程：记录自动禁用
     
     // 新增：状态监测相关成员
     MasterStateInfo master_state_info;
@@ -514,9 +1261,18 @@ private:
     std::thread hotkey_thread;                          // 快捷键监听线程
     std::atomic<bool> hotkey_listening;                 // 是否监听快捷键
     
+    bool scanBus();                                     // 扫描总线并与拓扑比对，身份不符时返回 false
+    void publishTopologyCheck(TopologyCheck check);
+    void publishSlaveConfigs(std::vector<size_t> configs);
+    bool createDomains();                               // 为每组从站创建一个域
     bool configureSlaves();
+    bool attachDomains();                               // activate() 之后获取各域数据并设置交换分频
+    unsigned int expectedSlaveCount() const;            // 健康检查期望的响应从站数
+    bool topologyMismatch() const;                      // 总线扫描与拓扑不一致
+    bool validateRealtimeOptions(const RealtimeOptions& options);
+    void setupRealtimeThread();                         // 在周期线程内设置调度/绑核/预缺页
     void processThreadFunc();
-    void updateMasterStatus();                          // 更新主站状态
+    void updateMasterStatus();                          // 更新主站状态（监督线程）
     
     // 任务处理线程函数
     void taskThreadFunc();
@@ -539,11 +1295,10 @@ private:
                                         int retract_timeout,
                                         ReliabilityProgressCallback progress_callback,
                                         std::function<void(const ReliabilityTestStats&)> completion_callback);
+    bool waitForBusRecovery(int cycle_number, const BusInterruptionStats& baseline);  // 测试停止时返回 false
     
     // 使用EC库宏进行PDO访问
     void writeRelayOutputs();
-    bool readDigitalInputPDO(uint8_t channel);
-    int16_t readAnalogInputPDO(uint8_t channel);
     
     // 新增：日志管理函数
     void rotateLogFile();                               // 轮转日志文件
@@ -0,0 +1,100 @@
+#ifndef FIELDBUSBACKEND_H
+#define FIELDBUSBACKEND_H
+
+// 仅在Linux + WITH_IGH_ETHERCAT时包含真正的EtherCAT头文件，否则使用进程内模拟总线
+#if defined(__linux__) && WITH_IGH_ETHERCAT
+#include <ecrt.h>
+#else
+#include "ethercat/ecrt_sim.h"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 现场总线后端类型
+enum class FieldbusBackendType {
+    BACKEND_IGH,            // IgH 内核主站（无 IgH 时为进程内模拟总线）
+    BACKEND_RAW_SOCKET,     // 纯用户态，AF_PACKET 原始套接字直接收发 EtherCAT 帧
+    BACKEND_REPLAY          // 回放 RecordingBackend 写出的过程数据记录文件
+};
+
+/**
+ * @brief 现场总线后端接口
+ *
+ * EtherCATMaster 只通过该接口访问总线。从站配置和 PDO 注册沿用 ecrt 的描述结构
+ * （ec_sync_info_t / ec_pdo_entry_reg_t），过程数据仍是按字节偏移访问的域数据，
+ * 因此 EC_READ_* / EC_WRITE_* 在所有后端上都适用。
+ *
+ * 调用顺序与 ecrt 相同：requestMaster → createDomain/configureSlave/registerPdoEntries
+ * → activate → 周期内 receive/processDomain/queueDomain/send → releaseMaster。
+ * 周期交换函数只能由周期线程调用；SDO 访问是阻塞的，只能在非实时线程中调用。
+ * 非阻塞 SDO 请求在 activate() 之前创建，之后由周期线程发起和查询，传输随周期帧推进。
+ */
+class FieldbusBackend {
+public:
+    virtual ~FieldbusBackend() {}
+
+    virtual FieldbusBackendType getType() const = 0;
+    virtual std::string getName() const = 0;
+
+    // 配置阶段
+    virtual bool requestMaster(unsigned int master_index) = 0;
+    virtual void releaseMaster() = 0;
+    virtual bool isMasterRequested() const = 0;
+    // 总线扫描（requestMaster 之后、activate 之前）：实际连接的从站，按位置排列
+    // 后端不支持扫描（回放）或扫描失败时返回 false
+    virtual bool scanSlaves(std::vector<ec_slave_info_t>& slaves) { slaves.clear(); return false; }
+    virtual int createDomain() = 0;                         // 返回域句柄，失败返回-1
+    virtual bool configureSlave(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                                const ec_sync_info_t* syncs = nullptr) = 0;   // syncs 以 index 0xff 结束
+    virtual bool registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) = 0;  // 以 index 0 结束
+    virtual bool activate() = 0;
+    virtual uint8_t* getDomainData(int domain) = 0;         // activate() 之后有效
+    virtual size_t getDomainSize(int domain) const = 0;
+
+    // 周期交换（仅周期线程）
+    virtual void receive() = 0;
+    virtual void processDomain(int domain, ec_domain_state_t& state) = 0;
+    virtual void queueDomain(int domain) = 0;
+    virtual void send() = 0;
+    virtual void getMasterState(ec_master_state_t& state) = 0;
+    // 第 config 个由 configureSlave() 成功配置的从站的状态（按配置顺序），后端不支持时返回 false
+    virtual bool getSlaveConfigState(size_t, ec_slave_config_state_t&) { return false; }
+
+    // SDO 访问（阻塞，非实时线程）
+    virtual bool sdoDownload(uint16_t position, uint16_t index, uint8_t subindex,
+                             const uint8_t* data, size_t size, uint32_t* abort_code) = 0;
+    virtual bool sdoUpload(uint16_t position, uint16_t index, uint8_t subindex,
+                           uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code) = 0;
+
+    // 非阻塞 SDO 请求（ecrt_slave_config_create_sdo_request）：参数为 (config, index, subindex, size, timeout_ms)，
+    // activate() 之前为第 config 个已配置的从站（按配置顺序）创建 size 字节的请求，返回请求句柄，后端不支持时返回 -1。
+    // 写入的长度为 size；读取完成后 getSdoRequestDataSize() 为实际上传的长度。其余函数只由周期线程调用
+    virtual int createSdoRequest(size_t, uint16_t, uint8_t, size_t, uint32_t) { return -1; }
+    virtual uint8_t* getSdoRequestData(int) { return nullptr; }
+    virtual size_t getSdoRequestDataSize(int) const { return 0; }
+    virtual ec_request_state_t getSdoRequestState(int) { return EC_REQUEST_ERROR; }
+    virtual void readSdoRequest(int) {}
+    virtual void writeSdoRequest(int) {}
+
+    // 热启动：activate() 成功后导出本次从总线读到、写入从站的配置（格式由后端决定），
+    // 下次 requestMaster() 之后、scanSlaves()/activate() 之前交回，后端逐个从站核对后跳过重复的读取和写入。
+    // 不支持时导出返回 false，导入的数据无法使用时返回 false（按冷启动处理）
+    virtual bool exportWarmStartData(std::vector<uint8_t>&) const { return false; }
+    virtual bool importWarmStartData(const std::vector<uint8_t>&) { return false; }
+
+    // 回放后端：记录已全部播放
+    virtual bool isReplayFinished() const { return false; }
+    // 运行中能否释放主站并重新建立配置（从站丢失后的热重配置）
+    virtual bool supportsReconfiguration() const { return true; }
+};
+
+// resource：原始套接字后端为网卡名（例如 "eth1"），回放后端为记录文件路径，IgH 后端忽略
+std::unique_ptr<FieldbusBackend> createFieldbusBackend(FieldbusBackendType type,
+                                                       const std::string& resource = "");
+std::string getFieldbusBackendTypeName(FieldbusBackendType type);
+
+#endif // FIELDBUSBACKEND_H
@@ -0,0 +1,107 @@
+#ifndef HYDRAULICPLANT_H
+#define HYDRAULICPLANT_H
+
+#include "ethercat/SimulatedBus.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+constexpr size_t HYDRAULIC_LEG_COUNT = 4;   // 四条支腿，对应 EL3074 通道 1-4
+
+// 压力传感器故障
+enum class SensorFault {
+    SENSOR_OK = 0,
+    SENSOR_STUCK,           // 读数冻结在 stuck_pressure（或注入故障时的压力）
+    SENSOR_OPEN_CIRCUIT     // 断线：0mA，EL3074 置 Error 位
+};
+
+// 单条支腿的参数
+struct HydraulicLegConfig {
+    float supply_pressure;          // 支撑阀通电时的稳态压力(bar)
+    float return_pressure;          // 回缩阀通电时的稳态压力(bar)
+    float rise_time_constant_ms;    // 支撑时的一阶时间常数
+    float fall_time_constant_ms;    // 回缩时的一阶时间常数
+    float leak_rate;                // 两阀都断开时的泄漏速度(bar/s)，0 表示保压
+    float noise_stddev;             // 传感器噪声标准差(bar)
+    float sensor_offset;            // 传感器零点偏移(bar)
+    SensorFault fault;
+    float stuck_pressure;           // SENSOR_STUCK 时的读数，负数表示冻结在故障发生时的压力
+
+    HydraulicLegConfig()
+        : supply_pressure(80.0f), return_pressure(0.0f)
+        , rise_time_constant_ms(400.0f), fall_time_constant_ms(300.0f)
+        , leak_rate(0.0f), noise_stddev(0.05f), sensor_offset(0.0f)
+        , fault(SensorFault::SENSOR_OK), stuck_pressure(-1.0f) {
+    }
+};
+
+// 整个对象的参数
+struct HydraulicPlantConfig {
+    std::array<HydraulicLegConfig, HYDRAULIC_LEG_COUNT> legs;
+    float spread;                   // 各腿时间常数和供油压力的随机离散度（相对值，0.1 = ±10%），在 reset() 时抽取
+    uint8_t support_relay;          // 支撑阀继电器通道 (1-4)
+    uint8_t retract_relay;          // 回缩阀继电器通道 (1-4)
+    int64_t step_ns;                // 每个总线周期推进的时间，应与主站周期一致
+    uint32_t seed;                  // 噪声和离散度的随机种子，相同种子得到相同的压力序列
+
+    HydraulicPlantConfig()
+        : legs(), spread(0.0f), support_relay(1), retract_relay(2)
+        , step_ns(10000000), seed(1) {
+    }
+};
+
+/**
+ * @brief 液压支腿对象模型（模拟总线专用）
+ *
+ * 每个总线周期读取 EL2634 继电器输出：支撑阀通电时各腿压力按一阶惯性升向供油压力，
+ * 回缩阀通电时降向回油压力（两阀同时通电按回缩处理），都断开时按泄漏速度下降。
+ * 压力加上零点偏移和高斯噪声后换算为 EL3074 原始值（0-100bar ↔ 0-32767）写回模拟总线。
+ *
+ * 模型按固定步长推进，与墙钟无关；相同配置和种子下同一继电器序列得到相同的输入序列。
+ * 配置和故障可在任意线程修改，下一周期生效。
+ */
+class HydraulicPlant {
+public:
+    explicit HydraulicPlant(const HydraulicPlantConfig& config = HydraulicPlantConfig());
+    ~HydraulicPlant();
+
+    HydraulicPlant(const HydraulicPlant&) = delete;
+    HydraulicPlant& operator=(const HydraulicPlant&) = delete;
+
+    // 作为模拟总线的每周期回调（替换已有回调）；detach() 或析构时移除
+    void attach(SimulatedBus& bus);
+    void detach();
+
+    // 推进一个步长并写入模拟输入（attach() 后由总线调用，也可直接调用）
+    void step(SimulatedBus& bus);
+
+    void setConfig(const HydraulicPlantConfig& config);     // 同时执行 reset()
+    HydraulicPlantConfig getConfig() const;
+    void reset();                                           // 压力归零，按种子重新抽取离散度和噪声
+
+    // 故障注入
+    void setLegFault(size_t leg, SensorFault fault, float stuck_pressure = -1.0f);
+    void setLegLeakRate(size_t leg, float leak_rate);
+
+    float getLegPressure(size_t leg) const;                 // 真实压力(bar)，不含传感器误差
+    uint64_t getStepCount() const;
+
+private:
+    static int16_t pressureToRaw(float pressure);
+    void drawSpreadLocked();
+
+    mutable std::mutex mutex;
+    HydraulicPlantConfig config;
+    std::array<float, HYDRAULIC_LEG_COUNT> pressure;
+    std::array<float, HYDRAULIC_LEG_COUNT> supply_scale;    // 离散度抽样
+    std::array<float, HYDRAULIC_LEG_COUNT> tau_scale;
+    std::array<float, HYDRAULIC_LEG_COUNT> frozen_reading;  // SENSOR_STUCK 冻结的读数
+    std::mt19937 rng;
+    std::normal_distribution<float> noise;
+    uint64_t step_count;
+    SimulatedBus* attached_bus;
+};
+
+#endif // HYDRAULICPLANT_H
@@ -0,0 +1,68 @@
+#ifndef IGHBACKEND_H
+#define IGHBACKEND_H
+
+#include "ethercat/FieldbusBackend.h"
+
+#include <vector>
+
+/**
+ * @brief IgH 内核主站后端
+ *
+ * 对 ecrt_* 的一对一封装。未启用 WITH_IGH_ETHERCAT 时 ecrt_* 由进程内模拟总线实现，
+ * 同一后端即为模拟后端。
+ */
+class IghBackend : public FieldbusBackend {
+public:
+    IghBackend();
+    ~IghBackend() override;
+
+    IghBackend(const IghBackend&) = delete;
+    IghBackend& operator=(const IghBackend&) = delete;
+
+    FieldbusBackendType getType() const override { return FieldbusBackendType::BACKEND_IGH; }
+    std::string getName() const override;
+
+    bool requestMaster(unsigned int master_index) override;
+    void releaseMaster() override;
+    bool isMasterRequested() const override { return master != nullptr; }
+    bool scanSlaves(std::vector<ec_slave_info_t>& slaves) override;
+    int createDomain() override;
+    bool configureSlave(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                        const ec_sync_info_t* syncs = nullptr) override;
+    bool registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) override;
+    bool activate() override;
+    uint8_t* getDomainData(int domain) override;
+    size_t getDomainSize(int domain) const override;
+
+    void receive() override;
+    void processDomain(int domain, ec_domain_state_t& state) override;
+    void queueDomain(int domain) override;
+    void send() override;
+    void getMasterState(ec_master_state_t& state) override;
+    bool getSlaveConfigState(size_t config, ec_slave_config_state_t& state) override;
+
+    bool sdoDownload(uint16_t position, uint16_t index, uint8_t subindex,
+                     const uint8_t* data, size_t size, uint32_t* abort_code) override;
+    bool sdoUpload(uint16_t position, uint16_t index, uint8_t subindex,
+                   uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code) override;
+
+    int createSdoRequest(size_t config, uint16_t index, uint8_t subindex, size_t size, uint32_t timeout_ms) override;
+    uint8_t* getSdoRequestData(int request) override;
+    size_t getSdoRequestDataSize(int request) const override;
+    ec_request_state_t getSdoRequestState(int request) override;
+    void readSdoRequest(int request) override;
+    void writeSdoRequest(int request) override;
+
+private:
+    bool isValidDomain(int domain) const { return domain >= 0 && static_cast<size_t>(domain) < domains.size(); }
+    bool isValidSdoRequest(int request) const {
+        return request >= 0 && static_cast<size_t>(request) < sdo_requests.size();
+    }
+
+    ec_master_t* master;
+    std::vector<ec_domain_t*> domains;
+    std::vector<ec_slave_config_t*> slave_configs;
+    std::vector<ec_sdo_request_t*> sdo_requests;    // 随主站释放
+};
+
+#endif // IGHBACKEND_H
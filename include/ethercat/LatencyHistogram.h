@@ -0,0 +1,143 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 固定桶的对数-线性直方图（单写者、多读者、无锁）
+ *
+ * 数值单位为纳秒。小于 16 的值每个值一个桶；更大的值按 2 的幂分段，
+ * 每段再线性分为 16 个子桶，相对误差不超过 1/16。超出上限的值计入最后一个桶。
+ *
+ * 写者（周期线程）只做 relaxed 的 load/store，不使用原子 RMW 指令；
+ * 读者通过 snapshot() 复制计数，不会阻塞写者。
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 4;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;   // 每个2的幂段内16个子桶
+    static constexpr unsigned MAX_EXPONENT = 33;                      // 覆盖到约 8.6 秒
+    static constexpr size_t BUCKET_COUNT =
+        SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    // 读者看到的直方图副本
+    struct Snapshot {
+        std::array<uint64_t, BUCKET_COUNT> buckets;
+        uint64_t count;
+        uint64_t sum;
+        uint64_t min;
+        uint64_t max;
+
+        Snapshot() : buckets{}, count(0), sum(0), min(0), max(0) {}
+
+        // 百分位值（返回所在桶的上界），percentile 取 0-100
+        uint64_t percentile(double percentile) const {
+            if (count == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+            if (rank == 0) rank = 1;
+            if (rank > count) rank = count;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKET_COUNT; i++) {
+                seen += buckets[i];
+                if (seen >= rank) {
+                    uint64_t upper = bucketUpperBound(i);
+                    return upper < max ? upper : max;
+                }
+            }
+            return max;
+        }
+
+        double mean() const {
+            return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+        }
+    };
+
+    LatencyHistogram() { reset(); }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // 仅由周期线程调用
+    void record(uint64_t value_ns) {
+        auto& bucket = buckets_[bucketIndex(value_ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + value_ns, std::memory_order_relaxed);
+        if (value_ns < min_.load(std::memory_order_relaxed)) {
+            min_.store(value_ns, std::memory_order_relaxed);
+        }
+        if (value_ns > max_.load(std::memory_order_relaxed)) {
+            max_.store(value_ns, std::memory_order_relaxed);
+        }
+        // count 最后发布，读者以它为准
+        count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 仅由周期线程调用（读者通过请求标志间接复位）
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(UINT64_MAX, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_release);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snap;
+        snap.count = count_.load(std::memory_order_acquire);
+        uint64_t bucket_total = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            snap.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+            bucket_total += snap.buckets[i];
+        }
+        // 复制期间写者可能继续写入，以桶计数之和为准保持百分位自洽
+        snap.count = bucket_total;
+        snap.sum = sum_.load(std::memory_order_relaxed);
+        uint64_t min = min_.load(std::memory_order_relaxed);
+        snap.min = (min == UINT64_MAX) ? 0 : min;
+        snap.max = max_.load(std::memory_order_relaxed);
+        return snap;
+    }
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        if (exponent >= MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        unsigned shift = exponent - SUB_BUCKET_BITS;
+        size_t mantissa = static_cast<size_t>((value >> shift) & (SUB_BUCKETS - 1));
+        return SUB_BUCKETS + shift * SUB_BUCKETS + mantissa;
+    }
+
+    static uint64_t bucketLowerBound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+        size_t mantissa = (index - SUB_BUCKETS) % SUB_BUCKETS;
+        return static_cast<uint64_t>(SUB_BUCKETS + mantissa) << shift;
+    }
+
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index + 1 >= BUCKET_COUNT) {
+            return UINT64_MAX;
+        }
+        return bucketLowerBound(index + 1) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+#endif // LATENCYHISTOGRAM_H
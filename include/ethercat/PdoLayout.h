@@ -0,0 +1,489 @@
+#ifndef PDOLAYOUT_H
+#define PDOLAYOUT_H
+
+#include "ethercat/FieldbusBackend.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 端子 PDO 布局的编译期描述和类型化访问
+ *
+ * 每种端子由一个描述结构给出身份、同步管理器和"每通道一个 PDO"的条目模板，
+ * PdoLayout<T> 在编译期算出各通道过程值相对通道 1 的位偏移。
+ * 运行时注册各通道的过程值条目（以及过程值之前的状态位条目），通道 1 的过程值给出
+ * 基准字节偏移，其余条目注册得到的偏移和位位置须与编译期布局一致（matchesRegistration()）。
+ * TerminalImage<T>::read<Ch>() 即"基准 + 常量"的一次加载；通道号、位位置和数据类型都在编译期检查。
+ * 每通道 1 位的端子（EL1008、EL2634）位图读写是一次字节加载 / 一次带掩码的字节写。
+ * 同一个域中的多个同类端子由 TerminalArray<T> 按通道号拼接，批量读写按端子循环。
+ *
+ * 前提是从站实际使用描述中的映射：拓扑中该从站的显式映射须与描述一致
+ * （matchesMapping()），或者不写映射而使用从站默认分配（描述即为默认分配）。
+ */
+
+// 通道 PDO 中的一个条目；gap 为填充位，否则对象索引为该通道的对象索引
+struct PdoEntryTemplate {
+    uint8_t subindex;
+    uint8_t bit_length;
+    bool gap;
+};
+
+struct SyncTemplate {
+    uint8_t index;
+    ec_direction_t dir;
+    ec_watchdog_mode_t watchdog;
+    bool channels;                  // 通道 PDO 分配在该同步管理器上
+};
+
+// ==================== 端子描述 ====================
+// 通道 n（从 1 开始）的 PDO 索引为 pdo_base + pdo_step*(n-1)，对象索引为 object_base + object_step*(n-1)
+
+// EL1008：8 路数字输入，每通道 1 位
+struct El1008 {
+    static constexpr const char* name = "EL1008";
+    static constexpr uint32_t vendor_id = 0x00000002;
+    static constexpr uint32_t product_code = 0x03f03052;
+    using value_type = bool;
+    static constexpr bool output = false;
+    static constexpr size_t channel_count = 8;
+    static constexpr uint16_t pdo_base = 0x1a00;
+    static constexpr uint16_t pdo_step = 1;
+    static constexpr uint16_t object_base = 0x6000;
+    static constexpr uint16_t object_step = 0x10;
+    static constexpr uint8_t value_subindex = 0x01;
+    static constexpr SyncTemplate syncs[] = {
+        {0, EC_DIR_INPUT, EC_WD_DISABLE, true},
+    };
+    static constexpr PdoEntryTemplate entries[] = {
+        {0x01, 1, false},           // Input
+    };
+};
+
+// EL3074：4 路模拟输入，每通道状态字 + 16 位值
+struct El3074 {
+    static constexpr const char* name = "EL3074";
+    static constexpr uint32_t vendor_id = 0x00000002;
+    static constexpr uint32_t product_code = 0x0c023052;
+    using value_type = int16_t;
+    static constexpr bool output = false;
+    static constexpr size_t channel_count = 4;
+    static constexpr uint16_t pdo_base = 0x1a00;
+    static constexpr uint16_t pdo_step = 2;
+    static constexpr uint16_t object_base = 0x6000;
+    static constexpr uint16_t object_step = 0x10;
+    static constexpr uint8_t value_subindex = 0x11;
+    static constexpr SyncTemplate syncs[] = {
+        {0, EC_DIR_OUTPUT, EC_WD_DISABLE, false},
+        {1, EC_DIR_INPUT, EC_WD_DISABLE, false},
+        {2, EC_DIR_OUTPUT, EC_WD_DISABLE, false},
+        {3, EC_DIR_INPUT, EC_WD_DISABLE, true},
+    };
+    static constexpr PdoEntryTemplate entries[] = {
+        {0x01, 1, false},           // Underrange
+        {0x02, 1, false},           // Overrange
+        {0x03, 2, false},           // Limit 1
+        {0x05, 2, false},           // Limit 2
+        {0x07, 1, false},           // Error
+        {0x00, 7, true},            // Gap
+        {0x0f, 1, false},           // TxPDO State
+        {0x10, 1, false},           // TxPDO Toggle
+        {0x11, 16, false},          // Value
+    };
+};
+
+// EL2634：4 路继电器输出，每通道 1 位
+struct El2634 {
+    static constexpr const char* name = "EL2634";
+    static constexpr uint32_t vendor_id = 0x00000002;
+    static constexpr uint32_t product_code = 0x0a4a3052;
+    using value_type = bool;
+    static constexpr bool output = true;
+    static constexpr size_t channel_count = 4;
+    static constexpr uint16_t pdo_base = 0x1600;
+    static constexpr uint16_t pdo_step = 1;
+    static constexpr uint16_t object_base = 0x7000;
+    static constexpr uint16_t object_step = 0x10;
+    static constexpr uint8_t value_subindex = 0x01;
+    static constexpr SyncTemplate syncs[] = {
+        {0, EC_DIR_OUTPUT, EC_WD_ENABLE, true},
+    };
+    static constexpr PdoEntryTemplate entries[] = {
+        {0x01, 1, false},           // Output
+    };
+};
+
+// ==================== 编译期布局 ====================
+template <typename T>
+struct PdoLayout {
+    static constexpr size_t sync_count = sizeof(T::syncs) / sizeof(T::syncs[0]);
+    static constexpr size_t entry_count = sizeof(T::entries) / sizeof(T::entries[0]);
+
+    static constexpr uint16_t pdoIndex(size_t channel) {
+        return static_cast<uint16_t>(T::pdo_base + T::pdo_step * (channel - 1));
+    }
+    static constexpr uint16_t objectIndex(size_t channel) {
+        return static_cast<uint16_t>(T::object_base + T::object_step * (channel - 1));
+    }
+
+    // 单个通道 PDO 的位长
+    static constexpr uint32_t pdoBits() {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < entry_count; i++) {
+            bits += T::entries[i].bit_length;
+        }
+        return bits;
+    }
+
+    // 过程值条目在模板中的下标，没有时为 entry_count
+    static constexpr size_t valueEntry() {
+        for (size_t i = 0; i < entry_count; i++) {
+            if (!T::entries[i].gap && T::entries[i].subindex == T::value_subindex) {
+                return i;
+            }
+        }
+        return entry_count;
+    }
+
+    static constexpr uint8_t valueBits() {
+        return valueEntry() < entry_count ? T::entries[valueEntry()].bit_length : 0;
+    }
+
+    // 条目 e 在通道 PDO 中的位偏移
+    static constexpr uint32_t entryBitOffset(size_t e) {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < e && i < entry_count; i++) {
+            bits += T::entries[i].bit_length;
+        }
+        return bits;
+    }
+
+    // 状态字：过程值之前的全部条目（EL3074 为 Underrange..TxPDO Toggle，共 16 位）
+    static constexpr uint32_t statusBits() { return entryBitOffset(valueEntry()); }
+
+    // 状态字中子索引为 subindex 的条目所占的位，没有时为 0
+    static constexpr uint32_t statusMask(uint8_t subindex) {
+        for (size_t i = 0; i < valueEntry(); i++) {
+            if (!T::entries[i].gap && T::entries[i].subindex == subindex) {
+                return ((1u << T::entries[i].bit_length) - 1) << entryBitOffset(i);
+            }
+        }
+        return 0;
+    }
+
+    static constexpr uint32_t statusShift(uint8_t subindex) {
+        for (size_t i = 0; i < valueEntry(); i++) {
+            if (!T::entries[i].gap && T::entries[i].subindex == subindex) {
+                return entryBitOffset(i);
+            }
+        }
+        return 0;
+    }
+
+    // 通道 channel 的过程值相对通道 1 过程值的位偏移（通道 PDO 在同步管理器中连续排列）
+    static constexpr uint32_t valueBitOffset(size_t channel) {
+        return static_cast<uint32_t>((channel - 1) * pdoBits());
+    }
+
+    // 每通道只有 1 位过程值且不超过 8 通道：通道 1 从字节边界开始时，该字节的
+    // bit 0..n-1 即通道 1..n，字节本身就是位图
+    static constexpr bool byteBitmap() {
+        return pdoBits() == 1 && valueBits() == 1 && T::channel_count <= 8;
+    }
+
+    static constexpr uint8_t byteMask() {
+        return static_cast<uint8_t>((1u << T::channel_count) - 1);
+    }
+};
+
+// ==================== 过程值编解码 ====================
+template <typename V>
+struct PdoValueCodec;
+
+template <>
+struct PdoValueCodec<bool> {
+    static constexpr uint8_t bit_length = 1;
+    static bool read(const uint8_t* data, unsigned int bit) { return EC_READ_BIT(data, bit) != 0; }
+    static void write(uint8_t* data, unsigned int bit, bool value) { EC_WRITE_BIT(data, bit, value); }
+};
+
+template <>
+struct PdoValueCodec<int16_t> {
+    static constexpr uint8_t bit_length = 16;
+    static int16_t read(const uint8_t* data, unsigned int) { return EC_READ_S16(data); }
+    static void write(uint8_t* data, unsigned int, int16_t value) { EC_WRITE_S16(data, value); }
+};
+
+/**
+ * @brief 一个端子在域中的过程映像
+ *
+ * 配置时由 registration() / statusRegistrations() 生成各通道过程值和状态位的注册项，
+ * 后端写入偏移和位位置；注册完成后检查一次 isAligned() 和 matchesRegistration()，
+ * 之后各通道的读写只用编译期常量偏移。只能由访问对应域数据的线程（周期线程）使用。
+ */
+template <typename T>
+class TerminalImage {
+public:
+    using Layout = PdoLayout<T>;
+    using value_type = typename T::value_type;
+    using Codec = PdoValueCodec<value_type>;
+
+    static_assert(Layout::valueEntry() < Layout::entry_count, "端子描述缺少过程值条目");
+    static_assert(Layout::valueBits() == Codec::bit_length, "过程值位长与数据类型不符");
+    static_assert(Codec::bit_length == 1 || Layout::pdoBits() % 8 == 0,
+                  "多字节过程值要求通道 PDO 按字节排列");
+    static_assert(T::channel_count <= 32, "通道位图为 32 位");
+
+    // 注册后待检查的条目
+    struct CheckedEntry {
+        uint8_t channel;
+        uint8_t subindex;
+        int32_t relative_bit;       // 相对通道 1 过程值的编译期位偏移
+        unsigned int offset;
+        unsigned int bit;
+    };
+
+    TerminalImage() : base_offset(0), base_bit(0), checked(), checked_count(0) {}
+
+    // 通道 channel 过程值的注册项；offset/bit_position 指向本对象，注册完成前对象不能移动
+    ec_pdo_entry_reg_t registration(uint16_t alias, uint16_t position, size_t channel = 1) {
+        if (channel == 1) {
+            return makeRegistration(alias, position, 1, T::value_subindex, &base_offset, &base_bit);
+        }
+        return checkedRegistration(alias, position, channel, T::value_subindex,
+                                   static_cast<int32_t>(Layout::valueBitOffset(channel)));
+    }
+
+    // 通道 channel 状态字中各条目的注册项（填充位除外），追加到 regs
+    void statusRegistrations(uint16_t alias, uint16_t position, size_t channel,
+                             std::vector<ec_pdo_entry_reg_t>& regs) {
+        for (size_t e = 0; e < Layout::valueEntry(); e++) {
+            if (T::entries[e].gap) {
+                continue;
+            }
+            int32_t relative = static_cast<int32_t>(Layout::valueBitOffset(channel)) -
+                               static_cast<int32_t>(Layout::statusBits()) +
+                               static_cast<int32_t>(Layout::entryBitOffset(e));
+            regs.push_back(checkedRegistration(alias, position, channel, T::entries[e].subindex, relative));
+        }
+    }
+
+    // 编译期位位置以通道 1 从字节边界开始为前提，注册后检查一次
+    bool isAligned() const { return base_bit == 0; }
+
+    // 已注册条目的偏移和位位置是否与编译期布局一致，不一致时 mismatch 为第一个不一致的条目
+    bool matchesRegistration(CheckedEntry& mismatch) const {
+        int64_t base = static_cast<int64_t>(base_offset) * 8 + base_bit;
+        for (size_t i = 0; i < checked_count; i++) {
+            const CheckedEntry& entry = checked[i];
+            if (static_cast<int64_t>(entry.offset) * 8 + entry.bit != base + entry.relative_bit) {
+                mismatch = entry;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    unsigned int offset() const { return base_offset; }
+
+    template <size_t Channel>
+    value_type read(const uint8_t* domain) const {
+        static_assert(Channel >= 1 && Channel <= T::channel_count, "通道超出端子范围");
+        constexpr uint32_t bit = Layout::valueBitOffset(Channel);
+        return Codec::read(domain + base_offset + bit / 8, bit % 8);
+    }
+
+    template <size_t Channel>
+    void write(uint8_t* domain, value_type value) const {
+        static_assert(T::output, "只能写输出端子");
+        static_assert(Channel >= 1 && Channel <= T::channel_count, "通道超出端子范围");
+        constexpr uint32_t bit = Layout::valueBitOffset(Channel);
+        Codec::write(domain + base_offset + bit / 8, bit % 8, value);
+    }
+
+    // 通道的状态字（过程值之前的各条目，位定义由 PdoLayout::statusMask() 给出）
+    template <size_t Channel>
+    uint16_t readStatus(const uint8_t* domain) const {
+        static_assert(Layout::statusBits() == 16, "状态字须为 16 位");
+        static_assert(Channel >= 1 && Channel <= T::channel_count, "通道超出端子范围");
+        constexpr int32_t bit = static_cast<int32_t>(Layout::valueBitOffset(Channel)) -
+                                static_cast<int32_t>(Layout::statusBits());
+        return EC_READ_U16(domain + static_cast<int32_t>(base_offset) + bit / 8);
+    }
+
+    // 全部通道的状态字，写入 status[0..channel_count)
+    void readAllStatus(const uint8_t* domain, uint16_t* status) const {
+        readAllStatus(domain, status, std::make_index_sequence<T::channel_count>());
+    }
+
+    // 全部通道的过程值，写入 values[0..channel_count)
+    void readAll(const uint8_t* domain, value_type* values) const {
+        readAll(domain, values, std::make_index_sequence<T::channel_count>());
+    }
+
+    // 位端子：bit i 对应通道 i+1
+    uint32_t readMask(const uint8_t* domain) const {
+        static_assert(Codec::bit_length == 1, "位图只适用于位端子");
+        if constexpr (Layout::byteBitmap()) {
+            return EC_READ_U8(domain + base_offset) & Layout::byteMask();
+        } else {
+            return readMask(domain, std::make_index_sequence<T::channel_count>());
+        }
+    }
+
+    // 只改写本端子各通道的位，同一字节中的其他位保持不变
+    void writeMask(uint8_t* domain, uint32_t mask) const {
+        static_assert(Codec::bit_length == 1, "位图只适用于位端子");
+        if constexpr (Layout::byteBitmap()) {
+            uint8_t* data = domain + base_offset;
+            constexpr uint8_t m = Layout::byteMask();
+            EC_WRITE_U8(data, static_cast<uint8_t>((EC_READ_U8(data) & ~m) | (mask & m)));
+        } else {
+            writeMask(domain, mask, std::make_index_sequence<T::channel_count>());
+        }
+    }
+
+    // 显式映射是否与描述一致；syncs 为 nullptr（从站默认分配）视为一致
+    static bool matchesMapping(const ec_sync_info_t* syncs) {
+        if (!syncs) {
+            return true;
+        }
+        for (const SyncTemplate& sync : T::syncs) {
+            if (!sync.channels) {
+                continue;
+            }
+            const ec_sync_info_t* found = nullptr;
+            for (const ec_sync_info_t* s = syncs; s->index != 0xff; s++) {
+                if (s->index == sync.index) {
+                    found = s;
+                    break;
+                }
+            }
+            if (!found || found->dir != sync.dir || found->n_pdos != T::channel_count) {
+                return false;
+            }
+            for (size_t ch = 1; ch <= T::channel_count; ch++) {
+                const ec_pdo_info_t& pdo = found->pdos[ch - 1];
+                if (pdo.index != Layout::pdoIndex(ch) || pdo.n_entries != Layout::entry_count) {
+                    return false;
+                }
+                for (size_t e = 0; e < Layout::entry_count; e++) {
+                    const PdoEntryTemplate& expected = T::entries[e];
+                    const ec_pdo_entry_info_t& actual = pdo.entries[e];
+                    uint16_t index = expected.gap ? 0 : Layout::objectIndex(ch);
+                    uint8_t subindex = expected.gap ? 0 : expected.subindex;
+                    if (actual.index != index || actual.subindex != subindex ||
+                        actual.bit_length != expected.bit_length) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    template <size_t... I>
+    void readAll(const uint8_t* domain, value_type* values, std::index_sequence<I...>) const {
+        ((values[I] = read<I + 1>(domain)), ...);
+    }
+
+    template <size_t... I>
+    void readAllStatus(const uint8_t* domain, uint16_t* status, std::index_sequence<I...>) const {
+        ((status[I] = readStatus<I + 1>(domain)), ...);
+    }
+
+    template <size_t... I>
+    uint32_t readMask(const uint8_t* domain, std::index_sequence<I...>) const {
+        return ((static_cast<uint32_t>(read<I + 1>(domain)) << I) | ...);
+    }
+
+    template <size_t... I>
+    void writeMask(uint8_t* domain, uint32_t mask, std::index_sequence<I...>) const {
+        (write<I + 1>(domain, ((mask >> I) & 0x01) != 0), ...);
+    }
+
+    ec_pdo_entry_reg_t makeRegistration(uint16_t alias, uint16_t position, size_t channel, uint8_t subindex,
+                                        unsigned int* offset, unsigned int* bit) const {
+        ec_pdo_entry_reg_t reg = {alias, position, T::vendor_id, T::product_code,
+                                  Layout::objectIndex(channel), subindex, offset, bit};
+        return reg;
+    }
+
+    ec_pdo_entry_reg_t checkedRegistration(uint16_t alias, uint16_t position, size_t channel, uint8_t subindex,
+                                           int32_t relative_bit) {
+        CheckedEntry& entry = checked[checked_count++];
+        entry.channel = static_cast<uint8_t>(channel);
+        entry.subindex = subindex;
+        entry.relative_bit = relative_bit;
+        entry.offset = 0;
+        entry.bit = 0;
+        return makeRegistration(alias, position, channel, subindex, &entry.offset, &entry.bit);
+    }
+
+    unsigned int base_offset;
+    unsigned int base_bit;
+    CheckedEntry checked[T::channel_count * Layout::entry_count];   // 通道 1 过程值以外的注册结果，仅用于检查
+    size_t checked_count;
+};
+
+/**
+ * @brief 一个域中同类端子的过程映像
+ *
+ * 第 k 个端子（从 0 开始）提供域通道 k*N+1..(k+1)*N，N 为 T::channel_count。
+ * 端子数由拓扑决定，配置时 resize() 一次后生成注册项，之后不再改变大小（注册项指向各元素）。
+ * 批量读写按端子循环，每个端子内部仍是编译期常量偏移，不按通道调用函数或分支。
+ */
+template <typename T>
+class TerminalArray {
+public:
+    using Image = TerminalImage<T>;
+    using value_type = typename T::value_type;
+
+    static constexpr size_t channels_per_terminal = T::channel_count;
+
+    void resize(size_t terminal_count) { terminals.assign(terminal_count, Image()); }
+    size_t size() const { return terminals.size(); }
+    size_t channelCount() const { return terminals.size() * T::channel_count; }
+
+    Image& operator[](size_t index) { return terminals[index]; }
+    const Image& operator[](size_t index) const { return terminals[index]; }
+
+    // 域通道 channel（从 1 开始）所在的端子和端子内通道号
+    static size_t terminalOf(size_t channel) { return (channel - 1) / T::channel_count; }
+    static size_t localChannel(size_t channel) { return (channel - 1) % T::channel_count + 1; }
+
+    // 全部通道的过程值，写入 values[0..channelCount())
+    void readAll(const uint8_t* domain, value_type* values) const {
+        for (size_t t = 0; t < terminals.size(); t++) {
+            terminals[t].readAll(domain, values + t * T::channel_count);
+        }
+    }
+
+    void readAllStatus(const uint8_t* domain, uint16_t* status) const {
+        for (size_t t = 0; t < terminals.size(); t++) {
+            terminals[t].readAllStatus(domain, status + t * T::channel_count);
+        }
+    }
+
+    // 位端子：bit i 对应域通道 i+1，最多 64 通道
+    uint64_t readMask(const uint8_t* domain) const {
+        uint64_t mask = 0;
+        for (size_t t = 0; t < terminals.size(); t++) {
+            mask |= static_cast<uint64_t>(terminals[t].readMask(domain)) << (t * T::channel_count);
+        }
+        return mask;
+    }
+
+    void writeMask(uint8_t* domain, uint64_t mask) const {
+        for (size_t t = 0; t < terminals.size(); t++) {
+            terminals[t].writeMask(domain, static_cast<uint32_t>(mask >> (t * T::channel_count)));
+        }
+    }
+
+private:
+    std::vector<Image> terminals;
+};
+
+#endif // PDOLAYOUT_H
@@ -0,0 +1,96 @@
+#ifndef PRESSURECALIBRATION_H
+#define PRESSURECALIBRATION_H
+
+#include "ethercat/EtherCATMaster.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * 压力通道标定文件（文本，# 之后为注释，空白分隔）：
+ *
+ *   channel 1 linear          通道 1 分段线性，随后每行一个标定点：电流(mA) 压力(bar)
+ *   4.02    0.0               电流须严格递增，至少 2 个点
+ *   12.00   49.6
+ *   19.97   100.3
+ *   channel 2 poly -0.35 6.27 -0.0011    多项式：压力 = c0 + c1·I + c2·I² + …（I 为电流 mA，低次在前）
+ *
+ * 标定点范围之外沿首末两段外推；结果不低于 PRESSURE_RANGE_MIN，与未标定的量程换算一致。
+ * 文件中没有出现的通道仍按 PRESSURE_RANGE_* / CURRENT_RANGE_* 线性换算。
+ */
+enum class CalibrationKind {
+    CALIBRATION_LINEAR,      // 分段线性
+    CALIBRATION_POLYNOMIAL   // 多项式
+};
+
+struct CalibrationPoint {
+    double current_ma;
+    double pressure_bar;
+};
+
+struct ChannelCalibration {
+    uint8_t channel;                            // 模拟输入通道号（1 起）
+    CalibrationKind kind;
+    std::vector<CalibrationPoint> points;       // 分段线性的标定点，按电流递增
+    std::vector<double> coefficients;           // 多项式系数，低次在前
+
+    double evaluate(double current_ma) const;   // 标定曲线在该电流下的压力（未限幅）
+};
+
+// 一个通道编译后的查表：下标为原始值按 uint16 重解释，覆盖全部 65536 个原始值
+struct PressureLookupTable {
+    float pressure[CALIBRATION_TABLE_SIZE];
+
+    float lookup(int16_t raw) const { return pressure[static_cast<uint16_t>(raw)]; }
+};
+
+/**
+ * @brief 编译好的一组通道查表
+ *
+ * 创建后只读，由 EtherCATMaster 以原子指针发布，周期线程和其他线程直接查表。
+ */
+class PressureCalibrationSet {
+public:
+    // 模拟输入 index+1 的查表，未标定的通道为 nullptr
+    const PressureLookupTable* table(size_t index) const {
+        return index < MAX_ANALOG_CHANNELS ? tables[index] : nullptr;
+    }
+    uint64_t getChannelMask() const { return channel_mask; }   // bit i：通道 i+1 已标定
+    const std::string& getSource() const { return source; }
+
+private:
+    friend class PressureCalibration;
+    PressureCalibrationSet();
+
+    std::vector<std::unique_ptr<PressureLookupTable>> storage;
+    const PressureLookupTable* tables[MAX_ANALOG_CHANNELS];
+    uint64_t channel_mask;
+    std::string source;
+};
+
+/**
+ * @brief 压力通道标定
+ *
+ * 从标定文件加载各通道的标定曲线，compile() 对每个通道逐个原始值求值，生成查表。
+ * 原始值到电流的换算与 convertAnalogToCurrent 相同。
+ */
+class PressureCalibration {
+public:
+    bool load(const std::string& path, std::string& error);
+    bool parse(const std::string& content, std::string& error);
+
+    std::unique_ptr<PressureCalibrationSet> compile() const;
+
+    const std::vector<ChannelCalibration>& getChannels() const { return channels; }
+    const std::string& getSource() const { return source; }
+
+private:
+    bool validate(const ChannelCalibration& calibration, size_t line, std::string& error) const;
+
+    std::vector<ChannelCalibration> channels;
+    std::string source;
+};
+
+#endif // PRESSURECALIBRATION_H
@@ -0,0 +1,227 @@
+#ifndef RAWSOCKETBACKEND_H
+#define RAWSOCKETBACKEND_H
+
+#include "ethercat/FieldbusBackend.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 纯用户态 EtherCAT 后端（AF_PACKET 原始套接字）
+ *
+ * 不依赖内核模块，直接在指定网卡上收发 EtherType 0x88A4 的帧，用于与 IgH 内核主站
+ * 对比周期延迟，也可以在测试机上通过 veth 对接软件从站运行。
+ *
+ * 支持的功能：
+ * - scanSlaves() 或 activate() 时扫描总线、分配站地址、从 SII 读取身份和同步管理器布局
+ *   （scanSlaves() 之后 activate() 沿用其结果，不再重复读取 SII）
+ * - 按 configureSlave 提供的同步管理器配置设置 SM/FMMU，CoE 从站写入 PDO 分配
+ *   （PDO 映射内容使用从站默认值）
+ * - 每个域一个 LRW 报文，附带 BRD 读取 AL 状态；未进入 OP 的从站由周期报文重复请求
+ * - CoE 快速/普通 SDO 上传和下载；周期运行后通过周期帧的非周期槽发送
+ * - 热启动：导出的数据为各从站的站地址、身份、SII 邮箱/同步管理器布局和已写入的 PDO 分配。
+ *   扫描时仍保留上次站地址（未断电）且身份一致的从站沿用缓存的布局，PDO 分配相同时不再写入；
+ *   上一次激活的结果同样用于热重配置
+ *
+ * 不支持分布式时钟、冗余和分段 SDO。需要 CAP_NET_RAW 权限。
+ */
+class RawSocketBackend : public FieldbusBackend {
+public:
+    explicit RawSocketBackend(const std::string& interface_name);
+    ~RawSocketBackend() override;
+
+    RawSocketBackend(const RawSocketBackend&) = delete;
+    RawSocketBackend& operator=(const RawSocketBackend&) = delete;
+
+    FieldbusBackendType getType() const override { return FieldbusBackendType::BACKEND_RAW_SOCKET; }
+    std::string getName() const override;
+
+    bool requestMaster(unsigned int master_index) override;
+    void releaseMaster() override;
+    bool isMasterRequested() const override { return socket_fd >= 0; }
+    bool scanSlaves(std::vector<ec_slave_info_t>& slaves) override;
+    int createDomain() override;
+    bool configureSlave(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                        const ec_sync_info_t* syncs = nullptr) override;
+    bool registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) override;
+    bool activate() override;
+    uint8_t* getDomainData(int domain) override;
+    size_t getDomainSize(int domain) const override;
+
+    void receive() override;
+    void processDomain(int domain, ec_domain_state_t& state) override;
+    void queueDomain(int domain) override;
+    void send() override;
+    void getMasterState(ec_master_state_t& state) override;
+
+    bool sdoDownload(uint16_t position, uint16_t index, uint8_t subindex,
+                     const uint8_t* data, size_t size, uint32_t* abort_code) override;
+    bool sdoUpload(uint16_t position, uint16_t index, uint8_t subindex,
+                   uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code) override;
+
+    bool exportWarmStartData(std::vector<uint8_t>& data) const override;
+    bool importWarmStartData(const std::vector<uint8_t>& data) override;
+
+private:
+    static constexpr size_t FRAME_MAX_SIZE = 1514;
+    static constexpr size_t MAX_DOMAINS = 8;
+    static constexpr size_t ACYCLIC_MAX_DATA = 512;
+    static constexpr uint8_t STATE_DATAGRAM_INDEX = 0x40;      // 周期帧中的 AL 状态 BRD
+    static constexpr uint8_t AL_CONTROL_DATAGRAM_INDEX = 0x41; // 周期帧中的 OP 请求 FPWR
+    static constexpr uint8_t ACYCLIC_DATAGRAM_INDEX = 0x42;    // 周期帧中的非周期槽
+    static constexpr int STATE_LOST_CYCLES = 10;               // 连续丢失状态报文的周期数，超过视为链路断开
+    static constexpr uint8_t WARM_START_VERSION = 1;
+
+    // 配置中的同步管理器
+    struct SyncConfig {
+        uint8_t index;
+        bool input;
+        uint32_t byte_offset;               // 在该从站同方向区域中的偏移
+        uint32_t byte_size;
+        ec_watchdog_mode_t watchdog_mode;
+        std::vector<uint16_t> pdo_indexes;
+    };
+
+    struct EntryLayout {
+        uint16_t index;
+        uint8_t subindex;
+        uint8_t bit_length;
+        uint32_t bit_offset;                // 在该从站同方向区域中的位偏移
+        bool input;
+    };
+
+    struct SlaveConfig {
+        uint16_t alias;
+        uint16_t position;
+        uint32_t vendor_id;
+        uint32_t product_code;
+        std::vector<SyncConfig> syncs;
+        std::vector<EntryLayout> entries;
+        uint32_t input_size;
+        uint32_t output_size;
+    };
+
+    // SII 中的同步管理器描述
+    struct SiiSync {
+        uint16_t start;
+        uint16_t length;
+        uint8_t control;
+        uint8_t enable;
+    };
+
+    // 写入从站的 PDO 分配（0x1C10 + SM 编号）
+    struct PdoAssignment {
+        uint8_t sync;
+        std::vector<uint16_t> pdo_indexes;
+    };
+
+    // 扫描得到的从站
+    struct BusSlave {
+        uint16_t station_address;
+        uint32_t vendor_id;
+        uint32_t product_code;
+        uint16_t mbx_rx_offset;
+        uint16_t mbx_rx_size;
+        uint16_t mbx_tx_offset;
+        uint16_t mbx_tx_size;
+        std::vector<SiiSync> sii_syncs;
+        std::vector<PdoAssignment> pdo_assignments;
+        bool retained;                      // 未断电且身份一致，沿用了热启动数据
+        uint8_t mbx_counter;
+        uint8_t next_fmmu;
+    };
+
+    struct Mapping {
+        uint16_t position;
+        size_t output_offset;
+        size_t input_offset;
+        size_t input_size;
+    };
+
+    struct Domain {
+        std::vector<Mapping> mappings;
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> rx;
+        uint32_t logical_address;
+        unsigned int expected_working_counter;
+        unsigned int rx_working_counter;
+        unsigned int working_counter;
+        ec_wc_state_t wc_state;
+        bool queued;
+        bool in_flight;
+        bool received;
+    };
+
+    // 周期运行后由非实时线程经周期帧发送的单个报文
+    enum AcyclicState { ACYCLIC_IDLE = 0, ACYCLIC_PENDING, ACYCLIC_SENT, ACYCLIC_DONE };
+    struct AcyclicSlot {
+        uint8_t command;
+        uint32_t address;
+        uint16_t length;
+        uint16_t working_counter;
+        uint8_t data[ACYCLIC_MAX_DATA];
+    };
+
+    // 帧收发
+    void beginFrame();
+    size_t appendDatagram(uint8_t command, uint8_t index, uint32_t address, const uint8_t* data, uint16_t length);
+    bool sendFrame();
+    template <typename Handler>
+    void forEachDatagram(const uint8_t* frame, size_t length, Handler handler) const;
+    int transact(uint8_t command, uint32_t address, uint8_t* data, uint16_t length, int timeout_ms = 100);
+
+    // 寄存器访问，返回 WKC，超时返回 -1
+    int fprd(uint16_t station, uint16_t reg, void* data, uint16_t length);
+    int fpwr(uint16_t station, uint16_t reg, const void* data, uint16_t length);
+    int aprd(uint16_t position, uint16_t reg, void* data, uint16_t length);
+    int apwr(uint16_t position, uint16_t reg, const void* data, uint16_t length);
+    int brd(uint16_t reg, void* data, uint16_t length);
+    int bwr(uint16_t reg, const void* data, uint16_t length);
+
+    bool scanBus();
+    bool readSii(uint16_t station, uint16_t word_address, uint32_t& value);
+    bool readSiiSyncs(BusSlave& slave);
+    const BusSlave* findWarmSlave(uint16_t position, uint16_t station_address) const;
+    bool requestState(uint16_t position, uint8_t state, int timeout_ms);
+    bool configureMailbox(uint16_t position);
+    bool configureProcessData(uint16_t position, const SlaveConfig& config);
+    bool writePdoAssignment(uint16_t position, const SyncConfig& sc);
+    bool writeFmmu(BusSlave& slave, uint32_t logical_address, uint16_t length, uint16_t physical_start, bool input);
+    bool mailboxExchange(uint16_t position, const std::vector<uint8_t>& request, std::vector<uint8_t>& response,
+                         int timeout_ms);
+    bool sdoTransfer(uint16_t position, const std::vector<uint8_t>& request, std::vector<uint8_t>& response,
+                     uint32_t* abort_code);
+    const SlaveConfig* findConfig(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code) const;
+
+    std::string interface_name;
+    int socket_fd;
+    int interface_index;
+    std::array<uint8_t, 6> mac_address;
+    std::array<uint8_t, FRAME_MAX_SIZE> tx_frame;
+    std::array<uint8_t, FRAME_MAX_SIZE> rx_frame;
+    size_t tx_length;
+    size_t last_datagram;                   // 帧中最后一个报文头的位置
+    uint8_t setup_index;
+
+    std::vector<SlaveConfig> configs;
+    std::vector<BusSlave> bus_slaves;
+    std::vector<Domain> domains;
+    std::vector<uint16_t> op_stations;      // 需要进入 OP 的从站站地址
+    bool activated;
+    bool bus_scanned;                       // bus_slaves 来自 scanSlaves()，activate() 直接使用
+    std::vector<BusSlave> warm_slaves;      // 导入的或上一次激活得到的从站（按位置），releaseMaster() 后保留
+
+    // 周期线程状态
+    std::atomic<bool> cyclic_running;       // 周期线程已开始 send()，此后非实时请求走非周期槽
+    uint64_t cyclic_count;
+    int state_lost_cycles;
+    ec_master_state_t master_state;
+
+    std::mutex acyclic_mutex;               // 串行化非实时线程的请求
+    std::atomic<int> acyclic_state;
+    AcyclicSlot acyclic_slot;
+};
+
+#endif // RAWSOCKETBACKEND_H
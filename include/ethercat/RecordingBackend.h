@@ -0,0 +1,142 @@
+#ifndef RECORDINGBACKEND_H
+#define RECORDINGBACKEND_H
+
+#include "ethercat/FieldbusBackend.h"
+#include "ethercat/LockFreeQueue.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/**
+ * 过程数据记录文件格式（小端）
+ *
+ * 文件头：
+ *   "ECPI"                   4 字节魔数
+ *   u16 version              PROCESS_IMAGE_RECORD_VERSION
+ *   u16 domain_count         不超过 PROCESS_IMAGE_MAX_DOMAINS
+ *   每个域：u32 size, u16 reg_count, reg_count 个注册项
+ *     注册项：u16 alias, u16 position, u32 vendor_id, u32 product_code,
+ *            u16 index, u8 subindex, u32 offset, u8 bit_position
+ *
+ * 每周期一条记录（两次 receive() 之间）：
+ *   u8 mask                  bit0-6 对应已处理的域，bit7 表示包含主站状态
+ *   每个已处理的域（按域号升序）：u16 working_counter, u8 wc_state, size 字节域数据
+ *   主站状态：u16 slaves_responding, u8 al_states, u8 link_up
+ */
+constexpr char PROCESS_IMAGE_RECORD_MAGIC[4] = {'E', 'C', 'P', 'I'};
+constexpr uint16_t PROCESS_IMAGE_RECORD_VERSION = 1;
+constexpr size_t PROCESS_IMAGE_MAX_DOMAINS = 7;
+constexpr uint8_t PROCESS_IMAGE_MASTER_STATE_FLAG = 0x80;
+constexpr size_t PROCESS_IMAGE_REG_SIZE = 20;
+
+/**
+ * @brief 过程数据记录后端
+ *
+ * 包装任意后端，原样转发所有调用，同时把每周期处理过的域数据、WKC 和主站状态
+ * 写入记录文件，供 ReplayBackend 回放。周期线程只写预分配的缓冲块，写文件由
+ * 独立的写线程完成；写线程跟不上时丢弃整条周期记录并计数。
+ */
+class RecordingBackend : public FieldbusBackend {
+public:
+    RecordingBackend(std::unique_ptr<FieldbusBackend> inner, const std::string& path);
+    ~RecordingBackend() override;
+
+    RecordingBackend(const RecordingBackend&) = delete;
+    RecordingBackend& operator=(const RecordingBackend&) = delete;
+
+    FieldbusBackendType getType() const override { return inner->getType(); }
+    std::string getName() const override;
+
+    bool requestMaster(unsigned int master_index) override;
+    void releaseMaster() override;
+    bool isMasterRequested() const override { return inner->isMasterRequested(); }
+    bool scanSlaves(std::vector<ec_slave_info_t>& slaves) override { return inner->scanSlaves(slaves); }
+    int createDomain() override;
+    bool configureSlave(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                        const ec_sync_info_t* syncs = nullptr) override;
+    bool registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) override;
+    bool activate() override;
+    uint8_t* getDomainData(int domain) override { return inner->getDomainData(domain); }
+    size_t getDomainSize(int domain) const override { return inner->getDomainSize(domain); }
+
+    void receive() override;
+    void processDomain(int domain, ec_domain_state_t& state) override;
+    void queueDomain(int domain) override { inner->queueDomain(domain); }
+    void send() override { inner->send(); }
+    void getMasterState(ec_master_state_t& state) override;
+    // 从站状态不写入记录，回放时不可用
+    bool getSlaveConfigState(size_t config, ec_slave_config_state_t& state) override {
+        return inner->getSlaveConfigState(config, state);
+    }
+
+    bool sdoDownload(uint16_t position, uint16_t index, uint8_t subindex,
+                     const uint8_t* data, size_t size, uint32_t* abort_code) override;
+    bool sdoUpload(uint16_t position, uint16_t index, uint8_t subindex,
+                   uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code) override;
+    // SDO 请求不写入记录，回放时不可用
+    int createSdoRequest(size_t config, uint16_t index, uint8_t subindex, size_t size, uint32_t timeout_ms) override {
+        return inner->createSdoRequest(config, index, subindex, size, timeout_ms);
+    }
+    uint8_t* getSdoRequestData(int request) override { return inner->getSdoRequestData(request); }
+    size_t getSdoRequestDataSize(int request) const override { return inner->getSdoRequestDataSize(request); }
+    ec_request_state_t getSdoRequestState(int request) override { return inner->getSdoRequestState(request); }
+    void readSdoRequest(int request) override { inner->readSdoRequest(request); }
+    void writeSdoRequest(int request) override { inner->writeSdoRequest(request); }
+    bool exportWarmStartData(std::vector<uint8_t>& data) const override { return inner->exportWarmStartData(data); }
+    bool importWarmStartData(const std::vector<uint8_t>& data) override { return inner->importWarmStartData(data); }
+
+    // 记录文件只有一个文件头，重新激活会覆盖已记录的内容
+    bool supportsReconfiguration() const override { return false; }
+
+    uint64_t getRecordedCycles() const { return recorded_cycles.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCycles() const { return dropped_cycles.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t CHUNK_COUNT = 16;
+
+    struct Chunk {
+        size_t used;
+        uint8_t data[CHUNK_SIZE];
+    };
+
+    // 本周期暂存的域数据（仅周期线程）
+    struct DomainRecord {
+        std::vector<ec_pdo_entry_reg_t> regs;   // 注册时的条目及得到的偏移
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> bit_positions;
+        std::vector<uint8_t> image;
+        ec_domain_state_t state;
+        bool processed;
+    };
+
+    void commitRecord();                        // 周期线程：把暂存的记录写入当前缓冲块
+    bool writeHeader();
+    void writerThreadFunc();
+    void stopWriter();
+
+    std::unique_ptr<FieldbusBackend> inner;
+    std::string path;
+    std::FILE* file;
+
+    std::vector<DomainRecord> domain_records;
+    ec_master_state_t staged_master_state;
+    bool master_state_staged;
+    bool record_open;                           // 已 receive()，记录待提交
+    size_t max_record_size;
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    Chunk* current_chunk;                       // 周期线程正在写入的块，nullptr 表示无空闲块
+    LockFreeQueue<Chunk*, CHUNK_COUNT> free_chunks;   // 写线程 -> 周期线程
+    LockFreeQueue<Chunk*, CHUNK_COUNT> full_chunks;   // 周期线程 -> 写线程
+    std::thread writer_thread;
+    std::atomic<bool> writer_running;
+    std::atomic<bool> write_failed;
+
+    std::atomic<uint64_t> recorded_cycles;
+    std::atomic<uint64_t> dropped_cycles;
+};
+
+#endif // RECORDINGBACKEND_H
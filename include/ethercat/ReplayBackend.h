@@ -0,0 +1,105 @@
+#ifndef REPLAYBACKEND_H
+#define REPLAYBACKEND_H
+
+#include "ethercat/RecordingBackend.h"
+
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief 过程数据回放后端
+ *
+ * 按周期回放 RecordingBackend 写出的记录文件：每次 receive() 取下一条记录，
+ * processDomain() 把记录的域数据和 WKC 原样交给主站，getMasterState() 返回记录的主站状态。
+ * 输出只写入本地域数据，不发往任何设备。
+ *
+ * 回放按周期而不是按时间推进，回放速度 = 记录时周期 / start() 的周期；
+ * 各域分频需与记录时一致，本周期没有记录的域保持上次的数据和状态。
+ * 记录播放完后 WKC 归零、链路断开，isReplayFinished() 返回 true。
+ */
+class ReplayBackend : public FieldbusBackend {
+public:
+    explicit ReplayBackend(const std::string& path);
+    ~ReplayBackend() override;
+
+    ReplayBackend(const ReplayBackend&) = delete;
+    ReplayBackend& operator=(const ReplayBackend&) = delete;
+
+    FieldbusBackendType getType() const override { return FieldbusBackendType::BACKEND_REPLAY; }
+    std::string getName() const override;
+
+    bool requestMaster(unsigned int master_index) override;
+    void releaseMaster() override;
+    bool isMasterRequested() const override { return mapped != nullptr; }
+    int createDomain() override;
+    bool configureSlave(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                        const ec_sync_info_t* syncs = nullptr) override;
+    bool registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) override;
+    bool activate() override;
+    uint8_t* getDomainData(int domain) override;
+    size_t getDomainSize(int domain) const override;
+
+    void receive() override;
+    void processDomain(int domain, ec_domain_state_t& state) override;
+    void queueDomain(int) override {}
+    void send() override {}
+    void getMasterState(ec_master_state_t& state) override;
+
+    bool sdoDownload(uint16_t position, uint16_t index, uint8_t subindex,
+                     const uint8_t* data, size_t size, uint32_t* abort_code) override;
+    bool sdoUpload(uint16_t position, uint16_t index, uint8_t subindex,
+                   uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code) override;
+
+    bool isReplayFinished() const override { return finished.load(std::memory_order_acquire); }
+    bool supportsReconfiguration() const override { return false; }
+    uint64_t getReplayedCycles() const { return replayed_cycles.load(std::memory_order_relaxed); }
+
+private:
+    struct RecordedEntry {
+        uint16_t alias;
+        uint16_t position;
+        uint32_t vendor_id;
+        uint32_t product_code;
+        uint16_t index;
+        uint8_t subindex;
+        uint32_t offset;
+        uint8_t bit_position;
+    };
+
+    // 主站配置从站时给出的 PDO 条目位宽
+    struct EntryWidth {
+        uint16_t alias;
+        uint16_t position;
+        uint16_t index;
+        uint8_t subindex;
+        uint8_t bit_length;
+    };
+
+    struct Domain {
+        std::vector<RecordedEntry> entries;
+        std::vector<uint8_t> data;
+        ec_domain_state_t state;            // 最近一次回放的状态
+        const uint8_t* pending;             // 当前记录中的域数据，nullptr 表示本周期没有
+        ec_domain_state_t pending_state;
+    };
+
+    bool parseHeader();
+    size_t entryBitLength(const ec_pdo_entry_reg_t& reg) const;
+
+    std::string path;
+    const uint8_t* mapped;
+    size_t mapped_size;
+    size_t records_offset;                  // 第一条周期记录的位置
+    size_t cursor;
+
+    std::vector<Domain> domains;
+    std::vector<EntryWidth> entry_widths;
+    size_t created_domains;
+    ec_master_state_t master_state;
+
+    std::atomic<bool> finished;
+    bool corrupt;
+    std::atomic<uint64_t> replayed_cycles;
+};
+
+#endif // REPLAYBACKEND_H
@@ -0,0 +1,84 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief 单写者顺序锁，用于发布固定大小的只读快照
+ *
+ * 写者（周期线程）从不等待；读者在写入进行中或被覆盖时重试。
+ * 数据按 64 位字保存在原子变量中，避免读写并发时的未定义行为。
+ * T 必须可平凡拷贝，且不应过大（每次读取都会完整复制）。
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock<T> 要求 T 可平凡拷贝");
+
+public:
+    SeqLock() : sequence_(0) {
+        T initial{};
+        store(initial);
+        sequence_.store(0, std::memory_order_relaxed);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // 仅由唯一写者调用
+    void store(const T& value) {
+        uint64_t words[WORD_COUNT] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint32_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);   // 奇数：写入进行中
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            data_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // 读取一次；写入冲突时返回 false
+    bool tryLoad(T& out) const {
+        uint32_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1u) {
+            return false;
+        }
+        uint64_t words[WORD_COUNT];
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            words[i] = data_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    // 重试直到得到一致的副本（写者每周期只写一次，重试次数极少）
+    T load() const {
+        T value;
+        while (!tryLoad(value)) {
+        }
+        return value;
+    }
+
+    // 已发布的版本数（每次 store 加一）
+    uint32_t version() const {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence_;
+    std::array<std::atomic<uint64_t>, WORD_COUNT> data_;
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,115 @@
+#ifndef SIMULATEDBUS_H
+#define SIMULATEDBUS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 模拟 EtherCAT 总线（ecrt_sim 的后端）
+ *
+ * 默认拓扑与实际设备相同：EK1100、EL1008、EL3074、EL2634、EL6001、EL6751，
+ * 每个从站按出厂默认 PDO 分配保存输入/输出映像，ecrt_slave_config_pdos 可覆盖。
+ * 主站激活后从站按周期数依次进入 PREOP/SAFEOP/OP（掉线后重新上线的从站从上线起重新计数），
+ * 域的 WKC 按 IgH 规则计算（读 +1，写 +2，仅统计响应且状态允许的从站）。
+ *
+ * 输入注入和故障注入可在任意线程调用；每周期回调在周期线程中执行（写出输出之后、
+ * 采样输入之前），用于驱动对象模型。
+ *
+ * EL3074 按 4-20mA 量程模拟状态位：每周期由数值得出 Underrange (< 4mA)、
+ * Overrange（满量程）和 Error（断线，< 3.6mA），并翻转 TxPDO Toggle。
+ * 限值 1/2 按对象字典 0x80n0 中的设置（:07/:08 启用，:13/:14 限值）比较，可经 SDO 修改。
+ * SDO 请求（ecrt_sdo_request_*）发起后第 3 个周期完成。
+ */
+class SimulatedBus {
+public:
+    // 从站的一个 PDO 条目（位偏移相对于该从站的输入或输出映像）
+    struct PdoEntry {
+        uint16_t index;
+        uint8_t subindex;
+        uint8_t bit_length;
+        uint32_t bit_offset;
+        bool input;
+    };
+
+    // 模拟从站
+    struct Slave {
+        uint16_t position;
+        uint32_t vendor_id;
+        uint32_t product_code;
+        std::string name;
+        bool responding;
+        uint8_t al_state;                   // EC_AL_STATE_*
+        std::vector<PdoEntry> entries;
+        std::vector<uint8_t> inputs;        // 从站 -> 主站
+        std::vector<uint8_t> outputs;       // 主站 -> 从站
+        bool has_mailbox;                   // 支持 CoE（SDO 访问）
+        std::map<uint32_t, std::vector<uint8_t>> sdo;   // 对象字典，键为 index << 8 | subindex
+    };
+
+    // 每周期回调：输出已写到从站，输入尚未采样
+    using CycleCallback = std::function<void(SimulatedBus& bus)>;
+
+    static SimulatedBus& instance();
+
+    void reset();                                       // 恢复默认拓扑，清空输入/输出和回调
+
+    // 输入注入 / 输出读取（按对象字典索引）
+    bool setInputEntry(uint16_t position, uint16_t index, uint8_t subindex, uint32_t value);
+    bool getInputEntry(uint16_t position, uint16_t index, uint8_t subindex, uint32_t& value) const;
+    bool getOutputEntry(uint16_t position, uint16_t index, uint8_t subindex, uint32_t& value) const;
+
+    // 对象字典（SDO）
+    bool setSdoEntry(uint16_t position, uint16_t index, uint8_t subindex, const std::vector<uint8_t>& value);
+    bool getSdoEntry(uint16_t position, uint16_t index, uint8_t subindex, std::vector<uint8_t>& value) const;
+
+    // 默认拓扑的便捷接口
+    void setAnalogRaw(size_t channel, int16_t raw);     // EL3074 通道 0-3 的 Value
+    int16_t getAnalogRaw(size_t channel) const;
+    void setDigitalInputs(uint8_t bits);                // EL1008，bit i 对应通道 i+1
+    uint8_t getRelayOutputs() const;                    // EL2634，bit i 对应通道 i+1
+
+    // 故障注入
+    void setSlaveResponding(uint16_t position, bool responding);
+    void freezeAnalogSample(size_t channel, bool frozen);   // EL3074 通道 0-3 停止产生新采样（Toggle 不再翻转）
+    void setLinkUp(bool up);
+    bool isLinkUp() const;
+
+    void setCycleCallback(CycleCallback callback);
+    uint64_t getCycleCount() const;                     // ecrt_master_send 调用次数
+
+    // 以下由 ecrt_sim 调用（持有 mutex() 时）
+    std::mutex& mutex() const { return mutex_; }
+    std::vector<Slave>& slaves() { return slaves_; }
+    Slave* findSlave(uint16_t position);
+    const PdoEntry* findEntry(const Slave& slave, uint16_t index, uint8_t subindex) const;
+    void runCycleCallback();                            // 不持有 mutex() 时调用
+    void countCycle() { cycle_count_++; }
+    void sampleAnalogLocked();                          // 每周期更新 EL3074 状态位和 TxPDO Toggle
+    static uint32_t sdoValueLocked(const Slave& slave, uint16_t index, uint8_t subindex);  // 小端整数，不存在时为 0
+    bool linkUpLocked() const { return link_up_; }
+
+    static uint32_t readBits(const std::vector<uint8_t>& image, uint32_t bit_offset, uint8_t bit_length);
+    static void writeBits(std::vector<uint8_t>& image, uint32_t bit_offset, uint8_t bit_length, uint32_t value);
+    static void layoutImages(Slave& slave);             // 按条目位偏移重新分配映像大小
+
+private:
+    SimulatedBus();
+    SimulatedBus(const SimulatedBus&) = delete;
+    SimulatedBus& operator=(const SimulatedBus&) = delete;
+
+    void buildDefaultTopology();
+
+    mutable std::mutex mutex_;
+    std::vector<Slave> slaves_;
+    bool link_up_;
+    uint64_t cycle_count_;
+    uint8_t analog_frozen_;                             // bit i：EL3074 通道 i 停止采样
+    CycleCallback cycle_callback_;
+};
+
+#endif // SIMULATEDBUS_H
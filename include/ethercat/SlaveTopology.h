@@ -0,0 +1,211 @@
+#ifndef SLAVETOPOLOGY_H
+#define SLAVETOPOLOGY_H
+
+#include "ethercat/FieldbusBackend.h"
+#include "ethercat/PdoLayout.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 拓扑描述文件（TwinCAT ENI 的子集，数值可写十进制、#x 或 0x 十六进制）：
+ *
+ *   <EtherCATConfig><Config>
+ *     <Slave Optional="true">              Optional：配置失败只警告（默认 false）
+ *       <Info>
+ *         <Name>EL3074</Name>
+ *         <VendorId>#x2</VendorId>
+ *         <ProductCode>#x0c023052</ProductCode>
+ *         <Alias>0</Alias>                 可选，默认 0
+ *         <Position>2</Position>           可选，默认为在文件中的序号
+ *       </Info>
+ *       <ProcessData>                      可选，省略时使用从站默认 PDO 分配
+ *         <Sm Index="0" Dir="Output" Watchdog="false"/>   显式的同步管理器（可不带 PDO）
+ *         <TxPdo Sm="3">                   TxPdo 为输入，RxPdo 为输出
+ *           <Index>#x1a00</Index>
+ *           <Entry><Index>#x6000</Index><SubIndex>#x11</SubIndex><BitLen>16</BitLen></Entry>
+ *         </TxPdo>
+ *       </ProcessData>
+ *     </Slave>
+ *     <ProcessImage>                       主站使用的过程数据
+ *       <Variable Domain="analog_in" Channel="1" Position="2" Index="#x6000" SubIndex="#x11"/>
+ *     </ProcessImage>
+ *   </Config></EtherCATConfig>
+ *
+ * 二进制缓存（小端）：
+ *   "ECTP"                    4 字节魔数
+ *   u16 version               SLAVE_TOPOLOGY_CACHE_VERSION
+ *   u16 reserved
+ *   u64 source_size, i64 source_mtime_ns     源文件大小和修改时间，不一致即失效
+ *   u32 slave_count, sync_count, pdo_count, entry_count, binding_count, string_bytes
+ *   从站：u16 alias, u16 position, u32 vendor_id, u32 product_code, u8 optional,
+ *         u32 first_sync, u32 sync_count, u32 name_offset, u16 name_length
+ *   同步管理器：u8 index, u8 dir, u8 watchdog, u32 first_pdo, u32 pdo_count
+ *   PDO：u16 index, u32 first_entry, u32 entry_count
+ *   条目：u16 index, u8 subindex, u8 bit_length
+ *   绑定：u8 domain, u8 channel, u32 slave, u16 index, u8 subindex
+ *   名称字符串池
+ */
+constexpr char SLAVE_TOPOLOGY_CACHE_MAGIC[4] = {'E', 'C', 'T', 'P'};
+constexpr uint16_t SLAVE_TOPOLOGY_CACHE_VERSION = 1;
+
+// ProcessImage 中 Domain 的取值，顺序与 ProcessDomainId 一致
+constexpr size_t TOPOLOGY_DOMAIN_COUNT = 3;
+constexpr const char* TOPOLOGY_DOMAIN_NAMES[TOPOLOGY_DOMAIN_COUNT] = {"analog_in", "digital_in", "relay_out"};
+
+struct TopologySlave {
+    std::string name;
+    uint16_t alias;
+    uint16_t position;
+    uint32_t vendor_id;
+    uint32_t product_code;
+    bool optional;                  // 配置失败时只警告（非关键从站）
+    uint32_t first_sync;            // 同步管理器表中的起始下标
+    uint32_t sync_count;            // 0 表示使用从站默认 PDO 分配
+};
+
+// 主站过程数据与 PDO 条目的绑定
+struct TopologyBinding {
+    uint8_t domain;                 // TOPOLOGY_DOMAIN_NAMES 的下标
+    uint8_t channel;                // 从 1 开始
+    uint32_t slave;                 // getSlaves() 的下标
+    uint16_t index;
+    uint8_t subindex;
+};
+
+// 总线扫描结果与拓扑比对，每个位置一项
+enum class SlaveCheckResult {
+    SLAVE_OK,
+    SLAVE_MISSING,                  // 拓扑中有，总线上没有
+    SLAVE_MISMATCH,                 // 该位置上的从站身份不符
+    SLAVE_UNEXPECTED                // 总线上有，拓扑中没有
+};
+
+struct SlaveCheckEntry {
+    uint16_t position;              // 总线上的位置（别名寻址已换算）；MISSING 时为拓扑中的位置
+    SlaveCheckResult result;
+    int expected;                   // getSlaves() 的下标，UNEXPECTED 时为 -1
+    uint32_t vendor_id;             // 总线上的实际身份，MISSING 时为 0
+    uint32_t product_code;
+    std::string name;               // 总线报告的名称（可能为空）
+};
+
+struct TopologyCheck {
+    bool scanned;                   // 后端支持扫描且扫描成功
+    bool verified;                  // 必需从站都在位且身份一致
+    unsigned int bus_slave_count;   // 总线上响应扫描的从站数
+    std::vector<SlaveCheckEntry> entries;
+
+    TopologyCheck()
+        : scanned(false)
+        , verified(false)
+        , bus_slave_count(0) {
+    }
+
+    // 某个拓扑从站的比对结果，不在表中时返回 nullptr
+    const SlaveCheckEntry* find(size_t slave_index) const;
+};
+
+/**
+ * @brief 从站拓扑和 PDO 映射
+ *
+ * 从拓扑描述文件加载，首次解析后写入二进制缓存，之后源文件未变化时直接读缓存。
+ * 同步管理器/PDO/条目保存在连续数组中，getSyncs() 返回可直接交给 configureSlave() 的表。
+ * 只能移动不能复制（表内指针指向自身的数组）。
+ */
+class SlaveTopology {
+public:
+    SlaveTopology();
+    SlaveTopology(SlaveTopology&&) = default;
+    SlaveTopology& operator=(SlaveTopology&&) = default;
+    SlaveTopology(const SlaveTopology&) = delete;
+    SlaveTopology& operator=(const SlaveTopology&) = delete;
+
+    // 试验台的默认拓扑：EK1100, EL1008, EL3074, EL2634, EL6001, EL6751（位置 0-5）
+    static SlaveTopology createDefault();
+
+    // cache_path 非空时优先读取有效缓存，否则解析 XML 并写入缓存（写缓存失败不影响加载）
+    bool load(const std::string& xml_path, const std::string& cache_path, std::string& error);
+    bool loadXml(const std::string& xml_path, std::string& error);
+    bool saveCache(const std::string& cache_path, std::string& error) const;
+
+    const std::vector<TopologySlave>& getSlaves() const { return slaves; }
+    const std::vector<TopologyBinding>& getBindings() const { return bindings; }
+    // 以 0xff 结尾的同步管理器表，从站使用默认分配时为 nullptr
+    const ec_sync_info_t* getSyncs(const TopologySlave& slave) const;
+    const TopologySlave* findSlave(uint16_t alias, uint16_t position) const;
+    // 写入从站的配置（身份、同步管理器和 PDO 分配/映射）的指纹，不含名称和过程数据绑定
+    uint64_t fingerprint() const;
+
+    // 与扫描到的从站（按位置排列，可能有空缺）逐个位置比对
+    TopologyCheck check(const std::vector<ec_slave_info_t>& bus) const;
+
+    const std::string& getSource() const { return source; }     // 来源描述（文件路径或"内置"）
+    bool isFromCache() const { return from_cache; }
+
+private:
+    struct SyncRecord {
+        uint8_t index;
+        uint8_t dir;
+        uint8_t watchdog;
+        uint32_t first_pdo;
+        uint32_t pdo_count;
+    };
+
+    struct PdoRecord {
+        uint16_t index;
+        uint32_t first_entry;
+        uint32_t entry_count;
+    };
+
+    // 按顺序构建：从站 → 同步管理器 → PDO → 条目
+    void addSlave(const std::string& name, uint16_t alias, uint16_t position,
+                  uint32_t vendor_id, uint32_t product_code, bool optional);
+    void addSync(uint8_t index, ec_direction_t dir, ec_watchdog_mode_t watchdog);
+    void addPdo(uint16_t index);
+    void addEntry(uint16_t index, uint8_t subindex, uint8_t bit_length);
+    template <typename T>
+    void addTerminal(uint16_t alias, uint16_t position, bool optional);  // 按端子描述添加从站和映射
+    void addBinding(uint8_t domain, uint8_t channel, uint32_t slave, uint16_t index, uint8_t subindex);
+    bool parseXml(const std::string& content, std::string& error);
+    bool validate(std::string& error) const;
+    void link();                    // 由记录生成 ecrt 描述表
+    bool loadCache(const std::string& cache_path, uint64_t source_size, int64_t source_mtime_ns);
+
+    std::vector<TopologySlave> slaves;
+    std::vector<SyncRecord> sync_records;
+    std::vector<PdoRecord> pdo_records;
+    std::vector<ec_pdo_entry_info_t> entries;
+    std::vector<TopologyBinding> bindings;
+
+    // link() 生成，每个从站的同步管理器后跟一个结束项
+    std::vector<ec_pdo_info_t> pdo_table;
+    std::vector<ec_sync_info_t> sync_table;
+    std::vector<uint32_t> sync_table_offset;
+
+    std::string source;
+    bool from_cache;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+};
+
+template <typename T>
+void SlaveTopology::addTerminal(uint16_t alias, uint16_t position, bool optional) {
+    using Layout = PdoLayout<T>;
+    addSlave(T::name, alias, position, T::vendor_id, T::product_code, optional);
+    for (const SyncTemplate& sync : T::syncs) {
+        addSync(sync.index, sync.dir, sync.watchdog);
+        if (!sync.channels) {
+            continue;
+        }
+        for (size_t ch = 1; ch <= T::channel_count; ch++) {
+            addPdo(Layout::pdoIndex(ch));
+            for (const PdoEntryTemplate& entry : T::entries) {
+                addEntry(entry.gap ? 0 : Layout::objectIndex(ch), entry.gap ? 0 : entry.subindex, entry.bit_length);
+            }
+        }
+    }
+}
+
+#endif // SLAVETOPOLOGY_H
@@ -0,0 +1,202 @@
+#ifndef ECRT_SIM_H
+#define ECRT_SIM_H
+
+/**
+ * @brief 进程内模拟的 ecrt 接口
+ *
+ * 在没有 IgH EtherCAT Master 的环境（开发机、CI、基准测试）中替代 <ecrt.h>。
+ * 类型名、函数签名和读写宏与 IgH 保持一致（只包含本项目用到的子集），
+ * EtherCATMaster 的代码无需任何条件编译即可在模拟总线上运行。
+ * 模拟总线的拓扑、输入注入和故障注入见 SimulatedBus.h。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define EC_END ~0U
+#define EC_MAX_STRING_LENGTH 64
+#define EC_MAX_PORTS 4
+
+typedef struct ec_master ec_master_t;
+typedef struct ec_domain ec_domain_t;
+typedef struct ec_slave_config ec_slave_config_t;
+typedef struct ec_sdo_request ec_sdo_request_t;
+
+typedef enum {
+    EC_DIR_INVALID,
+    EC_DIR_OUTPUT,
+    EC_DIR_INPUT,
+    EC_DIR_COUNT
+} ec_direction_t;
+
+typedef enum {
+    EC_WD_DEFAULT,
+    EC_WD_ENABLE,
+    EC_WD_DISABLE
+} ec_watchdog_mode_t;
+
+typedef enum {
+    EC_WC_ZERO = 0,
+    EC_WC_INCOMPLETE,
+    EC_WC_COMPLETE
+} ec_wc_state_t;
+
+typedef enum {
+    EC_AL_STATE_INIT = 1,
+    EC_AL_STATE_PREOP = 2,
+    EC_AL_STATE_SAFEOP = 4,
+    EC_AL_STATE_OP = 8
+} ec_al_state_t;
+
+typedef enum {
+    EC_REQUEST_UNUSED,
+    EC_REQUEST_BUSY,
+    EC_REQUEST_SUCCESS,
+    EC_REQUEST_ERROR
+} ec_request_state_t;
+
+typedef struct {
+    unsigned int slaves_responding;
+    unsigned int al_states : 4;
+    unsigned int link_up : 1;
+} ec_master_state_t;
+
+typedef struct {
+    unsigned int working_counter;
+    ec_wc_state_t wc_state;
+    unsigned int redundancy_active;
+} ec_domain_state_t;
+
+typedef struct {
+    unsigned int online : 1;
+    unsigned int operational : 1;
+    unsigned int al_state : 4;
+} ec_slave_config_state_t;
+
+typedef struct {
+    unsigned int slave_count;
+    unsigned int link_up : 1;
+    uint8_t scan_busy;
+    uint64_t app_time;
+} ec_master_info_t;
+
+typedef struct {
+    uint16_t position;
+    uint32_t vendor_id;
+    uint32_t product_code;
+    uint32_t revision_number;
+    uint32_t serial_number;
+    uint16_t alias;
+    int16_t current_on_ebus;
+    struct {
+        int desc;
+        uint32_t link_up;
+        uint32_t loop_closed;
+        uint32_t signal_detected;
+        uint16_t next_slave;
+        uint32_t delay_to_next_dc;
+    } ports[EC_MAX_PORTS];
+    uint8_t al_state;
+    uint8_t error_flag;
+    uint8_t sync_count;
+    uint16_t sdo_count;
+    char name[EC_MAX_STRING_LENGTH];
+} ec_slave_info_t;
+
+typedef struct {
+    uint16_t index;
+    uint8_t subindex;
+    uint8_t bit_length;
+} ec_pdo_entry_info_t;
+
+typedef struct {
+    uint16_t index;
+    unsigned int n_entries;
+    ec_pdo_entry_info_t *entries;
+} ec_pdo_info_t;
+
+typedef struct {
+    uint8_t index;
+    ec_direction_t dir;
+    unsigned int n_pdos;
+    ec_pdo_info_t *pdos;
+    ec_watchdog_mode_t watchdog_mode;
+} ec_sync_info_t;
+
+typedef struct {
+    uint16_t alias;
+    uint16_t position;
+    uint32_t vendor_id;
+    uint32_t product_code;
+    uint16_t index;
+    uint8_t subindex;
+    unsigned int *offset;
+    unsigned int *bit_position;
+} ec_pdo_entry_reg_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ec_master_t *ecrt_request_master(unsigned int master_index);
+void ecrt_release_master(ec_master_t *master);
+int ecrt_master(ec_master_t *master, ec_master_info_t *master_info);
+int ecrt_master_get_slave(ec_master_t *master, uint16_t slave_position, ec_slave_info_t *slave_info);
+ec_domain_t *ecrt_master_create_domain(ec_master_t *master);
+ec_slave_config_t *ecrt_master_slave_config(ec_master_t *master, uint16_t alias, uint16_t position,
+                                            uint32_t vendor_id, uint32_t product_code);
+int ecrt_master_activate(ec_master_t *master);
+void ecrt_master_deactivate(ec_master_t *master);
+void ecrt_master_send(ec_master_t *master);
+void ecrt_master_receive(ec_master_t *master);
+void ecrt_master_state(const ec_master_t *master, ec_master_state_t *state);
+int ecrt_master_sdo_download(ec_master_t *master, uint16_t slave_position, uint16_t index, uint8_t subindex,
+                             const uint8_t *data, size_t data_size, uint32_t *abort_code);
+int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position, uint16_t index, uint8_t subindex,
+                           uint8_t *target, size_t target_size, size_t *result_size, uint32_t *abort_code);
+
+int ecrt_slave_config_pdos(ec_slave_config_t *sc, unsigned int n_syncs, const ec_sync_info_t syncs[]);
+void ecrt_slave_config_state(const ec_slave_config_t *sc, ec_slave_config_state_t *state);
+ec_sdo_request_t *ecrt_slave_config_create_sdo_request(ec_slave_config_t *sc, uint16_t index, uint8_t subindex,
+                                                       size_t size);
+
+void ecrt_sdo_request_timeout(ec_sdo_request_t *req, uint32_t timeout);
+uint8_t *ecrt_sdo_request_data(ec_sdo_request_t *req);
+size_t ecrt_sdo_request_data_size(const ec_sdo_request_t *req);
+ec_request_state_t ecrt_sdo_request_state(ec_sdo_request_t *req);
+void ecrt_sdo_request_write(ec_sdo_request_t *req);
+void ecrt_sdo_request_read(ec_sdo_request_t *req);
+
+int ecrt_domain_reg_pdo_entry_list(ec_domain_t *domain, const ec_pdo_entry_reg_t *pdo_entry_regs);
+size_t ecrt_domain_size(const ec_domain_t *domain);
+uint8_t *ecrt_domain_data(ec_domain_t *domain);
+void ecrt_domain_process(ec_domain_t *domain);
+void ecrt_domain_queue(ec_domain_t *domain);
+void ecrt_domain_state(const ec_domain_t *domain, ec_domain_state_t *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+// 过程数据读写宏（小端主机）
+#define EC_READ_BIT(DATA, POS) ((*((uint8_t *) (DATA)) >> (POS)) & 0x01)
+#define EC_READ_U8(DATA) ((uint8_t) *((uint8_t *) (DATA)))
+#define EC_READ_S8(DATA) ((int8_t) *((uint8_t *) (DATA)))
+#define EC_READ_U16(DATA) ((uint16_t) *((uint16_t *) (void *) (DATA)))
+#define EC_READ_S16(DATA) ((int16_t) *((uint16_t *) (void *) (DATA)))
+#define EC_READ_U32(DATA) ((uint32_t) *((uint32_t *) (void *) (DATA)))
+#define EC_READ_S32(DATA) ((int32_t) *((uint32_t *) (void *) (DATA)))
+
+#define EC_WRITE_BIT(DATA, POS, VAL) \
+    do { \
+        if (VAL) *((uint8_t *) (DATA)) |= (1 << (POS)); \
+        else *((uint8_t *) (DATA)) &= ~(1 << (POS)); \
+    } while (0)
+#define EC_WRITE_U8(DATA, VAL) do { *((uint8_t *) (DATA)) = ((uint8_t) (VAL)); } while (0)
+#define EC_WRITE_S8(DATA, VAL) EC_WRITE_U8(DATA, VAL)
+#define EC_WRITE_U16(DATA, VAL) do { *((uint16_t *) (void *) (DATA)) = (uint16_t) (VAL); } while (0)
+#define EC_WRITE_S16(DATA, VAL) EC_WRITE_U16(DATA, VAL)
+#define EC_WRITE_U32(DATA, VAL) do { *((uint32_t *) (void *) (DATA)) = (uint32_t) (VAL); } while (0)
+#define EC_WRITE_S32(DATA, VAL) EC_WRITE_U32(DATA, VAL)
+
+#endif // ECRT_SIM_H
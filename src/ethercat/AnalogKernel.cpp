@@ -0,0 +1,181 @@
+#include "ethercat/AnalogKernel.h"
+#include "ethercat/EtherCATMaster.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ANALOG_KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define ANALOG_KERNEL_X86 0
+#endif
+
+namespace {
+
+// 与 EtherCATMaster 的单通道换算使用同一组常量和运算顺序
+constexpr float CURRENT_SPAN = CURRENT_RANGE_MAX - CURRENT_RANGE_MIN;
+constexpr float PRESSURE_SPAN = PRESSURE_RANGE_MAX - PRESSURE_RANGE_MIN;
+constexpr float ADC_SCALE = ADC_MAX_VALUE;
+constexpr uint16_t LIMIT2_ABOVE = AI_LIMIT_ABOVE << AI_STATUS_LIMIT2_SHIFT;
+
+static_assert(EtherCATMaster::PRESSURE_STALE <= 0xFF, "状态码须能放入 uint8_t");
+
+uint8_t statusCode(uint16_t status, bool stale) {
+    if (status & AI_STATUS_FAULT) return EtherCATMaster::PRESSURE_SENSOR_ERROR;
+    if (stale) return EtherCATMaster::PRESSURE_STALE;
+    if ((status & AI_STATUS_LIMIT2) == LIMIT2_ABOVE) return EtherCATMaster::PRESSURE_OVERLOAD;
+    if (status & AI_STATUS_OVERRANGE) return EtherCATMaster::PRESSURE_OVER_RANGE;
+    if (status & AI_STATUS_UNDERRANGE) return EtherCATMaster::PRESSURE_ZERO_DRIFT;
+    return EtherCATMaster::PRESSURE_NORMAL;
+}
+
+void convertScalarRange(const int16_t* raw, const uint16_t* status_words, uint64_t stale, size_t begin, size_t end,
+                        float* currents, float* pressures, uint8_t* statuses) {
+    for (size_t i = begin; i < end; i++) {
+        float current = static_cast<float>(raw[i]) * CURRENT_SPAN / ADC_SCALE + CURRENT_RANGE_MIN;
+        float pressure = (current - CURRENT_RANGE_MIN) * PRESSURE_SPAN / CURRENT_SPAN;
+        currents[i] = current;
+        pressures[i] = pressure < PRESSURE_RANGE_MIN ? PRESSURE_RANGE_MIN : pressure;
+        statuses[i] = statusCode(status_words[i], ((stale >> i) & 0x01) != 0);
+    }
+}
+
+void convertScalar(const int16_t* raw, const uint16_t* status_words, uint64_t stale, size_t count,
+                   float* currents, float* pressures, uint8_t* statuses) {
+    convertScalarRange(raw, status_words, stale, 0, count, currents, pressures, statuses);
+}
+
+#if ANALOG_KERNEL_X86
+// ==================== SSE2：每次 8 通道 ====================
+__attribute__((target("sse2")))
+inline void convertFloatsSse(__m128 raw, float* currents, float* pressures) {
+    const __m128 current_span = _mm_set1_ps(CURRENT_SPAN);
+    const __m128 current_min = _mm_set1_ps(CURRENT_RANGE_MIN);
+    __m128 current = _mm_add_ps(_mm_div_ps(_mm_mul_ps(raw, current_span), _mm_set1_ps(ADC_SCALE)), current_min);
+    __m128 pressure = _mm_div_ps(_mm_mul_ps(_mm_sub_ps(current, current_min), _mm_set1_ps(PRESSURE_SPAN)),
+                                 current_span);
+    _mm_storeu_ps(currents, current);
+    _mm_storeu_ps(pressures, _mm_max_ps(pressure, _mm_set1_ps(PRESSURE_RANGE_MIN)));
+}
+
+// 状态码按优先级从低到高覆盖，与 statusCode() 的判断顺序相反
+__attribute__((target("sse2")))
+inline __m128i selectSse(__m128i mask, uint8_t code, __m128i result) {
+    return _mm_or_si128(_mm_and_si128(mask, _mm_set1_epi16(code)), _mm_andnot_si128(mask, result));
+}
+
+__attribute__((target("sse2")))
+inline __m128i isSetSse(__m128i words, uint16_t bits) {
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_xor_si128(_mm_cmpeq_epi16(_mm_and_si128(words, _mm_set1_epi16(static_cast<short>(bits))), zero),
+                         _mm_cmpeq_epi16(zero, zero));
+}
+
+__attribute__((target("sse2")))
+void convertSse2(const int16_t* raw, const uint16_t* status_words, uint64_t stale, size_t count,
+                 float* currents, float* pressures, uint8_t* statuses) {
+    const __m128i lane_bits = _mm_setr_epi16(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+        convertFloatsSse(_mm_cvtepi32_ps(lo), currents + i, pressures + i);
+        convertFloatsSse(_mm_cvtepi32_ps(hi), currents + i + 4, pressures + i + 4);
+
+        __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(status_words + i));
+        __m128i stale_bits = _mm_and_si128(_mm_set1_epi16(static_cast<short>((stale >> i) & 0xFF)), lane_bits);
+        __m128i limit2 = _mm_cmpeq_epi16(_mm_and_si128(words, _mm_set1_epi16(static_cast<short>(AI_STATUS_LIMIT2))),
+                                         _mm_set1_epi16(static_cast<short>(LIMIT2_ABOVE)));
+        __m128i result = _mm_and_si128(isSetSse(words, AI_STATUS_UNDERRANGE),
+                                       _mm_set1_epi16(EtherCATMaster::PRESSURE_ZERO_DRIFT));
+        result = selectSse(isSetSse(words, AI_STATUS_OVERRANGE), EtherCATMaster::PRESSURE_OVER_RANGE, result);
+        result = selectSse(limit2, EtherCATMaster::PRESSURE_OVERLOAD, result);
+        result = selectSse(_mm_cmpeq_epi16(stale_bits, lane_bits), EtherCATMaster::PRESSURE_STALE, result);
+        result = selectSse(isSetSse(words, AI_STATUS_FAULT), EtherCATMaster::PRESSURE_SENSOR_ERROR, result);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(statuses + i), _mm_packus_epi16(result, result));
+    }
+    convertScalarRange(raw, status_words, stale, i, count, currents, pressures, statuses);
+}
+
+// ==================== AVX2：每次 16 通道 ====================
+__attribute__((target("avx2")))
+inline void convertFloatsAvx(__m256 raw, float* currents, float* pressures) {
+    const __m256 current_span = _mm256_set1_ps(CURRENT_SPAN);
+    const __m256 current_min = _mm256_set1_ps(CURRENT_RANGE_MIN);
+    __m256 current = _mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(raw, current_span), _mm256_set1_ps(ADC_SCALE)),
+                                   current_min);
+    __m256 pressure = _mm256_div_ps(_mm256_mul_ps(_mm256_sub_ps(current, current_min), _mm256_set1_ps(PRESSURE_SPAN)),
+                                    current_span);
+    _mm256_storeu_ps(currents, current);
+    _mm256_storeu_ps(pressures, _mm256_max_ps(pressure, _mm256_set1_ps(PRESSURE_RANGE_MIN)));
+}
+
+__attribute__((target("avx2")))
+inline __m256i selectAvx(__m256i mask, uint8_t code, __m256i result) {
+    return _mm256_blendv_epi8(result, _mm256_set1_epi16(code), mask);
+}
+
+__attribute__((target("avx2")))
+inline __m256i isSetAvx(__m256i words, uint16_t bits) {
+    const __m256i zero = _mm256_setzero_si256();
+    return _mm256_xor_si256(
+        _mm256_cmpeq_epi16(_mm256_and_si256(words, _mm256_set1_epi16(static_cast<short>(bits))), zero),
+        _mm256_cmpeq_epi16(zero, zero));
+}
+
+__attribute__((target("avx2")))
+void convertAvx2(const int16_t* raw, const uint16_t* status_words, uint64_t stale, size_t count,
+                 float* currents, float* pressures, uint8_t* statuses) {
+    const __m256i lane_bits = _mm256_setr_epi16(0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080,
+                                                0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000,
+                                                static_cast<short>(0x8000));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i + 8));
+        convertFloatsAvx(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(lo)), currents + i, pressures + i);
+        convertFloatsAvx(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(hi)), currents + i + 8, pressures + i + 8);
+
+        __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(status_words + i));
+        __m256i stale_bits = _mm256_and_si256(_mm256_set1_epi16(static_cast<short>((stale >> i) & 0xFFFF)),
+                                              lane_bits);
+        __m256i limit2 = _mm256_cmpeq_epi16(
+            _mm256_and_si256(words, _mm256_set1_epi16(static_cast<short>(AI_STATUS_LIMIT2))),
+            _mm256_set1_epi16(static_cast<short>(LIMIT2_ABOVE)));
+        __m256i result = _mm256_and_si256(isSetAvx(words, AI_STATUS_UNDERRANGE),
+                                          _mm256_set1_epi16(EtherCATMaster::PRESSURE_ZERO_DRIFT));
+        result = selectAvx(isSetAvx(words, AI_STATUS_OVERRANGE), EtherCATMaster::PRESSURE_OVER_RANGE, result);
+        result = selectAvx(limit2, EtherCATMaster::PRESSURE_OVERLOAD, result);
+        result = selectAvx(_mm256_cmpeq_epi16(stale_bits, lane_bits), EtherCATMaster::PRESSURE_STALE, result);
+        result = selectAvx(isSetAvx(words, AI_STATUS_FAULT), EtherCATMaster::PRESSURE_SENSOR_ERROR, result);
+        // packus 按 128 位分半打包，先取出两半再合并
+        __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(statuses + i), packed);
+    }
+    // 剩余不足 16 的通道交给 SSE2（其尾部再走标量）
+    if (i < count) {
+        convertSse2(raw + i, status_words + i, stale >> i, count - i, currents + i, pressures + i, statuses + i);
+    }
+}
+#endif
+
+} // namespace
+
+std::vector<AnalogKernel> availableAnalogKernels() {
+    std::vector<AnalogKernel> kernels;
+    kernels.push_back({"scalar", convertScalar});
+#if ANALOG_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        kernels.push_back({"sse2", convertSse2});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back({"avx2", convertAvx2});
+    }
+#endif
+    return kernels;
+}
+
+const AnalogKernel& analogKernel() {
+    static const AnalogKernel kernel = availableAnalogKernels().back();
+    return kernel;
+}
@@ -0,0 +1,139 @@
+#include "ethercat/Clock.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <time.h>
+
+namespace {
+
+constexpr int64_t NSEC_PER_SEC = 1000000000LL;
+
+int64_t readClockNs(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// 当前线程作为参与者加入的虚拟时钟
+thread_local const VirtualClock* participant_clock = nullptr;
+
+} // namespace
+
+// ==================== 系统时钟 ====================
+int64_t SystemClock::nowNs() const {
+    return readClockNs(CLOCK_MONOTONIC);
+}
+
+int64_t SystemClock::wallNs() const {
+    return readClockNs(CLOCK_REALTIME);
+}
+
+void SystemClock::sleepUntil(int64_t deadline_ns) {
+    struct timespec deadline;
+    deadline.tv_sec = static_cast<time_t>(deadline_ns / NSEC_PER_SEC);
+    deadline.tv_nsec = static_cast<long>(deadline_ns % NSEC_PER_SEC);
+    // 被信号打断时继续等待
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
+
+// ==================== 虚拟时钟 ====================
+VirtualClock::VirtualClock()
+    : VirtualClock(readClockNs(CLOCK_MONOTONIC), readClockNs(CLOCK_REALTIME)) {
+}
+
+VirtualClock::VirtualClock(int64_t start_ns, int64_t wall_start_ns)
+    : now_ns(start_ns)
+    , wall_offset_ns(wall_start_ns - start_ns)
+    , participants(0)
+    , sleeping_participants(0)
+    , advance_count(0) {
+}
+
+void VirtualClock::sleepUntil(int64_t deadline_ns) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (deadline_ns <= now_ns.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    Sleeper sleeper;
+    sleeper.deadline_ns = deadline_ns;
+    sleeper.participant = (participant_clock == this);
+    sleeper.woken = false;
+    sleepers.push_back(&sleeper);
+    if (sleeper.participant) {
+        sleeping_participants++;
+    }
+
+    tryAdvanceLocked();
+    cv.wait(lock, [&sleeper]() { return sleeper.woken; });
+    sleepers.remove(&sleeper);
+}
+
+void VirtualClock::addParticipant() {
+    std::lock_guard<std::mutex> lock(mutex);
+    participants++;
+}
+
+void VirtualClock::enterParticipant() {
+    participant_clock = this;
+}
+
+void VirtualClock::leaveParticipant() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (participant_clock == this) {
+        participant_clock = nullptr;
+    }
+    participants = std::max(0, participants - 1);
+    // 剩余的参与线程可能都在等待
+    tryAdvanceLocked();
+}
+
+void VirtualClock::advance(int64_t duration_ns) {
+    std::lock_guard<std::mutex> lock(mutex);
+    advanceToLocked(now_ns.load(std::memory_order_relaxed) + std::max<int64_t>(0, duration_ns));
+}
+
+uint64_t VirtualClock::getAdvanceCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return advance_count;
+}
+
+// 推进到 target_ns 并唤醒到期的等待者；唤醒的参与者立即计为运行中，
+// 避免它们真正醒来之前时间被再次推进
+void VirtualClock::advanceToLocked(int64_t target_ns) {
+    if (target_ns > now_ns.load(std::memory_order_relaxed)) {
+        now_ns.store(target_ns, std::memory_order_release);
+        advance_count++;
+    }
+    bool any_woken = false;
+    for (Sleeper* sleeper : sleepers) {
+        if (!sleeper->woken && sleeper->deadline_ns <= target_ns) {
+            sleeper->woken = true;
+            any_woken = true;
+            if (sleeper->participant) {
+                sleeping_participants--;
+            }
+        }
+    }
+    if (any_woken) {
+        cv.notify_all();
+    }
+}
+
+void VirtualClock::tryAdvanceLocked() {
+    if (sleeping_participants < participants) {
+        return;
+    }
+    int64_t next_ns = 0;
+    bool found = false;
+    for (const Sleeper* sleeper : sleepers) {
+        if (!sleeper->woken && (!found || sleeper->deadline_ns < next_ns)) {
+            next_ns = sleeper->deadline_ns;
+            found = true;
+        }
+    }
+    if (found) {
+        advanceToLocked(next_ns);
+    }
+}
@@ -1,17 +1,29 @@
 #include "ethercat/EtherCATMaster.h"
+#include "ethercat/RecordingBackend.h"
+#include "ethercat/AnalogKernel.h"
+#include "ethercat/PressureCalibration.h"
 #include <iostream>
 #include <iomanip>
 #include <thread>
 #include <chrono>
 #include <csignal>
+#include <cstdio>
 #include <cstring>
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <iterator>
+#include <cmath>
 #include <filesystem>
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <alloca.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <cerrno>
 
 // 全局变量用于信号处理
 static EtherCATMaster* g_master_instance = nullptr;
@@ -142,13 +154,107 @@ void hotkeyListener() {
     }
 }
 
-EtherCATMaster::EtherCATMaster() 
-    : master(nullptr)
-    , domain(nullptr)
-    , domain_data(nullptr)
+// ==================== 周期定时辅助函数 ====================
+static constexpr int64_t NSEC_PER_SEC = 1000000000LL;
+
+// 发布的状态字中表示"已采样"的标志位
+static constexpr uint64_t STATE_WORD_VALID = 1ULL << 63;
+
+// 压力目标监视请求字的标志位
+static constexpr uint64_t PRESSURE_TARGET_BELOW = 1ULL << 40;
+static constexpr uint64_t PRESSURE_TARGET_ARMED = 1ULL << 41;
+
+static inline int64_t timespecToNs(const struct timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// 单调时钟当前时间(ns)，用于各阶段实际耗时的统计（不受主站时钟影响）
+static inline int64_t monotonicNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return timespecToNs(ts);
+}
+
+static inline int64_t msToNs(int64_t ms) {
+    return ms * 1000000LL;
+}
+
+// 启动计时的显示格式：毫秒，保留一位小数
+static std::string formatDurationUs(int64_t us) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1fms", static_cast<double>(us) / 1000.0);
+    return buf;
+}
+
+// 触碰一段栈空间，避免周期运行中首次访问栈页时产生缺页
+static void prefaultStack(size_t size) {
+    if (size == 0) return;
+    volatile unsigned char* stack = static_cast<volatile unsigned char*>(alloca(size));
+    for (size_t i = 0; i < size; i += 4096) {
+        stack[i] = 0;
+    }
+    stack[size - 1] = 0;
+}
+
+EtherCATMaster::EtherCATMaster()
+    : backend(createFieldbusBackend(FieldbusBackendType::BACKEND_IGH))
+    , clock(std::make_shared<SystemClock>())
+    , topology(SlaveTopology::createDefault())
+    , topology_check()
+    , expected_slaves(0)
+    , domains_attached(false)
+    , analog_channel_count(0)
+    , digital_input_count(0)
+    , relay_channel_count(0)
+    , relay_channel_mask(0)
     , relay_states(0)
+    , relay_in_flight_count(0)
+    , relay_output_image(0)
+    , relay_confirm_timeout_cycles(1)
+    , next_relay_command_id(1)
+    , sdo_request_count(0)
+    , sdo_in_flight_count(0)
+    , next_sdo_operation_id(1)
+    , published_master_state(0)
+    , published_slave_states(0)
+    , bus_ready(false)
+    , bus_interruption_count(0)
+    , bus_interrupted(false)
+    , bus_lost_time()
+    , bus_lost_cycle(0)
+    , bus_reconfigure_time()
+    , bus_reconfigure_armed(false)
+    , bus_offline_slaves(0)
+    , bus_stats()
+    , cycle_park_requested(false)
+    , cycle_parked(false)
     , initialized(false)
     , running(false)
+    , memory_locked(false)
+    , input_snapshot_rt()
+    , cycle_count(0)
+    , analog_toggle_rt(0)
+    , analog_unchanged_rt()
+    , analog_stale_exchanges(1)
+    , cycle_timing_reset_requested(false)
+    , startup_timing()
+    , startup_begin_ns(0)
+    , cycle_start_ns(0)
+    , startup_tracking(false)
+    , startup_states_rt()
+    , startup_master_state_rt(0)
+    , startup_required_mask(0)
+    , startup_op_reported(false)
+    , overrun_run_max_ns(0)
+    , overrun_run_skipped(0)
+    , safe_outputs_active(false)
+    , pressure_target_request(0)
+    , pressure_target_level(0)
+    , next_pressure_target_id(1)
+    , pressure_target_fired_id(0)
+    , calibration(nullptr)
+    , calibration_readers(0)
+    , cycle_hook_count(0)
     , current_status(MasterStatus::STATUS_UNINITIALIZED)
     , test_running(false)
     , test_cancelled(false)
@@ -160,13 +266,16 @@ EtherCATMaster::EtherCATMaster()
     , hotkey_listening(false) {
     
     // 初始化偏移量
-    memset(off_dig_in, 0, sizeof(off_dig_in));
-    memset(off_ai_val, 0, sizeof(off_ai_val));
-    memset(off_relay_out, 0, sizeof(off_relay_out));
+    
+    relay_in_flight.fill(0);
+    for (size_t i = 0; i < relay_slots.size(); i++) {
+        relay_free_slots.tryPush(static_cast<uint16_t>(i));
+    }
+    sdo_in_flight.fill(nullptr);
+    sdo_active.fill(nullptr);
     
     // 初始化状态结构
     memset(&master_state, 0, sizeof(master_state));
-    memset(&domain_state, 0, sizeof(domain_state));
     
     // 设置信号处理
     g_master_instance = this;
@@ -186,52 +295,238 @@ EtherCATMaster::EtherCATMaster()
 
 EtherCATMaster::~EtherCATMaster() {
     stop();
+    swapCalibration(nullptr);
+    retired_calibrations.clear();
     g_master_instance = nullptr;
     g_hotkey_enabled = false;
 }
 
+bool EtherCATMaster::setFieldbusBackend(FieldbusBackendType type, const std::string& resource) {
+    if (initialized || backend->isMasterRequested()) {
+        log(LogLevel::LOG_ERROR, "Master", "主站已初始化，无法切换现场总线后端");
+        return false;
+    }
+    std::unique_ptr<FieldbusBackend> next = createFieldbusBackend(type, resource);
+    if (!next) {
+        return false;
+    }
+    backend = std::move(next);
+    log(LogLevel::LOG_INFO, "Master", "现场总线后端: " + backend->getName());
+    return true;
+}
+
+bool EtherCATMaster::enableProcessImageRecording(const std::string& path) {
+    if (initialized || backend->isMasterRequested()) {
+        log(LogLevel::LOG_ERROR, "Master", "主站已初始化，无法开启过程数据记录");
+        return false;
+    }
+    if (path.empty()) {
+        log(LogLevel::LOG_ERROR, "Master", "过程数据记录文件路径为空");
+        return false;
+    }
+    backend.reset(new RecordingBackend(std::move(backend), path));
+    log(LogLevel::LOG_INFO, "Master", "现场总线后端: " + backend->getName());
+    return true;
+}
+
+bool EtherCATMaster::loadTopology(const std::string& path, const std::string& cache_path) {
+    if (initialized || backend->isMasterRequested()) {
+        log(LogLevel::LOG_ERROR, "Master", "主站已初始化，无法切换从站拓扑");
+        return false;
+    }
+    SlaveTopology loaded;
+    std::string error;
+    if (!loaded.load(path, cache_path.empty() ? path + ".cache" : cache_path, error)) {
+        log(LogLevel::LOG_ERROR, "Master", "加载从站拓扑失败: " + error);
+        return false;
+    }
+    topology = std::move(loaded);
+    log(LogLevel::LOG_INFO, "Master", "从站拓扑: " + topology.getSource() + " (" +
+        std::to_string(topology.getSlaves().size()) + " 个从站" + (topology.isFromCache() ? "，来自缓存" : "") + ")");
+    return true;
+}
+
+bool EtherCATMaster::setClock(std::shared_ptr<Clock> new_clock) {
+    if (running) {
+        log(LogLevel::LOG_ERROR, "Master", "主站运行中，无法切换时钟");
+        return false;
+    }
+    if (!new_clock) {
+        new_clock = std::make_shared<SystemClock>();
+    }
+    clock = std::move(new_clock);
+    log(LogLevel::LOG_INFO, "Master", clock->isVirtual() ? "使用虚拟时钟" : "使用系统时钟");
+    return true;
+}
+
+std::chrono::steady_clock::time_point EtherCATMaster::clockNow() const {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(clock->nowNs())));
+}
+
 bool EtherCATMaster::initialize() {
-    std::cout << "初始化 EtherCAT 主站..." << std::endl;
+    std::cout << "初始化 EtherCAT 主站 (" << backend->getName() << ")..." << std::endl;
+    
+    // 各阶段耗时按单调时钟计（与主站时钟无关，虚拟时钟下同样是实际耗时）
+    StartupTiming timing;
+    startup_begin_ns = monotonicNowNs();
+    int64_t phase_ns = startup_begin_ns;
+    auto phaseUs = [&phase_ns]() {
+        int64_t now = monotonicNowNs();
+        int64_t us = (now - phase_ns) / 1000;
+        phase_ns = now;
+        return us;
+    };
     
     // 获取主站
-    master = ecrt_request_master(0);
-    if (!master) {
+    if (!backend->requestMaster(0)) {
         std::cerr << "错误: 无法请求 EtherCAT 主站" << std::endl;
         return false;
     }
     std::cout << "EtherCAT 主站请求成功" << std::endl;
+    timing.request_master_us = phaseUs();
+
+    // 热启动数据须在扫描之前交给后端
+    timing.fingerprint = configurationFingerprint();
+    timing.warm_start = loadWarmStartCache(timing.fingerprint);
+
+    // 扫描总线，与拓扑逐个位置比对
+    if (!scanBus()) {
+        std::cerr << "错误: 总线上的从站与拓扑不符" << std::endl;
+        backend->releaseMaster();
+        return false;
+    }
+    timing.scan_us = phaseUs();
 
-    // 创建域
-    domain = ecrt_master_create_domain(master);
-    if (!domain) {
-        std::cerr << "错误: 无法创建域" << std::endl;
-        ecrt_release_master(master);
-        master = nullptr;
+    // 创建域（每组从站一个域，交换周期在 start() 中按分频确定）
+    if (!createDomains()) {
+        backend->releaseMaster();
         return false;
     }
-    std::cout << "域创建成功" << std::endl;
 
-    // 配置从站和PDO映射
+    // 配置从站和PDO映射：每次都在主站内存中登记（IgH 要求每次请求主站后重新提交）；
+    // 拓扑验证通过后的快速路径在后端完成：原始套接字后端对热启动缓存中未断电的从站跳过 SII 读取和 PDO 分配写入
     if (!configureSlaves()) {
         std::cerr << "错误: 从站配置失败" << std::endl;
-        ecrt_release_master(master);
-        master = nullptr;
+        backend->releaseMaster();
+        for (auto& d : domains) {
+            d.domain = -1;
+        }
+        publishSlaveConfigs(std::vector<size_t>());
         return false;
     }
+    timing.configure_us = phaseUs();
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        startup_timing = timing;
+    }
 
     initialized = true;
-    std::cout << "EtherCAT 主站初始化成功" << std::endl;
+    std::cout << "EtherCAT 主站初始化成功 (请求主站 " << formatDurationUs(timing.request_master_us)
+              << "，扫描 " << formatDurationUs(timing.scan_us)
+              << "，配置 " << formatDurationUs(timing.configure_us) << ")" << std::endl;
+    return true;
+}
+
+bool EtherCATMaster::createDomains() {
+    for (size_t i = 0; i < PROCESS_DOMAIN_COUNT; i++) {
+        domains[i].domain = backend->createDomain();
+        if (domains[i].domain < 0) {
+            std::cerr << "错误: 无法创建域 " << getProcessDomainName(static_cast<ProcessDomainId>(i)) << std::endl;
+            for (auto& d : domains) {
+                d.domain = -1;
+            }
+            return false;
+        }
+    }
+    std::cout << "域创建成功: " << PROCESS_DOMAIN_COUNT << " 个" << std::endl;
     return true;
 }
 
+static std::string formatSlaveIdentity(uint32_t vendor_id, uint32_t product_code) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "0x%08x:0x%08x", vendor_id, product_code);
+    return buffer;
+}
+
+bool EtherCATMaster::scanBus() {
+    std::vector<ec_slave_info_t> bus;
+    if (!backend->scanSlaves(bus)) {
+        publishTopologyCheck(TopologyCheck());
+        log(LogLevel::LOG_WARNING, "Master", "后端不支持总线扫描或扫描失败，跳过拓扑校验");
+        return true;
+    }
+    TopologyCheck check = topology.check(bus);
+
+    // 逐个位置报告差异；必需从站身份不符时不继续配置
+    bool identity_ok = true;
+    for (const auto& entry : check.entries) {
+        std::string where = "位置 " + std::to_string(entry.position) + ": ";
+        std::string actual = formatSlaveIdentity(entry.vendor_id, entry.product_code) +
+                             (entry.name.empty() ? "" : " (" + entry.name + ")");
+        if (entry.result == SlaveCheckResult::SLAVE_UNEXPECTED) {
+            log(LogLevel::LOG_WARNING, "Master", where + "拓扑之外的从站 " + actual);
+            continue;
+        }
+        const TopologySlave& slave = topology.getSlaves()[entry.expected];
+        std::string expected = slave.name + " (" + formatSlaveIdentity(slave.vendor_id, slave.product_code) + ")";
+        LogLevel level = slave.optional ? LogLevel::LOG_WARNING : LogLevel::LOG_ERROR;
+        if (entry.result == SlaveCheckResult::SLAVE_MISSING) {
+            log(level, "Master", where + "缺少从站 " + expected);
+        } else if (entry.result == SlaveCheckResult::SLAVE_MISMATCH) {
+            log(level, "Master", where + "期望 " + expected + "，实际 " + actual);
+            identity_ok = identity_ok && slave.optional;
+        }
+    }
+
+    log(check.verified ? LogLevel::LOG_INFO : LogLevel::LOG_WARNING, "Master",
+        "总线扫描: " + std::to_string(check.bus_slave_count) + " 个从站，拓扑" +
+        (check.verified ? "一致" : "不一致"));
+    publishTopologyCheck(std::move(check));
+    return identity_ok;
+}
+
+// 扫描成功时以总线上实际的从站数为准（可选从站可能不在位），否则按拓扑
+void EtherCATMaster::publishTopologyCheck(TopologyCheck check) {
+    unsigned int expected = check.scanned ? check.bus_slave_count
+                                          : static_cast<unsigned int>(topology.getSlaves().size());
+    std::lock_guard<std::mutex> lock(config_mutex);
+    topology_check = std::move(check);
+    expected_slaves.store(expected, std::memory_order_release);
+}
+
+void EtherCATMaster::publishSlaveConfigs(std::vector<size_t> configs) {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    slave_configs = std::move(configs);
+}
+
+TopologyCheck EtherCATMaster::getTopologyCheck() const {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    return topology_check;
+}
+
+// 周期线程也会调用，不加锁
+unsigned int EtherCATMaster::expectedSlaveCount() const {
+    return expected_slaves.load(std::memory_order_acquire);
+}
+
+bool EtherCATMaster::topologyMismatch() const {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    return topology_check.scanned && !topology_check.verified;
+}
+
 // 新增：检查主站健康状态
 bool EtherCATMaster::checkMasterHealth() {
-    if (!master) {
+    if (!backend->isMasterRequested()) {
         return false;
     }
     
+    // 使用周期线程发布的主站状态，尚未采样时视为未就绪
     ec_master_state_t ms;
-    ecrt_master_state(master, &ms);
+    if (!loadMasterState(ms)) {
+        return false;
+    }
     
     // 检查链接状态
     if (!ms.link_up) {
@@ -240,10 +535,11 @@ bool EtherCATMaster::checkMasterHealth() {
         return false;
     }
     
-    // 检查从站响应数量 (实际配置: EK1100, EL1008, EL3074, EL2634, EL6001, EL6751 = 6个)
-    if (ms.slaves_responding != 6) {
-        std::cerr << "警告: 从站响应数量异常，期望6个，实际" << ms.slaves_responding << "个" << std::endl;
-        current_status = MasterStatus::STATUS_WARNING;
+    // 检查从站响应数量（期望值来自启动时的总线扫描或拓扑）
+    unsigned int expected = expectedSlaveCount();
+    bool slaves_ok = ms.slaves_responding == expected;
+    if (!slaves_ok) {
+        std::cerr << "警告: 从站响应数量异常，期望" << expected << "个，实际" << ms.slaves_responding << "个" << std::endl;
     } else {
         std::cout << "从站响应正常: " << ms.slaves_responding << "个" << std::endl;
     }
@@ -252,6 +548,8 @@ bool EtherCATMaster::checkMasterHealth() {
     if ((ms.al_states & 0x08) == 0) { // 检查是否在OP状态
         std::cout << "注意: 应用层状态: 0x" << std::hex << static_cast<int>(ms.al_states) << std::dec << std::endl;
         current_status = MasterStatus::STATUS_WARNING;
+    } else if (!slaves_ok || topologyMismatch()) {
+        current_status = MasterStatus::STATUS_WARNING;
     } else {
         current_status = MasterStatus::STATUS_OPERATIONAL;
     }
@@ -276,6 +574,11 @@ bool EtherCATMaster::verifyOperation(const std::string& operation_name) {
         return false;
     }
     
+    if (!bus_ready) {
+        std::cerr << "错误: " << operation_name << " - 总线中断，等待恢复" << std::endl;
+        return false;
+    }
+    
     if (!checkMasterHealth()) {
         std::cerr << "错误: " << operation_name << " - 主站健康状态检查失败" << std::endl;
         
@@ -294,28 +597,33 @@ bool EtherCATMaster::verifyOperation(const std::string& operation_name) {
 }
 
 // 新增：等待主站进入运行状态
+// 周期线程逐周期跟踪从站状态，监督线程在必需从站全部进入 OP 时完成 future，这里只等待该事件
 bool EtherCATMaster::waitForOperational(int timeout_ms) {
-    auto start_time = std::chrono::steady_clock::now();
-    
-    while (true) {
-        auto current_time = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            current_time - start_time).count();
-        
-        if (elapsed >= timeout_ms) {
-            std::cerr << "错误: 等待主站就绪超时 (" << timeout_ms << "ms)" << std::endl;
-            return false;
-        }
-        
-        if (checkMasterHealth()) {
-            if (current_status == MasterStatus::STATUS_OPERATIONAL) {
-                std::cout << "主站已进入运行状态，耗时 " << elapsed << "ms" << std::endl;
-                return true;
-            }
+    if (!running || !startup_op_future.valid()) {
+        return false;
+    }
+    auto start_time = clockNow();
+    bool reached;
+    if (!clock->isVirtual()) {
+        reached = startup_op_future.wait_for(std::chrono::milliseconds(timeout_ms)) == std::future_status::ready;
+    } else {
+        int64_t deadline_ns = clock->nowNs() + msToNs(timeout_ms);
+        while (startup_op_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready &&
+               clock->nowNs() < deadline_ns) {
+            clock->sleepFor(msToNs(1));
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        reached = startup_op_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(clockNow() - start_time).count();
+    if (!reached) {
+        std::cerr << "错误: 等待从站进入 OP 超时 (" << timeout_ms << "ms)" << std::endl;
+        return false;
     }
+    
+    // 周期线程在进入 OP 的周期已发布主站状态，据此更新主站状态（可能因可选从站缺失等为警告）
+    checkMasterHealth();
+    std::cout << "必需从站已全部进入 OP (周期 " << startup_op_future.get() << ")，等待 " << elapsed << "ms" << std::endl;
+    return true;
 }
 
 // 新增：获取主站状态
@@ -364,10 +672,27 @@ void EtherCATMaster::printHealthStatus() {
     std::cout << "当前状态: " << getMasterStatusString() << std::endl;
     
     ec_master_state_t ms;
-    ecrt_master_state(master, &ms);
+    if (!loadMasterState(ms)) {
+        std::cout << "主站状态尚未采样" << std::endl;
+        std::cout << "============================" << std::endl;
+        return;
+    }
     
     std::cout << "以太网链接: " << (ms.link_up ? "正常" : "断开") << std::endl;
-    std::cout << "响应从站: " << ms.slaves_responding << " 个" << std::endl;
+    std::cout << "响应从站: " << ms.slaves_responding << " 个 (期望 " << expectedSlaveCount() << " 个)" << std::endl;
+    TopologyCheck check = getTopologyCheck();
+    if (check.scanned) {
+        std::cout << "拓扑校验: " << (check.verified ? "一致" : "不一致") << std::endl;
+        for (const auto& entry : check.entries) {
+            if (entry.result == SlaveCheckResult::SLAVE_OK) continue;
+            std::cout << "  位置 " << entry.position << ": "
+                      << (entry.result == SlaveCheckResult::SLAVE_MISSING ? "缺少 " :
+                          entry.result == SlaveCheckResult::SLAVE_MISMATCH ? "身份不符 " : "拓扑之外 ")
+                      << (entry.expected >= 0 ? topology.getSlaves()[entry.expected].name
+                                              : formatSlaveIdentity(entry.vendor_id, entry.product_code))
+                      << std::endl;
+        }
+    }
     
     // 解析应用层状态
     std::cout << "应用层状态: ";
@@ -391,8 +716,9 @@ void EtherCATMaster::printHealthStatus() {
 
 // 新增：更新主站状态
 void EtherCATMaster::updateMasterStatus() {
-    if (!master) {
-        current_status = MasterStatus::STATUS_UNINITIALIZED;
+    if (!backend->isMasterRequested()) {
+        // 热重配置失败时主站已释放，仍按中断报告
+        current_status = bus_interrupted ? MasterStatus::STATUS_ERROR : MasterStatus::STATUS_UNINITIALIZED;
         return;
     }
     
@@ -401,9 +727,11 @@ void EtherCATMaster::updateMasterStatus() {
         return;
     }
     
-    // 获取主站状态
+    // 读取周期线程发布的主站状态
     ec_master_state_t ms;
-    ecrt_master_state(master, &ms);
+    if (!loadMasterState(ms)) {
+        return;
+    }
     
     // 更新状态信息
     {
@@ -414,10 +742,12 @@ void EtherCATMaster::updateMasterStatus() {
         master_state_info.last_update = std::chrono::system_clock::now();
     }
     
-    // 确定状态级别 (实际有6个从站: EK1100, EL1008, EL3074, EL2634, EL6001, EL6751)
-    if (!ms.link_up) {
+    // 确定状态级别（响应数量和拓扑一致性来自启动时的总线扫描）
+    if (!ms.link_up || bus_interrupted) {
         current_status = MasterStatus::STATUS_ERROR;
-    } else if (ms.slaves_responding != 6) {
+    } else if (ms.slaves_responding != expectedSlaveCount()) {
+        current_status = MasterStatus::STATUS_WARNING;
+    } else if (topologyMismatch()) {
         current_status = MasterStatus::STATUS_WARNING;
     } else if ((ms.al_states & 0x08) == 0) {
         current_status = MasterStatus::STATUS_WARNING;
@@ -429,7 +759,9 @@ void EtherCATMaster::updateMasterStatus() {
 // ==================== 日志记录功能 ====================
 void EtherCATMaster::log(LogLevel level, const std::string& module, const std::string& message, int cycle_number) {
     LogEntry entry;
-    entry.timestamp = std::chrono::system_clock::now();
+    entry.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(clock->wallNs())));
     entry.level = level;
     entry.module = module;
     entry.message = message;
@@ -604,17 +936,20 @@ void EtherCATMaster::startInfiniteReliabilityTestAsync(float support_target,
     {
         std::lock_guard<std::mutex> lock(stats_mutex);
         reliability_stats = ReliabilityTestStats();
-        reliability_stats.start_time = std::chrono::steady_clock::now();
+        reliability_stats.start_time = clockNow();
     }
     
-    // 在后台线程中执行测试
-    infinite_reliability_test_thread = std::thread([this, support_target, retract_target,
+    // 在后台线程中执行测试（测试线程参与虚拟时间推进）
+    std::shared_ptr<Clock> test_clock = clock;
+    test_clock->addParticipant();
+    infinite_reliability_test_thread = std::thread([this, test_clock, support_target, retract_target,
                                                    support_timeout, retract_timeout, 
                                                    progress_callback, completion_callback]() {
-        
+        test_clock->enterParticipant();
         executeInfiniteReliabilityTest(support_target, retract_target,
                                       support_timeout, retract_timeout,
                                       progress_callback, completion_callback);
+        test_clock->leaveParticipant();
     });
     
     infinite_reliability_test_thread.detach();
@@ -630,7 +965,7 @@ void EtherCATMaster::executeInfiniteReliabilityTest(float support_target,
                                                    std::function<void(const ReliabilityTestStats&)> completion_callback) {
     
     int cycle = 0;
-    auto test_start_time = std::chrono::steady_clock::now();
+    auto test_start_time = clockNow();
     auto last_report_time = test_start_time;
     
     try {
@@ -641,18 +976,34 @@ void EtherCATMaster::executeInfiniteReliabilityTest(float support_target,
         log(LogLevel::LOG_INFO, "ReliabilityTest", "收回超时: " + std::to_string(retract_timeout/1000) + " 秒");
         log(LogLevel::LOG_INFO, "ReliabilityTest", "按 'e' 结束测试并生成报告，按 's' 查看统计，按 'h' 查看帮助");
         
+        // 测试期间的总线中断按与开始时的差值统计
+        BusInterruptionStats bus_baseline = getBusInterruptionStats();
+        
         while (!stop_infinite_test && running) {
+            // 总线中断时在周期边界暂停，恢复后继续
+            if (!waitForBusRecovery(cycle + 1, bus_baseline)) {
+                break;
+            }
             cycle++;
             
             log(LogLevel::LOG_INFO, "ReliabilityTest", "开始第 " + std::to_string(cycle) + " 周期", cycle);
             
             // 执行支撑测试
-            auto support_start = std::chrono::steady_clock::now();
+            uint64_t interruptions = bus_interruption_count.load();
+            auto support_start = clockNow();
             TestResult support_result = executeSupportTest(support_target, support_timeout, nullptr, cycle);
-            auto support_end = std::chrono::steady_clock::now();
+            auto support_end = clockNow();
             int support_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                 support_end - support_start).count();
             
+            // 期间发生过总线中断的结果不计入统计，恢复后重做本周期
+            if (bus_interruption_count.load() != interruptions) {
+                log(LogLevel::LOG_WARNING, "ReliabilityTest",
+                    "周期 " + std::to_string(cycle) + " 支撑测试期间总线中断，恢复后重做本周期", cycle);
+                cycle--;
+                continue;
+            }
+            
             // 记录支撑测试结果
             {
                 std::lock_guard<std::mutex> lock(stats_mutex);
@@ -672,14 +1023,32 @@ void EtherCATMaster::executeInfiniteReliabilityTest(float support_target,
             }
             
             // 短暂等待
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            clock->sleepFor(msToNs(500));
             
-            // 执行收回测试
-            auto retract_start = std::chrono::steady_clock::now();
-            TestResult retract_result = executeRetractTest(retract_target, retract_timeout, nullptr, cycle);
-            auto retract_end = std::chrono::steady_clock::now();
-            int retract_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                retract_end - retract_start).count();
+            // 执行收回测试；期间发生总线中断时恢复后重做收回（支撑结果已记录）
+            TestResult retract_result;
+            int retract_time_ms = 0;
+            bool stopped = false;
+            while (true) {
+                interruptions = bus_interruption_count.load();
+                auto retract_start = clockNow();
+                retract_result = executeRetractTest(retract_target, retract_timeout, nullptr, cycle);
+                auto retract_end = clockNow();
+                retract_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    retract_end - retract_start).count();
+                if (bus_interruption_count.load() == interruptions) {
+                    break;
+                }
+                log(LogLevel::LOG_WARNING, "ReliabilityTest",
+                    "周期 " + std::to_string(cycle) + " 收回测试期间总线中断，恢复后重做收回", cycle);
+                if (!waitForBusRecovery(cycle, bus_baseline)) {
+                    stopped = true;
+                    break;
+                }
+            }
+            if (stopped) {
+                break;
+            }
             
             // 更新收回测试结果
             {
@@ -705,7 +1074,7 @@ void EtherCATMaster::executeInfiniteReliabilityTest(float support_target,
             }
             
             // 每10个周期或每分钟更新一次进度
-            auto current_time = std::chrono::steady_clock::now();
+            auto current_time = clockNow();
             bool should_report = (cycle % 10 == 0) || 
                                 std::chrono::duration_cast<std::chrono::seconds>(
                                     current_time - last_report_time).count() >= 60;
@@ -742,16 +1111,16 @@ void EtherCATMaster::executeInfiniteReliabilityTest(float support_target,
             
             // 如果不是最后一个周期，等待一下
             if (!stop_infinite_test) {
-                std::this_thread::sleep_for(std::chrono::seconds(2));
+                clock->sleepFor(msToNs(2000));
             }
         }
         
         // 测试结束
         std::lock_guard<std::mutex> lock(stats_mutex);
-        reliability_stats.end_time = std::chrono::steady_clock::now();
+        reliability_stats.end_time = clockNow();
         
         auto total_seconds = std::chrono::duration_cast<std::chrono::seconds>(
-            reliability_stats.getElapsedTime()).count();
+            reliability_stats.getElapsedTime(clockNow())).count();
         
         log(LogLevel::LOG_INFO, "ReliabilityTest", 
             "无限可靠性测试已停止，总运行时间: " + 
@@ -771,7 +1140,7 @@ void EtherCATMaster::executeInfiniteReliabilityTest(float support_target,
             std::string("可靠性测试异常: ") + e.what(), cycle);
         
         std::lock_guard<std::mutex> lock(stats_mutex);
-        reliability_stats.end_time = std::chrono::steady_clock::now();
+        reliability_stats.end_time = clockNow();
         
         if (completion_callback) {
             completion_callback(reliability_stats);
@@ -781,6 +1150,38 @@ void EtherCATMaster::executeInfiniteReliabilityTest(float support_target,
     infinite_test_running = false;
 }
 
+// 总线中断时等待恢复；恢复后按与测试开始时的差值更新中断统计，并在当前周期下记录中断时长
+bool EtherCATMaster::waitForBusRecovery(int cycle_number, const BusInterruptionStats& baseline) {
+    if (!bus_ready) {
+        log(LogLevel::LOG_WARNING, "ReliabilityTest",
+            "周期 " + std::to_string(cycle_number) + ": 总线中断，测试暂停等待恢复", cycle_number);
+        while (!bus_ready) {
+            if (stop_infinite_test || !running) {
+                return false;
+            }
+            clock->sleepFor(msToNs(100));
+        }
+    }
+    
+    BusInterruptionStats bus = getBusInterruptionStats();
+    int interruptions = static_cast<int>(bus.count - baseline.count);
+    int64_t downtime_ms = bus.total_downtime_ms - baseline.total_downtime_ms;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        if (interruptions == reliability_stats.bus_interruptions) {
+            return true;
+        }
+        reliability_stats.bus_interruptions = interruptions;
+        reliability_stats.bus_downtime_ms = downtime_ms;
+    }
+    log(LogLevel::LOG_INFO, "ReliabilityTest",
+        "周期 " + std::to_string(cycle_number) + ": 总线已恢复，中断 " + std::to_string(bus.last_downtime_ms) +
+        "ms (总线周期 " + std::to_string(bus.lost_cycle) + "-" + std::to_string(bus.recovered_cycle) +
+        ")，测试累计中断 " + std::to_string(interruptions) + " 次 / " + std::to_string(downtime_ms) + "ms",
+        cycle_number);
+    return true;
+}
+
 void EtherCATMaster::stopReliabilityTest(bool generate_report) {
     if (infinite_test_running.load()) {
         stop_infinite_test = true;
@@ -820,7 +1221,8 @@ TestResult EtherCATMaster::executeSupportTest(float target_pressure, int timeout
     TestResult result;
     result.status = TestStatus::TEST_RUNNING;
     
-    auto start_time = std::chrono::steady_clock::now();
+    auto start_time = clockNow();
+    int64_t start_ns = clock->nowNs();
     
     try {
         if (progress_callback) {
@@ -838,33 +1240,58 @@ TestResult EtherCATMaster::executeSupportTest(float target_pressure, int timeout
         }
         
         // 第一步：确保通道2（收回控制）关闭
-        if (!setRelayChannel(2, false)) {
+        RelayCommandResult relay_result;
+        if (!setRelayChannelConfirmed(2, false, 200, &relay_result)) {
             result.status = TestStatus::TEST_FAILED;
             result.success = false;
             result.message = "无法关闭通道2";
             log(LogLevel::LOG_ERROR, "SupportTest", "无法关闭通道2", cycle_number);
             return result;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        log(LogLevel::LOG_DEBUG, "SupportTest", "通道2已关闭 (发送周期 " +
+            std::to_string(relay_result.sent_cycle) + ", 确认周期 " +
+            std::to_string(relay_result.confirmed_cycle) + ")", cycle_number);
         
         // 第二步：打开通道1（支撑控制）
-        if (!setRelayChannel(1, true)) {
+        if (!setRelayChannelConfirmed(1, true, 200, &relay_result)) {
             result.status = TestStatus::TEST_FAILED;
             result.success = false;
             result.message = "无法打开通道1";
             log(LogLevel::LOG_ERROR, "SupportTest", "无法打开通道1", cycle_number);
             return result;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        log(LogLevel::LOG_DEBUG, "SupportTest", "通道1已打开 (发送周期 " +
+            std::to_string(relay_result.sent_cycle) + ", 确认周期 " +
+            std::to_string(relay_result.confirmed_cycle) + ")", cycle_number);
+        
+        // 第三步：周期内监视目标压力，越过阈值的周期即由周期线程断开通道1
+        uint32_t target_arm_id = armPressureTarget(PressureTargetMode::TARGET_ALL_ABOVE, target_pressure, 0x01);
+        if (target_arm_id == 0) {
+            setRelayChannel(1, false);
+            result.status = TestStatus::TEST_FAILED;
+            result.success = false;
+            result.message = "无法布防目标压力监视";
+            log(LogLevel::LOG_ERROR, "SupportTest", "无法布防目标压力监视", cycle_number);
+            return result;
+        }
         
-        // 第三步：实时监控压力传感器
         bool target_reached = false;
-        std::vector<float> pressures(4, 0.0f);
-        const int CHECK_INTERVAL_MS = 100;
+        PressureTargetEvent target_event;
+        std::vector<float> pressures(LEG_CHANNEL_COUNT, 0.0f);
+        const int CHECK_INTERVAL_MS = 100;  // 进度刷新间隔
+        const int EVENT_POLL_MS = 5;        // 越过事件轮询间隔（继电器已在周期内断开，只影响测试结束的延迟）
+        bool bus_lost = false;
         
         while (!test_cancelled.load()) {
+            // 总线中断后过程数据不再更新，不按过时的压力继续监视
+            if (!bus_ready) {
+                bus_lost = true;
+                log(LogLevel::LOG_WARNING, "SupportTest", "总线中断，停止监视", cycle_number);
+                break;
+            }
+            
             // 检查超时
-            auto current_time = std::chrono::steady_clock::now();
+            auto current_time = clockNow();
             auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                 current_time - start_time).count();
             
@@ -875,19 +1302,15 @@ TestResult EtherCATMaster::executeSupportTest(float target_pressure, int timeout
             }
             
             // 读取所有压力传感器
-            bool all_above_target = true;
             float min_pressure = 1000.0f;
             
             std::string log_entry = "压力传感器: ";
-            for (int i = 1; i <= 4; i++) {
-                pressures[i-1] = readAnalogInputAsPressure(i);
+            ProcessImageSnapshot snapshot = getProcessImageSnapshot();
+            convertChannelsToPressure(snapshot.analog_raw, pressures.data(), LEG_CHANNEL_COUNT);
+            for (size_t i = 1; i <= LEG_CHANNEL_COUNT; i++) {
                 log_entry += "P" + std::to_string(i) + "=" + 
                            std::to_string(pressures[i-1]) + "bar ";
                 
-                if (pressures[i-1] < target_pressure) {
-                    all_above_target = false;
-                }
-                
                 if (pressures[i-1] < min_pressure) {
                     min_pressure = pressures[i-1];
                 }
@@ -904,27 +1327,45 @@ TestResult EtherCATMaster::executeSupportTest(float target_pressure, int timeout
                 progress_callback(result);
             }
             
-            // 检查是否所有传感器都达到目标压力
-            if (all_above_target) {
-                target_reached = true;
-                log(LogLevel::LOG_INFO, "SupportTest", 
-                    "支撑测试达到目标压力 " + std::to_string(target_pressure) + " bar", cycle_number);
+            // 等待下一次检查，期间轮询周期线程发布的越过事件
+            for (int waited = 0; waited < CHECK_INTERVAL_MS && !target_reached; waited += EVENT_POLL_MS) {
+                target_reached = getPressureTargetEvent(target_arm_id, target_event);
+                if (!target_reached) {
+                    clock->sleepFor(msToNs(EVENT_POLL_MS));
+                }
+            }
+            if (target_reached) {
                 break;
             }
-            
-            // 等待下一次检查
-            std::this_thread::sleep_for(std::chrono::milliseconds(CHECK_INTERVAL_MS));
         }
         
-        // 第四步：关闭通道1（支撑控制）
-        if (!setRelayChannel(1, false)) {
+        // 撤防后再查一次，避免遗漏退出循环前刚发生的越过
+        disarmPressureTarget();
+        if (!target_reached) {
+            target_reached = getPressureTargetEvent(target_arm_id, target_event);
+        }
+        if (target_reached) {
+            convertChannelsToPressure(target_event.analog_raw, pressures.data(), LEG_CHANNEL_COUNT);
+            result.target_cycle = target_event.cycle;
+            result.target_timestamp_ns = target_event.timestamp_ns;
+            log(LogLevel::LOG_INFO, "SupportTest", 
+                "支撑测试达到目标压力 " + std::to_string(target_pressure) + " bar (周期 " +
+                std::to_string(target_event.cycle) + ")", cycle_number);
+        }
+        
+        // 第四步：关闭通道1（支撑控制）；总线中断时全部继电器已由监视线程断开
+        if (!bus_lost && !setRelayChannel(1, false)) {
             log(LogLevel::LOG_WARNING, "SupportTest", "无法关闭通道1", cycle_number);
         }
         
         // 设置最终结果
-        auto end_time = std::chrono::steady_clock::now();
+        auto end_time = clockNow();
         result.elapsed_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
             end_time - start_time).count();
+        if (target_reached) {
+            // 按越过阈值的周期计时，而不是按测试线程发现的时刻
+            result.elapsed_time_ms = static_cast<int>((result.target_timestamp_ns - start_ns) / 1000000);
+        }
         result.final_pressures = pressures;
         
         if (target_reached && !test_cancelled.load()) {
@@ -933,6 +1374,12 @@ TestResult EtherCATMaster::executeSupportTest(float target_pressure, int timeout
             result.message = "支撑测试成功完成";
             log(LogLevel::LOG_INFO, "SupportTest", 
                 "支撑测试成功，耗时 " + std::to_string(result.elapsed_time_ms) + "ms", cycle_number);
+        } else if (bus_lost) {
+            result.status = TestStatus::TEST_FAILED;
+            result.success = false;
+            result.message = "总线中断";
+            log(LogLevel::LOG_WARNING, "SupportTest",
+                "支撑测试因总线中断未完成，耗时 " + std::to_string(result.elapsed_time_ms) + "ms", cycle_number);
         } else if (!test_cancelled.load()) {
             result.status = TestStatus::TEST_COMPLETED;
             result.success = false;
@@ -957,7 +1404,8 @@ TestResult EtherCATMaster::executeRetractTest(float target_pressure, int timeout
     TestResult result;
     result.status = TestStatus::TEST_RUNNING;
     
-    auto start_time = std::chrono::steady_clock::now();
+    auto start_time = clockNow();
+    int64_t start_ns = clock->nowNs();
     
     try {
         if (progress_callback) {
@@ -975,33 +1423,58 @@ TestResult EtherCATMaster::executeRetractTest(float target_pressure, int timeout
         }
         
         // 第一步：确保通道1（支撑控制）关闭
-        if (!setRelayChannel(1, false)) {
+        RelayCommandResult relay_result;
+        if (!setRelayChannelConfirmed(1, false, 200, &relay_result)) {
             result.status = TestStatus::TEST_FAILED;
             result.success = false;
             result.message = "无法关闭通道1";
             log(LogLevel::LOG_ERROR, "RetractTest", "无法关闭通道1", cycle_number);
             return result;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        log(LogLevel::LOG_DEBUG, "RetractTest", "通道1已关闭 (发送周期 " +
+            std::to_string(relay_result.sent_cycle) + ", 确认周期 " +
+            std::to_string(relay_result.confirmed_cycle) + ")", cycle_number);
         
         // 第二步：打开通道2（收回控制）
-        if (!setRelayChannel(2, true)) {
+        if (!setRelayChannelConfirmed(2, true, 200, &relay_result)) {
             result.status = TestStatus::TEST_FAILED;
             result.success = false;
             result.message = "无法打开通道2";
             log(LogLevel::LOG_ERROR, "RetractTest", "无法打开通道2", cycle_number);
             return result;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        log(LogLevel::LOG_DEBUG, "RetractTest", "通道2已打开 (发送周期 " +
+            std::to_string(relay_result.sent_cycle) + ", 确认周期 " +
+            std::to_string(relay_result.confirmed_cycle) + ")", cycle_number);
+        
+        // 第三步：周期内监视目标压力，越过阈值的周期即由周期线程断开通道2
+        uint32_t target_arm_id = armPressureTarget(PressureTargetMode::TARGET_ALL_BELOW, target_pressure, 0x02);
+        if (target_arm_id == 0) {
+            setRelayChannel(2, false);
+            result.status = TestStatus::TEST_FAILED;
+            result.success = false;
+            result.message = "无法布防目标压力监视";
+            log(LogLevel::LOG_ERROR, "RetractTest", "无法布防目标压力监视", cycle_number);
+            return result;
+        }
         
-        // 第三步：实时监控压力传感器
         bool target_reached = false;
-        std::vector<float> pressures(4, 0.0f);
-        const int CHECK_INTERVAL_MS = 100;
+        PressureTargetEvent target_event;
+        std::vector<float> pressures(LEG_CHANNEL_COUNT, 0.0f);
+        const int CHECK_INTERVAL_MS = 100;  // 进度刷新间隔
+        const int EVENT_POLL_MS = 5;        // 越过事件轮询间隔（继电器已在周期内断开，只影响测试结束的延迟）
+        bool bus_lost = false;
         
         while (!test_cancelled.load()) {
+            // 总线中断后过程数据不再更新，不按过时的压力继续监视
+            if (!bus_ready) {
+                bus_lost = true;
+                log(LogLevel::LOG_WARNING, "RetractTest", "总线中断，停止监视", cycle_number);
+                break;
+            }
+            
             // 检查超时
-            auto current_time = std::chrono::steady_clock::now();
+            auto current_time = clockNow();
             auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                 current_time - start_time).count();
             
@@ -1012,19 +1485,15 @@ TestResult EtherCATMaster::executeRetractTest(float target_pressure, int timeout
             }
             
             // 读取所有压力传感器
-            bool all_below_target = true;
             float max_pressure = 0.0f;
             
             std::string log_entry = "压力传感器: ";
-            for (int i = 1; i <= 4; i++) {
-                pressures[i-1] = readAnalogInputAsPressure(i);
+            ProcessImageSnapshot snapshot = getProcessImageSnapshot();
+            convertChannelsToPressure(snapshot.analog_raw, pressures.data(), LEG_CHANNEL_COUNT);
+            for (size_t i = 1; i <= LEG_CHANNEL_COUNT; i++) {
                 log_entry += "P" + std::to_string(i) + "=" + 
                            std::to_string(pressures[i-1]) + "bar ";
                 
-                if (pressures[i-1] >= target_pressure) {
-                    all_below_target = false;
-                }
-                
                 if (pressures[i-1] > max_pressure) {
                     max_pressure = pressures[i-1];
                 }
@@ -1041,27 +1510,45 @@ TestResult EtherCATMaster::executeRetractTest(float target_pressure, int timeout
                 progress_callback(result);
             }
             
-            // 检查是否所有传感器都低于目标压力
-            if (all_below_target) {
-                target_reached = true;
-                log(LogLevel::LOG_INFO, "RetractTest", 
-                    "收回测试达到目标压力 < " + std::to_string(target_pressure) + " bar", cycle_number);
+            // 等待下一次检查，期间轮询周期线程发布的越过事件
+            for (int waited = 0; waited < CHECK_INTERVAL_MS && !target_reached; waited += EVENT_POLL_MS) {
+                target_reached = getPressureTargetEvent(target_arm_id, target_event);
+                if (!target_reached) {
+                    clock->sleepFor(msToNs(EVENT_POLL_MS));
+                }
+            }
+            if (target_reached) {
                 break;
             }
-            
-            // 等待下一次检查
-            std::this_thread::sleep_for(std::chrono::milliseconds(CHECK_INTERVAL_MS));
         }
         
-        // 第四步：关闭通道2（收回控制）
-        if (!setRelayChannel(2, false)) {
+        // 撤防后再查一次，避免遗漏退出循环前刚发生的越过
+        disarmPressureTarget();
+        if (!target_reached) {
+            target_reached = getPressureTargetEvent(target_arm_id, target_event);
+        }
+        if (target_reached) {
+            convertChannelsToPressure(target_event.analog_raw, pressures.data(), LEG_CHANNEL_COUNT);
+            result.target_cycle = target_event.cycle;
+            result.target_timestamp_ns = target_event.timestamp_ns;
+            log(LogLevel::LOG_INFO, "RetractTest", 
+                "收回测试达到目标压力 < " + std::to_string(target_pressure) + " bar (周期 " +
+                std::to_string(target_event.cycle) + ")", cycle_number);
+        }
+        
+        // 第四步：关闭通道2（收回控制）；总线中断时全部继电器已由监视线程断开
+        if (!bus_lost && !setRelayChannel(2, false)) {
             log(LogLevel::LOG_WARNING, "RetractTest", "无法关闭通道2", cycle_number);
         }
         
         // 设置最终结果
-        auto end_time = std::chrono::steady_clock::now();
+        auto end_time = clockNow();
         result.elapsed_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
             end_time - start_time).count();
+        if (target_reached) {
+            // 按越过阈值的周期计时，而不是按测试线程发现的时刻
+            result.elapsed_time_ms = static_cast<int>((result.target_timestamp_ns - start_ns) / 1000000);
+        }
         result.final_pressures = pressures;
         
         if (target_reached && !test_cancelled.load()) {
@@ -1070,6 +1557,12 @@ TestResult EtherCATMaster::executeRetractTest(float target_pressure, int timeout
             result.message = "收回测试成功完成";
             log(LogLevel::LOG_INFO, "RetractTest", 
                 "收回测试成功，耗时 " + std::to_string(result.elapsed_time_ms) + "ms", cycle_number);
+        } else if (bus_lost) {
+            result.status = TestStatus::TEST_FAILED;
+            result.success = false;
+            result.message = "总线中断";
+            log(LogLevel::LOG_WARNING, "RetractTest",
+                "收回测试因总线中断未完成，耗时 " + std::to_string(result.elapsed_time_ms) + "ms", cycle_number);
         } else if (!test_cancelled.load()) {
             result.status = TestStatus::TEST_COMPLETED;
             result.success = false;
@@ -1089,262 +1582,398 @@ TestResult EtherCATMaster::executeRetractTest(float target_pressure, int timeout
 }
 
 bool EtherCATMaster::configureSlaves() {
-    std::cout << "配置从站和PDO映射..." << std::endl;
+    std::cout << "配置从站和PDO映射 (拓扑: " << topology.getSource() << ")..." << std::endl;
     
-    // 配置 EK1100 (Slave 0) - 耦合器 (无PDO)
-    std::cout << "配置 EK1100 耦合器 (位置 0)..." << std::endl;
-    auto config0 = ecrt_master_slave_config(master, 0, 0, EK1100_VENDOR_ID, EK1100_PRODUCT_CODE);
-    if (!config0) {
-        std::cerr << "错误: 无法配置 EK1100 耦合器 (位置 0)" << std::endl;
-        return false;
+    const auto& slaves = topology.getSlaves();
+    std::vector<bool> skipped(slaves.size(), false);
+    std::vector<size_t> configs;
+    for (size_t i = 0; i < sdo_request_count; i++) {
+        sdo_requests[i].backend_request.store(-1);
     }
-    slave_configs.push_back(config0);
-    std::cout << "EK1100 配置成功" << std::endl;
-    
-    // 配置 EL1008 (Slave 1) - 数字输入
-    std::cout << "配置 EL1008 从站 (位置 1)..." << std::endl;
-    auto config1 = ecrt_master_slave_config(master, 0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE);
-    if (!config1) {
-        std::cerr << "错误: 无法配置 EL1008 从站 (位置 1)" << std::endl;
-        return false;
+    for (size_t i = 0; i < slaves.size(); i++) {
+        const TopologySlave& slave = slaves[i];
+        // 扫描确认不在位或身份不符的可选从站直接跳过，不为其创建配置
+        const SlaveCheckEntry* checked = topology_check.find(i);
+        if (slave.optional && checked && checked->result != SlaveCheckResult::SLAVE_OK) {
+            std::cout << "跳过 " << slave.name << " 从站 (位置 " << slave.position << ")：总线上不在位" << std::endl;
+            skipped[i] = true;
+            continue;
+        }
+        std::cout << "配置 " << slave.name << " 从站 (位置 " << slave.position << ")..." << std::endl;
+        if (!backend->configureSlave(slave.alias, slave.position, slave.vendor_id, slave.product_code,
+                                     topology.getSyncs(slave))) {
+            if (slave.optional) {
+                // 非关键从站，不返回 false
+                std::cerr << "警告: 无法配置 " << slave.name << " 从站 (位置 " << slave.position << ")，继续..." << std::endl;
+                continue;
+            }
+            std::cerr << "错误: 无法配置 " << slave.name << " 从站 (位置 " << slave.position << ") 或 PDO 映射" << std::endl;
+            return false;
+        }
+        createBackendSdoRequests(slave.position, configs.size());
+        configs.push_back(i);
+        std::cout << slave.name << " 配置成功" << std::endl;
     }
-    slave_configs.push_back(config1);
-    
-    // 配置 EL1008 PDO 条目
-    ec_pdo_entry_info_t slave_1_pdo_entries[] = {
-        {0x6000, 0x01, 1}, /* Input */
-        {0x6010, 0x01, 1}, /* Input */
-        {0x6020, 0x01, 1}, /* Input */
-        {0x6030, 0x01, 1}, /* Input */
-        {0x6040, 0x01, 1}, /* Input */
-        {0x6050, 0x01, 1}, /* Input */
-        {0x6060, 0x01, 1}, /* Input */
-        {0x6070, 0x01, 1}, /* Input */
-    };
-
-    ec_pdo_info_t slave_1_pdos[] = {
-        {0x1a00, 1, slave_1_pdo_entries + 0}, /* Channel 1 */
-        {0x1a01, 1, slave_1_pdo_entries + 1}, /* Channel 2 */
-        {0x1a02, 1, slave_1_pdo_entries + 2}, /* Channel 3 */
-        {0x1a03, 1, slave_1_pdo_entries + 3}, /* Channel 4 */
-        {0x1a04, 1, slave_1_pdo_entries + 4}, /* Channel 5 */
-        {0x1a05, 1, slave_1_pdo_entries + 5}, /* Channel 6 */
-        {0x1a06, 1, slave_1_pdo_entries + 6}, /* Channel 7 */
-        {0x1a07, 1, slave_1_pdo_entries + 7}, /* Channel 8 */
-    };
-
-    ec_sync_info_t slave_1_syncs[] = {
-        {0, EC_DIR_INPUT, 8, slave_1_pdos, EC_WD_DISABLE},
-        {0xff, EC_DIR_INVALID, 0, NULL, EC_WD_DISABLE}
-    };
-    
-    if (ecrt_slave_config_pdos(config1, EC_END, slave_1_syncs)) {
-        std::cerr << "错误: 无法配置 EL1008 PDO 映射" << std::endl;
-        return false;
-    }
-    std::cout << "EL1008 配置成功" << std::endl;
-
-    // 配置 EL3074 (Slave 2) - 模拟输入
-    std::cout << "配置 EL3074 从站 (位置 2)..." << std::endl;
-    auto config2 = ecrt_master_slave_config(master, 0, 2, EL3074_VENDOR_ID, EL3074_PRODUCT_CODE);
-    if (!config2) {
-        std::cerr << "错误: 无法配置 EL3074 从站 (位置 2)" << std::endl;
-        return false;
-    }
-    slave_configs.push_back(config2);
-    
-    // 配置 EL3074 PDO 条目
-    ec_pdo_entry_info_t slave_2_pdo_entries[] = {
-        {0x6000, 0x01, 1}, /* Underrange */
-        {0x6000, 0x02, 1}, /* Overrange */
-        {0x6000, 0x03, 2}, /* Limit 1 */
-        {0x6000, 0x05, 2}, /* Limit 2 */
-        {0x6000, 0x07, 1}, /* Error */
-        {0x0000, 0x00, 7}, /* Gap */
-        {0x6000, 0x0f, 1}, /* TxPDO State */
-        {0x6000, 0x10, 1}, /* TxPDO Toggle */
-        {0x6000, 0x11, 16}, /* Value */
-        {0x6010, 0x01, 1}, /* Underrange */
-        {0x6010, 0x02, 1}, /* Overrange */
-        {0x6010, 0x03, 2}, /* Limit 1 */
-        {0x6010, 0x05, 2}, /* Limit 2 */
-        {0x6010, 0x07, 1}, /* Error */
-        {0x0000, 0x00, 7}, /* Gap */
-        {0x6010, 0x0f, 1}, /* TxPDO State */
-        {0x6010, 0x10, 1}, /* TxPDO Toggle */
-        {0x6010, 0x11, 16}, /* Value */
-        {0x6020, 0x01, 1}, /* Underrange */
-        {0x6020, 0x02, 1}, /* Overrange */
-        {0x6020, 0x03, 2}, /* Limit 1 */
-        {0x6020, 0x05, 2}, /* Limit 2 */
-        {0x6020, 0x07, 1}, /* Error */
-        {0x0000, 0x00, 7}, /* Gap */
-        {0x6020, 0x0f, 1}, /* TxPDO State */
-        {0x6020, 0x10, 1}, /* TxPDO Toggle */
-        {0x6020, 0x11, 16}, /* Value */
-        {0x6030, 0x01, 1}, /* Underrange */
-        {0x6030, 0x02, 1}, /* Overrange */
-        {0x6030, 0x03, 2}, /* Limit 1 */
-        {0x6030, 0x05, 2}, /* Limit 2 */
-        {0x6030, 0x07, 1}, /* Error */
-        {0x0000, 0x00, 7}, /* Gap */
-        {0x6030, 0x0f, 1}, /* TxPDO State */
-        {0x6030, 0x10, 1}, /* TxPDO Toggle */
-        {0x6030, 0x11, 16}, /* Value */
-    };
-
-    ec_pdo_info_t slave_2_pdos[] = {
-        {0x1a00, 9, slave_2_pdo_entries + 0}, /* AI TxPDO-Map Standard Ch.1 */
-        {0x1a02, 9, slave_2_pdo_entries + 9}, /* AI TxPDO-Map Standard Ch.2 */
-        {0x1a04, 9, slave_2_pdo_entries + 18}, /* AI TxPDO-Map Standard Ch.3 */
-        {0x1a06, 9, slave_2_pdo_entries + 27}, /* AI TxPDO-Map Standard Ch.4 */
-    };
 
-    ec_sync_info_t slave_2_syncs[] = {
-        {0, EC_DIR_OUTPUT, 0, NULL, EC_WD_DISABLE},
-        {1, EC_DIR_INPUT, 0, NULL, EC_WD_DISABLE},
-        {2, EC_DIR_OUTPUT, 0, NULL, EC_WD_DISABLE},
-        {3, EC_DIR_INPUT, 4, slave_2_pdos, EC_WD_DISABLE},
-        {0xff, EC_DIR_INVALID, 0, NULL, EC_WD_DISABLE}
-    };
-    
-    if (ecrt_slave_config_pdos(config2, EC_END, slave_2_syncs)) {
-        std::cerr << "错误: 无法配置 EL3074 PDO 映射" << std::endl;
+    // 每个域由一个或多个同类端子提供，注册项由端子布局生成
+    std::cout << "注册PDO条目到域..." << std::endl;
+    std::vector<ec_pdo_entry_reg_t> domain_regs[PROCESS_DOMAIN_COUNT];
+    if (!bindTerminals(ProcessDomainId::DOMAIN_ANALOG_IN, analog_terminals, MAX_ANALOG_CHANNELS, skipped,
+                       domain_regs[static_cast<size_t>(ProcessDomainId::DOMAIN_ANALOG_IN)]) ||
+        !bindTerminals(ProcessDomainId::DOMAIN_DIGITAL_IN, digital_terminals, MAX_DIGITAL_INPUTS, skipped,
+                       domain_regs[static_cast<size_t>(ProcessDomainId::DOMAIN_DIGITAL_IN)]) ||
+        !bindTerminals(ProcessDomainId::DOMAIN_RELAY_OUT, relay_terminals, MAX_RELAY_CHANNELS, skipped,
+                       domain_regs[static_cast<size_t>(ProcessDomainId::DOMAIN_RELAY_OUT)])) {
         return false;
     }
-    std::cout << "EL3074 配置成功" << std::endl;
+    analog_channel_count = analog_terminals.channelCount();
+    digital_input_count = digital_terminals.channelCount();
+    relay_channel_count = relay_terminals.channelCount();
+    relay_channel_mask = static_cast<uint8_t>((1u << relay_channel_count) - 1);
+
+    for (size_t i = 0; i < PROCESS_DOMAIN_COUNT; i++) {
+        domain_regs[i].push_back(ec_pdo_entry_reg_t());  // 结束标记
+        if (!backend->registerPdoEntries(domains[i].domain, domain_regs[i].data())) {
+            std::cerr << "错误: 无法注册 PDO 条目到域 " << getProcessDomainName(static_cast<ProcessDomainId>(i)) << std::endl;
+            return false;
+        }
+    }
 
-    // 配置 EL2634 (Slave 3) - 继电器输出
-    std::cout << "配置 EL2634 从站 (位置 3)..." << std::endl;
-    auto config3 = ecrt_master_slave_config(master, 0, 3, EL2634_VENDOR_ID, EL2634_PRODUCT_CODE);
-    if (!config3) {
-        std::cerr << "错误: 无法配置 EL2634 从站 (位置 3)" << std::endl;
+    // 各通道的位位置在编译期按通道 1 从字节边界开始计算
+    if (!verifyTerminals(ProcessDomainId::DOMAIN_ANALOG_IN, analog_terminals) ||
+        !verifyTerminals(ProcessDomainId::DOMAIN_DIGITAL_IN, digital_terminals) ||
+        !verifyTerminals(ProcessDomainId::DOMAIN_RELAY_OUT, relay_terminals)) {
         return false;
     }
-    slave_configs.push_back(config3);
-    
-    // 配置 EL2634 PDO 条目
-    ec_pdo_entry_info_t slave_3_pdo_entries[] = {
-        {0x7000, 0x01, 1}, /* Output */
-        {0x7010, 0x01, 1}, /* Output */
-        {0x7020, 0x01, 1}, /* Output */
-        {0x7030, 0x01, 1}, /* Output */
-    };
 
-    ec_pdo_info_t slave_3_pdos[] = {
-        {0x1600, 1, slave_3_pdo_entries + 0}, /* Channel 1 */
-        {0x1601, 1, slave_3_pdo_entries + 1}, /* Channel 2 */
-        {0x1602, 1, slave_3_pdo_entries + 2}, /* Channel 3 */
-        {0x1603, 1, slave_3_pdo_entries + 3}, /* Channel 4 */
-    };
+    std::cout << "从站配置完成: " << configs.size() << " 个从站已配置" << std::endl;
+    publishSlaveConfigs(std::move(configs));
+    return true;
+}
 
-    ec_sync_info_t slave_3_syncs[] = {
-        {0, EC_DIR_OUTPUT, 4, slave_3_pdos, EC_WD_ENABLE},
-        {0xff, EC_DIR_INVALID, 0, NULL, EC_WD_DISABLE}
-    };
-    
-    if (ecrt_slave_config_pdos(config3, EC_END, slave_3_syncs)) {
-        std::cerr << "错误: 无法配置 EL2634 PDO 映射" << std::endl;
-        return false;
+// 域通道 c 由第 (c-1)/N 个端子的第 (c-1)%N+1 路提供（N 为端子通道数），各端子通道 1 的绑定确定该端子的从站；
+// 其余通道的绑定须与端子布局一致，每个绑定的通道注册一个条目
+template <typename T>
+bool EtherCATMaster::bindTerminals(ProcessDomainId domain, TerminalArray<T>& images, size_t max_channels,
+                                   const std::vector<bool>& skipped, std::vector<ec_pdo_entry_reg_t>& regs) {
+    using Array = TerminalArray<T>;
+    const std::string name = getProcessDomainName(domain);
+    const auto& bindings = topology.getBindings();
+    size_t terminal_count = 0;
+    for (const auto& binding : bindings) {
+        if (binding.domain == static_cast<uint8_t>(domain)) {
+            terminal_count = std::max(terminal_count, Array::terminalOf(binding.channel) + 1);
+        }
     }
-    std::cout << "EL2634 配置成功" << std::endl;
-    
-    // 配置 EL6001 (Slave 4) - RS232接口 (无PDO)
-    std::cout << "配置 EL6001 RS232接口 (位置 4)..." << std::endl;
-    auto config4 = ecrt_master_slave_config(master, 0, 4, EL6001_VENDOR_ID, EL6001_PRODUCT_CODE);
-    if (!config4) {
-        std::cerr << "警告: 无法配置 EL6001 从站 (位置 4)，继续..." << std::endl;
-        // 不返回 false，因为这不是关键从站
-    } else {
-        slave_configs.push_back(config4);
-        std::cout << "EL6001 配置成功" << std::endl;
+    if (terminal_count == 0) {
+        std::cerr << "错误: 拓扑缺少域 " << name << " 的绑定" << std::endl;
+        return false;
     }
-    
-    // 配置 EL6751 (Slave 5) - CANopen主站 (无PDO)
-    std::cout << "配置 EL6751 CANopen主站 (位置 5)..." << std::endl;
-    auto config5 = ecrt_master_slave_config(master, 0, 5, EL6751_VENDOR_ID, EL6751_PRODUCT_CODE);
-    if (!config5) {
-        std::cerr << "警告: 无法配置 EL6751 从站 (位置 5)，继续..." << std::endl;
-        // 不返回 false，因为这不是关键从站
-    } else {
-        slave_configs.push_back(config5);
-        std::cout << "EL6751 配置成功" << std::endl;
+    if (terminal_count * T::channel_count > max_channels) {
+        std::cerr << "错误: 域 " << name << " 需要 " << terminal_count << " 个 " << T::name
+                  << "，超过 " << max_channels << " 通道的上限" << std::endl;
+        return false;
     }
 
-    // 注册PDO条目到域
-    std::cout << "注册PDO条目到域..." << std::endl;
+    std::vector<const TopologyBinding*> firsts(terminal_count, nullptr);
+    for (const auto& binding : bindings) {
+        if (binding.domain == static_cast<uint8_t>(domain) && Array::localChannel(binding.channel) == 1) {
+            firsts[Array::terminalOf(binding.channel)] = &binding;
+        }
+    }
+    for (size_t t = 0; t < terminal_count; t++) {
+        if (!firsts[t]) {
+            std::cerr << "错误: 拓扑缺少域 " << name << " 通道 " << t * T::channel_count + 1 << " 的绑定" << std::endl;
+            return false;
+        }
+        const TopologySlave& slave = topology.getSlaves()[firsts[t]->slave];
+        if (skipped[firsts[t]->slave]) {
+            std::cerr << "错误: 域 " << name << " 绑定的从站 " << slave.name << " 不在位" << std::endl;
+            return false;
+        }
+        if (slave.vendor_id != T::vendor_id || slave.product_code != T::product_code) {
+            std::cerr << "错误: 域 " << name << " 绑定的从站 " << slave.name << " 不是 " << T::name << std::endl;
+            return false;
+        }
+        if (!TerminalImage<T>::matchesMapping(topology.getSyncs(slave))) {
+            std::cerr << "错误: 从站 " << slave.name << " 的 PDO 映射与 " << T::name << " 的布局不一致" << std::endl;
+            return false;
+        }
+        for (size_t u = 0; u < t; u++) {
+            if (firsts[u]->slave == firsts[t]->slave) {
+                std::cerr << "错误: 域 " << name << " 的多组通道绑定到同一个从站 " << slave.name << std::endl;
+                return false;
+            }
+        }
+    }
+    for (const auto& binding : bindings) {
+        if (binding.domain != static_cast<uint8_t>(domain)) continue;
+        size_t local = Array::localChannel(binding.channel);
+        if (binding.slave != firsts[Array::terminalOf(binding.channel)]->slave ||
+            binding.index != PdoLayout<T>::objectIndex(local) || binding.subindex != T::value_subindex) {
+            std::cerr << "错误: 域 " << name << " 通道 " << static_cast<int>(binding.channel)
+                      << " 的绑定与 " << T::name << " 的布局不一致" << std::endl;
+            return false;
+        }
+    }
 
-    ec_pdo_entry_reg_t domain_regs[] = {
-        // EL1008 - 数字输入 (注册所有8个通道)
-        {0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE, 0x6000, 1, &off_dig_in[0], NULL},
-        // {0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE, 0x6010, 1, &off_dig_in[1], NULL},
-        // {0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE, 0x6020, 1, &off_dig_in[2], NULL},
-        // {0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE, 0x6030, 1, &off_dig_in[3], NULL},
-        // {0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE, 0x6040, 1, &off_dig_in[4], NULL},
-        // {0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE, 0x6050, 1, &off_dig_in[5], NULL},
-        // {0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE, 0x6060, 1, &off_dig_in[6], NULL},
-        // {0, 1, EL1008_VENDOR_ID, EL1008_PRODUCT_CODE, 0x6070, 1, &off_dig_in[7], NULL},
-        
-        // EL3074 - 模拟输入 (只注册模拟值，子索引0x11)
-        {0, 2, EL3074_VENDOR_ID, EL3074_PRODUCT_CODE, 0x6000, 0x11, &off_ai_val[0], NULL},
-        {0, 2, EL3074_VENDOR_ID, EL3074_PRODUCT_CODE, 0x6010, 0x11, &off_ai_val[1], NULL},
-        {0, 2, EL3074_VENDOR_ID, EL3074_PRODUCT_CODE, 0x6020, 0x11, &off_ai_val[2], NULL},
-        {0, 2, EL3074_VENDOR_ID, EL3074_PRODUCT_CODE, 0x6030, 0x11, &off_ai_val[3], NULL},
-        
-        // EL2634 - 继电器输出 (注册所有4个通道)
-        {0, 3, EL2634_VENDOR_ID, EL2634_PRODUCT_CODE, 0x7000, 1, &off_relay_out[0], NULL},
-        // {0, 3, EL2634_VENDOR_ID, EL2634_PRODUCT_CODE, 0x7010, 1, &off_relay_out[1], NULL},
-        // {0, 3, EL2634_VENDOR_ID, EL2634_PRODUCT_CODE, 0x7020, 1, &off_relay_out[2], NULL},
-        // {0, 3, EL2634_VENDOR_ID, EL2634_PRODUCT_CODE, 0x7030, 1, &off_relay_out[3], NULL},
-        
-        {}  // 结束标记
-    };
-    
-    if (ecrt_domain_reg_pdo_entry_list(domain, domain_regs)) {
-        std::cerr << "错误: 无法注册 PDO 条目到域" << std::endl;
-        return false;
+    // 注册项指向各端子映像，生成注册项之前确定端子数
+    images.resize(terminal_count);
+    for (const auto& binding : bindings) {
+        if (binding.domain != static_cast<uint8_t>(domain)) continue;
+        const TopologySlave& slave = topology.getSlaves()[binding.slave];
+        TerminalImage<T>& image = images[Array::terminalOf(binding.channel)];
+        size_t local = Array::localChannel(binding.channel);
+        regs.push_back(image.registration(slave.alias, slave.position, local));
+        // 状态位（EL3074 的 Underrange..TxPDO Toggle）与过程值一起注册，每周期随过程值解码
+        if constexpr (PdoLayout<T>::statusBits() > 0) {
+            image.statusRegistrations(slave.alias, slave.position, local, regs);
+        }
     }
+    return true;
+}
 
-    std::cout << "从站配置完成: " << slave_configs.size() << " 个从站已配置" << std::endl;
+// 注册结果须符合编译期布局：各端子通道 1 从字节边界开始，其余通道在布局给出的位置上
+template <typename T>
+bool EtherCATMaster::verifyTerminals(ProcessDomainId domain, const TerminalArray<T>& images) {
+    const std::string name = getProcessDomainName(domain);
+    for (size_t t = 0; t < images.size(); t++) {
+        const TerminalImage<T>& image = images[t];
+        if (!image.isAligned()) {
+            std::cerr << "错误: 域 " << name << " 的第 " << t + 1 << " 个 " << T::name
+                      << " 过程数据未从字节边界开始" << std::endl;
+            return false;
+        }
+        typename TerminalImage<T>::CheckedEntry mismatch;
+        if (!image.matchesRegistration(mismatch)) {
+            std::cerr << "错误: 域 " << name << " 通道 " << t * T::channel_count + mismatch.channel << " 条目 0x"
+                      << std::hex << PdoLayout<T>::objectIndex(mismatch.channel) << ":"
+                      << static_cast<int>(mismatch.subindex) << std::dec << " 的注册位置与 " << T::name
+                      << " 的布局不一致" << std::endl;
+            return false;
+        }
+    }
     return true;
 }
+
 // ==================== 修改其他关键函数以支持日志 ====================
-bool EtherCATMaster::start() {
-    if (!initialized) {
-        log(LogLevel::LOG_ERROR, "Master", "主站未初始化");
+bool EtherCATMaster::validateRealtimeOptions(const RealtimeOptions& options) {
+    if (options.cycle_period_ns < MIN_CYCLE_PERIOD_NS) {
+        log(LogLevel::LOG_ERROR, "Master", "周期过短: " + std::to_string(options.cycle_period_ns) +
+            "ns，最小 " + std::to_string(MIN_CYCLE_PERIOD_NS) + "ns");
         return false;
     }
 
-    log(LogLevel::LOG_INFO, "Master", "激活 EtherCAT 主站...");
-    
-    // 激活主站
-    if (ecrt_master_activate(master)) {
-        log(LogLevel::LOG_ERROR, "Master", "无法激活主站");
-        current_status = MasterStatus::STATUS_ERROR;
-        return false;
+    for (size_t i = 0; i < PROCESS_DOMAIN_COUNT; i++) {
+        uint32_t divider = options.domain_dividers[i];
+        if (divider < 1 || divider > MAX_DOMAIN_DIVIDER) {
+            log(LogLevel::LOG_ERROR, "Master", "域 " + getProcessDomainName(static_cast<ProcessDomainId>(i)) +
+                " 分频无效: " + std::to_string(divider) + " (范围 1-" + std::to_string(MAX_DOMAIN_DIVIDER) + ")");
+            return false;
+        }
     }
 
-    // 获取域数据
-    domain_data = ecrt_domain_data(domain);
-    if (!domain_data) {
-        log(LogLevel::LOG_ERROR, "Master", "无法获取域数据");
-        current_status = MasterStatus::STATUS_ERROR;
+    if (!options.realtime) {
+        return true;
+    }
+
+    int min_prio = sched_get_priority_min(SCHED_FIFO);
+    int max_prio = sched_get_priority_max(SCHED_FIFO);
+    if (options.sched_priority < min_prio || options.sched_priority > max_prio) {
+        log(LogLevel::LOG_ERROR, "Master", "SCHED_FIFO 优先级无效: " + std::to_string(options.sched_priority) +
+            " (范围 " + std::to_string(min_prio) + "-" + std::to_string(max_prio) + ")");
         return false;
     }
 
+    long cpu_count = sysconf(_SC_NPROCESSORS_CONF);
+    if (options.cpu_core >= 0 && (options.cpu_core >= cpu_count || options.cpu_core >= CPU_SETSIZE)) {
+        log(LogLevel::LOG_ERROR, "Master", "CPU核心号无效: " + std::to_string(options.cpu_core) +
+            " (共 " + std::to_string(cpu_count) + " 个)");
+        return false;
+    }
+
+    if (options.prefault_stack_size > MAX_PREFAULT_STACK_SIZE) {
+        log(LogLevel::LOG_ERROR, "Master", "预缺页栈大小超过上限 " +
+            std::to_string(MAX_PREFAULT_STACK_SIZE) + " 字节");
+        return false;
+    }
+
+    return true;
+}
+
+// 在周期线程内执行：调度策略、CPU绑定、栈预缺页
+// 失败时只记录警告并以普通优先级继续运行
+void EtherCATMaster::setupRealtimeThread() {
+    if (!rt_options.realtime) {
+        return;
+    }
+
+    if (rt_options.cpu_core >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(rt_options.cpu_core, &cpuset);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+        if (err != 0) {
+            log(LogLevel::LOG_WARNING, "Master", "无法绑定周期线程到 CPU " +
+                std::to_string(rt_options.cpu_core) + ": " + std::strerror(err));
+        }
+    }
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = rt_options.sched_priority;
+    int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (err != 0) {
+        log(LogLevel::LOG_WARNING, "Master", std::string("无法设置 SCHED_FIFO 调度 (需要 root 或 CAP_SYS_NICE): ") +
+            std::strerror(err));
+    }
+
+    prefaultStack(rt_options.prefault_stack_size);
+
+    log(LogLevel::LOG_INFO, "Master", "实时周期线程: 周期 " + std::to_string(rt_options.cycle_period_ns / 1000) +
+        "µs, 优先级 " + std::to_string(rt_options.sched_priority) +
+        ", CPU " + (rt_options.cpu_core >= 0 ? std::to_string(rt_options.cpu_core) : std::string("未绑定")));
+}
+
+bool EtherCATMaster::start(const RealtimeOptions& options) {
+    if (!initialized) {
+        log(LogLevel::LOG_ERROR, "Master", "主站未初始化");
+        return false;
+    }
+
+    if (!validateRealtimeOptions(options)) {
+        return false;
+    }
+    rt_options = options;
+
+    // 锁定内存需在激活主站（分配过程数据）和创建周期线程之前完成
+    if (rt_options.realtime && rt_options.lock_memory && !memory_locked) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            memory_locked = true;
+        } else {
+            log(LogLevel::LOG_WARNING, "Master", std::string("mlockall 失败: ") + std::strerror(errno));
+        }
+    }
+
+    log(LogLevel::LOG_INFO, "Master", "激活 EtherCAT 主站...");
+    
+    // 激活主站
+    int64_t activate_begin_ns = monotonicNowNs();
+    if (!backend->activate()) {
+        log(LogLevel::LOG_ERROR, "Master", "无法激活主站");
+        current_status = MasterStatus::STATUS_ERROR;
+        return false;
+    }
+    uint64_t fingerprint;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        startup_timing.activate_us = (monotonicNowNs() - activate_begin_ns) / 1000;
+        fingerprint = startup_timing.fingerprint;
+    }
+    
+    // 本次从站配置在周期线程启动之前导出，必需从站全部进入 OP 后才写入热启动缓存，供下次启动使用
+    std::vector<uint8_t> warm_start_data;
+    if (!warm_start_cache_path.empty() && !backend->exportWarmStartData(warm_start_data)) {
+        warm_start_data.clear();
+    }
+
+    // 获取各域数据并设置交换分频
+    if (!attachDomains()) {
+        current_status = MasterStatus::STATUS_ERROR;
+        return false;
+    }
+
+    relay_confirm_timeout_cycles = std::max<int64_t>(2, RELAY_CONFIRM_TIMEOUT_NS / rt_options.cycle_period_ns);
+    
+    // 模拟输入采样停滞的时限换算为模拟输入域的交换次数
+    int64_t analog_period_ns = rt_options.cycle_period_ns *
+        rt_options.domain_dividers[static_cast<size_t>(ProcessDomainId::DOMAIN_ANALOG_IN)];
+    analog_stale_exchanges = static_cast<uint32_t>(std::max<int64_t>(2, ANALOG_STALE_TIMEOUT_NS / analog_period_ns));
+    analog_toggle_rt = 0;
+    analog_unchanged_rt.fill(0);
+    input_snapshot_rt.analog_count = static_cast<uint32_t>(analog_channel_count);
+    input_snapshot_rt.digital_count = static_cast<uint32_t>(digital_input_count);
+    
+    // 丢弃上次运行留下的状态字，等待周期线程重新采样
+    published_master_state = 0;
+    published_slave_states = 0;
+    
+    // 中断检测和中断统计不跨运行保留
+    bus_ready = true;
+    bus_interrupted = false;
+    bus_reconfigure_armed = false;
+    bus_offline_slaves = 0;
+    cycle_park_requested = false;
+    cycle_parked = false;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        bus_stats = BusInterruptionStats();
+    }
+    
+    // 超时统计和安全输出状态不跨运行保留
+    overrun_stats_rt = CycleOverrunStats();
+    overrun_stats.store(overrun_stats_rt);
+    overrun_run_max_ns = 0;
+    overrun_run_skipped = 0;
+    safe_outputs_active = false;
+    
+    // 从站进入 OP 的跟踪：周期线程逐周期采样，必需从站全部进入 OP 时由监督线程完成 future
+    startup_required_mask = 0;
+    for (size_t i = 0; i < std::min(slave_configs.size(), MAX_MONITORED_SLAVES); i++) {
+        if (!topology.getSlaves()[slave_configs[i]].optional) {
+            startup_required_mask |= 1u << i;
+        }
+    }
+    startup_states_rt.fill(0);
+    startup_master_state_rt = 0;
+    SlaveStateEvent stale_event;
+    while (slave_state_event_queue.tryPop(stale_event)) {
+    }
+    startup_op_promise = std::promise<uint64_t>();
+    startup_op_future = startup_op_promise.get_future().share();
+    startup_op_reported = false;
+    startup_tracking = true;
+    
     running = true;
     current_status = MasterStatus::STATUS_INITIALIZING;
+    cycle_start_ns = monotonicNowNs();
+    
+    // 周期线程和监督线程参与虚拟时间推进，须在创建线程之前计数
+    clock->addParticipant();
+    clock->addParticipant();
     
     // 启动处理线程
     process_thread = std::thread(&EtherCATMaster::processThreadFunc, this);
     
+    // 启动监督线程
+    supervisor_thread = std::thread(&EtherCATMaster::supervisorThreadFunc, this);
+    
     // 启动任务处理线程
     // task_thread = std::thread(&EtherCATMaster::taskThreadFunc, this);
     
-    // 等待主站进入运行状态（增加等待时间确保从站进入OP状态）
-    if (!waitForOperational(5000)) {
-        log(LogLevel::LOG_WARNING, "Master", "主站未能在5秒内进入运行状态，继续启动...");
+    // 等待必需从站全部进入 OP（事件驱动，进入 OP 的周期即返回）
+    if (waitForOperational(DEFAULT_OPERATIONAL_TIMEOUT_MS)) {
+        saveWarmStartCache(fingerprint, warm_start_data);
+    } else {
+        startup_tracking = false;
+        log(LogLevel::LOG_WARNING, "Master", "必需从站未能在 " + std::to_string(DEFAULT_OPERATIONAL_TIMEOUT_MS / 1000) +
+            " 秒内全部进入 OP，继续启动...");
+    }
+    
+    StartupTiming timing;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        startup_timing.total_us = (monotonicNowNs() - startup_begin_ns) / 1000;
+        timing = startup_timing;
     }
+    std::ostringstream oss;
+    oss << "启动耗时 " << formatDurationUs(timing.total_us) << (timing.warm_start ? " (热启动)" : " (冷启动)")
+        << ": 请求主站 " << formatDurationUs(timing.request_master_us)
+        << "，扫描 " << formatDurationUs(timing.scan_us)
+        << "，配置 " << formatDurationUs(timing.configure_us)
+        << "，激活 " << formatDurationUs(timing.activate_us)
+        << "，进入 OP " << (timing.time_to_op_us < 0 ? std::string("未完成") : formatDurationUs(timing.time_to_op_us));
+    log(LogLevel::LOG_INFO, "Master", oss.str());
     
     log(LogLevel::LOG_INFO, "Master", "EtherCAT 主站已启动并运行");
     std::cout << "[Master] 日志输出完成，准备设置日志文件..." << std::endl;
@@ -1361,31 +1990,71 @@ bool EtherCATMaster::start() {
     return true;
 }
 
+bool EtherCATMaster::attachDomains() {
+    for (size_t i = 0; i < PROCESS_DOMAIN_COUNT; i++) {
+        ProcessDomain& d = domains[i];
+        const std::string name = getProcessDomainName(static_cast<ProcessDomainId>(i));
+        d.data = backend->getDomainData(d.domain);
+        if (!d.data) {
+            log(LogLevel::LOG_ERROR, "Master", "无法获取域数据: " + name);
+            return false;
+        }
+        d.size = backend->getDomainSize(d.domain);
+        if (d.size > DOMAIN_IMAGE_MAX_SIZE) {
+            log(LogLevel::LOG_WARNING, "Master", "域 " + name + " 大小 " + std::to_string(d.size) +
+                " 字节，快照只保存前 " + std::to_string(DOMAIN_IMAGE_MAX_SIZE) + " 字节");
+        }
+        d.divider = rt_options.domain_dividers[i];
+        d.exchanging = false;
+        d.exchange_count = 0;
+        d.wkc_error_count = 0;
+        d.published_state = 0;   // 丢弃上次运行留下的状态字
+        log(LogLevel::LOG_INFO, "Master", "域 " + name + ": " + std::to_string(d.size) + " 字节，周期 " +
+            std::to_string(rt_options.cycle_period_ns * d.divider / 1000) + "µs");
+    }
+    domains_attached = true;
+    return true;
+}
+
+// 线程按 running 回收，不看主站是否仍被请求：热重配置失败后主站未激活，周期线程和监督线程仍在运行。
+// 主站在这里统一释放，热重配置只在重建之前释放旧配置
 void EtherCATMaster::stop() {
-    if (master && running) {
-        log(LogLevel::LOG_INFO, "Master", "正在停止 EtherCAT 主站...");
-        
-        running = false;
-        current_status = MasterStatus::STATUS_STOPPED;
-        
-        // 取消当前测试
+    if (!running && !backend->isMasterRequested()) {
+        return;
+    }
+    log(LogLevel::LOG_INFO, "Master", "正在停止 EtherCAT 主站...");
+    
+    if (running) {
+        // 取消当前测试，避免测试在关闭继电器之后再次开启
         cancelCurrentTest();
         stopReliabilityTest(false);  // 不生成报告
         
-        // 确保所有继电器关闭
-        setAllRelays(false);
+        // 确保所有继电器关闭：命令经周期线程发出，须在清除 running 之前提交并等待确认
+        deenergizeRelaysForStop();
+    }
+    
+    bool was_running = running.exchange(false);
+    if (was_running) {
+        startup_tracking = false;
+        current_status = MasterStatus::STATUS_STOPPED;
         
         // 通知任务线程退出
         task_cv.notify_all();
         
-        // 短暂等待以确保命令执行
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        
         // 等待处理线程结束
         if (process_thread.joinable()) {
             process_thread.join();
         }
         
+        // 等待监督线程结束
+        if (supervisor_thread.joinable()) {
+            supervisor_thread.join();
+        }
+        
+        // 周期线程已退出，未完成的继电器命令和 SDO 读写全部取消
+        cancelPendingRelayCommands();
+        cancelPendingSdoOperations();
+        
         // 等待任务线程结束
         if (task_thread.joinable()) {
             task_thread.join();
@@ -1408,21 +2077,29 @@ void EtherCATMaster::stop() {
                 hotkey_thread.join();
             }
         }
-        
-        ecrt_release_master(master);
-        master = nullptr;
-        domain = nullptr;
-        domain_data = nullptr;
-        slave_configs.clear();
-        initialized = false;
-        
-        // 关闭日志文件
-        if (log_file.is_open()) {
-            log_file.close();
-        }
-        
-        log(LogLevel::LOG_INFO, "Master", "EtherCAT 主站已停止");
     }
+    
+    domains_attached = false;
+    backend->releaseMaster();
+    for (auto& d : domains) {
+        d.domain = -1;
+        d.data = nullptr;
+        d.size = 0;
+    }
+    publishSlaveConfigs(std::vector<size_t>());
+    initialized = false;
+    
+    if (memory_locked) {
+        munlockall();
+        memory_locked = false;
+    }
+    
+    // 关闭日志文件
+    if (log_file.is_open()) {
+        log_file.close();
+    }
+    
+    log(LogLevel::LOG_INFO, "Master", "EtherCAT 主站已停止");
 }
 
 // ==================== 新增功能函数 ====================
@@ -1487,8 +2164,10 @@ bool EtherCATMaster::saveTestResultsToFile(const std::string& filename, const Re
         file << "平均收回时间: " << std::fixed << std::setprecision(1) << stats.avg_retract_time_ms << "ms" << std::endl;
         file << "最大连续支撑失败: " << stats.max_support_failures << std::endl;
         file << "最大连续收回失败: " << stats.max_retract_failures << std::endl;
+        file << "总线中断次数: " << stats.bus_interruptions << std::endl;
+        file << "总线中断累计时长: " << stats.bus_downtime_ms << "ms" << std::endl;
         
-        auto elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(stats.getElapsedTime()).count();
+        auto elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(stats.getElapsedTime(clockNow())).count();
         file << "总耗时: " << elapsed_seconds/3600 << " 小时 " 
              << (elapsed_seconds%3600)/60 << " 分 " 
              << elapsed_seconds%60 << " 秒" << std::endl;
@@ -1515,7 +2194,7 @@ bool EtherCATMaster::saveTestResultsToFile(const std::string& filename, const Re
 }
 
 void EtherCATMaster::printReliabilityTestReport(const ReliabilityTestStats& stats) const {
-    auto elapsed = stats.getElapsedTime();
+    auto elapsed = stats.getElapsedTime(clockNow());
     auto hours = std::chrono::duration_cast<std::chrono::hours>(elapsed).count();
     auto minutes = std::chrono::duration_cast<std::chrono::minutes>(elapsed).count() % 60;
     auto seconds = std::chrono::duration_cast<std::chrono::seconds>(elapsed).count() % 60;
@@ -1535,6 +2214,7 @@ void EtherCATMaster::printReliabilityTestReport(const ReliabilityTestStats& stat
     std::cout << "平均收回时间: " << std::fixed << std::setprecision(1) << stats.avg_retract_time_ms << "ms" << std::endl;
     std::cout << "最大连续支撑失败: " << stats.max_support_failures << std::endl;
     std::cout << "最大连续收回失败: " << stats.max_retract_failures << std::endl;
+    std::cout << "总线中断: " << stats.bus_interruptions << " 次，累计 " << stats.bus_downtime_ms << "ms" << std::endl;
     
     // 显示关键日志数量
     std::cout << "关键日志数量: " << stats.critical_logs.size() << std::endl;
@@ -1548,8 +2228,8 @@ bool EtherCATMaster::setRelayChannel(uint8_t channel, bool state) {
         return false;
     }
 
-    if (channel < 1 || channel > 4) {
-        std::cerr << "错误: 通道号必须在 1-4 范围内" << std::endl;
+    if (channel < 1 || channel > relay_channel_count) {
+        std::cerr << "错误: 通道号必须在 1-" << relay_channel_count << " 范围内" << std::endl;
         return false;
     }
 
@@ -1561,18 +2241,41 @@ bool EtherCATMaster::setRelayChannel(uint8_t channel, bool state) {
     std::cout << "设置继电器通道 " << static_cast<int>(channel) << " 为: " 
               << (state ? "开启" : "关闭") << std::endl;
 
-    // 更新继电器状态缓存
-    uint8_t current_states = relay_states.load();
-    if (state) {
-        current_states |= (1 << (channel - 1));
-    } else {
-        current_states &= ~(1 << (channel - 1));
+    // 提交到命令队列，由周期线程在周期边界应用
+    uint8_t bit = static_cast<uint8_t>(1u << (channel - 1));
+    std::future<RelayCommandResult> future = submitRelayCommand(bit, state ? bit : 0);
+    if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        return future.get().status != RelayCommandStatus::RELAY_CMD_REJECTED;
     }
-    relay_states.store(current_states);
-    
     return true;
 }
 
+bool EtherCATMaster::setRelayChannelConfirmed(uint8_t channel, bool state, int timeout_ms,
+                                              RelayCommandResult* result) {
+    if (channel < 1 || channel > relay_channel_count) {
+        std::cerr << "错误: 通道号必须在 1-" << relay_channel_count << " 范围内" << std::endl;
+        return false;
+    }
+    
+    if (!verifyOperation("设置继电器通道")) {
+        return false;
+    }
+    
+    uint8_t bit = static_cast<uint8_t>(1u << (channel - 1));
+    std::future<RelayCommandResult> future = submitRelayCommand(bit, state ? bit : 0);
+    if (!waitRelayCommand(future, timeout_ms)) {
+        log(LogLevel::LOG_WARNING, "Relay", "继电器通道 " + std::to_string(channel) +
+            " 在 " + std::to_string(timeout_ms) + "ms 内未确认");
+        return false;
+    }
+    
+    RelayCommandResult command_result = future.get();
+    if (result) {
+        *result = command_result;
+    }
+    return command_result.confirmed();
+}
+
 bool EtherCATMaster::setAllRelays(bool state) {
 
     if (!verifyOperation("设置所有继电器")) {
@@ -1584,47 +2287,55 @@ bool EtherCATMaster::setAllRelays(bool state) {
         return false;
     }
 
-    // 更新所有继电器状态
-    uint8_t new_states = state ? 0x0F : 0x00; // 4个通道全部开启或关闭
-    relay_states.store(new_states);
+    // 已绑定的通道全部开启或关闭
+    uint8_t mask = relay_channel_mask;
+    std::future<RelayCommandResult> future = submitRelayCommand(mask, state ? mask : 0x00);
+    if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+        future.get().status == RelayCommandStatus::RELAY_CMD_REJECTED) {
+        return false;
+    }
     
     std::cout << "设置所有继电器为: " << (state ? "开启" : "关闭") << std::endl;
     return true;
 }
 
 void EtherCATMaster::printDomainData() {
-    if (!domain_data) {
+    if (!domains_attached) {
         std::cout << "域数据不可用" << std::endl;
         return;
     }
     
-    std::cout << "=== 域数据 ===" << std::endl;
+    ProcessImageSnapshot snapshot = getProcessImageSnapshot();
+    std::cout << "=== 域数据 (周期 " << snapshot.cycle << ") ===" << std::endl;
     
     // 打印EL1008数字输入状态
-    std::cout << "EL1008 数字输入: ";
-    for (int i = 0; i < 8; i++) {
-        uint8_t* input_data = domain_data + off_dig_in[i];
-        uint8_t di_data = EC_READ_U8(input_data);
-        std::cout << "Ch" << (i+1) << "=" << static_cast<int>(di_data) << " ";
+    std::cout << "EL1008 数字输入: 0x" << std::hex << std::setw((snapshot.digital_count + 3) / 4) << std::setfill('0')
+              << snapshot.digital_inputs << std::dec << std::setfill(' ') << " ";
+    for (size_t i = 0; i < snapshot.digital_count; i++) {
+        std::cout << "Ch" << (i+1) << "=" << (snapshot.digitalInput(i) ? 1 : 0) << " ";
     }
     std::cout << std::endl;
     
     // 打印EL3074压力传感器状态
     std::cout << "EL3074 压力传感器: " << std::endl;
-    for (int i = 0; i < 4; i++) {
-        int16_t raw_value = readAnalogInputPDO(i + 1);
-        float current_value = convertAnalogToCurrent(raw_value);
-        float pressure_value = convertCurrentToPressure(current_value);
-        PressureStatus status = checkPressureStatus(i + 1);
+    AnalogBlock block;
+    convertAnalogBlock(snapshot, block);
+    for (size_t i = 0; i < block.count; i++) {
+        int16_t raw_value = snapshot.analog_raw[i];
+        float current_value = block.currents[i];
+        float pressure_value = block.pressures[i];
+        PressureStatus status = block.status(i);
         
         std::cout << "  Ch" << (i+1) << ": "
                   << "原始值=" << raw_value << ", "
                   << "电流=" << std::fixed << std::setprecision(3) << current_value << "mA, "
                   << "压力=" << std::fixed << std::setprecision(2) << pressure_value << "bar, "
+                  << "状态字=0x" << std::hex << std::setw(4) << std::setfill('0') << snapshot.analog_status[i]
+                  << std::dec << std::setfill(' ') << ", "
                   << "状态=" << getPressureStatusString(status);
         
         // 添加警告标记
-        if (status == PRESSURE_OVERLOAD) {
+        if (status == PRESSURE_OVERLOAD || status == PRESSURE_SENSOR_ERROR || status == PRESSURE_STALE) {
             std::cout << " [危险!]";
         } else if (status == PRESSURE_OVER_RANGE) {
             std::cout << " [警告]";
@@ -1637,12 +2348,24 @@ void EtherCATMaster::printDomainData() {
     // 打印EL2634继电器输出状态
     std::cout << "EL2634 继电器输出: ";
     uint8_t current_states = relay_states.load();
-    for (int i = 0; i < 4; i++) {
+    for (size_t i = 0; i < relay_channel_count; i++) {
         bool state = (current_states & (1 << i)) != 0;
         std::cout << "Ch" << (i+1) << "=" << (state ? "1" : "0") << " ";
     }
     std::cout << std::endl;
     
+    // 打印各域的交换情况
+    for (size_t i = 0; i < PROCESS_DOMAIN_COUNT; i++) {
+        ProcessDomainId id = static_cast<ProcessDomainId>(i);
+        DomainSnapshot domain_snapshot = getDomainSnapshot(id);
+        std::cout << "域 " << getProcessDomainName(id) << ": "
+                  << "分频=" << rt_options.domain_dividers[i] << ", "
+                  << "周期=" << domain_snapshot.cycle << ", "
+                  << "WC=" << domain_snapshot.working_counter << ", "
+                  << "WKC异常=" << domain_snapshot.wkc_error_count << "/" << domain_snapshot.exchange_count
+                  << std::endl;
+    }
+    
     std::cout << "==============" << std::endl;
 }
 
@@ -1655,25 +2378,26 @@ bool EtherCATMaster::toggleRelayChannel(uint8_t channel) {
         return false;
     }
 
-    if (channel < 1 || channel > 4) {
-        std::cerr << "错误: 通道号必须在 1-4 范围内" << std::endl;
+    if (channel < 1 || channel > relay_channel_count) {
+        std::cerr << "错误: 通道号必须在 1-" << relay_channel_count << " 范围内" << std::endl;
         return false;
     }
 
-    // 切换继电器状态
-    uint8_t current_states = relay_states.load();
-    current_states ^= (1 << (channel - 1)); // 使用异或切换位
-    relay_states.store(current_states);
+    // 切换继电器状态（由周期线程在当前输出上翻转，避免读-改-写竞争）
+    uint8_t bit = static_cast<uint8_t>(1u << (channel - 1));
+    std::future<RelayCommandResult> future = submitRelayCommand(bit, 0, nullptr, true);
+    if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+        future.get().status == RelayCommandStatus::RELAY_CMD_REJECTED) {
+        return false;
+    }
     
-    bool new_state = (current_states & (1 << (channel - 1))) != 0;
-    std::cout << "切换通道 " << static_cast<int>(channel) 
-              << " 到 " << (new_state ? "开启" : "关闭") << std::endl;
+    std::cout << "切换通道 " << static_cast<int>(channel) << std::endl;
     
     return true;
 }
 
 float EtherCATMaster::readAnalogInputAsPressure(uint8_t channel) {
-    if (channel < 1 || channel > 4) {
+    if (channel < 1 || channel > analog_channel_count) {
         return -1.0f;
     }
 
@@ -1681,9 +2405,8 @@ float EtherCATMaster::readAnalogInputAsPressure(uint8_t channel) {
         return -1.0f;
     }
 
-    int16_t raw_value = readAnalogInputPDO(channel);
-    float current_value = convertAnalogToCurrent(raw_value);
-    float pressure_value = convertCurrentToPressure(current_value);
+    int16_t raw_value = getProcessImageSnapshot().analog_raw[channel - 1];
+    float pressure_value = convertChannelToPressure(channel - 1, raw_value);
     
     // 注意：不输出日志到控制台，避免阻塞 UI
     // 如果需要详细日志，可以使用 log() 函数
@@ -1693,51 +2416,37 @@ float EtherCATMaster::readAnalogInputAsPressure(uint8_t channel) {
 
 void EtherCATMaster::printSlaveStates() {
     std::cout << "=== 从站状态 ===" << std::endl;
-    std::cout << "1. EL1008 - 8通道数字输入 (位置 1)" << std::endl;
-    std::cout << "2. EL3074 - 4通道模拟输入 (位置 2)" << std::endl;
-    std::cout << "3. EL2634 - 4通道继电器输出 (位置 3)" << std::endl;
+    const auto& slaves = topology.getSlaves();
+    for (size_t i = 0; i < slaves.size(); i++) {
+        std::cout << (i + 1) << ". " << slaves[i].name << " (位置 " << slaves[i].position << ")" << std::endl;
+    }
+    std::cout << "模拟输入 " << analog_channel_count << " 通道, 数字输入 " << digital_input_count
+              << " 通道, 继电器输出 " << relay_channel_count << " 通道" << std::endl;
     std::cout << "================" << std::endl;
 }
-std::vector<bool> EtherCATMaster::readAllDigitalInputs() {
-    std::vector<bool> states;
-    
-    if (!running || !domain_data) {
-        return states;
-    }
-    
-    // 直接读取PDO数据，不做额外验证（避免阻塞UI）
-    for (uint8_t i = 1; i <= 8; i++) {
-        states.push_back(readDigitalInputPDO(i));
+uint64_t EtherCATMaster::readAllDigitalInputs() {
+    if (!running || !domains_attached) {
+        return 0;
     }
-    return states;
-}
-
-bool EtherCATMaster::readDigitalInputPDO(uint8_t channel) {
-    if (!domain_data) return false;
-    if (channel < 1 || channel > 8) return false;
     
-    // EL1008 输入数据在域数据中的偏移量
-    uint8_t* input_data = domain_data + off_dig_in[channel - 1];
-    
-    // 使用 EC_READ_U8 宏读取输入状态
-    return (EC_READ_U8(input_data) & 0x01) != 0;
+    // 从同一周期的快照读取，不做额外验证（避免阻塞UI）
+    return getProcessImageSnapshot().digital_inputs;
 }
 
 bool EtherCATMaster::readDigitalInput(uint8_t channel) {
-    if (channel < 1 || channel > 8) {
+    if (channel < 1 || channel > digital_input_count) {
         return false;
     }
 
-    if (!running || !domain_data) {
+    if (!running || !domains_attached) {
         return false;
     }
 
-    // 直接读取PDO数据
-    return readDigitalInputPDO(channel);
+    return getProcessImageSnapshot().digitalInput(channel - 1);
 }
 std::vector<float> EtherCATMaster::readAllAnalogInputs() {
     std::vector<float> values;
-    for (uint8_t i = 1; i <= 4; i++) {
+    for (uint8_t i = 1; i <= analog_channel_count; i++) {
         values.push_back(readAnalogInput(i));
     }
     return values;
@@ -1755,27 +2464,36 @@ void EtherCATMaster::printMasterState() {
     // std::cout << "=========================" << std::endl;
 
 
-    if (!master) return;
+    if (!backend->isMasterRequested()) return;
     
-    ecrt_master_state(master, &master_state);
+    // 运行中只读取周期线程发布的状态，避免与周期线程并发访问主站
+    ec_master_state_t ms;
+    if (running) {
+        if (!loadMasterState(ms)) {
+            std::cout << "主站状态尚未采样" << std::endl;
+            return;
+        }
+    } else {
+        backend->getMasterState(ms);
+    }
     
     std::cout << "=== EtherCAT 主站状态 ===" << std::endl;
-    std::cout << "响应从站数量: " << master_state.slaves_responding << std::endl;
+    std::cout << "响应从站数量: " << ms.slaves_responding << std::endl;
     
     // 解析应用层状态
     std::cout << "应用层状态: ";
     std::vector<std::string> al_states;
     
-    if (master_state.al_states & 0x01) { // Bit 0: INIT
+    if (ms.al_states & 0x01) { // Bit 0: INIT
         al_states.push_back("INIT");
     }
-    if (master_state.al_states & 0x02) { // Bit 1: PREOP
+    if (ms.al_states & 0x02) { // Bit 1: PREOP
         al_states.push_back("PREOP");
     }
-    if (master_state.al_states & 0x04) { // Bit 2: SAFEOP
+    if (ms.al_states & 0x04) { // Bit 2: SAFEOP
         al_states.push_back("SAFEOP");
     }
-    if (master_state.al_states & 0x08) { // Bit 3: OP
+    if (ms.al_states & 0x08) { // Bit 3: OP
         al_states.push_back("OP");
     }
     
@@ -1787,16 +2505,16 @@ void EtherCATMaster::printMasterState() {
             std::cout << al_states[i];
         }
     }
-    std::cout << " (0x" << std::hex << static_cast<unsigned int>(master_state.al_states) << std::dec << ")" << std::endl;
+    std::cout << " (0x" << std::hex << static_cast<unsigned int>(ms.al_states) << std::dec << ")" << std::endl;
     
-    std::cout << "以太网链接: " << (master_state.link_up ? "正常" : "断开") << std::endl;
+    std::cout << "以太网链接: " << (ms.link_up ? "正常" : "断开") << std::endl;
     std::cout << "=========================" << std::endl;
 }
 
 
 float EtherCATMaster::readAnalogInput(uint8_t channel) {
-    if (channel < 1 || channel > 4) {
-        std::cerr << "错误: 通道号必须在 1-4 范围内" << std::endl;
+    if (channel < 1 || channel > analog_channel_count) {
+        std::cerr << "错误: 通道号必须在 1-" << analog_channel_count << " 范围内" << std::endl;
         return -1;
     }
 
@@ -1805,8 +2523,8 @@ float EtherCATMaster::readAnalogInput(uint8_t channel) {
         return -1;
     }
 
-    // 使用PDO读取模拟输入
-    int16_t raw_value = readAnalogInputPDO(channel);
+    // 从快照读取模拟输入
+    int16_t raw_value = getProcessImageSnapshot().analog_raw[channel - 1];
 
     // 转换为电流值
     float current_value = convertAnalogToCurrent(raw_value);
@@ -1819,38 +2537,6 @@ float EtherCATMaster::readAnalogInput(uint8_t channel) {
     return current_value;
 }
 
-int16_t EtherCATMaster::readAnalogInputPDO(uint8_t channel) {
-    if (!domain_data) {
-        std::cerr << "[PDO] domain_data is nullptr!" << std::endl;
-        return -1;
-    }
-    if (channel < 1 || channel > 4) return -1;
-    
-    // 调试：打印偏移量
-    static bool printed = false;
-    if (!printed) {
-        std::cout << "[PDO] 偏移量: off_ai_val[0]=" << off_ai_val[0] 
-                  << " [1]=" << off_ai_val[1]
-                  << " [2]=" << off_ai_val[2]
-                  << " [3]=" << off_ai_val[3] << std::endl;
-        printed = true;
-    }
-    
-    // EL3074 模拟输入数据在域数据中的偏移量
-    uint8_t* analog_data = domain_data + off_ai_val[channel - 1];
-    
-    // 读取16位值
-    int16_t raw = EC_READ_S16(analog_data);
-    
-    // 每10秒打印一次原始值
-    static int counter = 0;
-    if (counter++ % 1000 == 0) {
-        std::cout << "[PDO] 通道" << (int)channel << " 原始值=" << raw << std::endl;
-    }
-    
-    return raw;
-}
-
 // 添加模拟量转换函数
 float EtherCATMaster::convertAnalogToCurrent(int16_t analog_value) {
     // // 实际电流值 = 模拟量值 * (20 - 4) / 32767 + 4
@@ -1879,48 +2565,44 @@ float EtherCATMaster::convertCurrentToPressure(float current_value) {
 }
 
 EtherCATMaster::PressureStatus EtherCATMaster::checkPressureStatus(uint8_t channel) {
-    if (channel < 1 || channel > 4) {
+    if (channel < 1 || channel > analog_channel_count) {
         return PRESSURE_OUT_OF_RANGE;
     }
 
-    int16_t analog_value = readAnalogInputPDO(channel);
-    
-    // 检查传感器故障
-    if (checkForSensorError(analog_value)) {
+    return evaluatePressureStatus(getProcessImageSnapshot(), channel - 1);
+}
+
+EtherCATMaster::PressureStatus EtherCATMaster::evaluatePressureStatus(const ProcessImageSnapshot& snapshot,
+                                                                      size_t index) {
+    if (index >= snapshot.analog_count) {
+        return PRESSURE_OUT_OF_RANGE;
+    }
+    uint16_t status = snapshot.analog_status[index];
+
+    // 断线或端子报告数据无效
+    if (status & AI_STATUS_FAULT) {
         return PRESSURE_SENSOR_ERROR;
     }
-    
-    // 检查零点漂移
-    if (checkForZeroDrift(analog_value)) {
-        return PRESSURE_ZERO_DRIFT;
+
+    // 端子未再产生新采样，数值不可信
+    if ((snapshot.analog_stale >> index) & 0x01) {
+        return PRESSURE_STALE;
     }
-    
-    // 转换为压力值
-    float pressure = convertAnalogToPressure(analog_value);
-    
-    // 检查过载
-    if (checkForOverload(pressure)) {
+
+    // 限值 2 配置为过载压力时由端子比较
+    if (((status & AI_STATUS_LIMIT2) >> AI_STATUS_LIMIT2_SHIFT) == AI_LIMIT_ABOVE) {
         return PRESSURE_OVERLOAD;
     }
-    
-    // 检查超量程
-    if (pressure > PRESSURE_RANGE_MAX) {
+
+    if (status & AI_STATUS_OVERRANGE) {
         return PRESSURE_OVER_RANGE;
     }
-    
-    return PRESSURE_NORMAL;
-}
 
-// 压力状态检查函数
-bool EtherCATMaster::checkForZeroDrift(int16_t analog_value) {
-    // 检查零点漂移: 电流值 < 3.8mA (预留0.2mA容差)
-    float current = convertAnalogToCurrent(analog_value);
-    return current < (CURRENT_RANGE_MIN - 0.2f);
-}
+    if (status & AI_STATUS_UNDERRANGE) {
+        return PRESSURE_ZERO_DRIFT;
+    }
 
-bool EtherCATMaster::checkForOverload(float pressure_value) {
-    // 检查过载: 压力 > 200bar
-    return pressure_value > OVERLOAD_PRESSURE;
+    return PRESSURE_NORMAL;
 }
 
 float EtherCATMaster::convertAnalogToPressure(int16_t analog_value) {
@@ -1929,10 +2611,147 @@ float EtherCATMaster::convertAnalogToPressure(int16_t analog_value) {
     return convertCurrentToPressure(current_value);
 }
 
-bool EtherCATMaster::checkForSensorError(int16_t analog_value) {
-    // 检查传感器故障: 电流值超出正常范围
-    float current = convertAnalogToCurrent(analog_value);
-    return current < 3.0f || current > 21.0f; // 超出3-21mA范围视为故障
+// 批量换算与单通道换算的表达式相同；循环体无函数调用和分支，可由编译器向量化
+void EtherCATMaster::convertAnalogToCurrent(const int16_t* analog_values, float* currents, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        currents[i] = static_cast<float>(analog_values[i]) * (CURRENT_RANGE_MAX - CURRENT_RANGE_MIN) /
+                      ADC_MAX_VALUE + CURRENT_RANGE_MIN;
+    }
+}
+
+void EtherCATMaster::convertAnalogToPressure(const int16_t* analog_values, float* pressures, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float current_value = static_cast<float>(analog_values[i]) * (CURRENT_RANGE_MAX - CURRENT_RANGE_MIN) /
+                              ADC_MAX_VALUE + CURRENT_RANGE_MIN;
+        float pressure = (current_value - CURRENT_RANGE_MIN) *
+                         (PRESSURE_RANGE_MAX - PRESSURE_RANGE_MIN) /
+                         (CURRENT_RANGE_MAX - CURRENT_RANGE_MIN);
+        pressures[i] = std::max(pressure, PRESSURE_RANGE_MIN);
+    }
+}
+
+float EtherCATMaster::convertChannelToPressure(size_t index, int16_t analog_value) {
+    const PressureCalibrationSet* set = acquireCalibration();
+    const PressureLookupTable* table = set ? set->table(index) : nullptr;
+    float pressure = table ? table->lookup(analog_value) : convertAnalogToPressure(analog_value);
+    releaseCalibration();
+    return pressure;
+}
+
+void EtherCATMaster::convertChannelsToPressure(const int16_t* analog_values, float* pressures, size_t count) {
+    convertAnalogToPressure(analog_values, pressures, count);
+    const PressureCalibrationSet* set = acquireCalibration();
+    if (set) {
+        for (size_t i = 0; i < count; i++) {
+            if (const PressureLookupTable* table = set->table(i)) {
+                pressures[i] = table->lookup(analog_values[i]);
+            }
+        }
+    }
+    releaseCalibration();
+}
+
+void EtherCATMaster::convertAnalogBlock(const ProcessImageSnapshot& snapshot, AnalogBlock& block) const {
+    block.count = std::min<uint32_t>(snapshot.analog_count, MAX_ANALOG_CHANNELS);
+    analogKernel().convert(snapshot.analog_raw, snapshot.analog_status, snapshot.analog_stale, block.count,
+                           block.currents, block.pressures, block.statuses);
+    
+    // 已标定的通道每个一次查表，只覆盖压力；电流和状态仍是端子的测量结果
+    const PressureCalibrationSet* set = acquireCalibration();
+    if (set) {
+        uint64_t mask = set->getChannelMask();
+        if (block.count < 64) {
+            mask &= (1ULL << block.count) - 1;
+        }
+        while (mask) {
+            size_t i = static_cast<size_t>(__builtin_ctzll(mask));
+            block.pressures[i] = set->table(i)->lookup(snapshot.analog_raw[i]);
+            mask &= mask - 1;
+        }
+    }
+    releaseCalibration();
+}
+
+// ==================== 压力通道标定 ====================
+// 读者先登记再读指针：替换方在交换指针之后观察到读者数为 0 时，不会再有读者持有被替换的标定
+const PressureCalibrationSet* EtherCATMaster::acquireCalibration() const {
+    calibration_readers.fetch_add(1);
+    return calibration.load();
+}
+
+void EtherCATMaster::releaseCalibration() const {
+    calibration_readers.fetch_sub(1);
+}
+
+void EtherCATMaster::swapCalibration(std::unique_ptr<const PressureCalibrationSet> next) {
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+    const PressureCalibrationSet* previous = calibration.exchange(next.release());
+    if (previous) {
+        retired_calibrations.emplace_back(previous);
+    }
+    if (calibration_readers.load() == 0) {
+        retired_calibrations.clear();
+    }
+}
+
+// 监视线程：释放替换时仍有读者而留下的标定
+void EtherCATMaster::reclaimCalibrations() {
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+    if (!retired_calibrations.empty() && calibration_readers.load() == 0) {
+        retired_calibrations.clear();
+    }
+}
+
+bool EtherCATMaster::loadPressureCalibration(const std::string& path) {
+    PressureCalibration loaded;
+    std::string error;
+    if (!loaded.load(path, error)) {
+        log(LogLevel::LOG_ERROR, "Calibration", "加载压力标定失败: " + error);
+        return false;
+    }
+    auto start_ns = monotonicNowNs();
+    std::unique_ptr<const PressureCalibrationSet> set = loaded.compile();
+    auto compile_us = (monotonicNowNs() - start_ns) / 1000;
+    
+    std::string channels;
+    for (const auto& channel : loaded.getChannels()) {
+        channels += (channels.empty() ? "" : ", ") + std::to_string(channel.channel) +
+                    (channel.kind == CalibrationKind::CALIBRATION_LINEAR
+                         ? "(" + std::to_string(channel.points.size()) + " 点)"
+                         : "(" + std::to_string(channel.coefficients.size()) + " 项多项式)");
+        if (channel.channel > analog_channel_count && analog_channel_count > 0) {
+            log(LogLevel::LOG_WARNING, "Calibration",
+                "标定通道 " + std::to_string(channel.channel) + " 超出当前拓扑的模拟输入通道数 " +
+                std::to_string(analog_channel_count));
+        }
+    }
+    swapCalibration(std::move(set));
+    log(LogLevel::LOG_INFO, "Calibration", "压力标定: " + path + "，通道 " + channels + "，查表编译 " +
+        std::to_string(compile_us) + "µs");
+    return true;
+}
+
+void EtherCATMaster::clearPressureCalibration() {
+    swapCalibration(nullptr);
+    log(LogLevel::LOG_INFO, "Calibration", "已清除压力标定，全部通道按量程线性换算");
+}
+
+uint64_t EtherCATMaster::getCalibratedChannelMask() const {
+    const PressureCalibrationSet* set = acquireCalibration();
+    uint64_t mask = set ? set->getChannelMask() : 0;
+    releaseCalibration();
+    return mask;
+}
+
+std::string EtherCATMaster::getPressureCalibrationSource() const {
+    const PressureCalibrationSet* set = acquireCalibration();
+    std::string source = set ? set->getSource() : std::string();
+    releaseCalibration();
+    return source;
+}
+
+const char* EtherCATMaster::getAnalogKernelName() {
+    return analogKernel().name;
 }
 
 std::string EtherCATMaster::getPressureStatusString(PressureStatus status) {
@@ -1942,13 +2761,15 @@ std::string EtherCATMaster::getPressureStatusString(PressureStatus status) {
         case PRESSURE_ZERO_DRIFT:
             return "零点漂移";
         case PRESSURE_OVER_RANGE:
-            return "超量程(100-200bar)";
+            return "超量程(>20mA)";
         case PRESSURE_OVERLOAD:
-            return "过载警告(>200bar)";
+            return "过载警告(超过限值2)";
         case PRESSURE_SENSOR_ERROR:
             return "传感器故障";
         case PRESSURE_OUT_OF_RANGE:
             return "通道超出范围";
+        case PRESSURE_STALE:
+            return "采样停滞";
         default:
             return "未知状态";
     }
@@ -1957,101 +2778,1692 @@ std::string EtherCATMaster::getPressureStatusString(PressureStatus status) {
 void EtherCATMaster::processThreadFunc() {
     std::cout << "启动 EtherCAT 处理线程..." << std::endl;
     
-    auto next_cycle = std::chrono::steady_clock::now();
-    int cycle_counter = 0;
+    setupRealtimeThread();
+    
+    const int64_t period_ns = rt_options.cycle_period_ns;
+    
+    // 主站状态采样间隔按时间换算为周期数，保证不同周期长度下采样频率不变
+    const uint64_t master_state_interval = static_cast<uint64_t>(std::max<int64_t>(1, 100000000LL / period_ns));  // 100ms
+    
+    // 截止时间按主站时钟计算；虚拟时钟下处理本身不占用时间，不会出现超时
+    clock->enterParticipant();
+    int64_t next_cycle_ns = clock->nowNs();
+    uint64_t cycle_counter = 0;             // 与快照的 cycle 同类型，长时间运行不溢出
+    int64_t last_wakeup_ns = 0;
     
     while (running) {
-        next_cycle += std::chrono::milliseconds(10); // 10ms 周期
+        // 记录唤醒延迟和周期误差（首个周期没有上一次唤醒，不计入周期误差）
+        int64_t wakeup_ns = clock->nowNs();
+        if (cycle_timing_reset_requested.exchange(false, std::memory_order_acq_rel)) {
+            for (auto& histogram : cycle_histograms) {
+                histogram.reset();
+            }
+            last_wakeup_ns = 0;
+            
+            // 清零超时计数，但保持安全输出状态和进行中的连续超时
+            uint64_t consecutive = overrun_stats_rt.consecutive_overruns;
+            overrun_stats_rt = CycleOverrunStats();
+            overrun_stats_rt.consecutive_overruns = consecutive;
+            overrun_stats_rt.safe_outputs_active = safe_outputs_active;
+            overrun_stats.store(overrun_stats_rt);
+        }
+        if (cycle_counter > 0) {
+            recordCycleMetric(CycleMetric::WAKEUP_LATENCY, wakeup_ns - next_cycle_ns);
+        }
+        if (last_wakeup_ns != 0) {
+            int64_t period_error = (wakeup_ns - last_wakeup_ns) - period_ns;
+            recordCycleMetric(CycleMetric::PERIOD_ERROR, period_error < 0 ? -period_error : period_error);
+        }
+        last_wakeup_ns = wakeup_ns;
+        
+        next_cycle_ns += period_ns;
+        
+        // 监督线程重建主站配置期间不访问后端，只保持周期节拍
+        if (cycle_park_requested.load(std::memory_order_acquire)) {
+            cycle_parked.store(true, std::memory_order_release);
+            clock->sleepUntil(next_cycle_ns);
+            continue;
+        }
+        if (cycle_parked.load(std::memory_order_relaxed)) {
+            cycle_parked.store(false, std::memory_order_relaxed);
+            resumeAfterReconfigure();
+        }
         
         processCycle();
         
-        // 每10个周期更新一次状态
-        if (cycle_counter % 10 == 0) {
-            updateMasterStatus();
+        // 启动期间逐周期跟踪从站状态；必需从站全部进入 OP 的周期立即发布状态字，不等采样间隔
+        bool reached_op = startup_tracking.load(std::memory_order_acquire) && trackStartupStates();
+        
+        // 只发布原始状态字，解析和报告由监督线程完成
+        if (reached_op || cycle_counter % master_state_interval == 0) {
+            publishMasterState();
         }
-
         cycle_counter++;
-        if (cycle_counter % 100 == 0) { // 每100个周期检查一次状态
-            checkDomainState();
-            if (cycle_counter % 1000 == 0) { // 每1000个周期检查一次主站状态
-                checkMasterState();
-            }
+        
+        // 处理结束时已过下一周期的截止时间即为超时
+        int64_t overrun_ns = clock->nowNs() - next_cycle_ns;
+        if (overrun_ns >= 0) {
+            handleCycleOverrun(overrun_ns, next_cycle_ns);
+        } else if (overrun_stats_rt.consecutive_overruns > 0) {
+            endCycleOverrunRun();
         }
         
-        std::this_thread::sleep_until(next_cycle);
+        // 绝对截止时间等待，避免相对睡眠带来的累积漂移
+        clock->sleepUntil(next_cycle_ns);
     }
     
+    clock->leaveParticipant();
     std::cout << "EtherCAT 处理线程已停止" << std::endl;
 }
 
+// 热重配置后新激活的域从零开始：继电器输出回到断开，重建前已发送的命令无法再得到确认，按超时交付
+void EtherCATMaster::resumeAfterReconfigure() {
+    relay_output_image = 0;
+    relay_states.store(0);
+    for (size_t i = 0; i < relay_in_flight_count; i++) {
+        RelayCommandResult& result = relay_slots[relay_in_flight[i]].result;
+        if (result.status == RelayCommandStatus::RELAY_CMD_PENDING) {
+            result.status = RelayCommandStatus::RELAY_CMD_TIMEOUT;
+        }
+    }
+    
+    // 重建前发起的 SDO 传输随原主站配置释放，未开始的操作使用新的后端请求
+    for (size_t i = 0; i < sdo_in_flight_count; i++) {
+        SdoRequestResult& result = sdo_in_flight[i]->result;
+        if (result.status == SdoRequestStatus::SDO_PENDING && result.issued_cycle != 0) {
+            result.status = SdoRequestStatus::SDO_CANCELLED;
+            result.completed_cycle = cycle_count;
+        }
+    }
+    sdo_active.fill(nullptr);
+    
+    // 采样停滞检测重新开始
+    analog_toggle_rt = 0;
+    analog_unchanged_rt.fill(0);
+    input_snapshot_rt.analog_count = static_cast<uint32_t>(analog_channel_count);
+    input_snapshot_rt.digital_count = static_cast<uint32_t>(digital_input_count);
+}
+
 void EtherCATMaster::processCycle() {
     if (!running) return;
     
+    ++cycle_count;
+    int64_t t_start = monotonicNowNs();
+    
     // 接收 EtherCAT 帧
-    ecrt_master_receive(master);
+    backend->receive();
+    int64_t t_received = monotonicNowNs();
+    // 发布的时间戳取主站时钟（与测试计时一致），阶段耗时仍按实际时间统计
+    int64_t timestamp_ns = clock->isVirtual() ? clock->nowNs() : t_received;
+    
+    // 处理上一周期排队的域并发布其WKC和快照
+    ec_domain_state_t relay_ds;
+    bool relay_received = false;
+    for (size_t i = 0; i < PROCESS_DOMAIN_COUNT; i++) {
+        ProcessDomain& d = domains[i];
+        if (!d.exchanging) continue;
+        
+        ec_domain_state_t ds;
+        backend->processDomain(d.domain, ds);
+        publishDomainState(d, ds);
+        publishDomainSnapshot(d, ds, timestamp_ns);
+        
+        if (static_cast<ProcessDomainId>(i) == ProcessDomainId::DOMAIN_RELAY_OUT) {
+            relay_ds = ds;
+            relay_received = true;
+        }
+    }
+    int64_t t_processed = monotonicNowNs();
     
-    // 处理域数据
-    ecrt_domain_process(domain);
+    // 有输入域交换时发布合并的输入快照，供其他线程读取
+    bool analog_updated = processDomain(ProcessDomainId::DOMAIN_ANALOG_IN).exchanging;
+    bool digital_updated = processDomain(ProcessDomainId::DOMAIN_DIGITAL_IN).exchanging;
+    if (analog_updated || digital_updated) {
+        publishInputSnapshot(timestamp_ns, analog_updated, digital_updated);
+    }
+    if (analog_updated) {
+        evaluatePressureTarget(timestamp_ns);
+    }
+    int64_t t_published = monotonicNowNs();
     
-    // 写入继电器输出状态
-    writeRelayOutputs();
+    // 确认已发送的继电器命令；继电器域本周期到期时取出新命令
+    confirmRelayCommands(relay_received ? &relay_ds : nullptr);
+    bool relay_due = isDomainDue(processDomain(ProcessDomainId::DOMAIN_RELAY_OUT));
+    if (relay_due) {
+        applyRelayCommands();
+    }
     
-    // 发送过程数据
-    ecrt_domain_queue(domain);
-    ecrt_master_send(master);
-}
-
-void EtherCATMaster::checkDomainState() {
-    ec_domain_state_t ds;
-    ecrt_domain_state(domain, &ds);
+    // 推进 SDO 传输，邮箱报文由后端随本周期的帧收发
+    if (sdo_request_count > 0) {
+        advanceSdoRequests();
+    }
+    int64_t t_commands = monotonicNowNs();
+    
+    // 周期内钩子，可在写出前修改继电器输出
+    if (cycle_hook_count > 0) {
+        runCycleHooks(timestamp_ns, analog_updated, digital_updated, relay_due);
+    }
+    int64_t t_hooks = monotonicNowNs();
     
-    if (ds.working_counter != domain_state.working_counter) {
-        std::cout << "Domain: WC " << ds.working_counter << std::endl;
+    if (relay_due) {
+        writeRelayOutputs();
     }
-    if (ds.wc_state != domain_state.wc_state) {
-        std::cout << "Domain: State " << ds.wc_state << std::endl;
+    int64_t t_written = monotonicNowNs();
+    
+    // 排队本周期到期的域并发送
+    for (auto& d : domains) {
+        d.exchanging = isDomainDue(d);
+        if (d.exchanging) {
+            backend->queueDomain(d.domain);
+        }
     }
-    domain_state = ds;
+    backend->send();
+    int64_t t_sent = monotonicNowNs();
+    
+    recordCycleMetric(CycleMetric::RECEIVE, t_received - t_start);
+    recordCycleMetric(CycleMetric::DOMAIN_PROCESS, t_processed - t_received);
+    recordCycleMetric(CycleMetric::PUBLISH_SNAPSHOT, t_published - t_processed);
+    recordCycleMetric(CycleMetric::USER_HOOKS, t_hooks - t_commands);
+    recordCycleMetric(CycleMetric::WRITE_OUTPUTS, (t_commands - t_published) + (t_written - t_hooks));
+    recordCycleMetric(CycleMetric::SEND, t_sent - t_written);
+    recordCycleMetric(CycleMetric::CYCLE_EXECUTION, t_sent - t_start);
 }
 
-void EtherCATMaster::writeRelayOutputs() {
-    if (!domain_data) return;
-    
-    // 使用 EC_WRITE_U8 宏写入继电器输出状态
-    // 类似于示例代码中的: EC_WRITE_U8(domain1_pd + off_dig_out0, blink ? 0xFF : 0x00);
-    uint8_t current_states = relay_states.load();
+// 从输入域复制数据到合并快照，未交换的域保留上次的值（仅周期线程调用）
+void EtherCATMaster::publishInputSnapshot(int64_t timestamp_ns, bool analog_updated, bool digital_updated) {
+    ProcessImageSnapshot& snapshot = input_snapshot_rt;
+    snapshot.cycle = cycle_count;
+    snapshot.timestamp_ns = timestamp_ns;
+    const uint8_t* analog_data = domainData(ProcessDomainId::DOMAIN_ANALOG_IN);
+    if (analog_updated && analog_data) {
+        snapshot.analog_cycle = cycle_count;
+        analog_terminals.readAll(analog_data, snapshot.analog_raw);
+        analog_terminals.readAllStatus(analog_data, snapshot.analog_status);
+        
+        // TxPDO Toggle 每个新采样翻转一次；连续未翻转达到时限的通道标记为停滞
+        // 按通道数组批量计算，循环体无分支（条件选择由编译器生成条件传送）
+        const size_t count = snapshot.analog_count;
+        uint64_t toggles = 0;
+        for (size_t i = 0; i < count; i++) {
+            toggles |= static_cast<uint64_t>((snapshot.analog_status[i] & AI_STATUS_TXPDO_TOGGLE) != 0) << i;
+        }
+        uint64_t fresh = toggles ^ analog_toggle_rt;
+        uint64_t stale = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t unchanged = ((fresh >> i) & 0x01)
+                ? 0 : std::min(analog_unchanged_rt[i] + 1, analog_stale_exchanges);
+            analog_unchanged_rt[i] = unchanged;
+            stale |= static_cast<uint64_t>(unchanged >= analog_stale_exchanges) << i;
+        }
+        snapshot.analog_new_sample = fresh;
+        snapshot.analog_stale = stale;
+        analog_toggle_rt = toggles;
+    }
+    const uint8_t* digital_data = domainData(ProcessDomainId::DOMAIN_DIGITAL_IN);
+    if (digital_updated && digital_data) {
+        snapshot.digital_cycle = cycle_count;
+        snapshot.digital_inputs = digital_terminals.readMask(digital_data);
+    }
+    input_snapshot.store(snapshot);
+}
+
+// 发布单个域的快照（仅周期线程调用）
+void EtherCATMaster::publishDomainSnapshot(ProcessDomain& d, const ec_domain_state_t& ds, int64_t timestamp_ns) {
+    d.exchange_count++;
+    if (ds.wc_state != EC_WC_COMPLETE) {
+        d.wkc_error_count++;
+    }
     
-    // for (int i = 0; i < 4; i++) {
-    //     uint8_t* output_data = domain_data + off_relay_out[i];
-    //     uint8_t channel_state = (current_states & (1 << i)) ? 0x01 : 0;
-    //     EC_WRITE_U8(output_data, channel_state);
-    // }
+    DomainSnapshot snapshot;
+    snapshot.cycle = cycle_count;
+    snapshot.timestamp_ns = timestamp_ns;
+    snapshot.exchange_count = d.exchange_count;
+    snapshot.wkc_error_count = d.wkc_error_count;
+    snapshot.working_counter = ds.working_counter;
+    snapshot.wc_state = static_cast<uint32_t>(ds.wc_state);
+    snapshot.image_size = static_cast<uint32_t>(std::min(d.size, DOMAIN_IMAGE_MAX_SIZE));
+    memset(snapshot.image, 0, sizeof(snapshot.image));
+    memcpy(snapshot.image, d.data, snapshot.image_size);
+    d.snapshot.store(snapshot);
+}
+
+DomainSnapshot EtherCATMaster::getDomainSnapshot(ProcessDomainId id) const {
+    if (id >= ProcessDomainId::COUNT) {
+        return DomainSnapshot();
+    }
+    return domains[static_cast<size_t>(id)].snapshot.load();
+}
+
+std::string EtherCATMaster::getProcessDomainName(ProcessDomainId id) {
+    switch (id) {
+        case ProcessDomainId::DOMAIN_ANALOG_IN:
+            return "模拟输入";
+        case ProcessDomainId::DOMAIN_DIGITAL_IN:
+            return "数字输入";
+        case ProcessDomainId::DOMAIN_RELAY_OUT:
+            return "继电器输出";
+        default:
+            return "未知域";
+    }
+}
+
+// ==================== 周期计时统计 ====================
+void EtherCATMaster::recordCycleMetric(CycleMetric metric, int64_t value_ns) {
+    cycle_histograms[static_cast<size_t>(metric)].record(value_ns > 0 ? static_cast<uint64_t>(value_ns) : 0);
+}
+
+LatencyHistogram::Snapshot EtherCATMaster::getCycleHistogram(CycleMetric metric) const {
+    if (metric >= CycleMetric::COUNT) {
+        return LatencyHistogram::Snapshot();
+    }
+    return cycle_histograms[static_cast<size_t>(metric)].snapshot();
+}
+
+CycleTimingReport EtherCATMaster::getCycleTimingReport() const {
+    CycleTimingReport report;
+    report.cycle_period_ns = rt_options.cycle_period_ns;
+    
+    for (size_t i = 0; i < CYCLE_METRIC_COUNT; i++) {
+        LatencyHistogram::Snapshot snap = cycle_histograms[i].snapshot();
+        CycleMetricSummary& summary = report.metrics[i];
+        summary.count = snap.count;
+        summary.min_ns = snap.min;
+        summary.max_ns = snap.max;
+        summary.mean_ns = snap.mean();
+        summary.p50_ns = snap.percentile(50.0);
+        summary.p99_ns = snap.percentile(99.0);
+        summary.p999_ns = snap.percentile(99.9);
+    }
+    
+    return report;
+}
+
+void EtherCATMaster::resetCycleTiming() {
+    if (running) {
+        cycle_timing_reset_requested = true;
+    } else {
+        // 周期线程未运行时没有并发写者，可直接复位
+        for (auto& histogram : cycle_histograms) {
+            histogram.reset();
+        }
+        overrun_stats_rt = CycleOverrunStats();
+        overrun_stats_rt.safe_outputs_active = safe_outputs_active;
+        overrun_stats.store(overrun_stats_rt);
+    }
+}
+
+// ==================== 周期超时处理 ====================
+// 周期线程：本周期处理结束时已错过下一周期的截止时间
+void EtherCATMaster::handleCycleOverrun(int64_t overrun_ns, int64_t& next_cycle_ns) {
+    const int64_t period_ns = rt_options.cycle_period_ns;
+    const OverrunPolicy policy = rt_options.overrun_policy;
+    CycleOverrunStats& stats = overrun_stats_rt;
+    int64_t now_ns = clock->wallNs();
+    
+    bool run_started = (stats.consecutive_overruns == 0);
+    if (run_started) {
+        overrun_run_max_ns = 0;
+        overrun_run_skipped = 0;
+    }
+    
+    stats.overrun_count++;
+    stats.consecutive_overruns++;
+    stats.max_consecutive_overruns = std::max(stats.max_consecutive_overruns, stats.consecutive_overruns);
+    if (stats.first_overrun_cycle == 0) {
+        stats.first_overrun_cycle = cycle_count;
+        stats.first_overrun_time_ns = now_ns;
+    }
+    stats.last_overrun_cycle = cycle_count;
+    stats.last_overrun_time_ns = now_ns;
+    stats.last_overrun_ns = overrun_ns;
+    stats.max_overrun_ns = std::max(stats.max_overrun_ns, overrun_ns);
+    overrun_run_max_ns = std::max(overrun_run_max_ns, overrun_ns);
+    
+    // 补跑：保持截止时间不变，随后的周期会立即连续执行
+    if (policy != OverrunPolicy::OVERRUN_BURST_CATCH_UP) {
+        // 跳过已错过的周期边界，对齐到下一个尚未到达的边界
+        int64_t skipped = overrun_ns / period_ns + 1;
+        next_cycle_ns += skipped * period_ns;
+        stats.skipped_cycles += static_cast<uint64_t>(skipped);
+        overrun_run_skipped += static_cast<uint64_t>(skipped);
+    }
+    
+    bool safe_outputs_entered = false;
+    if (policy == OverrunPolicy::OVERRUN_DEGRADE_SAFE_OUTPUTS && !safe_outputs_active) {
+        // 继电器域下一次排队起（applyRelayCommands）输出全部断开
+        safe_outputs_active = true;
+        safe_outputs_entered = true;
+    }
+    stats.safe_outputs_active = safe_outputs_active;
+    
+    // 只报告每轮连续超时的开始和结束，避免持续超时时刷屏
+    if (run_started || safe_outputs_entered) {
+        CycleOverrunEvent event = {};
+        event.run_ended = false;
+        event.safe_outputs_entered = safe_outputs_entered;
+        event.cycle = cycle_count;
+        event.time_ns = now_ns;
+        event.overrun_ns = overrun_ns;
+        pushCycleOverrunEvent(event);
+    }
+    
+    overrun_stats.store(stats);
+}
+
+// 周期线程：连续超时后首个按时完成的周期
+void EtherCATMaster::endCycleOverrunRun() {
+    CycleOverrunStats& stats = overrun_stats_rt;
+    
+    CycleOverrunEvent event = {};
+    event.run_ended = true;
+    event.cycle = cycle_count;
+    event.time_ns = clock->wallNs();
+    event.overrun_ns = overrun_run_max_ns;
+    event.run_length = stats.consecutive_overruns;
+    event.skipped_cycles = overrun_run_skipped;
+    pushCycleOverrunEvent(event);
+    
+    stats.consecutive_overruns = 0;
+    overrun_stats.store(stats);
+}
+
+void EtherCATMaster::pushCycleOverrunEvent(const CycleOverrunEvent& event) {
+    if (!overrun_event_queue.tryPush(event)) {
+        overrun_stats_rt.dropped_events++;
+    }
+}
+
+// 监督线程：将超时事件写入日志，并关联当前可靠性测试周期
+void EtherCATMaster::dispatchCycleOverrunEvents() {
+    CycleOverrunEvent event;
+    while (overrun_event_queue.tryPop(event)) {
+        int reliability_cycle = 0;
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            reliability_cycle = reliability_stats.current_cycle;
+        }
+        
+        std::ostringstream oss;
+        if (event.run_ended) {
+            oss << "周期超时结束于周期 " << event.cycle << "：连续 " << event.run_length
+                << " 次，最大超出 " << event.overrun_ns / 1000 << "µs";
+            if (event.skipped_cycles > 0) {
+                oss << "，跳过 " << event.skipped_cycles << " 个周期";
+            }
+            log(LogLevel::LOG_WARNING, "Cycle", oss.str(), reliability_cycle);
+        } else {
+            oss << "周期 " << event.cycle << " 超时 " << event.overrun_ns / 1000 << "µs";
+            if (event.safe_outputs_entered) {
+                oss << "，继电器输出已置为安全状态";
+            }
+            log(event.safe_outputs_entered ? LogLevel::LOG_ERROR : LogLevel::LOG_WARNING,
+                "Cycle", oss.str(), reliability_cycle);
+        }
+    }
+}
+
+CycleOverrunStats EtherCATMaster::getCycleOverrunStats() const {
+    CycleOverrunStats stats = overrun_stats.load();
+    stats.safe_outputs_active = safe_outputs_active;   // clearSafeOutputs() 后立即反映
+    return stats;
+}
+
+void EtherCATMaster::clearSafeOutputs() {
+    if (safe_outputs_active.exchange(false)) {
+        log(LogLevel::LOG_INFO, "Cycle", "已退出安全输出状态，继电器命令恢复执行");
+    }
+}
+
+// ==================== 周期内压力目标监视 ====================
+int32_t EtherCATMaster::pressureToRawThreshold(float target_pressure) {
+    // 压力随原始值单调不减：先按线性关系估算，再修正到与 convertAnalogToPressure 一致的精确边界
+    double estimate = (static_cast<double>(target_pressure) - PRESSURE_RANGE_MIN) /
+                      (PRESSURE_RANGE_MAX - PRESSURE_RANGE_MIN) * ADC_MAX_VALUE;
+    int32_t raw = static_cast<int32_t>(std::lround(std::max(-32768.0, std::min(32768.0, estimate))));
+    while (raw > INT16_MIN && convertAnalogToPressure(static_cast<int16_t>(raw - 1)) >= target_pressure) {
+        raw--;
+    }
+    while (raw <= INT16_MAX && convertAnalogToPressure(static_cast<int16_t>(raw)) < target_pressure) {
+        raw++;
+    }
+    return raw;   // INT16_MAX + 1 表示目标不可达
+}
+
+uint32_t EtherCATMaster::armPressureTarget(PressureTargetMode mode, float target_pressure, uint8_t relay_mask,
+                                           uint8_t channel_mask) {
+    relay_mask &= relay_channel_mask;
+    channel_mask &= static_cast<uint8_t>((1u << std::min(analog_channel_count.load(), PRESSURE_TARGET_CHANNELS)) - 1);
+    if (!running || channel_mask == 0) {
+        return 0;
+    }
+    
+    // 布防ID占16位，跳过0
+    uint32_t arm_id = next_pressure_target_id.fetch_add(1) & 0xFFFF;
+    if (arm_id == 0) {
+        arm_id = next_pressure_target_id.fetch_add(1) & 0xFFFF;
+    }
+    
+    // 已标定的通道在周期线程中查表后与目标压力比较，目标字先于请求字发布
+    uint32_t level_bits;
+    std::memcpy(&level_bits, &target_pressure, sizeof(level_bits));
+    pressure_target_level.store(level_bits | (static_cast<uint64_t>(arm_id) << 48), std::memory_order_release);
+    
+    int32_t threshold = pressureToRawThreshold(target_pressure);
+    uint64_t word = (static_cast<uint64_t>(static_cast<uint32_t>(threshold)) & 0xFFFFFF)
+                  | (static_cast<uint64_t>(relay_mask) << 24)
+                  | (static_cast<uint64_t>(channel_mask) << 32)
+                  | (mode == PressureTargetMode::TARGET_ALL_BELOW ? PRESSURE_TARGET_BELOW : 0)
+                  | PRESSURE_TARGET_ARMED
+                  | (static_cast<uint64_t>(arm_id) << 48);
+    pressure_target_request.store(word, std::memory_order_release);
+    return arm_id;
+}
+
+void EtherCATMaster::disarmPressureTarget() {
+    pressure_target_request.store(0, std::memory_order_release);
+}
+
+bool EtherCATMaster::getPressureTargetEvent(uint32_t arm_id, PressureTargetEvent& event) const {
+    PressureTargetEvent latest = pressure_target_event.load();
+    if (arm_id == 0 || latest.arm_id != arm_id) {
+        return false;
+    }
+    event = latest;
+    return true;
+}
+
+// 周期线程：模拟输入域交换后判定，越过阈值时在本周期断开继电器
+void EtherCATMaster::evaluatePressureTarget(int64_t timestamp_ns) {
+    uint64_t word = pressure_target_request.load(std::memory_order_acquire);
+    if (!(word & PRESSURE_TARGET_ARMED)) {
+        return;
+    }
+    uint32_t arm_id = static_cast<uint32_t>(word >> 48);
+    if (arm_id == pressure_target_fired_id) {
+        return;
+    }
+    
+    uint64_t level = pressure_target_level.load(std::memory_order_acquire);
+    if (static_cast<uint32_t>(level >> 48) != arm_id) {
+        return;   // 正在重新布防，下一周期再判定
+    }
+    float target_pressure;
+    uint32_t level_bits = static_cast<uint32_t>(level);
+    std::memcpy(&target_pressure, &level_bits, sizeof(target_pressure));
+    
+    int32_t threshold = static_cast<int32_t>(static_cast<uint32_t>(word << 8)) >> 8;   // 符号扩展 24 位阈值
+    uint8_t relay_mask = static_cast<uint8_t>(word >> 24);
+    uint8_t channel_mask = static_cast<uint8_t>(word >> 32);
+    bool below = (word & PRESSURE_TARGET_BELOW) != 0;
+    
+    const PressureCalibrationSet* set = acquireCalibration();
+    bool reached = true;
+    for (size_t i = 0; i < PRESSURE_TARGET_CHANNELS && reached; i++) {
+        if (!(channel_mask & (1u << i))) continue;
+        // 故障或停滞通道的读数不参与判定，也不会使条件成立
+        if (input_snapshot_rt.analogFault(i)) {
+            reached = false;
+            break;
+        }
+        int16_t raw = input_snapshot_rt.analog_raw[i];
+        const PressureLookupTable* table = set ? set->table(i) : nullptr;
+        if (table) {
+            float pressure = table->lookup(raw);
+            reached = below ? (pressure < target_pressure) : (pressure >= target_pressure);
+        } else {
+            reached = below ? (raw < threshold) : (raw >= threshold);
+        }
+    }
+    releaseCalibration();
+    if (!reached) {
+        return;
+    }
+    
+    // 继电器域本周期到期时随本帧写出，否则在其下一次交换时写出
+    relay_output_image = static_cast<uint8_t>(relay_output_image & ~relay_mask);
+    relay_states.store(relay_output_image);
+    pressure_target_fired_id = arm_id;
+    
+    PressureTargetEvent event;
+    event.arm_id = arm_id;
+    event.cycle = cycle_count;
+    event.timestamp_ns = timestamp_ns;
+    event.relay_outputs = relay_output_image;
+    for (size_t i = 0; i < PRESSURE_TARGET_CHANNELS; i++) {
+        event.analog_raw[i] = input_snapshot_rt.analog_raw[i];
+    }
+    pressure_target_event.store(event);
+}
+
+// ==================== 周期内钩子 ====================
+int EtherCATMaster::registerCycleHook(const std::string& name, CycleHookFunction function, void* user_data,
+                                      int64_t budget_ns) {
+    if (running) {
+        log(LogLevel::LOG_ERROR, "Hook", "主站运行中不能注册周期钩子: " + name);
+        return -1;
+    }
+    if (!function || budget_ns <= 0) {
+        log(LogLevel::LOG_ERROR, "Hook", "周期钩子参数无效: " + name);
+        return -1;
+    }
+    if (cycle_hook_count >= MAX_CYCLE_HOOKS) {
+        log(LogLevel::LOG_ERROR, "Hook", "周期钩子数量已达上限 " + std::to_string(MAX_CYCLE_HOOKS));
+        return -1;
+    }
+    
+    CycleHook& hook = cycle_hooks[cycle_hook_count];
+    hook.name = name;
+    hook.function = function;
+    hook.user_data = user_data;
+    hook.budget_ns = budget_ns;
+    hook.consecutive_violations = 0;
+    hook.enabled = true;
+    hook.disabled_by_budget = false;
+    hook.calls = 0;
+    hook.budget_violations = 0;
+    hook.total_ns = 0;
+    hook.last_ns = 0;
+    hook.max_ns = 0;
+    
+    log(LogLevel::LOG_INFO, "Hook", "注册周期钩子 #" + std::to_string(cycle_hook_count) + " " + name +
+        "，预算 " + std::to_string(budget_ns / 1000) + "µs");
+    return static_cast<int>(cycle_hook_count++);
+}
+
+void EtherCATMaster::clearCycleHooks() {
+    if (running) {
+        log(LogLevel::LOG_ERROR, "Hook", "主站运行中不能清除周期钩子");
+        return;
+    }
+    for (size_t i = 0; i < cycle_hook_count; i++) {
+        cycle_hooks[i].enabled = false;
+        cycle_hooks[i].function = nullptr;
+        cycle_hooks[i].name.clear();
+    }
+    cycle_hook_count = 0;
+}
+
+bool EtherCATMaster::setCycleHookEnabled(int hook_id, bool enabled) {
+    if (hook_id < 0 || static_cast<size_t>(hook_id) >= cycle_hook_count) {
+        return false;
+    }
+    CycleHook& hook = cycle_hooks[hook_id];
+    if (enabled) {
+        hook.disabled_by_budget = false;
+    }
+    hook.enabled = enabled;
+    return true;
+}
+
+CycleHookStats EtherCATMaster::getCycleHookStats(int hook_id) const {
+    CycleHookStats stats;
+    if (hook_id < 0 || static_cast<size_t>(hook_id) >= cycle_hook_count) {
+        return stats;
+    }
+    const CycleHook& hook = cycle_hooks[hook_id];
+    stats.name = hook.name;
+    stats.budget_ns = hook.budget_ns;
+    stats.enabled = hook.enabled;
+    stats.disabled_by_budget = hook.disabled_by_budget;
+    stats.calls = hook.calls.load(std::memory_order_relaxed);
+    stats.budget_violations = hook.budget_violations.load(std::memory_order_relaxed);
+    stats.last_ns = hook.last_ns.load(std::memory_order_relaxed);
+    stats.max_ns = hook.max_ns.load(std::memory_order_relaxed);
+    uint64_t total_ns = hook.total_ns.load(std::memory_order_relaxed);
+    stats.mean_ns = stats.calls > 0 ? static_cast<double>(total_ns) / stats.calls : 0.0;
+    return stats;
+}
+
+// 周期线程：按注册顺序执行启用的钩子，测量耗时并执行预算
+void EtherCATMaster::runCycleHooks(int64_t timestamp_ns, bool analog_updated, bool digital_updated, bool relay_due) {
+    CycleHookContext context;
+    context.cycle = cycle_count;
+    context.timestamp_ns = timestamp_ns;
+    context.inputs = &input_snapshot_rt;
+    context.analog_updated = analog_updated;
+    context.digital_updated = digital_updated;
+    context.relay_due = relay_due;
+    context.relay_outputs = relay_output_image;
+    
+    for (size_t i = 0; i < cycle_hook_count; i++) {
+        CycleHook& hook = cycle_hooks[i];
+        if (!hook.enabled.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        
+        int64_t t_begin = monotonicNowNs();
+        hook.function(context, hook.user_data);
+        int64_t elapsed_ns = monotonicNowNs() - t_begin;
+        
+        // 单写者：relaxed 读改写即可
+        hook.calls.store(hook.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        hook.total_ns.store(hook.total_ns.load(std::memory_order_relaxed) + static_cast<uint64_t>(elapsed_ns),
+                            std::memory_order_relaxed);
+        hook.last_ns.store(elapsed_ns, std::memory_order_relaxed);
+        if (elapsed_ns > hook.max_ns.load(std::memory_order_relaxed)) {
+            hook.max_ns.store(elapsed_ns, std::memory_order_relaxed);
+        }
+        
+        if (elapsed_ns > hook.budget_ns) {
+            hook.budget_violations.store(hook.budget_violations.load(std::memory_order_relaxed) + 1,
+                                         std::memory_order_relaxed);
+            // 连续超预算则禁用，防止拖垮整个周期
+            if (++hook.consecutive_violations >= CYCLE_HOOK_MAX_VIOLATIONS) {
+                hook.enabled.store(false, std::memory_order_relaxed);
+                hook.disabled_by_budget.store(true, std::memory_order_relaxed);
+                hook.consecutive_violations = 0;
+                cycle_hook_event_queue.tryPush(static_cast<uint32_t>(i));
+            }
+        } else {
+            hook.consecutive_violations = 0;
+        }
+    }
+    
+    // 安全输出状态下忽略钩子对继电器的修改
+    if (!safe_outputs_active.load(std::memory_order_relaxed)) {
+        relay_output_image = context.relay_outputs;
+        relay_states.store(relay_output_image);
+    }
+}
+
+void EtherCATMaster::dispatchCycleHookEvents() {
+    uint32_t hook_id = 0;
+    while (cycle_hook_event_queue.tryPop(hook_id)) {
+        CycleHookStats stats = getCycleHookStats(static_cast<int>(hook_id));
+        log(LogLevel::LOG_ERROR, "Hook", "周期钩子 #" + std::to_string(hook_id) + " " + stats.name +
+            " 连续 " + std::to_string(CYCLE_HOOK_MAX_VIOLATIONS) + " 次超出预算 " +
+            std::to_string(stats.budget_ns / 1000) + "µs（最近 " + std::to_string(stats.last_ns / 1000) +
+            "µs），已禁用");
+    }
+}
+
+std::string EtherCATMaster::getCycleMetricName(CycleMetric metric) {
+    switch (metric) {
+        case CycleMetric::WAKEUP_LATENCY:
+            return "唤醒延迟";
+        case CycleMetric::RECEIVE:
+            return "接收";
+        case CycleMetric::DOMAIN_PROCESS:
+            return "域处理";
+        case CycleMetric::PUBLISH_SNAPSHOT:
+            return "快照发布";
+        case CycleMetric::USER_HOOKS:
+            return "周期钩子";
+        case CycleMetric::WRITE_OUTPUTS:
+            return "写输出";
+        case CycleMetric::SEND:
+            return "发送";
+        case CycleMetric::CYCLE_EXECUTION:
+            return "周期执行";
+        case CycleMetric::PERIOD_ERROR:
+            return "周期误差";
+        default:
+            return "未知指标";
+    }
+}
+
+// 监督线程：报告各域状态变化
+void EtherCATMaster::checkDomainState() {
+    for (size_t i = 0; i < PROCESS_DOMAIN_COUNT; i++) {
+        ProcessDomain& d = domains[i];
+        ec_domain_state_t ds;
+        if (!loadDomainState(d, ds)) {
+            continue;
+        }
+        
+        const std::string name = getProcessDomainName(static_cast<ProcessDomainId>(i));
+        if (ds.working_counter != d.reported_state.working_counter) {
+            log(LogLevel::LOG_INFO, "Domain", name + " WC " + std::to_string(ds.working_counter));
+        }
+        if (ds.wc_state != d.reported_state.wc_state) {
+            log(ds.wc_state == EC_WC_COMPLETE ? LogLevel::LOG_INFO : LogLevel::LOG_WARNING,
+                "Domain", name + " State " + std::to_string(static_cast<int>(ds.wc_state)));
+        }
+        d.reported_state = ds;
+    }
+}
+
+void EtherCATMaster::writeRelayOutputs() {
+    uint8_t* domain_data = domainData(ProcessDomainId::DOMAIN_RELAY_OUT);
+    if (!domain_data) return;
+    
+    // 各继电器通道的位位置在编译期确定
+    relay_terminals.writeMask(domain_data, relay_output_image);
+}
+
+// ==================== 继电器命令队列 ====================
+std::future<RelayCommandResult> EtherCATMaster::submitRelayCommand(uint8_t mask, uint8_t value,
+                                                                   RelayCommandCallback callback,
+                                                                   bool toggle) {
+    RelayCommandResult result;
+    result.command_id = next_relay_command_id.fetch_add(1);
+    mask &= relay_channel_mask;
+    
+    // 槽由监督线程在完成后归还；没有空闲槽时与队列满一样直接拒绝，不在调用线程之外分配
+    uint16_t slot_index = 0;
+    if (!running || mask == 0 || !relay_free_slots.tryPop(slot_index)) {
+        if (running && mask != 0) {
+            log(LogLevel::LOG_ERROR, "Relay", "继电器命令槽已用完");
+        }
+        result.status = RelayCommandStatus::RELAY_CMD_REJECTED;
+        result.outputs = relay_states.load();
+        std::promise<RelayCommandResult> rejected;
+        rejected.set_value(result);
+        if (callback) {
+            try {
+                callback(result);
+            } catch (const std::exception& e) {
+                log(LogLevel::LOG_ERROR, "Relay", std::string("继电器命令回调异常: ") + e.what());
+            }
+        }
+        return rejected.get_future();
+    }
+    
+    RelayCommandSlot& slot = relay_slots[slot_index];
+    slot.mask = mask;
+    slot.value = value & mask;
+    slot.toggle = toggle;
+    slot.result = result;
+    slot.promise = std::promise<RelayCommandResult>();
+    slot.callback = std::move(callback);
+    std::future<RelayCommandResult> future = slot.promise.get_future();
+    
+    if (!relay_command_queue.tryPush(slot_index)) {
+        log(LogLevel::LOG_ERROR, "Relay", "继电器命令队列已满");
+        slot.result.status = RelayCommandStatus::RELAY_CMD_REJECTED;
+        slot.result.outputs = relay_states.load();
+        completeRelayCommand(slot_index);
+    }
+    
+    return future;
+}
+
+// 周期线程：每周期调用；ds 非空表示本周期收到了继电器域的回帧
+void EtherCATMaster::confirmRelayCommands(const ec_domain_state_t* ds) {
+    // 已发送的命令：继电器域的回帧即是其回帧，按该域WKC判断是否确认
+    if (relay_in_flight_count > 0) {
+        bool wkc_complete = (ds != nullptr && ds->wc_state == EC_WC_COMPLETE);
+        
+        size_t kept = 0;
+        for (size_t i = 0; i < relay_in_flight_count; i++) {
+            uint16_t slot_index = relay_in_flight[i];
+            RelayCommandResult& result = relay_slots[slot_index].result;
+            if (result.status == RelayCommandStatus::RELAY_CMD_PENDING) {
+                if (wkc_complete) {
+                    result.status = RelayCommandStatus::RELAY_CMD_CONFIRMED;
+                    result.confirmed_cycle = cycle_count;
+                } else if (static_cast<int64_t>(cycle_count - result.sent_cycle) >= relay_confirm_timeout_cycles) {
+                    result.status = RelayCommandStatus::RELAY_CMD_TIMEOUT;
+                }
+            }
+            // 完成队列满时留到下一周期再交付
+            if (result.status == RelayCommandStatus::RELAY_CMD_PENDING ||
+                !relay_completion_queue.tryPush(slot_index)) {
+                relay_in_flight[kept++] = slot_index;
+            }
+        }
+        relay_in_flight_count = kept;
+    }
+}
+
+// 周期线程：继电器域排队前调用，在写输出之前
+void EtherCATMaster::applyRelayCommands() {
+    // 安全输出状态：继电器全部断开
+    bool safe_outputs = safe_outputs_active.load(std::memory_order_relaxed);
+    if (safe_outputs) {
+        relay_output_image = 0;
+    }
+    
+    // 取出新命令，按入队顺序应用到本周期输出
+    uint16_t slot_index = 0;
+    while (relay_in_flight_count < relay_in_flight.size() && relay_command_queue.tryPop(slot_index)) {
+        RelayCommandSlot& slot = relay_slots[slot_index];
+        if (safe_outputs) {
+            // 安全输出状态下拒绝新命令，下一周期随完成队列交付
+            slot.result.status = RelayCommandStatus::RELAY_CMD_REJECTED;
+        } else {
+            if (slot.toggle) {
+                relay_output_image ^= slot.mask;
+            } else {
+                relay_output_image = static_cast<uint8_t>((relay_output_image & ~slot.mask) | slot.value);
+            }
+            slot.result.sent_cycle = cycle_count;
+        }
+        slot.result.outputs = relay_output_image;
+        relay_in_flight[relay_in_flight_count++] = slot_index;
+    }
+    
+    relay_states.store(relay_output_image);
+}
+
+void EtherCATMaster::completeRelayCommand(uint16_t slot_index) {
+    RelayCommandSlot& slot = relay_slots[slot_index];
+    slot.promise.set_value(slot.result);
+    if (slot.callback) {
+        try {
+            slot.callback(slot.result);
+        } catch (const std::exception& e) {
+            log(LogLevel::LOG_ERROR, "Relay", std::string("继电器命令回调异常: ") + e.what());
+        }
+        slot.callback = nullptr;
+    }
+    relay_free_slots.tryPush(slot_index);
+}
+
+void EtherCATMaster::dispatchRelayCompletions() {
+    uint16_t slot_index = 0;
+    while (relay_completion_queue.tryPop(slot_index)) {
+        const RelayCommandResult& result = relay_slots[slot_index].result;
+        if (result.status == RelayCommandStatus::RELAY_CMD_TIMEOUT) {
+            log(LogLevel::LOG_WARNING, "Relay", "继电器命令 #" + std::to_string(result.command_id) +
+                " 在周期 " + std::to_string(result.sent_cycle) + " 发送后未得到WKC确认");
+        }
+        completeRelayCommand(slot_index);
+    }
+}
+
+// 仅在周期线程和监督线程都退出后调用
+void EtherCATMaster::cancelPendingRelayCommands() {
+    dispatchRelayCompletions();
+    
+    for (size_t i = 0; i < relay_in_flight_count; i++) {
+        relay_slots[relay_in_flight[i]].result.status = RelayCommandStatus::RELAY_CMD_CANCELLED;
+        completeRelayCommand(relay_in_flight[i]);
+    }
+    relay_in_flight_count = 0;
+    
+    uint16_t slot_index = 0;
+    while (relay_command_queue.tryPop(slot_index)) {
+        relay_slots[slot_index].result.status = RelayCommandStatus::RELAY_CMD_CANCELLED;
+        completeRelayCommand(slot_index);
+    }
+}
+
+bool EtherCATMaster::deenergizeRelaysForStop() {
+    uint8_t mask = relay_channel_mask;
+    if (mask == 0) {
+        return true;
+    }
+    // 重配置失败后周期线程停住，不再发帧，命令无法送出
+    if (cycle_parked.load(std::memory_order_acquire)) {
+        log(LogLevel::LOG_WARNING, "Relay", "周期线程已停住，停止前无法关闭继电器");
+        return false;
+    }
+    
+    std::future<RelayCommandResult> future = submitRelayCommand(mask, 0x00);
+    if (!waitRelayCommand(future, RELAY_SHUTDOWN_TIMEOUT_MS)) {
+        log(LogLevel::LOG_WARNING, "Relay", "停止前关闭继电器在 " + std::to_string(RELAY_SHUTDOWN_TIMEOUT_MS) +
+            "ms 内未完成");
+        return false;
+    }
+    RelayCommandResult result = future.get();
+    if (!result.confirmed()) {
+        log(LogLevel::LOG_WARNING, "Relay", std::string("停止前关闭继电器未得到确认: ") +
+            (result.status == RelayCommandStatus::RELAY_CMD_TIMEOUT ? "WKC 超时" : "命令被拒绝"));
+        return false;
+    }
+    log(LogLevel::LOG_INFO, "Relay", "全部继电器已关闭 (周期 " + std::to_string(result.sent_cycle) + " 发送，周期 " +
+        std::to_string(result.confirmed_cycle) + " 确认)");
+    return true;
+}
+
+bool EtherCATMaster::waitRelayCommand(std::future<RelayCommandResult>& future, int timeout_ms) {
+    if (!clock->isVirtual()) {
+        return future.wait_for(std::chrono::milliseconds(timeout_ms)) == std::future_status::ready;
+    }
+    int64_t deadline_ns = clock->nowNs() + msToNs(timeout_ms);
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (clock->nowNs() >= deadline_ns) {
+            return false;
+        }
+        clock->sleepFor(msToNs(1));
+    }
+    return true;
+}
 
-    // uint8_t* output_data = domain_data + off_relay_out[0];
-    // uint8_t channel_state = (current_states) ? 0x01 : 0;
-    // EC_WRITE_U8(output_data, channel_state);
+// ==================== SDO 请求 ====================
+static std::string formatSdoAddress(uint16_t position, uint16_t index, uint8_t subindex) {
+    char buffer[48];
+    std::snprintf(buffer, sizeof(buffer), "位置 %u 0x%04x:%02x", static_cast<unsigned int>(position),
+                  static_cast<unsigned int>(index), static_cast<unsigned int>(subindex));
+    return buffer;
+}
+
+int EtherCATMaster::createSdoRequest(uint16_t position, uint16_t index, uint8_t subindex, size_t size,
+                                     uint32_t timeout_ms) {
+    const std::string address = formatSdoAddress(position, index, subindex);
+    if (initialized || backend->isMasterRequested()) {
+        log(LogLevel::LOG_ERROR, "SDO", "主站已初始化，无法创建 SDO 请求: " + address);
+        return -1;
+    }
+    if (sdo_request_count >= MAX_SDO_REQUESTS) {
+        log(LogLevel::LOG_ERROR, "SDO", "SDO 请求数已达上限 " + std::to_string(MAX_SDO_REQUESTS));
+        return -1;
+    }
+    if (size == 0 || size > SDO_REQUEST_MAX_SIZE) {
+        log(LogLevel::LOG_ERROR, "SDO", "SDO 请求长度无效 (" + std::to_string(size) + " 字节): " + address);
+        return -1;
+    }
+    
+    SdoRequestSlot& slot = sdo_requests[sdo_request_count];
+    slot.position = position;
+    slot.index = index;
+    slot.subindex = subindex;
+    slot.size = size;
+    slot.timeout_ms = timeout_ms;
+    slot.backend_request.store(-1);
+    return static_cast<int>(sdo_request_count++);
+}
+
+bool EtherCATMaster::isSdoRequestAvailable(int request_id) const {
+    return initialized && request_id >= 0 && static_cast<size_t>(request_id) < sdo_request_count &&
+           sdo_requests[request_id].backend_request.load() >= 0;
+}
+
+// 主站配置阶段（activate() 之前）：为刚配置的从站创建其全部请求，config 为该从站的配置序号
+void EtherCATMaster::createBackendSdoRequests(uint16_t position, size_t config) {
+    for (size_t i = 0; i < sdo_request_count; i++) {
+        SdoRequestSlot& slot = sdo_requests[i];
+        if (slot.position != position) continue;
+        int handle = backend->createSdoRequest(config, slot.index, slot.subindex, slot.size, slot.timeout_ms);
+        slot.backend_request.store(handle);
+        if (handle < 0) {
+            log(LogLevel::LOG_WARNING, "SDO", "后端 " + backend->getName() + " 无法创建 SDO 请求 #" +
+                std::to_string(i) + ": " + formatSdoAddress(slot.position, slot.index, slot.subindex));
+        }
+    }
+}
+
+std::future<SdoRequestResult> EtherCATMaster::readSdo(int request_id, SdoRequestCallback callback) {
+    // 操作由监督线程在完成后释放
+    SdoOperation* operation = new SdoOperation();
+    operation->result.request_id = request_id;
+    operation->result.write = false;
+    operation->callback = callback;
+    return submitSdoOperation(operation);
+}
+
+std::future<SdoRequestResult> EtherCATMaster::writeSdo(int request_id, const uint8_t* data, size_t size,
+                                                       SdoRequestCallback callback) {
+    SdoOperation* operation = new SdoOperation();
+    operation->result.request_id = request_id;
+    operation->result.write = true;
+    if (data && size <= SDO_REQUEST_MAX_SIZE) {
+        std::memcpy(operation->result.data.data(), data, size);
+        operation->result.size = size;
+    }
+    operation->callback = callback;
+    return submitSdoOperation(operation);
+}
+
+std::future<SdoRequestResult> EtherCATMaster::writeSdoValue(int request_id, uint32_t value,
+                                                            SdoRequestCallback callback) {
+    uint8_t bytes[4];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    // 对象长度超过 4 字节时长度为 0，由 submitSdoOperation 拒绝
+    size_t size = 0;
+    if (request_id >= 0 && static_cast<size_t>(request_id) < sdo_request_count &&
+        sdo_requests[request_id].size <= sizeof(bytes)) {
+        size = sdo_requests[request_id].size;
+    }
+    return writeSdo(request_id, bytes, size, callback);
+}
+
+std::future<SdoRequestResult> EtherCATMaster::submitSdoOperation(SdoOperation* operation) {
+    SdoRequestResult& result = operation->result;
+    result.operation_id = next_sdo_operation_id.fetch_add(1);
+    std::future<SdoRequestResult> future = operation->promise.get_future();
+    
+    bool valid = result.request_id >= 0 && static_cast<size_t>(result.request_id) < sdo_request_count;
+    std::string reason;
+    if (valid) {
+        const SdoRequestSlot& slot = sdo_requests[result.request_id];
+        result.position = slot.position;
+        result.index = slot.index;
+        result.subindex = slot.subindex;
+        if (!running) {
+            reason = "主站未运行";
+        } else if (slot.backend_request.load() < 0) {
+            reason = "请求不可用（从站未配置或后端不支持）";
+        } else if (result.write && result.size != slot.size) {
+            reason = "写入长度 " + std::to_string(result.size) + " 与对象长度 " + std::to_string(slot.size) + " 不符";
+        } else if (!sdo_operation_queue.tryPush(operation)) {
+            reason = "SDO 操作队列已满";
+        }
+    } else {
+        reason = "无效的请求ID " + std::to_string(result.request_id);
+    }
+    
+    if (!reason.empty()) {
+        log(LogLevel::LOG_ERROR, "SDO", std::string(result.write ? "SDO 写入" : "SDO 读取") + "被拒绝: " + reason);
+        result.status = SdoRequestStatus::SDO_REJECTED;
+        completeSdoOperation(operation);
+    }
+    return future;
+}
+
+// 周期线程：同一请求同时只有一个传输，按提交顺序发起；后端在后续周期的帧中完成邮箱收发，这里只查询状态
+void EtherCATMaster::advanceSdoRequests() {
+    SdoOperation* operation = nullptr;
+    while (sdo_in_flight_count < sdo_in_flight.size() && sdo_operation_queue.tryPop(operation)) {
+        sdo_in_flight[sdo_in_flight_count++] = operation;
+    }
+    
+    size_t kept = 0;
+    for (size_t i = 0; i < sdo_in_flight_count; i++) {
+        operation = sdo_in_flight[i];
+        SdoRequestResult& result = operation->result;
+        size_t id = static_cast<size_t>(result.request_id);
+        int handle = sdo_requests[id].backend_request.load(std::memory_order_relaxed);
+        
+        if (result.status == SdoRequestStatus::SDO_PENDING) {
+            if (sdo_active[id] == operation) {
+                ec_request_state_t state = backend->getSdoRequestState(handle);
+                if (state == EC_REQUEST_SUCCESS) {
+                    if (!result.write) {
+                        result.size = std::min(backend->getSdoRequestDataSize(handle), result.data.size());
+                        std::memcpy(result.data.data(), backend->getSdoRequestData(handle), result.size);
+                    }
+                    result.status = SdoRequestStatus::SDO_SUCCESS;
+                } else if (state == EC_REQUEST_ERROR) {
+                    result.status = SdoRequestStatus::SDO_ERROR;
+                }
+                if (result.status != SdoRequestStatus::SDO_PENDING) {
+                    result.completed_cycle = cycle_count;
+                    sdo_active[id] = nullptr;
+                }
+            } else if (sdo_active[id] == nullptr) {
+                // 热重配置后从站不在位时请求不再可用
+                uint8_t* data = handle >= 0 ? backend->getSdoRequestData(handle) : nullptr;
+                if (!data) {
+                    result.status = SdoRequestStatus::SDO_REJECTED;
+                } else if (result.write) {
+                    std::memcpy(data, result.data.data(), result.size);
+                    backend->writeSdoRequest(handle);
+                } else {
+                    backend->readSdoRequest(handle);
+                }
+                if (data) {
+                    result.issued_cycle = cycle_count;
+                    sdo_active[id] = operation;
+                }
+            }
+        }
+        // 完成队列满时留到下一周期再交付
+        if (result.status == SdoRequestStatus::SDO_PENDING || !sdo_completion_queue.tryPush(operation)) {
+            sdo_in_flight[kept++] = operation;
+        }
+    }
+    sdo_in_flight_count = kept;
+}
+
+void EtherCATMaster::completeSdoOperation(SdoOperation* operation) {
+    operation->promise.set_value(operation->result);
+    if (operation->callback) {
+        try {
+            operation->callback(operation->result);
+        } catch (const std::exception& e) {
+            log(LogLevel::LOG_ERROR, "SDO", std::string("SDO 回调异常: ") + e.what());
+        }
+    }
+    delete operation;
+}
+
+void EtherCATMaster::dispatchSdoCompletions() {
+    SdoOperation* operation = nullptr;
+    while (sdo_completion_queue.tryPop(operation)) {
+        const SdoRequestResult& result = operation->result;
+        if (result.status != SdoRequestStatus::SDO_SUCCESS) {
+            log(LogLevel::LOG_WARNING, "SDO", std::string(result.write ? "SDO 写入" : "SDO 读取") + "失败: " +
+                formatSdoAddress(result.position, result.index, result.subindex) +
+                (result.status == SdoRequestStatus::SDO_CANCELLED ? "（主站重新配置）" : ""));
+        }
+        completeSdoOperation(operation);
+    }
+}
+
+// 仅在周期线程和监督线程都退出后调用
+void EtherCATMaster::cancelPendingSdoOperations() {
+    dispatchSdoCompletions();
+    
+    for (size_t i = 0; i < sdo_in_flight_count; i++) {
+        sdo_in_flight[i]->result.status = SdoRequestStatus::SDO_CANCELLED;
+        completeSdoOperation(sdo_in_flight[i]);
+        sdo_in_flight[i] = nullptr;
+    }
+    sdo_in_flight_count = 0;
+    sdo_active.fill(nullptr);
+    
+    SdoOperation* operation = nullptr;
+    while (sdo_operation_queue.tryPop(operation)) {
+        operation->result.status = SdoRequestStatus::SDO_CANCELLED;
+        completeSdoOperation(operation);
+    }
+}
 
+// ==================== 监督线程 ====================
+void EtherCATMaster::supervisorThreadFunc() {
+    const auto health_interval = std::chrono::milliseconds(100);
+    clock->enterParticipant();
+    auto next_health_check = clockNow();
+    
+    // 从干净的基线开始报告状态变化
+    memset(&master_state, 0, sizeof(master_state));
+    for (auto& d : domains) {
+        memset(&d.reported_state, 0, sizeof(d.reported_state));
+    }
+    
+    while (running) {
+        dispatchRelayCompletions();
+        dispatchSdoCompletions();
+        dispatchSlaveStateEvents();
+        dispatchCycleOverrunEvents();
+        dispatchCycleHookEvents();
+        
+        auto now = clockNow();
+        if (now >= next_health_check) {
+            updateMasterStatus();
+            checkDomainState();
+            checkMasterState();
+            checkBusState();
+            reclaimCalibrations();
+            next_health_check = now + health_interval;
+        }
+        
+        clock->sleepFor(msToNs(1));
+    }
+    clock->leaveParticipant();
+    dispatchRelayCompletions();
+    dispatchSdoCompletions();
+    dispatchSlaveStateEvents();
+    dispatchCycleOverrunEvents();
+    dispatchCycleHookEvents();
+}
+
+// ==================== 状态字发布 ====================
+void EtherCATMaster::publishDomainState(ProcessDomain& d, const ec_domain_state_t& ds) {
+    uint64_t word = STATE_WORD_VALID
+                  | static_cast<uint64_t>(ds.working_counter & 0xFFFFFFFFu)
+                  | (static_cast<uint64_t>(ds.wc_state & 0xFF) << 32);
+    d.published_state.store(word, std::memory_order_release);
+}
+
+void EtherCATMaster::publishMasterState() {
+    ec_master_state_t ms;
+    backend->getMasterState(ms);
+    
+    uint64_t word = STATE_WORD_VALID
+                  | static_cast<uint64_t>(ms.slaves_responding & 0xFFFFFFFFu)
+                  | (static_cast<uint64_t>(ms.al_states & 0xFF) << 32)
+                  | (static_cast<uint64_t>(ms.link_up ? 1 : 0) << 40);
+    published_master_state.store(word, std::memory_order_release);
+    
+    // 逐从站状态：身份被换掉的从站不再与配置匹配，同样表现为离线
+    uint64_t slaves = STATE_WORD_VALID;
+    size_t count = std::min(slave_configs.size(), MAX_MONITORED_SLAVES);
+    for (size_t i = 0; i < count; i++) {
+        ec_slave_config_state_t ss;
+        if (!backend->getSlaveConfigState(i, ss)) {
+            slaves = 0;
+            break;
+        }
+        slaves |= (static_cast<uint64_t>(ss.online ? 1 : 0) << i)
+                | (static_cast<uint64_t>(ss.operational ? 1 : 0) << (32 + i));
+    }
+    published_slave_states.store(slaves, std::memory_order_release);
+}
+
+bool EtherCATMaster::loadDomainState(const ProcessDomain& d, ec_domain_state_t& ds) const {
+    uint64_t word = d.published_state.load(std::memory_order_acquire);
+    if (!(word & STATE_WORD_VALID)) {
+        return false;
+    }
+    memset(&ds, 0, sizeof(ds));
+    ds.working_counter = static_cast<unsigned int>(word & 0xFFFFFFFFu);
+    ds.wc_state = static_cast<ec_wc_state_t>((word >> 32) & 0xFF);
+    return true;
+}
 
-    uint8_t* output_data = domain_data + off_relay_out[0];
-    EC_WRITE_U8(output_data, current_states);
+bool EtherCATMaster::loadMasterState(ec_master_state_t& ms) const {
+    uint64_t word = published_master_state.load(std::memory_order_acquire);
+    if (!(word & STATE_WORD_VALID)) {
+        return false;
+    }
+    memset(&ms, 0, sizeof(ms));
+    ms.slaves_responding = static_cast<unsigned int>(word & 0xFFFFFFFFu);
+    ms.al_states = static_cast<unsigned int>((word >> 32) & 0xFF);
+    ms.link_up = static_cast<unsigned int>((word >> 40) & 0x1);
+    return true;
 }
 
+// 监督线程：报告主站状态变化
 void EtherCATMaster::checkMasterState() {
     ec_master_state_t ms;
-    ecrt_master_state(master, &ms);
+    if (!loadMasterState(ms)) {
+        return;
+    }
     
     if (ms.slaves_responding != master_state.slaves_responding) {
-        std::cout << "Slaves: " << ms.slaves_responding << std::endl;
+        log(LogLevel::LOG_INFO, "Master", "Slaves: " + std::to_string(ms.slaves_responding));
     }
     if (ms.al_states != master_state.al_states) {
-        std::cout << "AL states: 0x" << std::hex << ms.al_states << std::dec << std::endl;
+        std::ostringstream oss;
+        oss << "AL states: 0x" << std::hex << static_cast<unsigned int>(ms.al_states);
+        log(LogLevel::LOG_INFO, "Master", oss.str());
     }
     if (ms.link_up != master_state.link_up) {
-        std::cout << "Link: " << (ms.link_up ? "up" : "down") << std::endl;
+        log(ms.link_up ? LogLevel::LOG_INFO : LogLevel::LOG_ERROR, "Master",
+            std::string("Link: ") + (ms.link_up ? "up" : "down"));
     }
     master_state = ms;
 }
 
+// ==================== 启动计时与热启动 ====================
+static std::string alStateName(uint8_t state) {
+    switch (state) {
+        case 0: return "离线";
+        case EC_AL_STATE_INIT: return "INIT";
+        case EC_AL_STATE_PREOP: return "PREOP";
+        case 0x03: return "BOOT";
+        case EC_AL_STATE_SAFEOP: return "SAFEOP";
+        case EC_AL_STATE_OP: return "OP";
+        default: {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "0x%02X", state);
+            return buf;
+        }
+    }
+}
+
+StartupTiming EtherCATMaster::getStartupTiming() const {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    return startup_timing;
+}
+
+// 周期线程：逐个已配置从站比较 AL 状态，变化时发出事件；后端不支持逐从站状态时按汇总状态判断
+bool EtherCATMaster::trackStartupStates() {
+    int64_t elapsed_ns = monotonicNowNs() - cycle_start_ns;
+    size_t count = std::min(slave_configs.size(), MAX_MONITORED_SLAVES);
+    bool per_slave = count > 0;
+    uint32_t operational = 0;
+    for (size_t i = 0; i < count; i++) {
+        ec_slave_config_state_t ss;
+        if (!backend->getSlaveConfigState(i, ss)) {
+            per_slave = false;
+            break;
+        }
+        uint8_t state = ss.online ? static_cast<uint8_t>(ss.al_state & 0x0F) : 0;
+        if (state != startup_states_rt[i]) {
+            SlaveStateEvent event = {static_cast<uint16_t>(i), startup_states_rt[i], state, false, cycle_count, elapsed_ns};
+            slave_state_event_queue.tryPush(event);     // 队列满时丢弃该事件，不影响进入 OP 的判断
+            startup_states_rt[i] = state;
+        }
+        if (ss.operational) {
+            operational |= 1u << i;
+        }
+    }
+    
+    bool reached;
+    if (per_slave) {
+        reached = (operational & startup_required_mask) == startup_required_mask;
+    } else {
+        ec_master_state_t ms;
+        backend->getMasterState(ms);
+        uint8_t state = ms.link_up ? static_cast<uint8_t>(ms.al_states & 0x0F) : 0;
+        if (state != startup_master_state_rt) {
+            SlaveStateEvent event = {SLAVE_STATE_ALL, startup_master_state_rt, state, false, cycle_count, elapsed_ns};
+            slave_state_event_queue.tryPush(event);
+            startup_master_state_rt = state;
+        }
+        reached = state == EC_AL_STATE_OP && ms.slaves_responding >= expectedSlaveCount();
+    }
+    if (!reached) {
+        return false;
+    }
+    
+    // 进入 OP 的事件不能丢，队列满时下个周期重试
+    SlaveStateEvent event = {SLAVE_STATE_ALL, 0, EC_AL_STATE_OP, true, cycle_count, elapsed_ns};
+    if (!slave_state_event_queue.tryPush(event)) {
+        return false;
+    }
+    startup_tracking.store(false, std::memory_order_release);
+    return true;
+}
+
+void EtherCATMaster::dispatchSlaveStateEvents() {
+    SlaveStateEvent event;
+    while (slave_state_event_queue.tryPop(event)) {
+        int64_t elapsed_us = event.elapsed_ns / 1000;
+        if (event.all_operational) {
+            if (startup_op_reported) {
+                continue;
+            }
+            startup_op_reported = true;
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                startup_timing.time_to_op_us = elapsed_us;
+                startup_timing.op_cycle = event.cycle;
+            }
+            log(LogLevel::LOG_INFO, "Master", "必需从站已全部进入 OP (周期 " + std::to_string(event.cycle) +
+                ")，周期线程启动后 " + formatDurationUs(elapsed_us));
+            startup_op_promise.set_value(event.cycle);
+            continue;
+        }
+        
+        SlaveStateTransition transition;
+        if (event.config == SLAVE_STATE_ALL) {
+            transition.position = SLAVE_STATE_ALL;
+            transition.name = "全部从站";
+        } else {
+            const TopologySlave& slave = topology.getSlaves()[slave_configs[event.config]];
+            transition.position = slave.position;
+            transition.name = slave.name;
+        }
+        transition.from_state = event.from_state;
+        transition.to_state = event.to_state;
+        transition.cycle = event.cycle;
+        transition.elapsed_us = elapsed_us;
+        std::string where = transition.position == SLAVE_STATE_ALL ? transition.name :
+                            "位置 " + std::to_string(transition.position) + " (" + transition.name + ")";
+        log(LogLevel::LOG_INFO, "Master", where + ": " + alStateName(event.from_state) + " → " +
+            alStateName(event.to_state) + " (周期 " + std::to_string(event.cycle) + "，" +
+            formatDurationUs(elapsed_us) + ")");
+        std::lock_guard<std::mutex> lock(state_mutex);
+        startup_timing.transitions.push_back(std::move(transition));
+    }
+}
+
+// 拓扑中写入从站的配置再混入后端名称（含网卡），同一拓扑换网卡或后端时不沿用缓存
+uint64_t EtherCATMaster::configurationFingerprint() const {
+    uint64_t hash = topology.fingerprint();
+    for (unsigned char c : backend->getName()) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// 热启动缓存（小端）：u8[4] 魔数, u16 版本, u16 保留, u64 配置指纹, u32 长度, 后端数据
+static constexpr size_t WARM_START_HEADER_SIZE = 4 + 2 + 2 + 8 + 4;
+
+static std::string formatFingerprint(uint64_t fingerprint) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(fingerprint));
+    return buf;
+}
+
+bool EtherCATMaster::loadWarmStartCache(uint64_t fingerprint) {
+    if (warm_start_cache_path.empty()) {
+        return false;
+    }
+    std::ifstream file(warm_start_cache_path, std::ios::binary);
+    if (!file) {
+        log(LogLevel::LOG_INFO, "Master", "没有热启动缓存，冷启动");
+        return false;
+    }
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto readLe = [&content](size_t offset, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value |= static_cast<uint64_t>(content[offset + i]) << (8 * i);
+        }
+        return value;
+    };
+    if (content.size() < WARM_START_HEADER_SIZE ||
+        std::memcmp(content.data(), WARM_START_CACHE_MAGIC, sizeof(WARM_START_CACHE_MAGIC)) != 0 ||
+        readLe(4, 2) != WARM_START_CACHE_VERSION ||
+        readLe(16, 4) != content.size() - WARM_START_HEADER_SIZE) {
+        log(LogLevel::LOG_WARNING, "Master", "热启动缓存 " + warm_start_cache_path + " 无效，冷启动");
+        return false;
+    }
+    uint64_t cached = readLe(8, 8);
+    if (cached != fingerprint) {
+        log(LogLevel::LOG_INFO, "Master", "配置指纹已变化 (缓存 " + formatFingerprint(cached) + "，本次 " +
+            formatFingerprint(fingerprint) + ")，冷启动");
+        return false;
+    }
+    std::vector<uint8_t> data(content.begin() + WARM_START_HEADER_SIZE, content.end());
+    if (!backend->importWarmStartData(data)) {
+        log(LogLevel::LOG_INFO, "Master", "后端不使用热启动数据，冷启动");
+        return false;
+    }
+    log(LogLevel::LOG_INFO, "Master", "热启动: 配置指纹 " + formatFingerprint(fingerprint) + " 与缓存一致");
+    return true;
+}
+
+void EtherCATMaster::saveWarmStartCache(uint64_t fingerprint, const std::vector<uint8_t>& data) {
+    if (warm_start_cache_path.empty() || data.empty()) {
+        return;
+    }
+    std::vector<uint8_t> out(WARM_START_CACHE_MAGIC, WARM_START_CACHE_MAGIC + sizeof(WARM_START_CACHE_MAGIC));
+    auto putLe = [&out](uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    };
+    putLe(WARM_START_CACHE_VERSION, 2);
+    putLe(0, 2);
+    putLe(fingerprint, 8);
+    putLe(data.size(), 4);
+    out.insert(out.end(), data.begin(), data.end());
+    
+    // 先写临时文件再改名，避免下次启动读到写了一半的缓存
+    std::string tmp_path = warm_start_cache_path + ".tmp";
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    bool written = file && file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    file.close();
+    if (!written || std::rename(tmp_path.c_str(), warm_start_cache_path.c_str()) != 0) {
+        log(LogLevel::LOG_WARNING, "Master", "无法写入热启动缓存 " + warm_start_cache_path);
+        std::remove(tmp_path.c_str());
+    }
+}
+
+// 按配置顺序的位图中各从站的位置和名称，用于日志
+static std::string describeSlaves(const SlaveTopology& topology, const std::vector<size_t>& configs, uint32_t mask) {
+    std::string text;
+    for (size_t i = 0; i < configs.size() && i < MAX_MONITORED_SLAVES; i++) {
+        if (!(mask & (1u << i))) continue;
+        const TopologySlave& slave = topology.getSlaves()[configs[i]];
+        if (!text.empty()) text += ", ";
+        text += "位置 " + std::to_string(slave.position) + " (" + slave.name + ")";
+    }
+    return text;
+}
+
+// 监督线程：检测总线中断和恢复
+// 中断：链路断开，或必需的已配置从站离线（后端不支持逐从站状态时按响应从站数少于期望判断）；
+// 恢复：必需的已配置从站全部回到 OP。从站已回到总线、后端却在 BUS_RECONFIGURE_DELAY_NS 内
+// 未能使其进入 OP 时（例如端子被换成其他型号、原始套接字后端下从站重新上电）重建主站配置
+void EtherCATMaster::checkBusState() {
+    auto now = clockNow();
+    const auto reconfigure_delay = std::chrono::nanoseconds(BUS_RECONFIGURE_DELAY_NS);
+    
+    // 上次重配置失败时周期线程仍停着，主站状态不再更新，按间隔重试
+    if (cycle_park_requested.load(std::memory_order_acquire)) {
+        if (now - bus_reconfigure_time >= reconfigure_delay) {
+            reconfigureBus();
+        }
+        return;
+    }
+    
+    ec_master_state_t ms;
+    if (!loadMasterState(ms)) {
+        return;
+    }
+    uint64_t slave_word = published_slave_states.load(std::memory_order_acquire);
+    bool per_slave = (slave_word & STATE_WORD_VALID) != 0;
+    
+    size_t count = std::min(slave_configs.size(), MAX_MONITORED_SLAVES);
+    uint32_t configured = static_cast<uint32_t>((1ULL << count) - 1);
+    uint32_t required = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!topology.getSlaves()[slave_configs[i]].optional) {
+            required |= 1u << i;
+        }
+    }
+    uint32_t online = per_slave ? static_cast<uint32_t>(slave_word) & configured : configured;
+    uint32_t operational = per_slave ? static_cast<uint32_t>(slave_word >> 32) & configured : configured;
+    uint32_t offline = configured & ~online;
+    
+    // 逐个报告离线和重新上线的从站（可选从站离线只报告，不算中断）
+    uint64_t cycle = getProcessImageSnapshot().cycle;
+    if (ms.link_up && (offline & ~bus_offline_slaves)) {
+        log((offline & ~bus_offline_slaves & required) ? LogLevel::LOG_ERROR : LogLevel::LOG_WARNING, "Master",
+            "从站离线 (周期 " + std::to_string(cycle) + "): " +
+            describeSlaves(topology, slave_configs, offline & ~bus_offline_slaves));
+    }
+    if (bus_offline_slaves & online) {
+        log(LogLevel::LOG_INFO, "Master", "从站重新上线 (周期 " + std::to_string(cycle) + "): " +
+            describeSlaves(topology, slave_configs, bus_offline_slaves & online));
+    }
+    bus_offline_slaves = offline;
+    
+    bool lost;
+    bool recovered;
+    if (per_slave) {
+        lost = !ms.link_up || (online & required) != required;
+        recovered = ms.link_up && (operational & required) == required;
+    } else {
+        lost = !ms.link_up || ms.slaves_responding < expectedSlaveCount();
+        recovered = !lost && (ms.al_states & EC_AL_STATE_OP) != 0;
+    }
+    
+    if (!bus_interrupted) {
+        if (!lost) {
+            return;
+        }
+        bus_interrupted = true;
+        bus_ready = false;
+        bus_interruption_count.fetch_add(1);
+        bus_lost_time = now;
+        bus_lost_cycle = cycle;
+        bus_reconfigure_armed = false;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            bus_stats.active = true;
+            bus_stats.count++;
+            bus_stats.lost_cycle = cycle;
+            bus_stats.lost_positions.clear();
+        }
+        current_status = MasterStatus::STATUS_ERROR;
+        std::string reason = !ms.link_up ? std::string("链路断开") :
+                             "响应从站 " + std::to_string(ms.slaves_responding) + " 个，期望 " +
+                             std::to_string(expectedSlaveCount()) + " 个";
+        log(LogLevel::LOG_ERROR, "Master", "总线中断 (周期 " + std::to_string(cycle) + "): " + reason);
+        
+        // 断开全部继电器，从站回到 OP 后不会按中断前的输出重新吸合
+        submitRelayCommand(relay_channel_mask, 0);
+    }
+    
+    // 记录本次中断中离线过的从站位置
+    if (offline & required) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        for (size_t i = 0; i < count; i++) {
+            if (!(offline & required & (1u << i))) continue;
+            uint16_t position = topology.getSlaves()[slave_configs[i]].position;
+            auto& positions = bus_stats.lost_positions;
+            if (std::find(positions.begin(), positions.end(), position) == positions.end()) {
+                positions.push_back(position);
+            }
+        }
+    }
+    
+    if (recovered) {
+        int64_t downtime_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - bus_lost_time).count();
+        bus_interrupted = false;
+        bus_reconfigure_armed = false;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            bus_stats.active = false;
+            bus_stats.recovered_cycle = cycle;
+            bus_stats.last_downtime_ms = downtime_ms;
+            bus_stats.total_downtime_ms += downtime_ms;
+        }
+        log(LogLevel::LOG_INFO, "Master", "总线恢复 (周期 " + std::to_string(cycle) + "): 中断 " +
+            std::to_string(downtime_ms) + "ms，自周期 " + std::to_string(bus_lost_cycle) + " 起");
+        bus_ready = true;
+        return;
+    }
+    
+    // 从站回到总线后才有重配置的必要；回放和记录不能重新激活
+    bool returned = ms.link_up && ms.slaves_responding >= expectedSlaveCount();
+    if (!returned || !backend->supportsReconfiguration()) {
+        bus_reconfigure_armed = false;
+        return;
+    }
+    if (!bus_reconfigure_armed) {
+        bus_reconfigure_armed = true;
+        bus_reconfigure_time = now;
+    } else if (now - bus_reconfigure_time >= reconfigure_delay) {
+        reconfigureBus();
+    }
+}
+
+// 监督线程：停住周期线程后释放主站，按拓扑重新扫描、配置从站和注册 PDO 并激活，各域数据指针随之更新。
+// 主站激活后不能再增删从站配置，受影响的位置只能随整个主站配置一起重建。
+// 失败时周期线程保持停住，主站留待下次重试或 stop() 释放
+bool EtherCATMaster::reconfigureBus() {
+    bus_reconfigure_time = clockNow();
+    bus_reconfigure_armed = true;
+    
+    if (!cycle_park_requested.load(std::memory_order_acquire)) {
+        log(LogLevel::LOG_WARNING, "Master", "从站回到总线后未能进入 OP，重新配置主站");
+        cycle_parked.store(false, std::memory_order_release);
+        cycle_park_requested.store(true, std::memory_order_release);
+        while (!cycle_parked.load(std::memory_order_acquire)) {
+            if (!running) {
+                return false;
+            }
+            clock->sleepFor(msToNs(1));
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        bus_stats.reconfigurations++;
+    }
+    
+    domains_attached = false;
+    backend->releaseMaster();
+    for (auto& d : domains) {
+        d.domain = -1;
+        d.data = nullptr;
+        d.size = 0;
+    }
+    publishSlaveConfigs(std::vector<size_t>());
+    bus_offline_slaves = 0;
+    published_master_state = 0;
+    published_slave_states = 0;
+    
+    if (!backend->requestMaster(0)) {
+        log(LogLevel::LOG_ERROR, "Master", "重新配置失败: 无法请求 EtherCAT 主站");
+        return false;
+    }
+    if (!scanBus() || !createDomains() || !configureSlaves()) {
+        log(LogLevel::LOG_ERROR, "Master", "重新配置失败: 总线上的从站与拓扑不符或从站配置失败");
+        return false;
+    }
+    if (!backend->activate() || !attachDomains()) {
+        log(LogLevel::LOG_ERROR, "Master", "重新配置失败: 无法激活主站");
+        return false;
+    }
+    
+    // 可选从站的在位情况可能变化，通道数随新配置更新（周期线程停住，可直接写入）
+    input_snapshot_rt.analog_count = static_cast<uint32_t>(analog_channel_count);
+    input_snapshot_rt.digital_count = static_cast<uint32_t>(digital_input_count);
+    
+    // 周期线程在下一周期恢复交换，从站重新进入 OP 后按恢复处理
+    cycle_park_requested.store(false, std::memory_order_release);
+    log(LogLevel::LOG_INFO, "Master", "主站已重新配置: " + std::to_string(slave_configs.size()) + " 个从站");
+    return true;
+}
+
+BusInterruptionStats EtherCATMaster::getBusInterruptionStats() const {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    return bus_stats;
+}
+
 void EtherCATMaster::cancelCurrentTest() {
     test_cancelled = true;
     if (test_thread.joinable()) {
@@ -2141,45 +4553,41 @@ void EtherCATMaster::setAllRelaysAsync(bool state,
 
 // 读取模拟输入为电流值 (mA)
 float EtherCATMaster::readAnalogInputAsCurrent(uint8_t channel) {
-    if (channel < 1 || channel > 4) {
+    if (channel < 1 || channel > analog_channel_count) {
         log(LogLevel::LOG_ERROR, "Analog", "无效的模拟通道: " + std::to_string(channel));
         return 0.0f;
     }
     
-    int16_t raw_value = readAnalogInputPDO(channel);
+    int16_t raw_value = getProcessImageSnapshot().analog_raw[channel - 1];
     return convertAnalogToCurrent(raw_value);
 }
 
 // 读取所有模拟输入为电流值
 std::vector<float> EtherCATMaster::readAllAnalogInputsAsCurrent() {
-    std::vector<float> currents(4);
+    std::vector<float> currents(analog_channel_count);
     
-    for (int i = 0; i < 4; i++) {
-        int16_t raw_value = readAnalogInputPDO(i + 1);
-        currents[i] = convertAnalogToCurrent(raw_value);
-    }
+    ProcessImageSnapshot snapshot = getProcessImageSnapshot();
+    convertAnalogToCurrent(snapshot.analog_raw, currents.data(), currents.size());
     
     return currents;
 }
 
 // 读取所有模拟输入为压力值
 std::vector<float> EtherCATMaster::readAllAnalogInputsAsPressure() {
-    std::vector<float> pressures(4, 0.0f);
+    std::vector<float> pressures(analog_channel_count, 0.0f);
     
     if (!running) {
         std::cerr << "[DEBUG] readAllAnalogInputsAsPressure: running=false" << std::endl;
         return pressures;
     }
-    if (!domain_data) {
+    if (!domains_attached) {
         std::cerr << "[DEBUG] readAllAnalogInputsAsPressure: domain_data=nullptr" << std::endl;
         return pressures;
     }
     
-    for (int i = 0; i < 4; i++) {
-        int16_t raw_value = readAnalogInputPDO(i + 1);
-        float current_value = convertAnalogToCurrent(raw_value);
-        pressures[i] = convertCurrentToPressure(current_value);
-    }
+    AnalogBlock block;
+    convertAnalogBlock(getProcessImageSnapshot(), block);
+    std::copy(block.pressures, block.pressures + std::min<size_t>(block.count, pressures.size()), pressures.begin());
     
     return pressures;
 }
@@ -2205,11 +4613,14 @@ void EtherCATMaster::readAllAnalogInputsAsync(
                       const std::vector<std::string>&)> callback) {
     std::lock_guard<std::mutex> lock(task_mutex);
     task_queue.push([this, callback]() {
-        std::vector<float> pressures = readAllAnalogInputsAsPressure();
-        std::vector<std::string> statuses(4);
-        for (int i = 0; i < 4; i++) {
-            PressureStatus status = checkPressureStatus(i + 1);
-            statuses[i] = getPressureStatusString(status);
+        AnalogBlock block;
+        convertAnalogBlock(getProcessImageSnapshot(), block);
+        std::vector<float> pressures(analog_channel_count, 0.0f);
+        std::vector<std::string> statuses(analog_channel_count);
+        for (size_t i = 0; i < statuses.size(); i++) {
+            bool sampled = i < block.count;
+            pressures[i] = sampled ? block.pressures[i] : 0.0f;
+            statuses[i] = getPressureStatusString(sampled ? block.status(i) : PRESSURE_OUT_OF_RANGE);
         }
         if (callback) {
             callback(pressures, statuses);
@@ -2235,12 +4646,12 @@ void EtherCATMaster::startSupportTestAsync(float target_pressure,
         setRelayChannel(1, true);
         setRelayChannel(2, false);
         
-        auto start_time = std::chrono::steady_clock::now();
+        auto start_time = clockNow();
         bool success = false;
         
         while (!test_cancelled) {
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start_time).count();
+                clockNow() - start_time).count();
             
             if (elapsed > timeout_ms) {
                 log(LogLevel::LOG_WARNING, "Test", "支撑测试超时");
@@ -2270,7 +4681,7 @@ void EtherCATMaster::startSupportTestAsync(float target_pressure,
                 progress_callback(result);
             }
             
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            clock->sleepFor(msToNs(50));
         }
         
         // 完成
@@ -2279,7 +4690,7 @@ void EtherCATMaster::startSupportTestAsync(float target_pressure,
         result.final_pressures = readAllAnalogInputsAsPressure();
         result.elapsed_time_ms = static_cast<int>(
             std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start_time).count());
+                clockNow() - start_time).count());
         result.message = success ? "支撑测试成功" : "支撑测试失败";
         
         current_test_status = result.status;
@@ -2309,12 +4720,12 @@ void EtherCATMaster::startRetractTestAsync(float target_pressure,
         setRelayChannel(1, false);
         setRelayChannel(2, true);
         
-        auto start_time = std::chrono::steady_clock::now();
+        auto start_time = clockNow();
         bool success = false;
         
         while (!test_cancelled) {
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start_time).count();
+                clockNow() - start_time).count();
             
             if (elapsed > timeout_ms) {
                 log(LogLevel::LOG_WARNING, "Test", "收回测试超时");
@@ -2344,7 +4755,7 @@ void EtherCATMaster::startRetractTestAsync(float target_pressure,
                 progress_callback(result);
             }
             
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            clock->sleepFor(msToNs(50));
         }
         
         // 完成
@@ -2353,7 +4764,7 @@ void EtherCATMaster::startRetractTestAsync(float target_pressure,
         result.final_pressures = readAllAnalogInputsAsPressure();
         result.elapsed_time_ms = static_cast<int>(
             std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start_time).count());
+                clockNow() - start_time).count());
         result.message = success ? "收回测试成功" : "收回测试失败";
         
         current_test_status = result.status;
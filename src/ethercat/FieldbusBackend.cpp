@@ -0,0 +1,26 @@
+#include "ethercat/FieldbusBackend.h"
+#include "ethercat/IghBackend.h"
+#include "ethercat/RawSocketBackend.h"
+#include "ethercat/ReplayBackend.h"
+
+// ==================== 后端工厂 ====================
+std::unique_ptr<FieldbusBackend> createFieldbusBackend(FieldbusBackendType type, const std::string& resource) {
+    switch (type) {
+        case FieldbusBackendType::BACKEND_IGH:
+            return std::unique_ptr<FieldbusBackend>(new IghBackend());
+        case FieldbusBackendType::BACKEND_RAW_SOCKET:
+            return std::unique_ptr<FieldbusBackend>(new RawSocketBackend(resource));
+        case FieldbusBackendType::BACKEND_REPLAY:
+            return std::unique_ptr<FieldbusBackend>(new ReplayBackend(resource));
+    }
+    return nullptr;
+}
+
+std::string getFieldbusBackendTypeName(FieldbusBackendType type) {
+    switch (type) {
+        case FieldbusBackendType::BACKEND_IGH: return "IgH";
+        case FieldbusBackendType::BACKEND_RAW_SOCKET: return "原始套接字";
+        case FieldbusBackendType::BACKEND_REPLAY: return "回放";
+    }
+    return "未知";
+}
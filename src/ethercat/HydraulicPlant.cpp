@@ -0,0 +1,167 @@
+#include "ethercat/HydraulicPlant.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float PLANT_PRESSURE_FULL_SCALE = 100.0f;     // 100bar 对应 20mA
+constexpr float PLANT_RAW_FULL_SCALE = 32767.0f;
+constexpr float OPEN_CIRCUIT_PRESSURE = -25.0f;         // 0mA 对应的压力读数
+constexpr float MIN_TIME_CONSTANT_MS = 0.1f;
+
+} // namespace
+
+// ==================== 液压支腿对象模型 ====================
+HydraulicPlant::HydraulicPlant(const HydraulicPlantConfig& config)
+    : config(config)
+    , pressure()
+    , supply_scale()
+    , tau_scale()
+    , frozen_reading()
+    , rng(config.seed)
+    , noise(0.0f, 1.0f)
+    , step_count(0)
+    , attached_bus(nullptr) {
+    reset();
+}
+
+HydraulicPlant::~HydraulicPlant() {
+    detach();
+}
+
+void HydraulicPlant::attach(SimulatedBus& bus) {
+    detach();
+    attached_bus = &bus;
+    bus.setCycleCallback([this](SimulatedBus& b) { step(b); });
+}
+
+void HydraulicPlant::detach() {
+    if (attached_bus) {
+        attached_bus->setCycleCallback(nullptr);
+        attached_bus = nullptr;
+    }
+}
+
+void HydraulicPlant::step(SimulatedBus& bus) {
+    uint8_t relays = bus.getRelayOutputs();
+    std::array<int16_t, HYDRAULIC_LEG_COUNT> raw;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool support = config.support_relay >= 1 && (relays & (1u << (config.support_relay - 1)));
+        bool retract = config.retract_relay >= 1 && (relays & (1u << (config.retract_relay - 1)));
+        const float dt_ms = static_cast<float>(config.step_ns) / 1000000.0f;
+
+        for (size_t i = 0; i < HYDRAULIC_LEG_COUNT; i++) {
+            const HydraulicLegConfig& leg = config.legs[i];
+            float& p = pressure[i];
+
+            if (retract) {
+                float tau = std::max(leg.fall_time_constant_ms * tau_scale[i], MIN_TIME_CONSTANT_MS);
+                p += (leg.return_pressure - p) * (1.0f - std::exp(-dt_ms / tau));
+            } else if (support) {
+                float tau = std::max(leg.rise_time_constant_ms * tau_scale[i], MIN_TIME_CONSTANT_MS);
+                p += (leg.supply_pressure * supply_scale[i] - p) * (1.0f - std::exp(-dt_ms / tau));
+            } else if (leg.leak_rate > 0.0f) {
+                p = std::max(0.0f, p - leg.leak_rate * dt_ms / 1000.0f);
+            }
+
+            float reading;
+            switch (leg.fault) {
+                case SensorFault::SENSOR_STUCK:
+                    reading = frozen_reading[i];
+                    break;
+                case SensorFault::SENSOR_OPEN_CIRCUIT:
+                    reading = OPEN_CIRCUIT_PRESSURE;
+                    break;
+                default:
+                    reading = p + leg.sensor_offset;
+                    if (leg.noise_stddev > 0.0f) {
+                        reading += noise(rng) * leg.noise_stddev;
+                    }
+                    break;
+            }
+            raw[i] = pressureToRaw(reading);
+        }
+        step_count++;
+    }
+
+    for (size_t i = 0; i < HYDRAULIC_LEG_COUNT; i++) {
+        bus.setAnalogRaw(i, raw[i]);
+    }
+}
+
+void HydraulicPlant::setConfig(const HydraulicPlantConfig& new_config) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        config = new_config;
+    }
+    reset();
+}
+
+HydraulicPlantConfig HydraulicPlant::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return config;
+}
+
+void HydraulicPlant::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    rng.seed(config.seed);
+    noise.reset();
+    drawSpreadLocked();
+    for (size_t i = 0; i < HYDRAULIC_LEG_COUNT; i++) {
+        const HydraulicLegConfig& leg = config.legs[i];
+        pressure[i] = leg.return_pressure;
+        frozen_reading[i] = leg.stuck_pressure >= 0.0f ? leg.stuck_pressure : pressure[i] + leg.sensor_offset;
+    }
+    step_count = 0;
+}
+
+void HydraulicPlant::setLegFault(size_t leg, SensorFault fault, float stuck_pressure) {
+    if (leg >= HYDRAULIC_LEG_COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    HydraulicLegConfig& cfg = config.legs[leg];
+    cfg.fault = fault;
+    cfg.stuck_pressure = stuck_pressure;
+    frozen_reading[leg] = stuck_pressure >= 0.0f ? stuck_pressure : pressure[leg] + cfg.sensor_offset;
+}
+
+void HydraulicPlant::setLegLeakRate(size_t leg, float leak_rate) {
+    if (leg >= HYDRAULIC_LEG_COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    config.legs[leg].leak_rate = std::max(0.0f, leak_rate);
+}
+
+float HydraulicPlant::getLegPressure(size_t leg) const {
+    if (leg >= HYDRAULIC_LEG_COUNT) {
+        return 0.0f;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    return pressure[leg];
+}
+
+uint64_t HydraulicPlant::getStepCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return step_count;
+}
+
+int16_t HydraulicPlant::pressureToRaw(float pressure) {
+    // 与 convertAnalogToPressure 互逆：0-100bar ↔ 4-20mA ↔ 0-32767
+    float raw = std::round(pressure * PLANT_RAW_FULL_SCALE / PLANT_PRESSURE_FULL_SCALE);
+    raw = std::min(std::max(raw, -32768.0f), 32767.0f);
+    return static_cast<int16_t>(raw);
+}
+
+void HydraulicPlant::drawSpreadLocked() {
+    float spread = std::max(0.0f, std::min(config.spread, 0.9f));
+    std::uniform_real_distribution<float> scale(1.0f - spread, 1.0f + spread);
+    for (size_t i = 0; i < HYDRAULIC_LEG_COUNT; i++) {
+        supply_scale[i] = spread > 0.0f ? scale(rng) : 1.0f;
+        tau_scale[i] = spread > 0.0f ? scale(rng) : 1.0f;
+    }
+}
@@ -0,0 +1,209 @@
+#include "ethercat/IghBackend.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+// 请求主站后，IgH 可能仍在扫描总线
+constexpr int SCAN_WAIT_TIMEOUT_MS = 3000;
+
+} // namespace
+
+// ==================== IgH 后端 ====================
+IghBackend::IghBackend()
+    : master(nullptr) {
+}
+
+IghBackend::~IghBackend() {
+    releaseMaster();
+}
+
+std::string IghBackend::getName() const {
+#if defined(__linux__) && WITH_IGH_ETHERCAT
+    return "IgH";
+#else
+    return "IgH (模拟总线)";
+#endif
+}
+
+bool IghBackend::requestMaster(unsigned int master_index) {
+    if (master) {
+        return true;
+    }
+    master = ecrt_request_master(master_index);
+    return master != nullptr;
+}
+
+void IghBackend::releaseMaster() {
+    if (master) {
+        ecrt_release_master(master);
+        master = nullptr;
+    }
+    domains.clear();
+    slave_configs.clear();
+    sdo_requests.clear();
+}
+
+bool IghBackend::scanSlaves(std::vector<ec_slave_info_t>& slaves) {
+    slaves.clear();
+    if (!master) {
+        return false;
+    }
+
+    ec_master_info_t info;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SCAN_WAIT_TIMEOUT_MS);
+    while (true) {
+        if (ecrt_master(master, &info)) {
+            return false;
+        }
+        if (!info.scan_busy) {
+            break;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            std::cerr << "警告: 等待 IgH 总线扫描完成超时" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // 链路断开时 slave_count 为 0，结果为空表
+    for (unsigned int position = 0; position < info.slave_count; position++) {
+        ec_slave_info_t slave;
+        if (ecrt_master_get_slave(master, static_cast<uint16_t>(position), &slave) == 0) {
+            slaves.push_back(slave);
+        }
+    }
+    return true;
+}
+
+int IghBackend::createDomain() {
+    if (!master) {
+        return -1;
+    }
+    ec_domain_t* domain = ecrt_master_create_domain(master);
+    if (!domain) {
+        return -1;
+    }
+    domains.push_back(domain);
+    return static_cast<int>(domains.size() - 1);
+}
+
+bool IghBackend::configureSlave(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                                const ec_sync_info_t* syncs) {
+    if (!master) {
+        return false;
+    }
+    ec_slave_config_t* config = ecrt_master_slave_config(master, alias, position, vendor_id, product_code);
+    if (!config) {
+        return false;
+    }
+    if (syncs && ecrt_slave_config_pdos(config, EC_END, syncs)) {
+        return false;
+    }
+    slave_configs.push_back(config);
+    return true;
+}
+
+bool IghBackend::registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) {
+    if (!isValidDomain(domain)) {
+        return false;
+    }
+    return ecrt_domain_reg_pdo_entry_list(domains[domain], regs) == 0;
+}
+
+bool IghBackend::activate() {
+    return master && ecrt_master_activate(master) == 0;
+}
+
+uint8_t* IghBackend::getDomainData(int domain) {
+    return isValidDomain(domain) ? ecrt_domain_data(domains[domain]) : nullptr;
+}
+
+size_t IghBackend::getDomainSize(int domain) const {
+    return isValidDomain(domain) ? ecrt_domain_size(domains[domain]) : 0;
+}
+
+void IghBackend::receive() {
+    ecrt_master_receive(master);
+}
+
+void IghBackend::processDomain(int domain, ec_domain_state_t& state) {
+    ecrt_domain_process(domains[domain]);
+    ecrt_domain_state(domains[domain], &state);
+}
+
+void IghBackend::queueDomain(int domain) {
+    ecrt_domain_queue(domains[domain]);
+}
+
+void IghBackend::send() {
+    ecrt_master_send(master);
+}
+
+void IghBackend::getMasterState(ec_master_state_t& state) {
+    ecrt_master_state(master, &state);
+}
+
+bool IghBackend::getSlaveConfigState(size_t config, ec_slave_config_state_t& state) {
+    if (config >= slave_configs.size()) {
+        return false;
+    }
+    ecrt_slave_config_state(slave_configs[config], &state);
+    return true;
+}
+
+bool IghBackend::sdoDownload(uint16_t position, uint16_t index, uint8_t subindex,
+                             const uint8_t* data, size_t size, uint32_t* abort_code) {
+    if (!master) {
+        return false;
+    }
+    return ecrt_master_sdo_download(master, position, index, subindex, data, size, abort_code) == 0;
+}
+
+bool IghBackend::sdoUpload(uint16_t position, uint16_t index, uint8_t subindex,
+                           uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code) {
+    if (!master) {
+        return false;
+    }
+    return ecrt_master_sdo_upload(master, position, index, subindex, data, size, result_size, abort_code) == 0;
+}
+
+int IghBackend::createSdoRequest(size_t config, uint16_t index, uint8_t subindex, size_t size,
+                                 uint32_t timeout_ms) {
+    if (config >= slave_configs.size()) {
+        return -1;
+    }
+    ec_sdo_request_t* request = ecrt_slave_config_create_sdo_request(slave_configs[config], index, subindex, size);
+    if (!request) {
+        return -1;
+    }
+    ecrt_sdo_request_timeout(request, timeout_ms);
+    sdo_requests.push_back(request);
+    return static_cast<int>(sdo_requests.size() - 1);
+}
+
+uint8_t* IghBackend::getSdoRequestData(int request) {
+    return isValidSdoRequest(request) ? ecrt_sdo_request_data(sdo_requests[request]) : nullptr;
+}
+
+size_t IghBackend::getSdoRequestDataSize(int request) const {
+    return isValidSdoRequest(request) ? ecrt_sdo_request_data_size(sdo_requests[request]) : 0;
+}
+
+ec_request_state_t IghBackend::getSdoRequestState(int request) {
+    return isValidSdoRequest(request) ? ecrt_sdo_request_state(sdo_requests[request]) : EC_REQUEST_ERROR;
+}
+
+void IghBackend::readSdoRequest(int request) {
+    if (isValidSdoRequest(request)) {
+        ecrt_sdo_request_read(sdo_requests[request]);
+    }
+}
+
+void IghBackend::writeSdoRequest(int request) {
+    if (isValidSdoRequest(request)) {
+        ecrt_sdo_request_write(sdo_requests[request]);
+    }
+}
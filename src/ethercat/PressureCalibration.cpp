@@ -0,0 +1,193 @@
+#include "ethercat/PressureCalibration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+std::string at(size_t line) {
+    return "第 " + std::to_string(line) + " 行: ";
+}
+
+bool parseNumber(const std::string& token, double& value) {
+    char* end = nullptr;
+    value = std::strtod(token.c_str(), &end);
+    return end != token.c_str() && *end == '\0' && std::isfinite(value);
+}
+
+// 与 EtherCATMaster::convertAnalogToCurrent 相同的单精度换算
+float rawToCurrent(int16_t raw) {
+    return static_cast<float>(raw) * (CURRENT_RANGE_MAX - CURRENT_RANGE_MIN) / ADC_MAX_VALUE + CURRENT_RANGE_MIN;
+}
+
+float clampPressure(double pressure) {
+    return static_cast<float>(std::max(pressure, static_cast<double>(PRESSURE_RANGE_MIN)));
+}
+
+} // namespace
+
+double ChannelCalibration::evaluate(double current_ma) const {
+    if (kind == CalibrationKind::CALIBRATION_POLYNOMIAL) {
+        double pressure = 0.0;
+        for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it) {
+            pressure = pressure * current_ma + *it;
+        }
+        return pressure;
+    }
+    // 找到所在的段，范围之外使用首末两段
+    size_t segment = 1;
+    while (segment + 1 < points.size() && current_ma > points[segment].current_ma) {
+        segment++;
+    }
+    const CalibrationPoint& a = points[segment - 1];
+    const CalibrationPoint& b = points[segment];
+    return a.pressure_bar + (current_ma - a.current_ma) * (b.pressure_bar - a.pressure_bar) /
+                            (b.current_ma - a.current_ma);
+}
+
+PressureCalibrationSet::PressureCalibrationSet()
+    : tables()
+    , channel_mask(0) {
+}
+
+bool PressureCalibration::load(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "无法读取标定文件: " + path;
+        return false;
+    }
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    PressureCalibration loaded;
+    if (!loaded.parse(ss.str(), error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    loaded.source = path;
+    *this = std::move(loaded);
+    return true;
+}
+
+bool PressureCalibration::parse(const std::string& content, std::string& error) {
+    std::vector<ChannelCalibration> parsed;
+    std::istringstream input(content);
+    std::string text;
+    size_t line = 0;
+    size_t channel_line = 0;
+
+    while (std::getline(input, text)) {
+        line++;
+        text = text.substr(0, text.find('#'));
+        std::istringstream fields(text);
+        std::vector<std::string> tokens;
+        for (std::string token; fields >> token;) {
+            tokens.push_back(token);
+        }
+        if (tokens.empty()) {
+            continue;
+        }
+
+        if (tokens[0] == "channel") {
+            if (!parsed.empty() && !validate(parsed.back(), channel_line, error)) {
+                return false;
+            }
+            double number = 0.0;
+            if (tokens.size() < 3 || !parseNumber(tokens[1], number) || number != std::floor(number) ||
+                number < 1 || number > MAX_ANALOG_CHANNELS) {
+                error = at(line) + "应为 \"channel <1-" + std::to_string(MAX_ANALOG_CHANNELS) + "> linear|poly\"";
+                return false;
+            }
+            ChannelCalibration calibration;
+            calibration.channel = static_cast<uint8_t>(number);
+            for (const auto& existing : parsed) {
+                if (existing.channel == calibration.channel) {
+                    error = at(line) + "通道 " + std::to_string(calibration.channel) + " 重复标定";
+                    return false;
+                }
+            }
+            if (tokens[2] == "linear" && tokens.size() == 3) {
+                calibration.kind = CalibrationKind::CALIBRATION_LINEAR;
+            } else if (tokens[2] == "poly" && tokens.size() > 3) {
+                calibration.kind = CalibrationKind::CALIBRATION_POLYNOMIAL;
+                for (size_t i = 3; i < tokens.size(); i++) {
+                    if (!parseNumber(tokens[i], number)) {
+                        error = at(line) + "无效的多项式系数 \"" + tokens[i] + "\"";
+                        return false;
+                    }
+                    calibration.coefficients.push_back(number);
+                }
+            } else {
+                error = at(line) + "标定方式应为 \"linear\" 或 \"poly <c0> [c1 ...]\"";
+                return false;
+            }
+            parsed.push_back(std::move(calibration));
+            channel_line = line;
+            continue;
+        }
+
+        // 标定点：只能跟在 linear 通道之后
+        if (parsed.empty() || parsed.back().kind != CalibrationKind::CALIBRATION_LINEAR) {
+            error = at(line) + "标定点之前应有 \"channel <n> linear\"";
+            return false;
+        }
+        CalibrationPoint point;
+        if (tokens.size() != 2 || !parseNumber(tokens[0], point.current_ma) ||
+            !parseNumber(tokens[1], point.pressure_bar)) {
+            error = at(line) + "标定点应为 \"<电流 mA> <压力 bar>\"";
+            return false;
+        }
+        parsed.back().points.push_back(point);
+    }
+
+    if (parsed.empty()) {
+        error = "没有通道标定";
+        return false;
+    }
+    if (!validate(parsed.back(), channel_line, error)) {
+        return false;
+    }
+    channels = std::move(parsed);
+    return true;
+}
+
+bool PressureCalibration::validate(const ChannelCalibration& calibration, size_t line, std::string& error) const {
+    std::string label = at(line) + "通道 " + std::to_string(calibration.channel);
+    if (calibration.kind == CalibrationKind::CALIBRATION_POLYNOMIAL) {
+        if (calibration.coefficients.size() > CALIBRATION_MAX_POLY_TERMS) {
+            error = label + " 的多项式超过 " + std::to_string(CALIBRATION_MAX_POLY_TERMS) + " 项";
+            return false;
+        }
+        return true;
+    }
+    if (calibration.points.size() < 2 || calibration.points.size() > CALIBRATION_MAX_POINTS) {
+        error = label + " 需要 2-" + std::to_string(CALIBRATION_MAX_POINTS) + " 个标定点";
+        return false;
+    }
+    for (size_t i = 1; i < calibration.points.size(); i++) {
+        if (calibration.points[i].current_ma <= calibration.points[i - 1].current_ma) {
+            error = label + " 的标定点电流应严格递增";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<PressureCalibrationSet> PressureCalibration::compile() const {
+    std::unique_ptr<PressureCalibrationSet> set(new PressureCalibrationSet());
+    set->source = source;
+    for (const auto& calibration : channels) {
+        std::unique_ptr<PressureLookupTable> table(new PressureLookupTable);
+        for (int32_t raw = INT16_MIN; raw <= INT16_MAX; raw++) {
+            float current = rawToCurrent(static_cast<int16_t>(raw));
+            table->pressure[static_cast<uint16_t>(raw)] = clampPressure(calibration.evaluate(current));
+        }
+        size_t index = calibration.channel - 1;
+        set->tables[index] = table.get();
+        set->channel_mask |= 1ULL << index;
+        set->storage.push_back(std::move(table));
+    }
+    return set;
+}
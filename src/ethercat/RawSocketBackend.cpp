@@ -0,0 +1,1350 @@
+#include "ethercat/RawSocketBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef PACKET_IGNORE_OUTGOING
+#define PACKET_IGNORE_OUTGOING 23
+#endif
+
+namespace {
+
+constexpr uint16_t ETHERTYPE_ETHERCAT = 0x88A4;
+constexpr size_t ETH_HEADER_SIZE = 14;
+constexpr size_t ECAT_HEADER_SIZE = 2;
+constexpr size_t DATAGRAM_HEADER_SIZE = 10;
+constexpr size_t DATAGRAM_WKC_SIZE = 2;
+constexpr size_t ETH_MIN_FRAME_SIZE = 60;
+
+// 报文命令
+constexpr uint8_t CMD_APRD = 0x01;
+constexpr uint8_t CMD_APWR = 0x02;
+constexpr uint8_t CMD_FPRD = 0x04;
+constexpr uint8_t CMD_FPWR = 0x05;
+constexpr uint8_t CMD_BRD = 0x07;
+constexpr uint8_t CMD_BWR = 0x08;
+constexpr uint8_t CMD_LRW = 0x0C;
+
+// ESC 寄存器
+constexpr uint16_t REG_TYPE = 0x0000;
+constexpr uint16_t REG_STATION_ADDRESS = 0x0010;
+constexpr uint16_t REG_AL_CONTROL = 0x0120;
+constexpr uint16_t REG_AL_STATUS = 0x0130;
+constexpr uint16_t REG_AL_STATUS_CODE = 0x0134;
+constexpr uint16_t REG_SII_CONFIG = 0x0500;
+constexpr uint16_t REG_SII_CONTROL = 0x0502;
+constexpr uint16_t REG_SII_DATA = 0x0508;
+constexpr uint16_t REG_FMMU = 0x0600;
+constexpr uint16_t REG_SM = 0x0800;
+
+constexpr uint16_t FMMU_REGION_SIZE = 256;
+constexpr uint16_t SM_REGION_SIZE = 128;
+constexpr uint8_t MAX_FMMUS = 16;
+
+constexpr uint16_t STATION_ADDRESS_BASE = 0x1001;
+
+constexpr uint8_t AL_STATE_MASK = 0x0F;
+constexpr uint8_t AL_ERROR_FLAG = 0x10;
+
+// SII 字地址和类别
+constexpr uint16_t SII_VENDOR_ID = 0x0008;
+constexpr uint16_t SII_PRODUCT_CODE = 0x000A;
+constexpr uint16_t SII_MBX_RX = 0x0018;
+constexpr uint16_t SII_MBX_TX = 0x001A;
+constexpr uint16_t SII_CATEGORY_START = 0x0040;
+constexpr uint16_t SII_CATEGORY_LIMIT = 0x0800;
+constexpr uint16_t SII_CATEGORY_SYNCM = 41;
+constexpr uint16_t SII_CATEGORY_END = 0xFFFF;
+constexpr uint16_t SII_BUSY = 0x8000;
+constexpr uint16_t SII_ERROR_COMMAND = 0x2000;
+
+// 邮箱和 CoE
+constexpr size_t MBX_HEADER_SIZE = 6;
+constexpr uint8_t MBX_TYPE_COE = 0x03;
+constexpr uint8_t SM_STATUS_MAILBOX_FULL = 0x08;
+constexpr uint16_t COE_SERVICE_EMERGENCY = 0x1;
+constexpr uint16_t COE_SERVICE_SDO_REQUEST = 0x2;
+constexpr uint16_t COE_SERVICE_SDO_RESPONSE = 0x3;
+constexpr size_t COE_SDO_SIZE = 10;         // CoE 头 2 + 命令 1 + 索引 2 + 子索引 1 + 数据 4
+constexpr uint8_t SDO_DOWNLOAD_RESPONSE = 0x60;
+constexpr uint8_t SDO_UPLOAD_REQUEST = 0x40;
+constexpr uint8_t SDO_ABORT = 0x80;
+constexpr int SDO_TIMEOUT_MS = 1000;
+
+void putU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void putU32(uint8_t* p, uint32_t value) {
+    putU16(p, static_cast<uint16_t>(value));
+    putU16(p + 2, static_cast<uint16_t>(value >> 16));
+}
+
+uint16_t getU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t getU32(const uint8_t* p) {
+    return getU16(p) | (static_cast<uint32_t>(getU16(p + 2)) << 16);
+}
+
+uint32_t physicalAddress(uint16_t adp, uint16_t ado) {
+    return adp | (static_cast<uint32_t>(ado) << 16);
+}
+
+int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string hex(uint32_t value) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "0x%08X", value);
+    return buf;
+}
+
+// 热启动数据编解码（小端）
+void appendU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+    appendU16(out, static_cast<uint16_t>(value));
+    appendU16(out, static_cast<uint16_t>(value >> 16));
+}
+
+// 越界读取返回 0 并置 ok = false
+struct WarmReader {
+    const uint8_t* p;
+    size_t left;
+    bool ok;
+
+    const uint8_t* take(size_t n) {
+        if (!ok || left < n) {
+            ok = false;
+            return nullptr;
+        }
+        const uint8_t* at = p;
+        p += n;
+        left -= n;
+        return at;
+    }
+    uint8_t u8() { const uint8_t* at = take(1); return at ? at[0] : 0; }
+    uint16_t u16() { const uint8_t* at = take(2); return at ? getU16(at) : 0; }
+    uint32_t u32() { const uint8_t* at = take(4); return at ? getU32(at) : 0; }
+};
+
+} // namespace
+
+RawSocketBackend::RawSocketBackend(const std::string& interface_name)
+    : interface_name(interface_name)
+    , socket_fd(-1)
+    , interface_index(0)
+    , mac_address()
+    , tx_frame()
+    , rx_frame()
+    , tx_length(0)
+    , last_datagram(0)
+    , setup_index(0)
+    , activated(false)
+    , bus_scanned(false)
+    , cyclic_running(false)
+    , cyclic_count(0)
+    , state_lost_cycles(0)
+    , master_state()
+    , acyclic_state(ACYCLIC_IDLE)
+    , acyclic_slot() {
+}
+
+RawSocketBackend::~RawSocketBackend() {
+    releaseMaster();
+}
+
+std::string RawSocketBackend::getName() const {
+    return "原始套接字 (" + (interface_name.empty() ? std::string("未指定网卡") : interface_name) + ")";
+}
+
+// ==================== 配置阶段 ====================
+bool RawSocketBackend::requestMaster(unsigned int master_index) {
+    (void)master_index;     // 用户态后端按网卡区分主站
+    if (socket_fd >= 0) {
+        return true;
+    }
+    if (interface_name.empty() || interface_name.size() >= IFNAMSIZ) {
+        std::cerr << "错误: 原始套接字后端需要指定网卡" << std::endl;
+        return false;
+    }
+
+    int fd = socket(AF_PACKET, SOCK_RAW, htons(ETHERTYPE_ETHERCAT));
+    if (fd < 0) {
+        std::cerr << "错误: 无法创建原始套接字: " << std::strerror(errno) << "（需要 CAP_NET_RAW）" << std::endl;
+        return false;
+    }
+
+    struct ifreq ifr;
+    std::memset(&ifr, 0, sizeof(ifr));
+    std::strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+        std::cerr << "错误: 找不到网卡 " << interface_name << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    interface_index = ifr.ifr_ifindex;
+    if (ioctl(fd, SIOCGIFHWADDR, &ifr) < 0) {
+        std::cerr << "错误: 无法读取网卡地址: " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    std::memcpy(mac_address.data(), ifr.ifr_hwaddr.sa_data, mac_address.size());
+    if (ioctl(fd, SIOCGIFFLAGS, &ifr) == 0 && !(ifr.ifr_flags & IFF_UP)) {
+        std::cerr << "警告: 网卡 " << interface_name << " 未启用" << std::endl;
+    }
+
+    // 不接收本机发出的帧（旧内核不支持时在接收时按包类型过滤）
+    int one = 1;
+    setsockopt(fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+
+    struct sockaddr_ll addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETHERTYPE_ETHERCAT);
+    addr.sll_ifindex = interface_index;
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "错误: 无法绑定网卡 " << interface_name << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    socket_fd = fd;
+    return true;
+}
+
+void RawSocketBackend::releaseMaster() {
+    if (socket_fd >= 0) {
+        // 周期线程已停止，复位请求直接发送
+        cyclic_running = false;
+        if (activated) {
+            uint8_t init[2] = {EC_AL_STATE_INIT, 0};
+            bwr(REG_AL_CONTROL, init, sizeof(init));
+        }
+        close(socket_fd);
+        socket_fd = -1;
+    }
+    configs.clear();
+    bus_slaves.clear();
+    domains.clear();
+    op_stations.clear();
+    activated = false;
+    bus_scanned = false;
+    cyclic_running = false;
+    cyclic_count = 0;
+    state_lost_cycles = 0;
+    master_state = ec_master_state_t();
+    acyclic_state = ACYCLIC_IDLE;
+}
+
+bool RawSocketBackend::scanSlaves(std::vector<ec_slave_info_t>& slaves) {
+    slaves.clear();
+    if (socket_fd < 0 || activated || !scanBus()) {
+        return false;
+    }
+    bus_scanned = true;
+
+    // scanBus() 已把全部从站复位到 INIT
+    for (uint16_t position = 0; position < bus_slaves.size(); position++) {
+        ec_slave_info_t info;
+        std::memset(&info, 0, sizeof(info));
+        info.position = position;
+        info.vendor_id = bus_slaves[position].vendor_id;
+        info.product_code = bus_slaves[position].product_code;
+        info.al_state = EC_AL_STATE_INIT;
+        slaves.push_back(info);
+    }
+    return true;
+}
+
+int RawSocketBackend::createDomain() {
+    if (socket_fd < 0 || activated || domains.size() >= MAX_DOMAINS) {
+        return -1;
+    }
+    Domain domain;
+    domain.logical_address = 0;
+    domain.expected_working_counter = 0;
+    domain.rx_working_counter = 0;
+    domain.working_counter = 0;
+    domain.wc_state = EC_WC_ZERO;
+    domain.queued = false;
+    domain.in_flight = false;
+    domain.received = false;
+    domains.push_back(domain);
+    return static_cast<int>(domains.size() - 1);
+}
+
+bool RawSocketBackend::configureSlave(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                                      const ec_sync_info_t* syncs) {
+    if (socket_fd < 0 || activated) {
+        return false;
+    }
+    if (alias != 0) {
+        std::cerr << "错误: 原始套接字后端不支持别名寻址" << std::endl;
+        return false;
+    }
+
+    SlaveConfig config;
+    config.alias = alias;
+    config.position = position;
+    config.vendor_id = vendor_id;
+    config.product_code = product_code;
+    config.input_size = 0;
+    config.output_size = 0;
+
+    for (unsigned int i = 0; syncs && syncs[i].index != 0xff; i++) {
+        const ec_sync_info_t& sync = syncs[i];
+        if (sync.dir != EC_DIR_INPUT && sync.dir != EC_DIR_OUTPUT) {
+            return false;
+        }
+        SyncConfig sc;
+        sc.index = sync.index;
+        sc.input = sync.dir == EC_DIR_INPUT;
+        sc.byte_offset = sc.input ? config.input_size : config.output_size;
+        sc.watchdog_mode = sync.watchdog_mode;
+
+        uint32_t bits = 0;
+        for (unsigned int p = 0; p < sync.n_pdos; p++) {
+            const ec_pdo_info_t& pdo = sync.pdos[p];
+            sc.pdo_indexes.push_back(pdo.index);
+            for (unsigned int e = 0; pdo.entries && e < pdo.n_entries; e++) {
+                const ec_pdo_entry_info_t& entry = pdo.entries[e];
+                config.entries.push_back({entry.index, entry.subindex, entry.bit_length,
+                                          sc.byte_offset * 8 + bits, sc.input});
+                bits += entry.bit_length;
+            }
+        }
+        sc.byte_size = (bits + 7) / 8;
+        (sc.input ? config.input_size : config.output_size) += sc.byte_size;
+        config.syncs.push_back(sc);
+    }
+
+    for (auto& existing : configs) {
+        if (existing.position == position) {
+            if (existing.vendor_id != vendor_id || existing.product_code != product_code) {
+                return false;
+            }
+            if (syncs) {
+                existing = config;
+            }
+            return true;
+        }
+    }
+    configs.push_back(config);
+    return true;
+}
+
+const RawSocketBackend::SlaveConfig* RawSocketBackend::findConfig(uint16_t alias, uint16_t position,
+                                                                   uint32_t vendor_id, uint32_t product_code) const {
+    for (const auto& config : configs) {
+        if (config.alias == alias && config.position == position &&
+            config.vendor_id == vendor_id && config.product_code == product_code) {
+            return &config;
+        }
+    }
+    return nullptr;
+}
+
+bool RawSocketBackend::registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) {
+    if (domain < 0 || static_cast<size_t>(domain) >= domains.size() || !regs || activated) {
+        return false;
+    }
+    Domain& d = domains[domain];
+
+    for (const ec_pdo_entry_reg_t* reg = regs; reg->index; reg++) {
+        const SlaveConfig* config = findConfig(reg->alias, reg->position, reg->vendor_id, reg->product_code);
+        if (!config) {
+            return false;
+        }
+        const EntryLayout* entry = nullptr;
+        for (const auto& e : config->entries) {
+            if (e.index == reg->index && e.subindex == reg->subindex) {
+                entry = &e;
+                break;
+            }
+        }
+        if (!entry) {
+            return false;
+        }
+
+        // 从站首次注册时把整个输出/输入区追加到域（输出在前）
+        auto it = std::find_if(d.mappings.begin(), d.mappings.end(),
+                               [&](const Mapping& m) { return m.position == config->position; });
+        if (it == d.mappings.end()) {
+            Mapping map;
+            map.position = config->position;
+            map.output_offset = d.data.size();
+            map.input_offset = map.output_offset + config->output_size;
+            map.input_size = config->input_size;
+            d.data.resize(map.input_offset + config->input_size, 0);
+            d.expected_working_counter += (config->input_size > 0 ? 1 : 0) + (config->output_size > 0 ? 2 : 0);
+            d.mappings.push_back(map);
+            it = d.mappings.end() - 1;
+        }
+
+        size_t base = entry->input ? it->input_offset : it->output_offset;
+        unsigned int bit = entry->bit_offset % 8;
+        if (reg->bit_position) {
+            *reg->bit_position = bit;
+        } else if (bit != 0) {
+            return false;   // 非字节对齐的条目必须提供 bit_position
+        }
+        if (reg->offset) {
+            *reg->offset = static_cast<unsigned int>(base + entry->bit_offset / 8);
+        }
+    }
+    return true;
+}
+
+bool RawSocketBackend::activate() {
+    if (socket_fd < 0 || activated) {
+        return false;
+    }
+
+    // 周期帧：每个域一个 LRW，加上状态 BRD 和非周期槽
+    size_t frame_size = ETH_HEADER_SIZE + ECAT_HEADER_SIZE +
+                        2 * (DATAGRAM_HEADER_SIZE + DATAGRAM_WKC_SIZE) + 2 + ACYCLIC_MAX_DATA;
+    uint32_t logical_address = 0;
+    for (auto& d : domains) {
+        d.logical_address = logical_address;
+        logical_address += static_cast<uint32_t>(d.data.size());
+        d.rx.assign(d.data.size(), 0);
+        frame_size += DATAGRAM_HEADER_SIZE + d.data.size() + DATAGRAM_WKC_SIZE;
+    }
+    if (frame_size > FRAME_MAX_SIZE) {
+        std::cerr << "错误: 过程数据超出单帧容量 (" << frame_size << " 字节)" << std::endl;
+        return false;
+    }
+
+    if (!bus_scanned && !scanBus()) {
+        return false;
+    }
+    bus_scanned = false;
+
+    for (const auto& config : configs) {
+        if (config.position >= bus_slaves.size()) {
+            std::cerr << "错误: 位置 " << config.position << " 没有从站" << std::endl;
+            return false;
+        }
+        const BusSlave& slave = bus_slaves[config.position];
+        if (slave.vendor_id != config.vendor_id || slave.product_code != config.product_code) {
+            std::cerr << "错误: 位置 " << config.position << " 的从站身份不符: "
+                      << hex(slave.vendor_id) << "/" << hex(slave.product_code) << std::endl;
+            return false;
+        }
+    }
+
+    for (uint16_t position = 0; position < bus_slaves.size(); position++) {
+        if (!configureMailbox(position) || !requestState(position, EC_AL_STATE_PREOP, 3000)) {
+            return false;
+        }
+    }
+
+    for (const auto& config : configs) {
+        if (!configureProcessData(config.position, config)) {
+            return false;
+        }
+        BusSlave& slave = bus_slaves[config.position];
+        bool has_mailbox = slave.mbx_rx_size > 0;
+        for (const auto& d : domains) {
+            for (const auto& map : d.mappings) {
+                if (map.position != config.position) continue;
+                for (const auto& sc : config.syncs) {
+                    if (sc.byte_size == 0 || (has_mailbox && sc.index < 2)) continue;
+                    size_t offset = (sc.input ? map.input_offset : map.output_offset) + sc.byte_offset;
+                    if (!writeFmmu(slave, d.logical_address + static_cast<uint32_t>(offset),
+                                   static_cast<uint16_t>(sc.byte_size), slave.sii_syncs[sc.index].start, sc.input)) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    op_stations.clear();
+    for (const auto& config : configs) {
+        if (!requestState(config.position, EC_AL_STATE_SAFEOP, 10000)) {
+            return false;
+        }
+        op_stations.push_back(bus_slaves[config.position].station_address);
+    }
+
+    // OP 请求在周期帧中发出：带输出的从站需要先收到有效过程数据
+    activated = true;
+    warm_slaves = bus_slaves;
+    return true;
+}
+
+uint8_t* RawSocketBackend::getDomainData(int domain) {
+    if (!activated || domain < 0 || static_cast<size_t>(domain) >= domains.size() || domains[domain].data.empty()) {
+        return nullptr;
+    }
+    return domains[domain].data.data();
+}
+
+size_t RawSocketBackend::getDomainSize(int domain) const {
+    if (domain < 0 || static_cast<size_t>(domain) >= domains.size()) {
+        return 0;
+    }
+    return domains[domain].data.size();
+}
+
+// ==================== 周期交换 ====================
+void RawSocketBackend::receive() {
+    bool state_seen = false;
+
+    for (;;) {
+        struct sockaddr_ll from;
+        socklen_t from_len = sizeof(from);
+        ssize_t n = recvfrom(socket_fd, rx_frame.data(), rx_frame.size(), MSG_DONTWAIT,
+                             reinterpret_cast<struct sockaddr*>(&from), &from_len);
+        if (n <= 0) {
+            break;
+        }
+        if (from.sll_pkttype == PACKET_OUTGOING) {
+            continue;
+        }
+        forEachDatagram(rx_frame.data(), static_cast<size_t>(n),
+            [&](uint8_t command, uint8_t index, const uint8_t* data, uint16_t length, uint16_t wkc) {
+                if (index < domains.size() && command == CMD_LRW) {
+                    Domain& d = domains[index];
+                    if (d.in_flight && length == d.rx.size()) {
+                        std::memcpy(d.rx.data(), data, length);
+                        d.rx_working_counter = wkc;
+                        d.in_flight = false;
+                        d.received = true;
+                    }
+                } else if (index == STATE_DATAGRAM_INDEX && length >= 2) {
+                    master_state.slaves_responding = wkc;
+                    master_state.al_states = data[0] & AL_STATE_MASK;
+                    state_seen = true;
+                } else if (index == ACYCLIC_DATAGRAM_INDEX && acyclic_state.load(std::memory_order_acquire) == ACYCLIC_SENT) {
+                    std::memcpy(acyclic_slot.data, data, std::min<size_t>(length, acyclic_slot.length));
+                    acyclic_slot.working_counter = wkc;
+                    acyclic_state.store(ACYCLIC_DONE, std::memory_order_release);
+                }
+            });
+    }
+
+    if (state_seen) {
+        state_lost_cycles = 0;
+        master_state.link_up = 1;
+    } else if (++state_lost_cycles >= STATE_LOST_CYCLES) {
+        master_state.slaves_responding = 0;
+        master_state.al_states = 0;
+        master_state.link_up = 0;
+    }
+
+    // 未返回的报文视为丢失：域本周期 WKC 为 0，非周期报文重发
+    for (auto& d : domains) {
+        d.in_flight = false;
+    }
+    int sent = ACYCLIC_SENT;
+    acyclic_state.compare_exchange_strong(sent, ACYCLIC_PENDING, std::memory_order_acq_rel);
+}
+
+void RawSocketBackend::processDomain(int domain, ec_domain_state_t& state) {
+    Domain& d = domains[domain];
+    if (!d.received) {
+        d.working_counter = 0;
+    } else {
+        d.received = false;
+        d.working_counter = d.rx_working_counter;
+        for (const auto& map : d.mappings) {
+            std::memcpy(d.data.data() + map.input_offset, d.rx.data() + map.input_offset, map.input_size);
+        }
+    }
+
+    if (d.working_counter == 0) {
+        d.wc_state = EC_WC_ZERO;
+    } else if (d.working_counter == d.expected_working_counter) {
+        d.wc_state = EC_WC_COMPLETE;
+    } else {
+        d.wc_state = EC_WC_INCOMPLETE;
+    }
+    state.working_counter = d.working_counter;
+    state.wc_state = d.wc_state;
+    state.redundancy_active = 0;
+}
+
+void RawSocketBackend::queueDomain(int domain) {
+    domains[domain].queued = true;
+}
+
+void RawSocketBackend::send() {
+    cyclic_running.store(true, std::memory_order_release);
+    cyclic_count++;
+
+    beginFrame();
+    for (size_t i = 0; i < domains.size(); i++) {
+        Domain& d = domains[i];
+        if (!d.queued) continue;
+        d.queued = false;
+        if (d.data.empty()) continue;
+        appendDatagram(CMD_LRW, static_cast<uint8_t>(i), d.logical_address, d.data.data(),
+                       static_cast<uint16_t>(d.data.size()));
+        d.in_flight = true;
+    }
+
+    uint8_t status[2] = {0, 0};
+    appendDatagram(CMD_BRD, STATE_DATAGRAM_INDEX, physicalAddress(0, REG_AL_STATUS), status, sizeof(status));
+
+    // 尚未全部进入 OP 时每 100 个周期重复请求（同时应答错误标志）
+    if (master_state.al_states != EC_AL_STATE_OP && cyclic_count % 100 == 1) {
+        uint8_t control[2] = {EC_AL_STATE_OP | AL_ERROR_FLAG, 0};
+        for (uint16_t station : op_stations) {
+            appendDatagram(CMD_FPWR, AL_CONTROL_DATAGRAM_INDEX, physicalAddress(station, REG_AL_CONTROL),
+                           control, sizeof(control));
+        }
+    }
+
+    if (acyclic_state.load(std::memory_order_acquire) == ACYCLIC_PENDING) {
+        if (appendDatagram(acyclic_slot.command, ACYCLIC_DATAGRAM_INDEX, acyclic_slot.address,
+                           acyclic_slot.data, acyclic_slot.length)) {
+            acyclic_state.store(ACYCLIC_SENT, std::memory_order_release);
+        }
+    }
+
+    sendFrame();
+}
+
+void RawSocketBackend::getMasterState(ec_master_state_t& state) {
+    if (!cyclic_running.load(std::memory_order_acquire) && socket_fd >= 0) {
+        // 周期线程未运行时直接查询
+        uint8_t status[2] = {0, 0};
+        int wkc = brd(REG_AL_STATUS, status, sizeof(status));
+        master_state.slaves_responding = wkc > 0 ? static_cast<unsigned int>(wkc) : 0;
+        master_state.al_states = wkc > 0 ? (status[0] & AL_STATE_MASK) : 0;
+        master_state.link_up = wkc >= 0 ? 1 : 0;
+    }
+    state = master_state;
+}
+
+// ==================== 帧收发 ====================
+void RawSocketBackend::beginFrame() {
+    std::memset(tx_frame.data(), 0xFF, 6);                      // 广播
+    std::memcpy(tx_frame.data() + 6, mac_address.data(), 6);
+    tx_frame[12] = static_cast<uint8_t>(ETHERTYPE_ETHERCAT >> 8);
+    tx_frame[13] = static_cast<uint8_t>(ETHERTYPE_ETHERCAT & 0xFF);
+    tx_length = ETH_HEADER_SIZE + ECAT_HEADER_SIZE;
+    last_datagram = 0;
+}
+
+size_t RawSocketBackend::appendDatagram(uint8_t command, uint8_t index, uint32_t address,
+                                        const uint8_t* data, uint16_t length) {
+    if (tx_length + DATAGRAM_HEADER_SIZE + length + DATAGRAM_WKC_SIZE > FRAME_MAX_SIZE) {
+        return 0;
+    }
+    if (last_datagram) {
+        tx_frame[last_datagram + 7] |= 0x80;                    // 上一个报文的“后续还有”标志
+    }
+    uint8_t* p = tx_frame.data() + tx_length;
+    p[0] = command;
+    p[1] = index;
+    putU32(p + 2, address);
+    putU16(p + 6, length & 0x07FF);
+    putU16(p + 8, 0);
+    if (data) {
+        std::memcpy(p + DATAGRAM_HEADER_SIZE, data, length);
+    } else {
+        std::memset(p + DATAGRAM_HEADER_SIZE, 0, length);
+    }
+    putU16(p + DATAGRAM_HEADER_SIZE + length, 0);
+    last_datagram = tx_length;
+    tx_length += DATAGRAM_HEADER_SIZE + length + DATAGRAM_WKC_SIZE;
+    return last_datagram + DATAGRAM_HEADER_SIZE;
+}
+
+bool RawSocketBackend::sendFrame() {
+    size_t ecat_length = tx_length - ETH_HEADER_SIZE - ECAT_HEADER_SIZE;
+    putU16(tx_frame.data() + ETH_HEADER_SIZE, static_cast<uint16_t>((ecat_length & 0x07FF) | (1 << 12)));
+    size_t length = tx_length;
+    if (length < ETH_MIN_FRAME_SIZE) {
+        std::memset(tx_frame.data() + length, 0, ETH_MIN_FRAME_SIZE - length);
+        length = ETH_MIN_FRAME_SIZE;
+    }
+    return ::send(socket_fd, tx_frame.data(), length, 0) == static_cast<ssize_t>(length);
+}
+
+template <typename Handler>
+void RawSocketBackend::forEachDatagram(const uint8_t* frame, size_t length, Handler handler) const {
+    if (length < ETH_HEADER_SIZE + ECAT_HEADER_SIZE ||
+        frame[12] != static_cast<uint8_t>(ETHERTYPE_ETHERCAT >> 8) ||
+        frame[13] != static_cast<uint8_t>(ETHERTYPE_ETHERCAT & 0xFF)) {
+        return;
+    }
+    uint16_t header = getU16(frame + ETH_HEADER_SIZE);
+    if ((header >> 12) != 1) {
+        return;
+    }
+    size_t end = std::min(length, ETH_HEADER_SIZE + ECAT_HEADER_SIZE + (header & 0x07FF));
+    size_t pos = ETH_HEADER_SIZE + ECAT_HEADER_SIZE;
+    while (pos + DATAGRAM_HEADER_SIZE + DATAGRAM_WKC_SIZE <= end) {
+        const uint8_t* p = frame + pos;
+        uint16_t length_field = getU16(p + 6);
+        uint16_t data_length = length_field & 0x07FF;
+        if (pos + DATAGRAM_HEADER_SIZE + data_length + DATAGRAM_WKC_SIZE > end) {
+            return;
+        }
+        handler(p[0], p[1], p + DATAGRAM_HEADER_SIZE, data_length, getU16(p + DATAGRAM_HEADER_SIZE + data_length));
+        if (!(length_field & 0x8000)) {
+            return;
+        }
+        pos += DATAGRAM_HEADER_SIZE + data_length + DATAGRAM_WKC_SIZE;
+    }
+}
+
+int RawSocketBackend::transact(uint8_t command, uint32_t address, uint8_t* data, uint16_t length, int timeout_ms) {
+    if (socket_fd < 0) {
+        return -1;
+    }
+
+    // 周期运行中：交给周期线程在下一帧中发送
+    if (cyclic_running.load(std::memory_order_acquire)) {
+        if (length > ACYCLIC_MAX_DATA) {
+            return -1;
+        }
+        std::lock_guard<std::mutex> lock(acyclic_mutex);
+        acyclic_slot.command = command;
+        acyclic_slot.address = address;
+        acyclic_slot.length = length;
+        acyclic_slot.working_counter = 0;
+        std::memcpy(acyclic_slot.data, data, length);
+        acyclic_state.store(ACYCLIC_PENDING, std::memory_order_release);
+
+        int64_t deadline = steadyNowMs() + timeout_ms;
+        int64_t hard_deadline = deadline + 1000;
+        for (;;) {
+            int state = acyclic_state.load(std::memory_order_acquire);
+            if (state == ACYCLIC_DONE) {
+                std::memcpy(data, acyclic_slot.data, length);
+                int wkc = acyclic_slot.working_counter;
+                acyclic_state.store(ACYCLIC_IDLE, std::memory_order_release);
+                return wkc;
+            }
+            int64_t now = steadyNowMs();
+            if (now >= deadline) {
+                // 已发出的报文必须等周期线程处理完才能释放槽
+                int pending = ACYCLIC_PENDING;
+                if (acyclic_state.compare_exchange_strong(pending, ACYCLIC_IDLE, std::memory_order_acq_rel) ||
+                    now >= hard_deadline) {
+                    acyclic_state.store(ACYCLIC_IDLE, std::memory_order_release);
+                    return -1;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    uint8_t index = static_cast<uint8_t>(0x80 | (setup_index++ & 0x7F));
+    beginFrame();
+    size_t offset = appendDatagram(command, index, address, data, length);
+    if (!offset || !sendFrame()) {
+        return -1;
+    }
+
+    int64_t deadline = steadyNowMs() + timeout_ms;
+    for (;;) {
+        int remaining = static_cast<int>(deadline - steadyNowMs());
+        if (remaining <= 0) {
+            return -1;
+        }
+        struct pollfd pfd = {socket_fd, POLLIN, 0};
+        if (poll(&pfd, 1, remaining) <= 0) {
+            continue;
+        }
+        struct sockaddr_ll from;
+        socklen_t from_len = sizeof(from);
+        ssize_t n = recvfrom(socket_fd, rx_frame.data(), rx_frame.size(), 0,
+                             reinterpret_cast<struct sockaddr*>(&from), &from_len);
+        if (n <= 0 || from.sll_pkttype == PACKET_OUTGOING) {
+            continue;
+        }
+        int result = -1;
+        forEachDatagram(rx_frame.data(), static_cast<size_t>(n),
+            [&](uint8_t cmd, uint8_t idx, const uint8_t* payload, uint16_t payload_length, uint16_t wkc) {
+                if (cmd == command && idx == index && payload_length == length) {
+                    std::memcpy(data, payload, length);
+                    result = wkc;
+                }
+            });
+        if (result >= 0) {
+            return result;
+        }
+    }
+}
+
+int RawSocketBackend::fprd(uint16_t station, uint16_t reg, void* data, uint16_t length) {
+    std::memset(data, 0, length);
+    return transact(CMD_FPRD, physicalAddress(station, reg), static_cast<uint8_t*>(data), length);
+}
+
+int RawSocketBackend::fpwr(uint16_t station, uint16_t reg, const void* data, uint16_t length) {
+    std::vector<uint8_t> buf(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + length);
+    return transact(CMD_FPWR, physicalAddress(station, reg), buf.data(), length);
+}
+
+int RawSocketBackend::aprd(uint16_t position, uint16_t reg, void* data, uint16_t length) {
+    std::memset(data, 0, length);
+    return transact(CMD_APRD, physicalAddress(static_cast<uint16_t>(-position), reg), static_cast<uint8_t*>(data), length);
+}
+
+int RawSocketBackend::apwr(uint16_t position, uint16_t reg, const void* data, uint16_t length) {
+    std::vector<uint8_t> buf(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + length);
+    return transact(CMD_APWR, physicalAddress(static_cast<uint16_t>(-position), reg), buf.data(), length);
+}
+
+int RawSocketBackend::brd(uint16_t reg, void* data, uint16_t length) {
+    std::memset(data, 0, length);
+    return transact(CMD_BRD, physicalAddress(0, reg), static_cast<uint8_t*>(data), length);
+}
+
+int RawSocketBackend::bwr(uint16_t reg, const void* data, uint16_t length) {
+    std::vector<uint8_t> buf(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + length);
+    return transact(CMD_BWR, physicalAddress(0, reg), buf.data(), length);
+}
+
+// ==================== 总线扫描与从站配置 ====================
+bool RawSocketBackend::scanBus() {
+    uint8_t type[2];
+    int count = brd(REG_TYPE, type, sizeof(type));
+    if (count <= 0) {
+        std::cerr << "错误: 网卡 " << interface_name << " 上未检测到 EtherCAT 从站" << std::endl;
+        return false;
+    }
+
+    // 全部复位到 INIT 并清除 FMMU/SM 配置
+    uint8_t init[2] = {EC_AL_STATE_INIT | AL_ERROR_FLAG, 0};
+    bwr(REG_AL_CONTROL, init, sizeof(init));
+    std::vector<uint8_t> zeros(FMMU_REGION_SIZE, 0);
+    bwr(REG_FMMU, zeros.data(), FMMU_REGION_SIZE);
+    bwr(REG_SM, zeros.data(), SM_REGION_SIZE);
+
+    bus_slaves.clear();
+    size_t retained = 0;
+    for (uint16_t position = 0; position < static_cast<uint16_t>(count); position++) {
+        BusSlave slave;
+        slave.station_address = static_cast<uint16_t>(STATION_ADDRESS_BASE + position);
+        slave.retained = false;
+        slave.mbx_counter = 0;
+        slave.next_fmmu = 0;
+
+        // 站地址寄存器上电时清零，仍是上次分配的地址说明从站之后没有断电
+        uint8_t address[2];
+        uint16_t previous_address = 0;
+        if (!warm_slaves.empty() && aprd(position, REG_STATION_ADDRESS, address, sizeof(address)) == 1) {
+            previous_address = getU16(address);
+        }
+        putU16(address, slave.station_address);
+        if (apwr(position, REG_STATION_ADDRESS, address, sizeof(address)) != 1) {
+            std::cerr << "错误: 无法为位置 " << position << " 分配站地址" << std::endl;
+            return false;
+        }
+
+        if (!readSii(slave.station_address, SII_VENDOR_ID, slave.vendor_id) ||
+            !readSii(slave.station_address, SII_PRODUCT_CODE, slave.product_code)) {
+            std::cerr << "错误: 无法读取位置 " << position << " 的 SII" << std::endl;
+            return false;
+        }
+
+        // 热启动：沿用缓存的 SII 布局和 PDO 分配，省去逐字读取 SII 类别
+        const BusSlave* warm = findWarmSlave(position, previous_address);
+        if (warm && warm->vendor_id == slave.vendor_id && warm->product_code == slave.product_code) {
+            slave.mbx_rx_offset = warm->mbx_rx_offset;
+            slave.mbx_rx_size = warm->mbx_rx_size;
+            slave.mbx_tx_offset = warm->mbx_tx_offset;
+            slave.mbx_tx_size = warm->mbx_tx_size;
+            slave.sii_syncs = warm->sii_syncs;
+            slave.pdo_assignments = warm->pdo_assignments;
+            slave.retained = true;
+            retained++;
+            bus_slaves.push_back(slave);
+            continue;
+        }
+
+        uint32_t rx = 0;
+        uint32_t tx = 0;
+        if (!readSii(slave.station_address, SII_MBX_RX, rx) ||
+            !readSii(slave.station_address, SII_MBX_TX, tx) ||
+            !readSiiSyncs(slave)) {
+            std::cerr << "错误: 无法读取位置 " << position << " 的 SII" << std::endl;
+            return false;
+        }
+        slave.mbx_rx_offset = static_cast<uint16_t>(rx);
+        slave.mbx_rx_size = static_cast<uint16_t>(rx >> 16);
+        slave.mbx_tx_offset = static_cast<uint16_t>(tx);
+        slave.mbx_tx_size = static_cast<uint16_t>(tx >> 16);
+        if (!slave.mbx_rx_size || !slave.mbx_tx_size) {
+            slave.mbx_rx_size = 0;
+            slave.mbx_tx_size = 0;
+        }
+        bus_slaves.push_back(slave);
+    }
+    std::cout << "原始套接字后端: 检测到 " << bus_slaves.size() << " 个从站";
+    if (retained > 0) {
+        std::cout << "，其中 " << retained << " 个沿用热启动数据";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+const RawSocketBackend::BusSlave* RawSocketBackend::findWarmSlave(uint16_t position, uint16_t station_address) const {
+    if (position >= warm_slaves.size() || station_address == 0 ||
+        warm_slaves[position].station_address != station_address) {
+        return nullptr;
+    }
+    return &warm_slaves[position];
+}
+
+bool RawSocketBackend::readSii(uint16_t station, uint16_t word_address, uint32_t& value) {
+    uint8_t ecat_access = 0;
+    fpwr(station, REG_SII_CONFIG, &ecat_access, 1);
+
+    uint8_t status[2];
+    auto waitIdle = [&]() {
+        int64_t deadline = steadyNowMs() + 20;
+        do {
+            if (fprd(station, REG_SII_CONTROL, status, sizeof(status)) != 1) {
+                return false;
+            }
+            if (!(getU16(status) & SII_BUSY)) {
+                return true;
+            }
+        } while (steadyNowMs() < deadline);
+        return false;
+    };
+
+    if (!waitIdle()) {
+        return false;
+    }
+    uint8_t command[6] = {0x00, 0x01, 0, 0, 0, 0};      // 读命令 + 字地址
+    putU16(command + 2, word_address);
+    if (fpwr(station, REG_SII_CONTROL, command, sizeof(command)) != 1 || !waitIdle() ||
+        (getU16(status) & SII_ERROR_COMMAND)) {
+        return false;
+    }
+    uint8_t data[4];
+    if (fprd(station, REG_SII_DATA, data, sizeof(data)) != 1) {
+        return false;
+    }
+    value = getU32(data);
+    return true;
+}
+
+bool RawSocketBackend::readSiiSyncs(BusSlave& slave) {
+    slave.sii_syncs.clear();
+    uint16_t word = SII_CATEGORY_START;
+    while (word < SII_CATEGORY_LIMIT) {
+        uint32_t header = 0;
+        if (!readSii(slave.station_address, word, header)) {
+            return false;
+        }
+        uint16_t type = static_cast<uint16_t>(header);
+        uint16_t size = static_cast<uint16_t>(header >> 16);
+        if (type == SII_CATEGORY_END) {
+            break;
+        }
+        if ((type & 0x7FFF) == SII_CATEGORY_SYNCM) {
+            for (uint16_t i = 0; i + 4 <= size; i += 4) {
+                uint32_t w0 = 0;
+                uint32_t w1 = 0;
+                if (!readSii(slave.station_address, static_cast<uint16_t>(word + 2 + i), w0) ||
+                    !readSii(slave.station_address, static_cast<uint16_t>(word + 4 + i), w1)) {
+                    return false;
+                }
+                SiiSync sync;
+                sync.start = static_cast<uint16_t>(w0);
+                sync.length = static_cast<uint16_t>(w0 >> 16);
+                sync.control = static_cast<uint8_t>(w1);
+                sync.enable = static_cast<uint8_t>(w1 >> 16);
+                slave.sii_syncs.push_back(sync);
+            }
+        }
+        word = static_cast<uint16_t>(word + 2 + size);
+    }
+    return true;
+}
+
+bool RawSocketBackend::requestState(uint16_t position, uint8_t state, int timeout_ms) {
+    uint16_t station = bus_slaves[position].station_address;
+    uint8_t control[2] = {state, 0};
+    if (fpwr(station, REG_AL_CONTROL, control, sizeof(control)) != 1) {
+        std::cerr << "错误: 无法向位置 " << position << " 发送状态请求" << std::endl;
+        return false;
+    }
+
+    int64_t deadline = steadyNowMs() + timeout_ms;
+    do {
+        uint8_t status[2];
+        if (fprd(station, REG_AL_STATUS, status, sizeof(status)) == 1) {
+            if ((status[0] & AL_STATE_MASK) == state) {
+                return true;
+            }
+            if (status[0] & AL_ERROR_FLAG) {
+                uint8_t code[2];
+                fprd(station, REG_AL_STATUS_CODE, code, sizeof(code));
+                std::cerr << "错误: 位置 " << position << " 状态切换失败，AL 状态码 " << hex(getU16(code)) << std::endl;
+                uint8_t ack[2] = {static_cast<uint8_t>((status[0] & AL_STATE_MASK) | AL_ERROR_FLAG), 0};
+                fpwr(station, REG_AL_CONTROL, ack, sizeof(ack));
+                return false;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    } while (steadyNowMs() < deadline);
+
+    std::cerr << "错误: 位置 " << position << " 状态切换超时" << std::endl;
+    return false;
+}
+
+bool RawSocketBackend::configureMailbox(uint16_t position) {
+    const BusSlave& slave = bus_slaves[position];
+    if (!slave.mbx_rx_size) {
+        return true;
+    }
+    uint8_t sm[16] = {};
+    putU16(sm, slave.mbx_rx_offset);
+    putU16(sm + 2, slave.mbx_rx_size);
+    sm[4] = 0x26;       // 邮箱，主站写
+    sm[6] = 0x01;
+    putU16(sm + 8, slave.mbx_tx_offset);
+    putU16(sm + 10, slave.mbx_tx_size);
+    sm[12] = 0x22;      // 邮箱，主站读
+    sm[14] = 0x01;
+    if (fpwr(slave.station_address, REG_SM, sm, sizeof(sm)) != 1) {
+        std::cerr << "错误: 无法配置位置 " << position << " 的邮箱" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RawSocketBackend::configureProcessData(uint16_t position, const SlaveConfig& config) {
+    const BusSlave& slave = bus_slaves[position];
+    bool has_mailbox = slave.mbx_rx_size > 0;
+
+    for (const auto& sc : config.syncs) {
+        if (has_mailbox && sc.index < 2) {
+            continue;   // SM0/SM1 为邮箱
+        }
+
+        // CoE 从站写入 PDO 分配；从站未断电且上次写入的分配相同时不再写入
+        if (has_mailbox && !writePdoAssignment(position, sc)) {
+            return false;
+        }
+
+        if (sc.byte_size == 0) {
+            continue;
+        }
+        if (sc.index >= slave.sii_syncs.size()) {
+            std::cerr << "错误: 位置 " << position << " 的 SII 中没有 SM" << static_cast<int>(sc.index) << std::endl;
+            return false;
+        }
+        const SiiSync& sii = slave.sii_syncs[sc.index];
+        uint8_t control = sii.control;
+        if (sc.watchdog_mode == EC_WD_ENABLE) {
+            control |= 0x40;
+        } else if (sc.watchdog_mode == EC_WD_DISABLE) {
+            control &= static_cast<uint8_t>(~0x40);
+        }
+        uint8_t sm[8] = {};
+        putU16(sm, sii.start);
+        putU16(sm + 2, static_cast<uint16_t>(sc.byte_size));
+        sm[4] = control;
+        sm[6] = 0x01;
+        if (fpwr(slave.station_address, static_cast<uint16_t>(REG_SM + 8 * sc.index), sm, sizeof(sm)) != 1) {
+            std::cerr << "错误: 无法配置位置 " << position << " 的 SM" << static_cast<int>(sc.index) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RawSocketBackend::writePdoAssignment(uint16_t position, const SyncConfig& sc) {
+    BusSlave& slave = bus_slaves[position];
+    auto written = std::find_if(slave.pdo_assignments.begin(), slave.pdo_assignments.end(),
+                                [&sc](const PdoAssignment& a) { return a.sync == sc.index; });
+    if (slave.retained && written != slave.pdo_assignments.end() && written->pdo_indexes == sc.pdo_indexes) {
+        return true;
+    }
+
+    // 0x1C10 + SM 编号：先清零条目数，写入各 PDO 后再写条目数
+    uint16_t assign = static_cast<uint16_t>(0x1C10 + sc.index);
+    uint32_t abort_code = 0;
+    uint8_t count = 0;
+    bool ok = sdoDownload(position, assign, 0, &count, 1, &abort_code);
+    for (size_t i = 0; ok && i < sc.pdo_indexes.size(); i++) {
+        uint8_t pdo[2];
+        putU16(pdo, sc.pdo_indexes[i]);
+        ok = sdoDownload(position, assign, static_cast<uint8_t>(i + 1), pdo, sizeof(pdo), &abort_code);
+    }
+    count = static_cast<uint8_t>(sc.pdo_indexes.size());
+    if (ok) {
+        ok = sdoDownload(position, assign, 0, &count, 1, &abort_code);
+    }
+    if (!ok) {
+        std::cerr << "错误: 位置 " << position << " PDO 分配 " << hex(assign)
+                  << " 写入失败，中止码 " << hex(abort_code) << std::endl;
+        if (written != slave.pdo_assignments.end()) {
+            slave.pdo_assignments.erase(written);   // 写了一半，从站中的分配已不确定
+        }
+        return false;
+    }
+    if (written != slave.pdo_assignments.end()) {
+        written->pdo_indexes = sc.pdo_indexes;
+    } else {
+        slave.pdo_assignments.push_back({sc.index, sc.pdo_indexes});
+    }
+    return true;
+}
+
+bool RawSocketBackend::writeFmmu(BusSlave& slave, uint32_t logical_address, uint16_t length,
+                                 uint16_t physical_start, bool input) {
+    if (slave.next_fmmu >= MAX_FMMUS) {
+        return false;
+    }
+    uint8_t fmmu[16] = {};
+    putU32(fmmu, logical_address);
+    putU16(fmmu + 4, length);
+    fmmu[6] = 0;        // 逻辑起始位
+    fmmu[7] = 7;        // 逻辑结束位
+    putU16(fmmu + 8, physical_start);
+    fmmu[10] = 0;
+    fmmu[11] = input ? 0x01 : 0x02;
+    fmmu[12] = 0x01;
+    uint16_t reg = static_cast<uint16_t>(REG_FMMU + 16 * slave.next_fmmu);
+    if (fpwr(slave.station_address, reg, fmmu, sizeof(fmmu)) != 1) {
+        return false;
+    }
+    slave.next_fmmu++;
+    return true;
+}
+
+// ==================== 邮箱与 SDO ====================
+bool RawSocketBackend::mailboxExchange(uint16_t position, const std::vector<uint8_t>& request,
+                                       std::vector<uint8_t>& response, int timeout_ms) {
+    if (position >= bus_slaves.size() || !bus_slaves[position].mbx_rx_size) {
+        return false;
+    }
+    BusSlave& slave = bus_slaves[position];
+    if (MBX_HEADER_SIZE + request.size() > slave.mbx_rx_size) {
+        return false;
+    }
+
+    std::vector<uint8_t> out(slave.mbx_rx_size, 0);
+    putU16(out.data(), static_cast<uint16_t>(request.size()));
+    slave.mbx_counter = static_cast<uint8_t>(slave.mbx_counter % 7 + 1);
+    out[5] = static_cast<uint8_t>((slave.mbx_counter << 4) | MBX_TYPE_COE);
+    std::copy(request.begin(), request.end(), out.begin() + MBX_HEADER_SIZE);
+
+    // 接收邮箱满时 WKC 为 0，重试直到超时
+    int64_t deadline = steadyNowMs() + timeout_ms;
+    while (fpwr(slave.station_address, slave.mbx_rx_offset, out.data(), static_cast<uint16_t>(out.size())) != 1) {
+        if (steadyNowMs() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::vector<uint8_t> in(slave.mbx_tx_size, 0);
+    while (steadyNowMs() < deadline) {
+        uint8_t sm_status = 0;
+        if (fprd(slave.station_address, static_cast<uint16_t>(REG_SM + 8 + 5), &sm_status, 1) == 1 &&
+            (sm_status & SM_STATUS_MAILBOX_FULL) &&
+            fprd(slave.station_address, slave.mbx_tx_offset, in.data(), static_cast<uint16_t>(in.size())) == 1) {
+            size_t length = std::min<size_t>(getU16(in.data()), in.size() - MBX_HEADER_SIZE);
+            if ((in[5] & 0x0F) == MBX_TYPE_COE && length >= 2 &&
+                (getU16(in.data() + MBX_HEADER_SIZE) >> 12) != COE_SERVICE_EMERGENCY) {
+                response.assign(in.begin() + MBX_HEADER_SIZE, in.begin() + MBX_HEADER_SIZE + length);
+                return true;
+            }
+            continue;   // 紧急报文或其他协议，继续等待应答
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+bool RawSocketBackend::sdoTransfer(uint16_t position, const std::vector<uint8_t>& request,
+                                   std::vector<uint8_t>& response, uint32_t* abort_code) {
+    if (abort_code) {
+        *abort_code = 0;
+    }
+    if (!mailboxExchange(position, request, response, SDO_TIMEOUT_MS) || response.size() < COE_SDO_SIZE) {
+        return false;
+    }
+    uint16_t service = getU16(response.data()) >> 12;
+    if (service != COE_SERVICE_SDO_RESPONSE && service != COE_SERVICE_SDO_REQUEST) {
+        return false;
+    }
+    if (response[2] == SDO_ABORT) {
+        if (abort_code) {
+            *abort_code = getU32(response.data() + 6);
+        }
+        return false;
+    }
+    // 应答的索引和子索引必须与请求一致
+    return getU16(response.data() + 3) == getU16(request.data() + 3) && response[5] == request[5];
+}
+
+bool RawSocketBackend::sdoDownload(uint16_t position, uint16_t index, uint8_t subindex,
+                                   const uint8_t* data, size_t size, uint32_t* abort_code) {
+    if (size == 0 || !data) {
+        return false;
+    }
+    std::vector<uint8_t> request(COE_SDO_SIZE + (size > 4 ? size : 0), 0);
+    putU16(request.data(), static_cast<uint16_t>(COE_SERVICE_SDO_REQUEST << 12));
+    putU16(request.data() + 3, index);
+    request[5] = subindex;
+    if (size <= 4) {
+        request[2] = static_cast<uint8_t>(0x23 | ((4 - size) << 2));    // 快速下载
+        std::memcpy(request.data() + 6, data, size);
+    } else {
+        request[2] = 0x21;                                              // 普通下载（不分段）
+        putU32(request.data() + 6, static_cast<uint32_t>(size));
+        std::memcpy(request.data() + COE_SDO_SIZE, data, size);
+    }
+
+    std::vector<uint8_t> response;
+    return sdoTransfer(position, request, response, abort_code) && response[2] == SDO_DOWNLOAD_RESPONSE;
+}
+
+bool RawSocketBackend::sdoUpload(uint16_t position, uint16_t index, uint8_t subindex,
+                                 uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code) {
+    if (!data || !result_size) {
+        return false;
+    }
+    std::vector<uint8_t> request(COE_SDO_SIZE, 0);
+    putU16(request.data(), static_cast<uint16_t>(COE_SERVICE_SDO_REQUEST << 12));
+    request[2] = SDO_UPLOAD_REQUEST;
+    putU16(request.data() + 3, index);
+    request[5] = subindex;
+
+    std::vector<uint8_t> response;
+    if (!sdoTransfer(position, request, response, abort_code) || (response[2] & 0xE0) != SDO_UPLOAD_REQUEST) {
+        return false;
+    }
+
+    uint8_t command = response[2];
+    const uint8_t* payload = response.data() + 6;
+    size_t length = 0;
+    if (command & 0x02) {
+        length = (command & 0x01) ? 4 - ((command >> 2) & 0x03) : 4;   // 快速上传
+    } else {
+        length = getU32(response.data() + 6);
+        payload = response.data() + COE_SDO_SIZE;
+        if (COE_SDO_SIZE + length > response.size()) {
+            return false;   // 需要分段上传
+        }
+    }
+    if (length > size) {
+        return false;
+    }
+    std::memcpy(data, payload, length);
+    *result_size = length;
+    return true;
+}
+
+// ==================== 热启动数据 ====================
+// u8 version, u16 slave_count；从站：u16 station_address, u32 vendor_id, u32 product_code,
+// u16 mbx_rx_offset, u16 mbx_rx_size, u16 mbx_tx_offset, u16 mbx_tx_size,
+// u8 sync_count + (u16 start, u16 length, u8 control, u8 enable),
+// u8 assignment_count + (u8 sync, u8 pdo_count + u16 pdo_index)
+bool RawSocketBackend::exportWarmStartData(std::vector<uint8_t>& data) const {
+    data.clear();
+    if (!activated || warm_slaves.empty()) {
+        return false;
+    }
+    data.push_back(WARM_START_VERSION);
+    appendU16(data, static_cast<uint16_t>(warm_slaves.size()));
+    for (const auto& slave : warm_slaves) {
+        appendU16(data, slave.station_address);
+        appendU32(data, slave.vendor_id);
+        appendU32(data, slave.product_code);
+        appendU16(data, slave.mbx_rx_offset);
+        appendU16(data, slave.mbx_rx_size);
+        appendU16(data, slave.mbx_tx_offset);
+        appendU16(data, slave.mbx_tx_size);
+        data.push_back(static_cast<uint8_t>(slave.sii_syncs.size()));
+        for (const auto& sync : slave.sii_syncs) {
+            appendU16(data, sync.start);
+            appendU16(data, sync.length);
+            data.push_back(sync.control);
+            data.push_back(sync.enable);
+        }
+        data.push_back(static_cast<uint8_t>(slave.pdo_assignments.size()));
+        for (const auto& assignment : slave.pdo_assignments) {
+            data.push_back(assignment.sync);
+            data.push_back(static_cast<uint8_t>(assignment.pdo_indexes.size()));
+            for (uint16_t pdo : assignment.pdo_indexes) {
+                appendU16(data, pdo);
+            }
+        }
+    }
+    return true;
+}
+
+bool RawSocketBackend::importWarmStartData(const std::vector<uint8_t>& data) {
+    if (activated) {
+        return false;
+    }
+    WarmReader in = {data.data(), data.size(), true};
+    if (in.u8() != WARM_START_VERSION) {
+        return false;
+    }
+    std::vector<BusSlave> slaves(in.u16());
+    for (auto& slave : slaves) {
+        slave.station_address = in.u16();
+        slave.vendor_id = in.u32();
+        slave.product_code = in.u32();
+        slave.mbx_rx_offset = in.u16();
+        slave.mbx_rx_size = in.u16();
+        slave.mbx_tx_offset = in.u16();
+        slave.mbx_tx_size = in.u16();
+        slave.sii_syncs.resize(in.u8());
+        for (auto& sync : slave.sii_syncs) {
+            sync.start = in.u16();
+            sync.length = in.u16();
+            sync.control = in.u8();
+            sync.enable = in.u8();
+        }
+        slave.pdo_assignments.resize(in.u8());
+        for (auto& assignment : slave.pdo_assignments) {
+            assignment.sync = in.u8();
+            assignment.pdo_indexes.resize(in.u8());
+            for (auto& pdo : assignment.pdo_indexes) {
+                pdo = in.u16();
+            }
+        }
+        slave.retained = false;
+        slave.mbx_counter = 0;
+        slave.next_fmmu = 0;
+        if (!in.ok) {
+            return false;
+        }
+    }
+    if (!in.ok || in.left != 0) {
+        return false;
+    }
+    warm_slaves = std::move(slaves);
+    return true;
+}
@@ -0,0 +1,321 @@
+#include "ethercat/RecordingBackend.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+uint8_t* putU8(uint8_t* p, uint8_t value) {
+    *p = value;
+    return p + 1;
+}
+
+uint8_t* putU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    return p + 2;
+}
+
+uint8_t* putU32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return p + 4;
+}
+
+constexpr size_t DOMAIN_RECORD_HEADER_SIZE = 3;     // u16 working_counter + u8 wc_state
+constexpr size_t MASTER_STATE_RECORD_SIZE = 4;
+
+} // namespace
+
+// ==================== 过程数据记录后端 ====================
+RecordingBackend::RecordingBackend(std::unique_ptr<FieldbusBackend> inner, const std::string& path)
+    : inner(std::move(inner))
+    , path(path)
+    , file(nullptr)
+    , staged_master_state()
+    , master_state_staged(false)
+    , record_open(false)
+    , max_record_size(0)
+    , current_chunk(nullptr)
+    , writer_running(false)
+    , write_failed(false)
+    , recorded_cycles(0)
+    , dropped_cycles(0) {
+}
+
+RecordingBackend::~RecordingBackend() {
+    releaseMaster();
+}
+
+std::string RecordingBackend::getName() const {
+    return inner->getName() + " (记录到 " + path + ")";
+}
+
+bool RecordingBackend::requestMaster(unsigned int master_index) {
+    return inner->requestMaster(master_index);
+}
+
+void RecordingBackend::releaseMaster() {
+    // 先停止写线程，保证最后一条记录和缓冲块全部落盘
+    stopWriter();
+    inner->releaseMaster();
+    domain_records.clear();
+}
+
+int RecordingBackend::createDomain() {
+    int domain = inner->createDomain();
+    if (domain < 0) {
+        return domain;
+    }
+    if (static_cast<size_t>(domain) >= PROCESS_IMAGE_MAX_DOMAINS) {
+        std::cerr << "错误: 过程数据记录最多支持 " << PROCESS_IMAGE_MAX_DOMAINS << " 个域" << std::endl;
+        return -1;
+    }
+    if (domain_records.size() <= static_cast<size_t>(domain)) {
+        domain_records.resize(domain + 1);
+    }
+    return domain;
+}
+
+bool RecordingBackend::configureSlave(uint16_t alias, uint16_t position, uint32_t vendor_id, uint32_t product_code,
+                                      const ec_sync_info_t* syncs) {
+    return inner->configureSlave(alias, position, vendor_id, product_code, syncs);
+}
+
+bool RecordingBackend::registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) {
+    if (!inner->registerPdoEntries(domain, regs)) {
+        return false;
+    }
+    // 保存注册结果，回放时按相同的从站和对象字典索引还原偏移
+    DomainRecord& record = domain_records[domain];
+    for (const ec_pdo_entry_reg_t* reg = regs; reg->index; reg++) {
+        record.regs.push_back(*reg);
+        record.offsets.push_back(reg->offset ? *reg->offset : 0);
+        record.bit_positions.push_back(reg->bit_position ? *reg->bit_position : 0);
+    }
+    return true;
+}
+
+bool RecordingBackend::activate() {
+    if (!inner->activate()) {
+        return false;
+    }
+
+    max_record_size = 1 + MASTER_STATE_RECORD_SIZE;
+    for (size_t i = 0; i < domain_records.size(); i++) {
+        DomainRecord& record = domain_records[i];
+        record.image.assign(inner->getDomainSize(static_cast<int>(i)), 0);
+        record.state = ec_domain_state_t();
+        record.processed = false;
+        max_record_size += DOMAIN_RECORD_HEADER_SIZE + record.image.size();
+    }
+    if (max_record_size > CHUNK_SIZE) {
+        std::cerr << "错误: 域数据过大，单周期记录 " << max_record_size << " 字节超过缓冲块大小" << std::endl;
+        return false;
+    }
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "错误: 无法创建记录文件 " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (!writeHeader()) {
+        std::cerr << "错误: 无法写入记录文件头 " << path << std::endl;
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    // 缓冲块一次分配完，周期线程只在空闲队列和满队列之间传递指针
+    chunks.clear();
+    Chunk* chunk = nullptr;
+    while (free_chunks.tryPop(chunk)) {}
+    while (full_chunks.tryPop(chunk)) {}
+    for (size_t i = 0; i < CHUNK_COUNT; i++) {
+        chunks.emplace_back(new Chunk());
+        chunks.back()->used = 0;
+        if (i > 0) {
+            free_chunks.tryPush(chunks.back().get());
+        }
+    }
+    current_chunk = chunks.front().get();
+
+    master_state_staged = false;
+    record_open = false;
+    recorded_cycles = 0;
+    dropped_cycles = 0;
+    write_failed = false;
+    writer_running = true;
+    writer_thread = std::thread(&RecordingBackend::writerThreadFunc, this);
+    return true;
+}
+
+void RecordingBackend::receive() {
+    // 新周期开始：提交上一周期的记录
+    if (record_open) {
+        commitRecord();
+    }
+    inner->receive();
+    record_open = writer_running.load(std::memory_order_relaxed);
+}
+
+void RecordingBackend::processDomain(int domain, ec_domain_state_t& state) {
+    inner->processDomain(domain, state);
+    if (!record_open) {
+        return;
+    }
+    DomainRecord& record = domain_records[domain];
+    const uint8_t* data = inner->getDomainData(domain);
+    if (data) {
+        memcpy(record.image.data(), data, record.image.size());
+    }
+    record.state = state;
+    record.processed = true;
+}
+
+void RecordingBackend::getMasterState(ec_master_state_t& state) {
+    inner->getMasterState(state);
+    if (record_open) {
+        staged_master_state = state;
+        master_state_staged = true;
+    }
+}
+
+bool RecordingBackend::sdoDownload(uint16_t position, uint16_t index, uint8_t subindex,
+                                   const uint8_t* data, size_t size, uint32_t* abort_code) {
+    return inner->sdoDownload(position, index, subindex, data, size, abort_code);
+}
+
+bool RecordingBackend::sdoUpload(uint16_t position, uint16_t index, uint8_t subindex,
+                                 uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code) {
+    return inner->sdoUpload(position, index, subindex, data, size, result_size, abort_code);
+}
+
+void RecordingBackend::commitRecord() {
+    record_open = false;
+
+    // 当前块放不下时交给写线程并换一个空闲块；没有空闲块则丢弃本周期
+    if (current_chunk && current_chunk->used + max_record_size > CHUNK_SIZE) {
+        full_chunks.tryPush(current_chunk);
+        current_chunk = nullptr;
+    }
+    if (!current_chunk && free_chunks.tryPop(current_chunk)) {
+        current_chunk->used = 0;
+    }
+
+    if (current_chunk) {
+        uint8_t* start = current_chunk->data + current_chunk->used;
+        uint8_t* p = start + 1;
+        uint8_t mask = 0;
+        for (size_t i = 0; i < domain_records.size(); i++) {
+            const DomainRecord& record = domain_records[i];
+            if (!record.processed) continue;
+            mask |= static_cast<uint8_t>(1u << i);
+            p = putU16(p, static_cast<uint16_t>(record.state.working_counter));
+            p = putU8(p, static_cast<uint8_t>(record.state.wc_state));
+            memcpy(p, record.image.data(), record.image.size());
+            p += record.image.size();
+        }
+        if (master_state_staged) {
+            mask |= PROCESS_IMAGE_MASTER_STATE_FLAG;
+            p = putU16(p, static_cast<uint16_t>(staged_master_state.slaves_responding));
+            p = putU8(p, static_cast<uint8_t>(staged_master_state.al_states));
+            p = putU8(p, static_cast<uint8_t>(staged_master_state.link_up));
+        }
+        start[0] = mask;
+        current_chunk->used += static_cast<size_t>(p - start);
+        recorded_cycles.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        dropped_cycles.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    for (auto& record : domain_records) {
+        record.processed = false;
+    }
+    master_state_staged = false;
+}
+
+bool RecordingBackend::writeHeader() {
+    std::vector<uint8_t> header(8);
+    memcpy(header.data(), PROCESS_IMAGE_RECORD_MAGIC, sizeof(PROCESS_IMAGE_RECORD_MAGIC));
+    putU16(&header[4], PROCESS_IMAGE_RECORD_VERSION);
+    putU16(&header[6], static_cast<uint16_t>(domain_records.size()));
+
+    for (const auto& record : domain_records) {
+        size_t pos = header.size();
+        header.resize(pos + 6 + record.regs.size() * PROCESS_IMAGE_REG_SIZE);
+        uint8_t* p = &header[pos];
+        p = putU32(p, static_cast<uint32_t>(record.image.size()));
+        p = putU16(p, static_cast<uint16_t>(record.regs.size()));
+        for (size_t i = 0; i < record.regs.size(); i++) {
+            const ec_pdo_entry_reg_t& reg = record.regs[i];
+            p = putU16(p, reg.alias);
+            p = putU16(p, reg.position);
+            p = putU32(p, reg.vendor_id);
+            p = putU32(p, reg.product_code);
+            p = putU16(p, reg.index);
+            p = putU8(p, reg.subindex);
+            p = putU32(p, record.offsets[i]);
+            p = putU8(p, static_cast<uint8_t>(record.bit_positions[i]));
+        }
+    }
+    return std::fwrite(header.data(), 1, header.size(), file) == header.size();
+}
+
+void RecordingBackend::writerThreadFunc() {
+    while (true) {
+        bool stopping = !writer_running.load(std::memory_order_acquire);
+        Chunk* chunk = nullptr;
+        bool wrote = false;
+        while (full_chunks.tryPop(chunk)) {
+            if (std::fwrite(chunk->data, 1, chunk->used, file) != chunk->used) {
+                write_failed = true;
+            }
+            chunk->used = 0;
+            free_chunks.tryPush(chunk);
+            wrote = true;
+        }
+        if (stopping) {
+            break;
+        }
+        if (!wrote) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+void RecordingBackend::stopWriter() {
+    if (!writer_thread.joinable()) {
+        return;
+    }
+
+    // 周期线程已停止，提交最后一条记录并交出当前块
+    if (record_open) {
+        commitRecord();
+    }
+    if (current_chunk && current_chunk->used > 0) {
+        full_chunks.tryPush(current_chunk);
+    }
+    current_chunk = nullptr;
+
+    writer_running.store(false, std::memory_order_release);
+    writer_thread.join();
+
+    if (std::fclose(file) != 0) {
+        write_failed = true;
+    }
+    file = nullptr;
+    chunks.clear();
+
+    if (write_failed) {
+        std::cerr << "错误: 写入记录文件 " << path << " 失败，记录不完整" << std::endl;
+    }
+    std::cout << "过程数据记录: " << recorded_cycles.load() << " 个周期已写入 " << path;
+    if (dropped_cycles.load() > 0) {
+        std::cout << "，" << dropped_cycles.load() << " 个周期因写入跟不上被丢弃";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,351 @@
+#include "ethercat/ReplayBackend.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+uint16_t getU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t getU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+// ==================== 过程数据回放后端 ====================
+ReplayBackend::ReplayBackend(const std::string& path)
+    : path(path)
+    , mapped(nullptr)
+    , mapped_size(0)
+    , records_offset(0)
+    , cursor(0)
+    , created_domains(0)
+    , master_state()
+    , finished(false)
+    , corrupt(false)
+    , replayed_cycles(0) {
+}
+
+ReplayBackend::~ReplayBackend() {
+    releaseMaster();
+}
+
+std::string ReplayBackend::getName() const {
+    return "回放 (" + path + ")";
+}
+
+bool ReplayBackend::requestMaster(unsigned int) {
+    if (mapped) {
+        return true;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "错误: 无法打开记录文件 " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        std::cerr << "错误: 记录文件为空或无法读取: " << path << std::endl;
+        close(fd);
+        return false;
+    }
+
+    // 预先映射并读入整个文件，周期线程回放时不再触发磁盘读取
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "错误: 无法映射记录文件: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    mapped = static_cast<const uint8_t*>(addr);
+    mapped_size = static_cast<size_t>(st.st_size);
+
+    if (!parseHeader()) {
+        std::cerr << "错误: 记录文件格式无效: " << path << std::endl;
+        releaseMaster();
+        return false;
+    }
+    return true;
+}
+
+void ReplayBackend::releaseMaster() {
+    if (mapped) {
+        if (corrupt) {
+            std::cerr << "错误: 记录文件在第 " << replayed_cycles.load() << " 个周期后损坏，回放提前结束" << std::endl;
+        }
+        munmap(const_cast<uint8_t*>(mapped), mapped_size);
+        mapped = nullptr;
+        mapped_size = 0;
+    }
+    domains.clear();
+    entry_widths.clear();
+    created_domains = 0;
+    finished = false;
+    corrupt = false;
+}
+
+bool ReplayBackend::parseHeader() {
+    if (mapped_size < 8 || memcmp(mapped, PROCESS_IMAGE_RECORD_MAGIC, sizeof(PROCESS_IMAGE_RECORD_MAGIC)) != 0) {
+        return false;
+    }
+    if (getU16(mapped + 4) != PROCESS_IMAGE_RECORD_VERSION) {
+        std::cerr << "错误: 不支持的记录文件版本 " << getU16(mapped + 4) << std::endl;
+        return false;
+    }
+    size_t domain_count = getU16(mapped + 6);
+    if (domain_count > PROCESS_IMAGE_MAX_DOMAINS) {
+        return false;
+    }
+
+    size_t pos = 8;
+    domains.assign(domain_count, Domain());
+    for (auto& d : domains) {
+        if (pos + 6 > mapped_size) {
+            return false;
+        }
+        // 每条周期记录都带一份完整的域数据，域大小不可能超过文件剩余部分
+        size_t size = getU32(mapped + pos);
+        size_t reg_count = getU16(mapped + pos + 4);
+        pos += 6;
+        if (size > mapped_size - pos) {
+            std::cerr << "错误: 记录的域大小 " << size << " 字节超出文件长度" << std::endl;
+            return false;
+        }
+        d.data.assign(size, 0);
+        if (pos + reg_count * PROCESS_IMAGE_REG_SIZE > mapped_size) {
+            return false;
+        }
+        for (size_t i = 0; i < reg_count; i++, pos += PROCESS_IMAGE_REG_SIZE) {
+            const uint8_t* p = mapped + pos;
+            RecordedEntry entry;
+            entry.alias = getU16(p);
+            entry.position = getU16(p + 2);
+            entry.vendor_id = getU32(p + 4);
+            entry.product_code = getU32(p + 8);
+            entry.index = getU16(p + 12);
+            entry.subindex = p[14];
+            entry.offset = getU32(p + 15);
+            entry.bit_position = p[19];
+            // 条目宽度要到注册时才知道，这里先保证起始位置落在域内
+            if (entry.offset >= size || entry.bit_position > 7) {
+                std::cerr << "错误: 记录中从站 " << entry.position << " 的 PDO 条目 0x" << std::hex << entry.index
+                          << ":" << static_cast<int>(entry.subindex) << std::dec << " 位置越界 (偏移 "
+                          << entry.offset << "，位 " << static_cast<int>(entry.bit_position) << "，域 " << size
+                          << " 字节)" << std::endl;
+                return false;
+            }
+            d.entries.push_back(entry);
+        }
+        d.state = ec_domain_state_t();
+        d.pending = nullptr;
+    }
+    records_offset = pos;
+    cursor = pos;
+    return true;
+}
+
+int ReplayBackend::createDomain() {
+    if (!mapped || created_domains >= domains.size()) {
+        std::cerr << "错误: 记录文件只包含 " << domains.size() << " 个域" << std::endl;
+        return -1;
+    }
+    return static_cast<int>(created_domains++);
+}
+
+bool ReplayBackend::configureSlave(uint16_t alias, uint16_t position, uint32_t, uint32_t,
+                                   const ec_sync_info_t* syncs) {
+    // 从站身份在注册 PDO 条目时与记录逐项核对；这里只记下各条目的位宽，注册时检查条目不越出域
+    if (!mapped) {
+        return false;
+    }
+    for (unsigned int i = 0; syncs && syncs[i].index != 0xff; i++) {
+        for (unsigned int p = 0; p < syncs[i].n_pdos; p++) {
+            const ec_pdo_info_t& pdo = syncs[i].pdos[p];
+            for (unsigned int e = 0; e < pdo.n_entries; e++) {
+                const ec_pdo_entry_info_t& info = pdo.entries[e];
+                entry_widths.push_back({alias, position, info.index, info.subindex, info.bit_length});
+            }
+        }
+    }
+    return true;
+}
+
+size_t ReplayBackend::entryBitLength(const ec_pdo_entry_reg_t& reg) const {
+    for (const auto& width : entry_widths) {
+        if (width.alias == reg.alias && width.position == reg.position && width.index == reg.index &&
+            width.subindex == reg.subindex) {
+            return width.bit_length;
+        }
+    }
+    // 没有 PDO 映射的从站：字节寻址的条目至少占一个字节，位寻址的至少一位
+    return reg.bit_position ? 1 : 8;
+}
+
+bool ReplayBackend::registerPdoEntries(int domain, const ec_pdo_entry_reg_t* regs) {
+    if (domain < 0 || static_cast<size_t>(domain) >= created_domains) {
+        return false;
+    }
+    const std::vector<RecordedEntry>& entries = domains[domain].entries;
+    for (const ec_pdo_entry_reg_t* reg = regs; reg->index; reg++) {
+        const RecordedEntry* found = nullptr;
+        for (const auto& entry : entries) {
+            if (entry.alias == reg->alias && entry.position == reg->position &&
+                entry.vendor_id == reg->vendor_id && entry.product_code == reg->product_code &&
+                entry.index == reg->index && entry.subindex == reg->subindex) {
+                found = &entry;
+                break;
+            }
+        }
+        if (!found) {
+            std::cerr << "错误: 记录中没有从站 " << reg->position << " 的 PDO 条目 0x" << std::hex
+                      << reg->index << ":" << static_cast<int>(reg->subindex) << std::dec << std::endl;
+            return false;
+        }
+        // 条目的最后一位须落在域内，否则主站按偏移访问域数据时会越界
+        size_t end_bit = static_cast<size_t>(found->offset) * 8 + found->bit_position + entryBitLength(*reg);
+        if (end_bit > domains[domain].data.size() * 8) {
+            std::cerr << "错误: 记录中从站 " << reg->position << " 的 PDO 条目 0x" << std::hex << reg->index << ":"
+                      << static_cast<int>(reg->subindex) << std::dec << " 越出域 (偏移 " << found->offset
+                      << "，域 " << domains[domain].data.size() << " 字节)" << std::endl;
+            return false;
+        }
+        if (reg->offset) {
+            *reg->offset = found->offset;
+        }
+        if (reg->bit_position) {
+            *reg->bit_position = found->bit_position;
+        } else if (found->bit_position != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReplayBackend::activate() {
+    if (!mapped) {
+        return false;
+    }
+    if (created_domains != domains.size()) {
+        std::cerr << "错误: 记录文件包含 " << domains.size() << " 个域，主站创建了 " << created_domains << " 个" << std::endl;
+        return false;
+    }
+    for (auto& d : domains) {
+        std::fill(d.data.begin(), d.data.end(), 0);
+        d.state = ec_domain_state_t();
+        d.pending = nullptr;
+    }
+    master_state = ec_master_state_t();
+    cursor = records_offset;
+    replayed_cycles = 0;
+    corrupt = false;
+    finished = false;
+    return true;
+}
+
+uint8_t* ReplayBackend::getDomainData(int domain) {
+    if (domain < 0 || static_cast<size_t>(domain) >= domains.size() || domains[domain].data.empty()) {
+        return nullptr;
+    }
+    return domains[domain].data.data();
+}
+
+size_t ReplayBackend::getDomainSize(int domain) const {
+    if (domain < 0 || static_cast<size_t>(domain) >= domains.size()) {
+        return 0;
+    }
+    return domains[domain].data.size();
+}
+
+void ReplayBackend::receive() {
+    for (auto& d : domains) {
+        d.pending = nullptr;
+    }
+    if (finished.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (cursor >= mapped_size) {
+        finished.store(true, std::memory_order_release);
+        return;
+    }
+
+    // 解析一条周期记录，域数据直接指向映射内存
+    size_t pos = cursor;
+    uint8_t mask = mapped[pos++];
+    for (size_t i = 0; i < domains.size(); i++) {
+        if (!(mask & (1u << i))) continue;
+        Domain& d = domains[i];
+        if (pos + 3 + d.data.size() > mapped_size) {
+            corrupt = true;
+            finished.store(true, std::memory_order_release);
+            return;
+        }
+        d.pending_state = ec_domain_state_t();
+        d.pending_state.working_counter = getU16(mapped + pos);
+        d.pending_state.wc_state = static_cast<ec_wc_state_t>(mapped[pos + 2]);
+        d.pending = mapped + pos + 3;
+        pos += 3 + d.data.size();
+    }
+    if (mask & PROCESS_IMAGE_MASTER_STATE_FLAG) {
+        if (pos + 4 > mapped_size) {
+            corrupt = true;
+            finished.store(true, std::memory_order_release);
+            return;
+        }
+        master_state.slaves_responding = getU16(mapped + pos);
+        master_state.al_states = mapped[pos + 2] & 0x0F;
+        master_state.link_up = mapped[pos + 3] & 0x01;
+        pos += 4;
+    }
+    cursor = pos;
+    replayed_cycles.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ReplayBackend::processDomain(int domain, ec_domain_state_t& state) {
+    Domain& d = domains[domain];
+    if (finished.load(std::memory_order_relaxed)) {
+        // 播放完：与从站全部掉线相同
+        d.state = ec_domain_state_t();
+        d.state.wc_state = EC_WC_ZERO;
+    } else if (d.pending) {
+        memcpy(d.data.data(), d.pending, d.data.size());
+        d.state = d.pending_state;
+    }
+    state = d.state;
+}
+
+void ReplayBackend::getMasterState(ec_master_state_t& state) {
+    if (finished.load(std::memory_order_relaxed)) {
+        state = ec_master_state_t();
+        return;
+    }
+    state = master_state;
+}
+
+bool ReplayBackend::sdoDownload(uint16_t, uint16_t, uint8_t, const uint8_t*, size_t, uint32_t* abort_code) {
+    if (abort_code) {
+        *abort_code = 0;
+    }
+    return false;
+}
+
+bool ReplayBackend::sdoUpload(uint16_t, uint16_t, uint8_t, uint8_t*, size_t, size_t* result_size, uint32_t* abort_code) {
+    if (result_size) {
+        *result_size = 0;
+    }
+    if (abort_code) {
+        *abort_code = 0;
+    }
+    return false;
+}
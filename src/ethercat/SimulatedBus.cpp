@@ -0,0 +1,1073 @@
+#include "ethercat/SimulatedBus.h"
+#include "ethercat/ecrt_sim.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+// ==================== 模拟总线 ====================
+
+namespace {
+
+constexpr uint32_t BECKHOFF_VENDOR_ID = 0x00000002;
+
+// 激活后从站进入各状态所需的周期数
+constexpr uint64_t SIM_SAFEOP_CYCLES = 5;
+constexpr uint64_t SIM_OP_CYCLES = 10;
+
+// EL3074 4-20mA 量程：0-32767 对应 4-20mA，断线判定 3.6mA
+constexpr int32_t SIM_AI_RAW_FULL_SCALE = 32767;
+constexpr int32_t SIM_AI_RAW_OPEN_CIRCUIT = -819;
+
+// EL3074 AI Settings (0x80n0) 中的子索引
+constexpr uint8_t SIM_AI_ENABLE_FILTER = 0x06;
+constexpr uint8_t SIM_AI_ENABLE_LIMIT1 = 0x07;
+constexpr uint8_t SIM_AI_ENABLE_LIMIT2 = 0x08;
+constexpr uint8_t SIM_AI_LIMIT1 = 0x13;
+constexpr uint8_t SIM_AI_LIMIT2 = 0x14;
+constexpr uint8_t SIM_AI_FILTER_SETTINGS = 0x15;
+
+// SDO 请求发起后经过的周期数（邮箱写入、从站处理、邮箱读出）
+constexpr uint64_t SIM_SDO_REQUEST_CYCLES = 3;
+
+SimulatedBus::Slave makeSlave(uint16_t position, uint32_t product_code, const char* name) {
+    SimulatedBus::Slave slave;
+    slave.position = position;
+    slave.vendor_id = BECKHOFF_VENDOR_ID;
+    slave.product_code = product_code;
+    slave.name = name;
+    slave.responding = true;
+    slave.al_state = EC_AL_STATE_PREOP;
+    slave.has_mailbox = false;
+    return slave;
+}
+
+void setSdoValue(SimulatedBus::Slave& slave, uint16_t index, uint8_t subindex, uint32_t value, size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    slave.sdo[(static_cast<uint32_t>(index) << 8) | subindex] = bytes;
+}
+
+// CoE 从站的身份对象
+void addIdentityObjects(SimulatedBus::Slave& slave, uint32_t device_type) {
+    slave.has_mailbox = true;
+    setSdoValue(slave, 0x1000, 0x00, device_type, 4);
+    setSdoValue(slave, 0x1018, 0x00, 4, 1);
+    setSdoValue(slave, 0x1018, 0x01, slave.vendor_id, 4);
+    setSdoValue(slave, 0x1018, 0x02, slave.product_code, 4);
+    setSdoValue(slave, 0x1018, 0x03, 0x00100000, 4);
+    setSdoValue(slave, 0x1018, 0x04, 0, 4);
+}
+
+// 按顺序追加条目，位偏移在各自方向的映像中连续分配
+void appendEntries(SimulatedBus::Slave& slave, bool input, const ec_pdo_entry_info_t* entries, size_t count) {
+    uint32_t bit_offset = 0;
+    for (const auto& entry : slave.entries) {
+        if (entry.input == input) {
+            bit_offset = std::max(bit_offset, entry.bit_offset + entry.bit_length);
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        slave.entries.push_back({entries[i].index, entries[i].subindex, entries[i].bit_length, bit_offset, input});
+        bit_offset += entries[i].bit_length;
+    }
+}
+
+} // namespace
+
+SimulatedBus& SimulatedBus::instance() {
+    static SimulatedBus bus;
+    return bus;
+}
+
+SimulatedBus::SimulatedBus()
+    : link_up_(true)
+    , cycle_count_(0)
+    , analog_frozen_(0) {
+    buildDefaultTopology();
+}
+
+void SimulatedBus::buildDefaultTopology() {
+    slaves_.clear();
+
+    slaves_.push_back(makeSlave(0, 0x044c2c52, "EK1100"));
+
+    Slave el1008 = makeSlave(1, 0x03f03052, "EL1008");
+    for (uint16_t ch = 0; ch < 8; ch++) {
+        ec_pdo_entry_info_t entry = {static_cast<uint16_t>(0x6000 + ch * 0x10), 0x01, 1};
+        appendEntries(el1008, true, &entry, 1);
+    }
+    slaves_.push_back(el1008);
+
+    // EL3074 标准通道映射：状态位 16 bit + 数值 16 bit
+    Slave el3074 = makeSlave(2, 0x0c023052, "EL3074");
+    for (uint16_t ch = 0; ch < 4; ch++) {
+        uint16_t index = static_cast<uint16_t>(0x6000 + ch * 0x10);
+        ec_pdo_entry_info_t entries[] = {
+            {index, 0x01, 1}, {index, 0x02, 1}, {index, 0x03, 2}, {index, 0x05, 2},
+            {index, 0x07, 1}, {0x0000, 0x00, 7}, {index, 0x0f, 1}, {index, 0x10, 1},
+            {index, 0x11, 16},
+        };
+        appendEntries(el3074, true, entries, sizeof(entries) / sizeof(entries[0]));
+    }
+    addIdentityObjects(el3074, 0x01091389);
+    for (uint16_t ch = 0; ch < 4; ch++) {
+        uint16_t index = static_cast<uint16_t>(0x8000 + ch * 0x10);
+        setSdoValue(el3074, index, SIM_AI_ENABLE_FILTER, 1, 1);
+        setSdoValue(el3074, index, SIM_AI_ENABLE_LIMIT1, 0, 1);
+        setSdoValue(el3074, index, SIM_AI_ENABLE_LIMIT2, 0, 1);
+        setSdoValue(el3074, index, SIM_AI_LIMIT1, 0, 2);
+        setSdoValue(el3074, index, SIM_AI_LIMIT2, 0, 2);
+    }
+    setSdoValue(el3074, 0x8000, SIM_AI_FILTER_SETTINGS, 0, 2);    // 50Hz FIR，对全部通道生效
+    slaves_.push_back(el3074);
+
+    Slave el2634 = makeSlave(3, 0x0a4a3052, "EL2634");
+    for (uint16_t ch = 0; ch < 4; ch++) {
+        ec_pdo_entry_info_t entry = {static_cast<uint16_t>(0x7000 + ch * 0x10), 0x01, 1};
+        appendEntries(el2634, false, &entry, 1);
+    }
+    slaves_.push_back(el2634);
+
+    Slave el6001 = makeSlave(4, 0x17713052, "EL6001");
+    addIdentityObjects(el6001, 0x00001389);
+    slaves_.push_back(el6001);
+    Slave el6751 = makeSlave(5, 0x1a5f3052, "EL6751");
+    addIdentityObjects(el6751, 0x00001389);
+    slaves_.push_back(el6751);
+
+    for (auto& slave : slaves_) {
+        layoutImages(slave);
+    }
+}
+
+void SimulatedBus::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buildDefaultTopology();
+    link_up_ = true;
+    cycle_count_ = 0;
+    analog_frozen_ = 0;
+    cycle_callback_ = nullptr;
+}
+
+void SimulatedBus::layoutImages(Slave& slave) {
+    uint32_t input_bits = 0;
+    uint32_t output_bits = 0;
+    for (const auto& entry : slave.entries) {
+        uint32_t end = entry.bit_offset + entry.bit_length;
+        if (entry.input) {
+            input_bits = std::max(input_bits, end);
+        } else {
+            output_bits = std::max(output_bits, end);
+        }
+    }
+    slave.inputs.assign((input_bits + 7) / 8, 0);
+    slave.outputs.assign((output_bits + 7) / 8, 0);
+}
+
+uint32_t SimulatedBus::readBits(const std::vector<uint8_t>& image, uint32_t bit_offset, uint8_t bit_length) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < bit_length && i < 32; i++) {
+        uint32_t bit = bit_offset + i;
+        if (bit / 8 >= image.size()) {
+            break;
+        }
+        if (image[bit / 8] & (1u << (bit % 8))) {
+            value |= (1u << i);
+        }
+    }
+    return value;
+}
+
+void SimulatedBus::writeBits(std::vector<uint8_t>& image, uint32_t bit_offset, uint8_t bit_length, uint32_t value) {
+    for (uint8_t i = 0; i < bit_length && i < 32; i++) {
+        uint32_t bit = bit_offset + i;
+        if (bit / 8 >= image.size()) {
+            break;
+        }
+        if (value & (1u << i)) {
+            image[bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+        } else {
+            image[bit / 8] &= static_cast<uint8_t>(~(1u << (bit % 8)));
+        }
+    }
+}
+
+SimulatedBus::Slave* SimulatedBus::findSlave(uint16_t position) {
+    for (auto& slave : slaves_) {
+        if (slave.position == position) {
+            return &slave;
+        }
+    }
+    return nullptr;
+}
+
+const SimulatedBus::PdoEntry* SimulatedBus::findEntry(const Slave& slave, uint16_t index, uint8_t subindex) const {
+    for (const auto& entry : slave.entries) {
+        if (entry.index == index && entry.subindex == subindex) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool SimulatedBus::setInputEntry(uint16_t position, uint16_t index, uint8_t subindex, uint32_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slave* slave = findSlave(position);
+    if (!slave) {
+        return false;
+    }
+    const PdoEntry* entry = findEntry(*slave, index, subindex);
+    if (!entry || !entry->input) {
+        return false;
+    }
+    writeBits(slave->inputs, entry->bit_offset, entry->bit_length, value);
+    return true;
+}
+
+bool SimulatedBus::getInputEntry(uint16_t position, uint16_t index, uint8_t subindex, uint32_t& value) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& slave : slaves_) {
+        if (slave.position != position) {
+            continue;
+        }
+        const PdoEntry* entry = findEntry(slave, index, subindex);
+        if (!entry || !entry->input) {
+            return false;
+        }
+        value = readBits(slave.inputs, entry->bit_offset, entry->bit_length);
+        return true;
+    }
+    return false;
+}
+
+bool SimulatedBus::getOutputEntry(uint16_t position, uint16_t index, uint8_t subindex, uint32_t& value) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& slave : slaves_) {
+        if (slave.position != position) {
+            continue;
+        }
+        const PdoEntry* entry = findEntry(slave, index, subindex);
+        if (!entry || entry->input) {
+            return false;
+        }
+        value = readBits(slave.outputs, entry->bit_offset, entry->bit_length);
+        return true;
+    }
+    return false;
+}
+
+bool SimulatedBus::setSdoEntry(uint16_t position, uint16_t index, uint8_t subindex, const std::vector<uint8_t>& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slave* slave = findSlave(position);
+    if (!slave || !slave->has_mailbox) {
+        return false;
+    }
+    slave->sdo[(static_cast<uint32_t>(index) << 8) | subindex] = value;
+    return true;
+}
+
+bool SimulatedBus::getSdoEntry(uint16_t position, uint16_t index, uint8_t subindex, std::vector<uint8_t>& value) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& slave : slaves_) {
+        if (slave.position != position) {
+            continue;
+        }
+        auto it = slave.sdo.find((static_cast<uint32_t>(index) << 8) | subindex);
+        if (it == slave.sdo.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+    return false;
+}
+
+void SimulatedBus::setAnalogRaw(size_t channel, int16_t raw) {
+    if (channel >= 4) {
+        return;
+    }
+    setInputEntry(2, static_cast<uint16_t>(0x6000 + channel * 0x10), 0x11, static_cast<uint16_t>(raw));
+}
+
+int16_t SimulatedBus::getAnalogRaw(size_t channel) const {
+    uint32_t value = 0;
+    if (channel >= 4 || !getInputEntry(2, static_cast<uint16_t>(0x6000 + channel * 0x10), 0x11, value)) {
+        return 0;
+    }
+    return static_cast<int16_t>(static_cast<uint16_t>(value));
+}
+
+void SimulatedBus::setDigitalInputs(uint8_t bits) {
+    for (uint16_t ch = 0; ch < 8; ch++) {
+        setInputEntry(1, static_cast<uint16_t>(0x6000 + ch * 0x10), 0x01, (bits >> ch) & 0x01);
+    }
+}
+
+uint8_t SimulatedBus::getRelayOutputs() const {
+    uint8_t bits = 0;
+    for (uint16_t ch = 0; ch < 4; ch++) {
+        uint32_t value = 0;
+        if (getOutputEntry(3, static_cast<uint16_t>(0x7000 + ch * 0x10), 0x01, value) && value) {
+            bits |= static_cast<uint8_t>(1u << ch);
+        }
+    }
+    return bits;
+}
+
+void SimulatedBus::setSlaveResponding(uint16_t position, bool responding) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slave* slave = findSlave(position);
+    if (slave) {
+        slave->responding = responding;
+        if (!responding) {
+            slave->al_state = EC_AL_STATE_INIT;
+        }
+    }
+}
+
+void SimulatedBus::freezeAnalogSample(size_t channel, bool frozen) {
+    if (channel >= 4) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint8_t bit = static_cast<uint8_t>(1u << channel);
+    analog_frozen_ = static_cast<uint8_t>(frozen ? (analog_frozen_ | bit) : (analog_frozen_ & ~bit));
+}
+
+void SimulatedBus::sampleAnalogLocked() {
+    Slave* slave = findSlave(2);
+    if (!slave || slave->al_state < EC_AL_STATE_SAFEOP) {
+        return;
+    }
+    for (uint16_t ch = 0; ch < 4; ch++) {
+        if (analog_frozen_ & (1u << ch)) {
+            continue;
+        }
+        uint16_t index = static_cast<uint16_t>(0x6000 + ch * 0x10);
+        const PdoEntry* value = findEntry(*slave, index, 0x11);
+        const PdoEntry* toggle = findEntry(*slave, index, 0x10);
+        if (!value || !toggle) {
+            continue;
+        }
+        int32_t raw = static_cast<int16_t>(readBits(slave->inputs, value->bit_offset, value->bit_length));
+        const uint8_t subindexes[] = {0x01, 0x02, 0x07};
+        const bool flags[] = {raw < 0, raw >= SIM_AI_RAW_FULL_SCALE, raw < SIM_AI_RAW_OPEN_CIRCUIT};
+        for (size_t i = 0; i < 3; i++) {
+            const PdoEntry* entry = findEntry(*slave, index, subindexes[i]);
+            if (entry) {
+                writeBits(slave->inputs, entry->bit_offset, entry->bit_length, flags[i] ? 1 : 0);
+            }
+        }
+        
+        // 限值比较按对象字典中的设置：0 未启用，1 低于，2 高于，3 等于
+        uint16_t settings = static_cast<uint16_t>(0x8000 + ch * 0x10);
+        const uint8_t limit_subindexes[][3] = {
+            {0x03, SIM_AI_ENABLE_LIMIT1, SIM_AI_LIMIT1},
+            {0x05, SIM_AI_ENABLE_LIMIT2, SIM_AI_LIMIT2},
+        };
+        for (const auto& limit : limit_subindexes) {
+            const PdoEntry* entry = findEntry(*slave, index, limit[0]);
+            if (!entry) {
+                continue;
+            }
+            uint32_t result = 0;
+            if (sdoValueLocked(*slave, settings, limit[1]) != 0) {
+                int32_t threshold = static_cast<int16_t>(sdoValueLocked(*slave, settings, limit[2]));
+                result = raw < threshold ? 1 : (raw > threshold ? 2 : 3);
+            }
+            writeBits(slave->inputs, entry->bit_offset, entry->bit_length, result);
+        }
+        
+        uint32_t state = readBits(slave->inputs, toggle->bit_offset, toggle->bit_length);
+        writeBits(slave->inputs, toggle->bit_offset, toggle->bit_length, state ^ 0x01);
+    }
+}
+
+uint32_t SimulatedBus::sdoValueLocked(const Slave& slave, uint16_t index, uint8_t subindex) {
+    auto it = slave.sdo.find((static_cast<uint32_t>(index) << 8) | subindex);
+    if (it == slave.sdo.end()) {
+        return 0;
+    }
+    uint32_t value = 0;
+    for (size_t i = 0; i < it->second.size() && i < 4; i++) {
+        value |= static_cast<uint32_t>(it->second[i]) << (8 * i);
+    }
+    return value;
+}
+
+void SimulatedBus::setLinkUp(bool up) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    link_up_ = up;
+}
+
+bool SimulatedBus::isLinkUp() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return link_up_;
+}
+
+void SimulatedBus::setCycleCallback(CycleCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cycle_callback_ = std::move(callback);
+}
+
+uint64_t SimulatedBus::getCycleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cycle_count_;
+}
+
+void SimulatedBus::runCycleCallback() {
+    CycleCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        callback = cycle_callback_;
+    }
+    if (callback) {
+        callback(*this);
+    }
+}
+
+// ==================== ecrt 接口 ====================
+
+struct ec_sdo_request {
+    ec_slave_config_t* config;
+    uint16_t index;
+    uint8_t subindex;
+    std::vector<uint8_t> data;              // 容量为创建时的大小
+    size_t data_size;                       // 写入的长度 / 读取到的长度
+    uint32_t timeout_ms;
+    ec_request_state_t state;
+    bool write;
+    uint64_t issued_cycle;                  // 发起时主站的 active_cycles
+};
+
+struct ec_slave_config {
+    ec_master_t* master;
+    uint16_t alias;
+    uint16_t position;
+    uint32_t vendor_id;
+    uint32_t product_code;
+    std::vector<std::unique_ptr<ec_sdo_request_t>> sdo_requests;
+};
+
+struct ec_domain {
+    // 从站在域映像中的区域（输出在前，输入在后）
+    struct Mapping {
+        uint16_t position;
+        size_t output_offset;
+        size_t output_size;
+        size_t input_offset;
+        size_t input_size;
+    };
+
+    ec_master_t* master;
+    std::vector<Mapping> mappings;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> rx;                // 在途报文带回的输入
+    bool queued;
+    bool in_flight;
+    bool received;
+    unsigned int rx_working_counter;
+    unsigned int working_counter;
+    unsigned int expected_working_counter;
+    ec_wc_state_t wc_state;
+};
+
+struct ec_master {
+    SimulatedBus* bus;
+    std::vector<std::unique_ptr<ec_domain>> domains;
+    std::vector<std::unique_ptr<ec_slave_config>> configs;
+    bool activated;
+    uint64_t active_cycles;
+    std::map<uint16_t, uint64_t> rejoined_cycles;   // 激活后重新上线的从站：位置 -> 上线时的 active_cycles
+};
+
+namespace {
+
+// 配置与总线上的从站身份一致时返回该从站（调用者持有总线锁）
+SimulatedBus::Slave* configuredSlave(const ec_slave_config_t* sc) {
+    if (!sc || sc->alias != 0) {
+        return nullptr;
+    }
+    SimulatedBus::Slave* slave = sc->master->bus->findSlave(sc->position);
+    if (!slave || slave->vendor_id != sc->vendor_id || slave->product_code != sc->product_code) {
+        return nullptr;
+    }
+    return slave;
+}
+
+bool isConfigured(const ec_master_t* master, uint16_t position) {
+    for (const auto& config : master->configs) {
+        if (config->position == position && configuredSlave(config.get())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 发起后经过 SIM_SDO_REQUEST_CYCLES 个周期完成，按完成时从站的对象字典读写（调用者持有总线锁）
+void advanceSdoRequests(ec_master_t* master) {
+    bool link_up = master->bus->linkUpLocked();
+    for (const auto& config : master->configs) {
+        for (const auto& req : config->sdo_requests) {
+            if (req->state != EC_REQUEST_BUSY ||
+                master->active_cycles - req->issued_cycle < SIM_SDO_REQUEST_CYCLES) {
+                continue;
+            }
+            SimulatedBus::Slave* slave = configuredSlave(config.get());
+            if (!slave || !slave->responding || !slave->has_mailbox || !link_up) {
+                req->state = EC_REQUEST_ERROR;
+                continue;
+            }
+            uint32_t key = (static_cast<uint32_t>(req->index) << 8) | req->subindex;
+            if (req->write) {
+                slave->sdo[key] = std::vector<uint8_t>(req->data.begin(), req->data.begin() + req->data_size);
+                req->state = EC_REQUEST_SUCCESS;
+                continue;
+            }
+            auto it = slave->sdo.find(key);
+            if (it == slave->sdo.end() || it->second.size() > req->data.size()) {
+                req->state = EC_REQUEST_ERROR;
+                continue;
+            }
+            std::copy(it->second.begin(), it->second.end(), req->data.begin());
+            req->data_size = it->second.size();
+            req->state = EC_REQUEST_SUCCESS;
+        }
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+ec_master_t* ecrt_request_master(unsigned int master_index) {
+    if (master_index != 0) {
+        return nullptr;
+    }
+    ec_master_t* master = new ec_master_t();
+    master->bus = &SimulatedBus::instance();
+    master->activated = false;
+    master->active_cycles = 0;
+
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+    for (auto& slave : master->bus->slaves()) {
+        if (slave.responding) {
+            slave.al_state = EC_AL_STATE_PREOP;
+        }
+    }
+    return master;
+}
+
+void ecrt_release_master(ec_master_t* master) {
+    if (!master) {
+        return;
+    }
+    ecrt_master_deactivate(master);
+    delete master;
+}
+
+int ecrt_master(ec_master_t* master, ec_master_info_t* master_info) {
+    if (!master || !master_info) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+    std::memset(master_info, 0, sizeof(*master_info));
+    master_info->slave_count = static_cast<unsigned int>(master->bus->slaves().size());
+    master_info->link_up = master->bus->linkUpLocked() ? 1 : 0;
+    return 0;
+}
+
+int ecrt_master_get_slave(ec_master_t* master, uint16_t slave_position, ec_slave_info_t* slave_info) {
+    if (!master || !slave_info) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+    SimulatedBus::Slave* slave = master->bus->findSlave(slave_position);
+    if (!slave || !slave->responding || !master->bus->linkUpLocked()) {
+        return -1;
+    }
+    std::memset(slave_info, 0, sizeof(*slave_info));
+    slave_info->position = slave->position;
+    slave_info->vendor_id = slave->vendor_id;
+    slave_info->product_code = slave->product_code;
+    slave_info->al_state = slave->al_state;
+    std::strncpy(slave_info->name, slave->name.c_str(), EC_MAX_STRING_LENGTH - 1);
+    return 0;
+}
+
+ec_domain_t* ecrt_master_create_domain(ec_master_t* master) {
+    if (!master || master->activated) {
+        return nullptr;
+    }
+    auto domain = std::make_unique<ec_domain_t>();
+    domain->master = master;
+    domain->queued = false;
+    domain->in_flight = false;
+    domain->received = false;
+    domain->rx_working_counter = 0;
+    domain->working_counter = 0;
+    domain->expected_working_counter = 0;
+    domain->wc_state = EC_WC_ZERO;
+    master->domains.push_back(std::move(domain));
+    return master->domains.back().get();
+}
+
+ec_slave_config_t* ecrt_master_slave_config(ec_master_t* master, uint16_t alias, uint16_t position,
+                                            uint32_t vendor_id, uint32_t product_code) {
+    if (!master || master->activated) {
+        return nullptr;
+    }
+    for (const auto& config : master->configs) {
+        if (config->alias == alias && config->position == position) {
+            // 与 IgH 一致：同一位置的身份冲突视为错误
+            if (config->vendor_id != vendor_id || config->product_code != product_code) {
+                return nullptr;
+            }
+            return config.get();
+        }
+    }
+    auto config = std::make_unique<ec_slave_config_t>();
+    config->master = master;
+    config->alias = alias;
+    config->position = position;
+    config->vendor_id = vendor_id;
+    config->product_code = product_code;
+    master->configs.push_back(std::move(config));
+    return master->configs.back().get();
+}
+
+int ecrt_master_activate(ec_master_t* master) {
+    if (!master) {
+        return -1;
+    }
+    for (auto& domain : master->domains) {
+        domain->rx.assign(domain->data.size(), 0);
+    }
+    master->activated = true;
+    master->active_cycles = 0;
+    master->rejoined_cycles.clear();
+    return 0;
+}
+
+void ecrt_master_deactivate(ec_master_t* master) {
+    if (!master || !master->activated) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+    for (auto& slave : master->bus->slaves()) {
+        if (slave.responding) {
+            slave.al_state = EC_AL_STATE_PREOP;
+        }
+        std::fill(slave.outputs.begin(), slave.outputs.end(), 0);
+    }
+    master->activated = false;
+}
+
+void ecrt_master_send(ec_master_t* master) {
+    if (!master || !master->activated) {
+        return;
+    }
+    SimulatedBus* bus = master->bus;
+
+    // 1. 输出写到处于 OP 的从站
+    {
+        std::lock_guard<std::mutex> lock(bus->mutex());
+        bus->countCycle();
+        if (bus->linkUpLocked()) {
+            for (auto& domain : master->domains) {
+                if (!domain->queued) {
+                    continue;
+                }
+                for (const auto& map : domain->mappings) {
+                    SimulatedBus::Slave* slave = bus->findSlave(map.position);
+                    if (slave && slave->responding && slave->al_state == EC_AL_STATE_OP && map.output_size > 0) {
+                        std::memcpy(slave->outputs.data(), domain->data.data() + map.output_offset, map.output_size);
+                    }
+                }
+            }
+        }
+    }
+
+    // 2. 对象模型根据输出更新输入
+    bus->runCycleCallback();
+
+    // 3. 采样输入并计算 WKC（读 +1，写 +2）
+    std::lock_guard<std::mutex> lock(bus->mutex());
+    bus->sampleAnalogLocked();
+    bool link_up = bus->linkUpLocked();
+    for (auto& domain : master->domains) {
+        if (!domain->queued) {
+            continue;
+        }
+        domain->queued = false;
+        domain->in_flight = link_up;
+        domain->rx_working_counter = 0;
+        if (!link_up) {
+            continue;
+        }
+        for (const auto& map : domain->mappings) {
+            SimulatedBus::Slave* slave = bus->findSlave(map.position);
+            if (!slave || !slave->responding) {
+                continue;
+            }
+            if (map.input_size > 0 && slave->al_state >= EC_AL_STATE_SAFEOP) {
+                std::memcpy(domain->rx.data() + map.input_offset, slave->inputs.data(), map.input_size);
+                domain->rx_working_counter += 1;
+            }
+            if (map.output_size > 0 && slave->al_state == EC_AL_STATE_OP) {
+                domain->rx_working_counter += 2;
+            }
+        }
+    }
+}
+
+void ecrt_master_receive(ec_master_t* master) {
+    if (!master || !master->activated) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+
+    // 已配置的从站在激活后依次进入 SAFEOP、OP；掉线后重新上线（回到 INIT）的从站
+    // 与 IgH 一样由主站重新配置，从上线的周期起重新计数
+    master->active_cycles++;
+    for (auto& slave : master->bus->slaves()) {
+        if (!slave.responding) {
+            continue;
+        }
+        if (isConfigured(master, slave.position)) {
+            if (slave.al_state == EC_AL_STATE_INIT) {
+                master->rejoined_cycles[slave.position] = master->active_cycles;
+            }
+            auto rejoined = master->rejoined_cycles.find(slave.position);
+            uint64_t cycles = master->active_cycles -
+                              (rejoined != master->rejoined_cycles.end() ? rejoined->second : 0);
+            if (cycles >= SIM_OP_CYCLES) {
+                slave.al_state = EC_AL_STATE_OP;
+            } else if (cycles >= SIM_SAFEOP_CYCLES) {
+                slave.al_state = EC_AL_STATE_SAFEOP;
+            } else {
+                slave.al_state = EC_AL_STATE_PREOP;
+            }
+        } else if (slave.al_state < EC_AL_STATE_PREOP) {
+            slave.al_state = EC_AL_STATE_PREOP;
+        }
+    }
+
+    for (auto& domain : master->domains) {
+        if (domain->in_flight) {
+            domain->in_flight = false;
+            domain->received = true;
+        }
+    }
+    
+    advanceSdoRequests(master);
+}
+
+void ecrt_master_state(const ec_master_t* master, ec_master_state_t* state) {
+    if (!master || !state) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+    unsigned int responding = 0;
+    unsigned int al_states = 0;
+    bool link_up = master->bus->linkUpLocked();
+    if (link_up) {
+        for (const auto& slave : master->bus->slaves()) {
+            if (slave.responding) {
+                responding++;
+                al_states |= slave.al_state;
+            }
+        }
+    }
+    state->slaves_responding = responding;
+    state->al_states = al_states & 0x0F;
+    state->link_up = link_up ? 1 : 0;
+}
+
+int ecrt_master_sdo_download(ec_master_t* master, uint16_t slave_position, uint16_t index, uint8_t subindex,
+                             const uint8_t* data, size_t data_size, uint32_t* abort_code) {
+    if (!master || (!data && data_size > 0)) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+    SimulatedBus::Slave* slave = master->bus->findSlave(slave_position);
+    if (!slave || !slave->responding || !slave->has_mailbox || !master->bus->linkUpLocked()) {
+        return -1;
+    }
+    if (abort_code) {
+        *abort_code = 0;
+    }
+    slave->sdo[(static_cast<uint32_t>(index) << 8) | subindex] = std::vector<uint8_t>(data, data + data_size);
+    return 0;
+}
+
+int ecrt_master_sdo_upload(ec_master_t* master, uint16_t slave_position, uint16_t index, uint8_t subindex,
+                           uint8_t* target, size_t target_size, size_t* result_size, uint32_t* abort_code) {
+    if (!master || !target || !result_size) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+    SimulatedBus::Slave* slave = master->bus->findSlave(slave_position);
+    if (!slave || !slave->responding || !slave->has_mailbox || !master->bus->linkUpLocked()) {
+        return -1;
+    }
+    auto it = slave->sdo.find((static_cast<uint32_t>(index) << 8) | subindex);
+    if (it == slave->sdo.end()) {
+        if (abort_code) {
+            *abort_code = 0x06020000;   // 对象不存在
+        }
+        return -1;
+    }
+    if (it->second.size() > target_size) {
+        return -1;
+    }
+    std::memcpy(target, it->second.data(), it->second.size());
+    *result_size = it->second.size();
+    if (abort_code) {
+        *abort_code = 0;
+    }
+    return 0;
+}
+
+int ecrt_slave_config_pdos(ec_slave_config_t* sc, unsigned int n_syncs, const ec_sync_info_t syncs[]) {
+    if (!sc || sc->master->activated) {
+        return -1;
+    }
+    if (!syncs) {
+        return 0;
+    }
+    for (unsigned int i = 0; i < n_syncs && syncs[i].index != 0xff; i++) {
+        if (syncs[i].dir != EC_DIR_INPUT && syncs[i].dir != EC_DIR_OUTPUT) {
+            return -1;
+        }
+    }
+    std::lock_guard<std::mutex> lock(sc->master->bus->mutex());
+    SimulatedBus::Slave* slave = configuredSlave(sc);
+
+    // 配置的 PDO 分配替换从站默认分配；从站不在总线上时与 IgH 一样只保存配置
+    std::vector<SimulatedBus::PdoEntry> saved;
+    if (slave) {
+        saved.swap(slave->entries);
+    }
+    bool any = false;
+    for (unsigned int i = 0; i < n_syncs && syncs[i].index != 0xff; i++) {
+        const ec_sync_info_t& sync = syncs[i];
+        for (unsigned int p = 0; p < sync.n_pdos; p++) {
+            const ec_pdo_info_t& pdo = sync.pdos[p];
+            if (slave && pdo.entries) {
+                appendEntries(*slave, sync.dir == EC_DIR_INPUT, pdo.entries, pdo.n_entries);
+                any = true;
+            }
+        }
+    }
+    if (slave) {
+        if (any) {
+            // 新分配中仍然存在的条目保留当前值（例如启动前注入的输入）
+            std::vector<uint8_t> old_inputs;
+            std::vector<uint8_t> old_outputs;
+            old_inputs.swap(slave->inputs);
+            old_outputs.swap(slave->outputs);
+            SimulatedBus::layoutImages(*slave);
+            for (const auto& entry : slave->entries) {
+                for (const auto& prev : saved) {
+                    if (entry.index != 0 && prev.index == entry.index && prev.subindex == entry.subindex &&
+                        prev.input == entry.input && prev.bit_length == entry.bit_length) {
+                        const std::vector<uint8_t>& from = prev.input ? old_inputs : old_outputs;
+                        std::vector<uint8_t>& to = entry.input ? slave->inputs : slave->outputs;
+                        SimulatedBus::writeBits(to, entry.bit_offset, entry.bit_length,
+                                                SimulatedBus::readBits(from, prev.bit_offset, prev.bit_length));
+                        break;
+                    }
+                }
+            }
+        } else {
+            slave->entries.swap(saved);
+        }
+    }
+    return 0;
+}
+
+void ecrt_slave_config_state(const ec_slave_config_t* sc, ec_slave_config_state_t* state) {
+    if (!sc || !state) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sc->master->bus->mutex());
+    SimulatedBus::Slave* slave = configuredSlave(sc);
+    bool online = slave && slave->responding && sc->master->bus->linkUpLocked();
+    state->online = online ? 1 : 0;
+    state->al_state = online ? (slave->al_state & 0x0F) : 0;
+    state->operational = (online && slave->al_state == EC_AL_STATE_OP) ? 1 : 0;
+}
+
+ec_sdo_request_t* ecrt_slave_config_create_sdo_request(ec_slave_config_t* sc, uint16_t index, uint8_t subindex,
+                                                       size_t size) {
+    if (!sc || sc->master->activated) {
+        return nullptr;
+    }
+    auto req = std::make_unique<ec_sdo_request_t>();
+    req->config = sc;
+    req->index = index;
+    req->subindex = subindex;
+    req->data.assign(size, 0);
+    req->data_size = size;
+    req->timeout_ms = 0;
+    req->state = EC_REQUEST_UNUSED;
+    req->write = false;
+    req->issued_cycle = 0;
+    sc->sdo_requests.push_back(std::move(req));
+    return sc->sdo_requests.back().get();
+}
+
+void ecrt_sdo_request_timeout(ec_sdo_request_t* req, uint32_t timeout) {
+    if (req) {
+        req->timeout_ms = timeout;
+    }
+}
+
+uint8_t* ecrt_sdo_request_data(ec_sdo_request_t* req) {
+    return (req && !req->data.empty()) ? req->data.data() : nullptr;
+}
+
+size_t ecrt_sdo_request_data_size(const ec_sdo_request_t* req) {
+    return req ? req->data_size : 0;
+}
+
+ec_request_state_t ecrt_sdo_request_state(ec_sdo_request_t* req) {
+    if (!req) {
+        return EC_REQUEST_ERROR;
+    }
+    std::lock_guard<std::mutex> lock(req->config->master->bus->mutex());
+    return req->state;
+}
+
+void ecrt_sdo_request_write(ec_sdo_request_t* req) {
+    if (!req) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(req->config->master->bus->mutex());
+    req->write = true;
+    req->data_size = req->data.size();
+    req->issued_cycle = req->config->master->active_cycles;
+    req->state = EC_REQUEST_BUSY;
+}
+
+void ecrt_sdo_request_read(ec_sdo_request_t* req) {
+    if (!req) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(req->config->master->bus->mutex());
+    req->write = false;
+    req->issued_cycle = req->config->master->active_cycles;
+    req->state = EC_REQUEST_BUSY;
+}
+
+int ecrt_domain_reg_pdo_entry_list(ec_domain_t* domain, const ec_pdo_entry_reg_t* pdo_entry_regs) {
+    if (!domain || !pdo_entry_regs || domain->master->activated) {
+        return -1;
+    }
+    ec_master_t* master = domain->master;
+    std::lock_guard<std::mutex> lock(master->bus->mutex());
+
+    for (const ec_pdo_entry_reg_t* reg = pdo_entry_regs; reg->index; reg++) {
+        ec_slave_config_t* sc = nullptr;
+        for (const auto& config : master->configs) {
+            if (config->alias == reg->alias && config->position == reg->position &&
+                config->vendor_id == reg->vendor_id && config->product_code == reg->product_code) {
+                sc = config.get();
+                break;
+            }
+        }
+        SimulatedBus::Slave* slave = configuredSlave(sc);
+        if (!slave) {
+            return -1;
+        }
+        const SimulatedBus::PdoEntry* entry = master->bus->findEntry(*slave, reg->index, reg->subindex);
+        if (!entry) {
+            return -1;
+        }
+
+        // 与 IgH 一样按同步管理器整体映射：从站首次注册时把整个输出/输入区追加到域
+        auto it = std::find_if(domain->mappings.begin(), domain->mappings.end(),
+                               [&](const ec_domain::Mapping& m) { return m.position == slave->position; });
+        if (it == domain->mappings.end()) {
+            ec_domain::Mapping map;
+            map.position = slave->position;
+            map.output_offset = domain->data.size();
+            map.output_size = slave->outputs.size();
+            map.input_offset = map.output_offset + map.output_size;
+            map.input_size = slave->inputs.size();
+            domain->data.resize(map.input_offset + map.input_size, 0);
+            domain->expected_working_counter += (map.input_size > 0 ? 1 : 0) + (map.output_size > 0 ? 2 : 0);
+            domain->mappings.push_back(map);
+            it = domain->mappings.end() - 1;
+        }
+
+        size_t base = entry->input ? it->input_offset : it->output_offset;
+        unsigned int bit = entry->bit_offset % 8;
+        if (reg->bit_position) {
+            *reg->bit_position = bit;
+        } else if (bit != 0) {
+            return -1;  // 非字节对齐的条目必须提供 bit_position
+        }
+        if (reg->offset) {
+            *reg->offset = static_cast<unsigned int>(base + entry->bit_offset / 8);
+        }
+    }
+    return 0;
+}
+
+size_t ecrt_domain_size(const ec_domain_t* domain) {
+    return domain ? domain->data.size() : 0;
+}
+
+uint8_t* ecrt_domain_data(ec_domain_t* domain) {
+    if (!domain || !domain->master->activated || domain->data.empty()) {
+        return nullptr;
+    }
+    return domain->data.data();
+}
+
+void ecrt_domain_process(ec_domain_t* domain) {
+    if (!domain) {
+        return;
+    }
+    if (!domain->received) {
+        domain->working_counter = 0;
+    } else {
+        domain->received = false;
+        domain->working_counter = domain->rx_working_counter;
+        for (const auto& map : domain->mappings) {
+            if (map.input_size > 0) {
+                std::memcpy(domain->data.data() + map.input_offset, domain->rx.data() + map.input_offset, map.input_size);
+            }
+        }
+    }
+
+    if (domain->working_counter == 0) {
+        domain->wc_state = EC_WC_ZERO;
+    } else if (domain->working_counter == domain->expected_working_counter) {
+        domain->wc_state = EC_WC_COMPLETE;
+    } else {
+        domain->wc_state = EC_WC_INCOMPLETE;
+    }
+}
+
+void ecrt_domain_queue(ec_domain_t* domain) {
+    if (domain) {
+        domain->queued = true;
+    }
+}
+
+void ecrt_domain_state(const ec_domain_t* domain, ec_domain_state_t* state) {
+    if (!domain || !state) {
+        return;
+    }
+    state->working_counter = domain->working_counter;
+    state->wc_state = domain->wc_state;
+    state->redundancy_active = 0;
+}
+
+} // extern "C"
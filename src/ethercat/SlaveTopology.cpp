@@ -0,0 +1,1163 @@
+#include "ethercat/SlaveTopology.h"
+#include "ethercat/EtherCATMaster.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace {
+
+// ==================== 最小 XML 读取器 ====================
+// 只支持拓扑文件需要的部分：元素、属性、文本、注释、CDATA 和预定义/数字实体
+struct XmlElement {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> attributes;
+    std::string text;
+    std::vector<XmlElement> children;
+    int line;
+
+    const XmlElement* child(const char* child_name) const {
+        for (const auto& c : children) {
+            if (c.name == child_name) return &c;
+        }
+        return nullptr;
+    }
+
+    const std::string* attribute(const char* attribute_name) const {
+        for (const auto& a : attributes) {
+            if (a.first == attribute_name) return &a.second;
+        }
+        return nullptr;
+    }
+};
+
+class XmlReader {
+public:
+    explicit XmlReader(const std::string& text) : text(text), pos(0), depth(0), line_pos(0), line(1) {}
+
+    bool parse(XmlElement& root, std::string& error) {
+        if (!skipMisc() || !parseElement(root) || !skipMisc()) {
+            error = message;
+            return false;
+        }
+        if (pos != text.size()) {
+            fail("根元素之后有多余内容");
+            error = message;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 32;
+
+    bool fail(const std::string& what) {
+        if (message.empty()) {
+            message = "第 " + std::to_string(lineAt(pos)) + " 行: " + what;
+        }
+        return false;
+    }
+
+    // 行号增量统计（读取位置只增不减）
+    int lineAt(size_t at) {
+        if (at < line_pos) {
+            line_pos = 0;
+            line = 1;
+        }
+        for (; line_pos < at && line_pos < text.size(); line_pos++) {
+            if (text[line_pos] == '\n') line++;
+        }
+        return line;
+    }
+
+    bool startsWith(const char* prefix) const {
+        return text.compare(pos, std::strlen(prefix), prefix) == 0;
+    }
+
+    bool skipPast(const char* terminator) {
+        size_t end = text.find(terminator, pos);
+        if (end == std::string::npos) {
+            return fail(std::string("缺少 ") + terminator);
+        }
+        pos = end + std::strlen(terminator);
+        return true;
+    }
+
+    void skipSpace() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+    }
+
+    // 根元素前后的空白、XML 声明、注释和 DOCTYPE
+    bool skipMisc() {
+        while (true) {
+            skipSpace();
+            if (startsWith("<?")) {
+                if (!skipPast("?>")) return false;
+            } else if (startsWith("<!--")) {
+                if (!skipPast("-->")) return false;
+            } else if (startsWith("<!")) {
+                if (!skipPast(">")) return false;
+            } else {
+                return true;
+            }
+        }
+    }
+
+    static bool isNameChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '.' || c == ':' ||
+               (static_cast<unsigned char>(c) & 0x80);
+    }
+
+    bool parseName(std::string& name) {
+        size_t begin = pos;
+        while (pos < text.size() && isNameChar(text[pos])) pos++;
+        if (pos == begin) {
+            return fail("缺少名称");
+        }
+        name.assign(text, begin, pos - begin);
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, unsigned long cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xc0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3f));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xe0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (cp & 0x3f));
+        } else {
+            out += static_cast<char>(0xf0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (cp & 0x3f));
+        }
+    }
+
+    // 解码 [begin, end) 中的字符数据并追加到 out
+    bool decode(size_t begin, size_t end, std::string& out) {
+        for (size_t i = begin; i < end; i++) {
+            if (text[i] != '&') {
+                out += text[i];
+                continue;
+            }
+            size_t semi = text.find(';', i);
+            if (semi == std::string::npos || semi > end) {
+                pos = i;
+                return fail("实体缺少 ';'");
+            }
+            std::string entity = text.substr(i + 1, semi - i - 1);
+            if (entity == "lt") out += '<';
+            else if (entity == "gt") out += '>';
+            else if (entity == "amp") out += '&';
+            else if (entity == "quot") out += '"';
+            else if (entity == "apos") out += '\'';
+            else if (entity.size() > 1 && entity[0] == '#') {
+                bool hex = entity[1] == 'x' || entity[1] == 'X';
+                const char* digits = entity.c_str() + (hex ? 2 : 1);
+                char* parse_end = nullptr;
+                unsigned long cp = std::strtoul(digits, &parse_end, hex ? 16 : 10);
+                if (*digits == '\0' || *parse_end != '\0' || cp == 0 || cp > 0x10ffff) {
+                    pos = i;
+                    return fail("无效的字符引用 &" + entity + ";");
+                }
+                appendUtf8(out, cp);
+            } else {
+                pos = i;
+                return fail("未知实体 &" + entity + ";");
+            }
+            i = semi;
+        }
+        return true;
+    }
+
+    bool parseElement(XmlElement& element) {
+        if (++depth > MAX_DEPTH) {
+            return fail("元素嵌套过深");
+        }
+        element.line = lineAt(pos);
+        if (pos >= text.size() || text[pos] != '<') {
+            return fail("缺少元素");
+        }
+        pos++;
+        if (!parseName(element.name)) return false;
+
+        // 属性
+        while (true) {
+            skipSpace();
+            if (startsWith("/>")) {
+                pos += 2;
+                depth--;
+                return true;
+            }
+            if (startsWith(">")) {
+                pos++;
+                break;
+            }
+            std::string name;
+            if (!parseName(name)) return false;
+            skipSpace();
+            if (pos >= text.size() || text[pos] != '=') {
+                return fail("属性 " + name + " 缺少 '='");
+            }
+            pos++;
+            skipSpace();
+            if (pos >= text.size() || (text[pos] != '"' && text[pos] != '\'')) {
+                return fail("属性 " + name + " 缺少引号");
+            }
+            char quote = text[pos++];
+            size_t end = text.find(quote, pos);
+            if (end == std::string::npos) {
+                return fail("属性 " + name + " 缺少结束引号");
+            }
+            std::string value;
+            if (!decode(pos, end, value)) return false;
+            element.attributes.emplace_back(name, value);
+            pos = end + 1;
+        }
+
+        // 内容
+        while (true) {
+            if (pos >= text.size()) {
+                return fail("元素 " + element.name + " 未结束");
+            }
+            if (startsWith("</")) {
+                pos += 2;
+                std::string name;
+                if (!parseName(name)) return false;
+                if (name != element.name) {
+                    return fail("结束标签 " + name + " 与 " + element.name + " 不匹配");
+                }
+                skipSpace();
+                if (pos >= text.size() || text[pos] != '>') {
+                    return fail("结束标签缺少 '>'");
+                }
+                pos++;
+                depth--;
+                return true;
+            }
+            if (startsWith("<!--")) {
+                if (!skipPast("-->")) return false;
+            } else if (startsWith("<![CDATA[")) {
+                size_t begin = pos + 9;
+                if (!skipPast("]]>")) return false;
+                element.text.append(text, begin, pos - 3 - begin);
+            } else if (startsWith("<?")) {
+                if (!skipPast("?>")) return false;
+            } else if (text[pos] == '<') {
+                element.children.emplace_back();
+                if (!parseElement(element.children.back())) return false;
+            } else {
+                size_t end = text.find('<', pos);
+                if (end == std::string::npos) end = text.size();
+                if (!decode(pos, end, element.text)) return false;
+                pos = end;
+            }
+        }
+    }
+
+    const std::string& text;
+    size_t pos;
+    int depth;
+    size_t line_pos;
+    int line;
+    std::string message;
+};
+
+std::string trim(const std::string& s) {
+    size_t begin = 0;
+    size_t end = s.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(s[begin]))) begin++;
+    while (end > begin && std::isspace(static_cast<unsigned char>(s[end - 1]))) end--;
+    return s.substr(begin, end - begin);
+}
+
+// 十进制或 #x / 0x 十六进制
+bool parseNumber(const std::string& raw, uint32_t max, uint32_t& value) {
+    std::string s = trim(raw);
+    int base = 10;
+    size_t skip = 0;
+    if (s.size() > 2 && (s[0] == '#' || s[0] == '0') && (s[1] == 'x' || s[1] == 'X')) {
+        base = 16;
+        skip = 2;
+    }
+    if (s.size() <= skip) return false;
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long v = std::strtoull(s.c_str() + skip, &end, base);
+    if (errno != 0 || *end != '\0' || s[skip] == '-' || v > max) return false;
+    value = static_cast<uint32_t>(v);
+    return true;
+}
+
+bool parseBool(const std::string& raw, bool& value) {
+    std::string s = trim(raw);
+    if (s == "true" || s == "1") { value = true; return true; }
+    if (s == "false" || s == "0") { value = false; return true; }
+    return false;
+}
+
+std::string at(const XmlElement& e) {
+    return "第 " + std::to_string(e.line) + " 行 <" + e.name + ">: ";
+}
+
+// 子元素文本形式的数值；required 为 false 且缺失时保持 value 不变
+bool childNumber(const XmlElement& parent, const char* name, uint32_t max, bool required,
+                 uint32_t& value, std::string& error) {
+    const XmlElement* c = parent.child(name);
+    if (!c) {
+        if (required) error = at(parent) + "缺少 <" + name + ">";
+        return !required;
+    }
+    if (!parseNumber(c->text, max, value)) {
+        error = at(*c) + "无效的数值 \"" + trim(c->text) + "\"";
+        return false;
+    }
+    return true;
+}
+
+bool attributeNumber(const XmlElement& e, const char* name, uint32_t max, bool required,
+                     uint32_t& value, std::string& error) {
+    const std::string* a = e.attribute(name);
+    if (!a) {
+        if (required) error = at(e) + "缺少属性 " + name;
+        return !required;
+    }
+    if (!parseNumber(*a, max, value)) {
+        error = at(e) + "属性 " + name + " 的数值无效 \"" + *a + "\"";
+        return false;
+    }
+    return true;
+}
+
+bool readFile(const std::string& path, std::string& content) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    content = ss.str();
+    return !file.bad();
+}
+
+bool statFile(const std::string& path, uint64_t& size, int64_t& mtime_ns) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    size = static_cast<uint64_t>(st.st_size);
+    mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+
+// ==================== 缓存编解码（小端） ====================
+void putU8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+void putU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+// 越界读取返回 0 并置 ok = false
+struct CacheReader {
+    const uint8_t* p;
+    size_t left;
+    bool ok;
+
+    bool take(size_t n) {
+        if (!ok || left < n) {
+            ok = false;
+            return false;
+        }
+        left -= n;
+        return true;
+    }
+
+    uint8_t u8() {
+        if (!take(1)) return 0;
+        return *p++;
+    }
+
+    uint16_t u16() {
+        if (!take(2)) return 0;
+        uint16_t v = static_cast<uint16_t>(p[0] | (p[1] << 8));
+        p += 2;
+        return v;
+    }
+
+    uint32_t u32() {
+        if (!take(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(p[i]) << (8 * i);
+        p += 4;
+        return v;
+    }
+
+    uint64_t u64() {
+        if (!take(8)) return 0;
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+        p += 8;
+        return v;
+    }
+};
+
+constexpr size_t CACHE_HEADER_SIZE = 4 + 2 + 2 + 8 + 8 + 6 * 4;
+constexpr size_t CACHE_SLAVE_SIZE = 2 + 2 + 4 + 4 + 1 + 4 + 4 + 4 + 2;
+constexpr size_t CACHE_SYNC_SIZE = 1 + 1 + 1 + 4 + 4;
+constexpr size_t CACHE_PDO_SIZE = 2 + 4 + 4;
+constexpr size_t CACHE_ENTRY_SIZE = 2 + 1 + 1;
+constexpr size_t CACHE_BINDING_SIZE = 1 + 1 + 4 + 2 + 1;
+
+// FNV-1a 64 位，按小端逐字节累加
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+void hashValue(uint64_t& hash, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        hash ^= static_cast<uint8_t>(value >> (8 * i));
+        hash *= FNV_PRIME;
+    }
+}
+
+} // namespace
+
+// ==================== 从站拓扑 ====================
+SlaveTopology::SlaveTopology()
+    : from_cache(false)
+    , source_size(0)
+    , source_mtime_ns(0) {
+}
+
+SlaveTopology SlaveTopology::createDefault() {
+    SlaveTopology topology;
+
+    // EK1100 耦合器 (无PDO)
+    topology.addSlave("EK1100", 0, 0, EK1100_VENDOR_ID, EK1100_PRODUCT_CODE, false);
+
+    // 数字输入、模拟输入、继电器输出：PDO 映射由端子描述生成（PdoLayout.h）
+    topology.addTerminal<El1008>(0, 1, false);
+    topology.addTerminal<El3074>(0, 2, false);
+    topology.addTerminal<El2634>(0, 3, false);
+
+    // EL6001 RS232 / EL6751 CANopen 主站（无PDO，非关键从站）
+    topology.addSlave("EL6001", 0, 4, EL6001_VENDOR_ID, EL6001_PRODUCT_CODE, true);
+    topology.addSlave("EL6751", 0, 5, EL6751_VENDOR_ID, EL6751_PRODUCT_CODE, true);
+
+    // 过程数据：四路压力、八路数字输入、四路继电器，每个通道注册一个条目
+    for (uint8_t ch = 1; ch <= El3074::channel_count; ch++) {
+        topology.addBinding(0, ch, 2, PdoLayout<El3074>::objectIndex(ch), El3074::value_subindex);
+    }
+    for (uint8_t ch = 1; ch <= El1008::channel_count; ch++) {
+        topology.addBinding(1, ch, 1, PdoLayout<El1008>::objectIndex(ch), El1008::value_subindex);
+    }
+    for (uint8_t ch = 1; ch <= El2634::channel_count; ch++) {
+        topology.addBinding(2, ch, 3, PdoLayout<El2634>::objectIndex(ch), El2634::value_subindex);
+    }
+
+    topology.link();
+    topology.source = "内置";
+    return topology;
+}
+
+void SlaveTopology::addSlave(const std::string& name, uint16_t alias, uint16_t position,
+                             uint32_t vendor_id, uint32_t product_code, bool optional) {
+    TopologySlave slave;
+    slave.name = name;
+    slave.alias = alias;
+    slave.position = position;
+    slave.vendor_id = vendor_id;
+    slave.product_code = product_code;
+    slave.optional = optional;
+    slave.first_sync = static_cast<uint32_t>(sync_records.size());
+    slave.sync_count = 0;
+    slaves.push_back(slave);
+}
+
+void SlaveTopology::addSync(uint8_t index, ec_direction_t dir, ec_watchdog_mode_t watchdog) {
+    SyncRecord sync;
+    sync.index = index;
+    sync.dir = static_cast<uint8_t>(dir);
+    sync.watchdog = static_cast<uint8_t>(watchdog);
+    sync.first_pdo = static_cast<uint32_t>(pdo_records.size());
+    sync.pdo_count = 0;
+    sync_records.push_back(sync);
+    slaves.back().sync_count++;
+}
+
+void SlaveTopology::addPdo(uint16_t index) {
+    PdoRecord pdo;
+    pdo.index = index;
+    pdo.first_entry = static_cast<uint32_t>(entries.size());
+    pdo.entry_count = 0;
+    pdo_records.push_back(pdo);
+    sync_records.back().pdo_count++;
+}
+
+void SlaveTopology::addEntry(uint16_t index, uint8_t subindex, uint8_t bit_length) {
+    ec_pdo_entry_info_t entry;
+    entry.index = index;
+    entry.subindex = subindex;
+    entry.bit_length = bit_length;
+    entries.push_back(entry);
+    pdo_records.back().entry_count++;
+}
+
+void SlaveTopology::addBinding(uint8_t domain, uint8_t channel, uint32_t slave, uint16_t index, uint8_t subindex) {
+    TopologyBinding binding;
+    binding.domain = domain;
+    binding.channel = channel;
+    binding.slave = slave;
+    binding.index = index;
+    binding.subindex = subindex;
+    bindings.push_back(binding);
+}
+
+bool SlaveTopology::validate(std::string& error) const {
+    if (slaves.empty()) {
+        error = "拓扑中没有从站";
+        return false;
+    }
+
+    // 记录之间的下标（缓存读入时需要检查）
+    for (const auto& slave : slaves) {
+        if (slave.first_sync > sync_records.size() || slave.sync_count > sync_records.size() - slave.first_sync) {
+            error = "从站 " + slave.name + " 的同步管理器下标越界";
+            return false;
+        }
+    }
+    for (const auto& sync : sync_records) {
+        if (sync.first_pdo > pdo_records.size() || sync.pdo_count > pdo_records.size() - sync.first_pdo ||
+            (sync.dir != EC_DIR_INPUT && sync.dir != EC_DIR_OUTPUT) || sync.watchdog > EC_WD_DISABLE) {
+            error = "同步管理器 " + std::to_string(sync.index) + " 无效";
+            return false;
+        }
+    }
+    for (const auto& pdo : pdo_records) {
+        if (pdo.first_entry > entries.size() || pdo.entry_count > entries.size() - pdo.first_entry) {
+            error = "PDO 的条目下标越界";
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < slaves.size(); i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (slaves[i].alias == slaves[j].alias && slaves[i].position == slaves[j].position) {
+                error = "从站 " + slaves[i].name + " 与 " + slaves[j].name + " 的位置重复: " +
+                        std::to_string(slaves[i].alias) + ":" + std::to_string(slaves[i].position);
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < bindings.size(); i++) {
+        const TopologyBinding& b = bindings[i];
+        if (b.domain >= TOPOLOGY_DOMAIN_COUNT || b.channel == 0 || b.slave >= slaves.size()) {
+            error = "过程数据绑定 " + std::to_string(i + 1) + " 无效";
+            return false;
+        }
+        std::string label = std::string(TOPOLOGY_DOMAIN_NAMES[b.domain]) + " 通道 " + std::to_string(b.channel);
+        for (size_t j = 0; j < i; j++) {
+            if (bindings[j].domain == b.domain && bindings[j].channel == b.channel) {
+                error = label + " 重复绑定";
+                return false;
+            }
+        }
+
+        // 显式映射的从站上，绑定的条目必须在映射中
+        const TopologySlave& slave = slaves[b.slave];
+        if (slave.sync_count == 0) continue;
+        bool found = false;
+        for (uint32_t s = slave.first_sync; s < slave.first_sync + slave.sync_count && !found; s++) {
+            const SyncRecord& sync = sync_records[s];
+            for (uint32_t p = sync.first_pdo; p < sync.first_pdo + sync.pdo_count && !found; p++) {
+                const PdoRecord& pdo = pdo_records[p];
+                for (uint32_t e = pdo.first_entry; e < pdo.first_entry + pdo.entry_count; e++) {
+                    if (entries[e].index == b.index && entries[e].subindex == b.subindex) {
+                        found = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (!found) {
+            char entry[16];
+            std::snprintf(entry, sizeof(entry), "0x%04x:%02x", b.index, b.subindex);
+            error = label + " 绑定的条目 " + entry + " 不在从站 " + slave.name + " 的 PDO 映射中";
+            return false;
+        }
+    }
+    return true;
+}
+
+void SlaveTopology::link() {
+    pdo_table.clear();
+    pdo_table.reserve(pdo_records.size());
+    for (const auto& pdo : pdo_records) {
+        ec_pdo_info_t info;
+        info.index = pdo.index;
+        info.n_entries = pdo.entry_count;
+        info.entries = pdo.entry_count ? &entries[pdo.first_entry] : nullptr;
+        pdo_table.push_back(info);
+    }
+
+    sync_table.clear();
+    sync_table.reserve(sync_records.size() + slaves.size());
+    sync_table_offset.assign(slaves.size(), 0);
+    for (size_t i = 0; i < slaves.size(); i++) {
+        const TopologySlave& slave = slaves[i];
+        sync_table_offset[i] = static_cast<uint32_t>(sync_table.size());
+        for (uint32_t s = slave.first_sync; s < slave.first_sync + slave.sync_count; s++) {
+            const SyncRecord& record = sync_records[s];
+            ec_sync_info_t sync;
+            sync.index = record.index;
+            sync.dir = static_cast<ec_direction_t>(record.dir);
+            sync.n_pdos = record.pdo_count;
+            sync.pdos = record.pdo_count ? &pdo_table[record.first_pdo] : nullptr;
+            sync.watchdog_mode = static_cast<ec_watchdog_mode_t>(record.watchdog);
+            sync_table.push_back(sync);
+        }
+        ec_sync_info_t end;
+        end.index = 0xff;
+        end.dir = EC_DIR_INVALID;
+        end.n_pdos = 0;
+        end.pdos = nullptr;
+        end.watchdog_mode = EC_WD_DEFAULT;
+        sync_table.push_back(end);
+    }
+}
+
+const ec_sync_info_t* SlaveTopology::getSyncs(const TopologySlave& slave) const {
+    size_t i = static_cast<size_t>(&slave - slaves.data());
+    if (i >= slaves.size() || slave.sync_count == 0) {
+        return nullptr;
+    }
+    return &sync_table[sync_table_offset[i]];
+}
+
+uint64_t SlaveTopology::fingerprint() const {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hashValue(hash, slaves.size(), 4);
+    for (const auto& slave : slaves) {
+        hashValue(hash, slave.alias, 2);
+        hashValue(hash, slave.position, 2);
+        hashValue(hash, slave.vendor_id, 4);
+        hashValue(hash, slave.product_code, 4);
+        hashValue(hash, slave.sync_count, 4);
+        for (uint32_t s = 0; s < slave.sync_count; s++) {
+            const SyncRecord& sync = sync_records[slave.first_sync + s];
+            hashValue(hash, sync.index, 1);
+            hashValue(hash, sync.dir, 1);
+            hashValue(hash, sync.watchdog, 1);
+            hashValue(hash, sync.pdo_count, 4);
+            for (uint32_t p = 0; p < sync.pdo_count; p++) {
+                const PdoRecord& pdo = pdo_records[sync.first_pdo + p];
+                hashValue(hash, pdo.index, 2);
+                hashValue(hash, pdo.entry_count, 4);
+                for (uint32_t e = 0; e < pdo.entry_count; e++) {
+                    const ec_pdo_entry_info_t& entry = entries[pdo.first_entry + e];
+                    hashValue(hash, entry.index, 2);
+                    hashValue(hash, entry.subindex, 1);
+                    hashValue(hash, entry.bit_length, 1);
+                }
+            }
+        }
+    }
+    return hash;
+}
+
+const TopologySlave* SlaveTopology::findSlave(uint16_t alias, uint16_t position) const {
+    for (const auto& slave : slaves) {
+        if (slave.alias == alias && slave.position == position) {
+            return &slave;
+        }
+    }
+    return nullptr;
+}
+
+// ==================== 总线比对 ====================
+const SlaveCheckEntry* TopologyCheck::find(size_t slave_index) const {
+    for (const auto& entry : entries) {
+        if (entry.expected == static_cast<int>(slave_index)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+TopologyCheck SlaveTopology::check(const std::vector<ec_slave_info_t>& bus) const {
+    TopologyCheck result;
+    result.scanned = true;
+    result.verified = true;
+    result.bus_slave_count = static_cast<unsigned int>(bus.size());
+
+    auto findBus = [&bus](uint32_t position) -> const ec_slave_info_t* {
+        for (const auto& info : bus) {
+            if (info.position == position) {
+                return &info;
+            }
+        }
+        return nullptr;
+    };
+
+    std::vector<bool> matched(bus.size(), false);
+    for (size_t i = 0; i < slaves.size(); i++) {
+        const TopologySlave& slave = slaves[i];
+        SlaveCheckEntry entry;
+        entry.position = slave.position;
+        entry.result = SlaveCheckResult::SLAVE_MISSING;
+        entry.expected = static_cast<int>(i);
+        entry.vendor_id = 0;
+        entry.product_code = 0;
+
+        // 别名寻址：相对于带该别名的从站
+        const ec_slave_info_t* info = nullptr;
+        if (slave.alias == 0) {
+            info = findBus(slave.position);
+        } else {
+            for (const auto& candidate : bus) {
+                if (candidate.alias == slave.alias) {
+                    info = findBus(static_cast<uint32_t>(candidate.position) + slave.position);
+                    break;
+                }
+            }
+        }
+        if (info) {
+            matched[info - bus.data()] = true;
+            entry.position = info->position;
+            entry.vendor_id = info->vendor_id;
+            entry.product_code = info->product_code;
+            entry.name = info->name;
+            entry.result = (info->vendor_id == slave.vendor_id && info->product_code == slave.product_code)
+                           ? SlaveCheckResult::SLAVE_OK : SlaveCheckResult::SLAVE_MISMATCH;
+        }
+        if (entry.result == SlaveCheckResult::SLAVE_MISMATCH ||
+            (entry.result == SlaveCheckResult::SLAVE_MISSING && !slave.optional)) {
+            result.verified = false;
+        }
+        result.entries.push_back(entry);
+    }
+
+    // 拓扑之外的从站不影响校验结果，只报告
+    for (size_t i = 0; i < bus.size(); i++) {
+        if (matched[i]) continue;
+        SlaveCheckEntry entry;
+        entry.position = bus[i].position;
+        entry.result = SlaveCheckResult::SLAVE_UNEXPECTED;
+        entry.expected = -1;
+        entry.vendor_id = bus[i].vendor_id;
+        entry.product_code = bus[i].product_code;
+        entry.name = bus[i].name;
+        result.entries.push_back(entry);
+    }
+
+    std::stable_sort(result.entries.begin(), result.entries.end(),
+                     [](const SlaveCheckEntry& a, const SlaveCheckEntry& b) { return a.position < b.position; });
+    return result;
+}
+
+// ==================== XML 解析 ====================
+bool SlaveTopology::loadXml(const std::string& xml_path, std::string& error) {
+    SlaveTopology topology;
+    std::string content;
+    if (!statFile(xml_path, topology.source_size, topology.source_mtime_ns) || !readFile(xml_path, content)) {
+        error = "无法读取拓扑文件: " + xml_path;
+        return false;
+    }
+    if (!topology.parseXml(content, error) || !topology.validate(error)) {
+        error = xml_path + ": " + error;
+        return false;
+    }
+    topology.link();
+    topology.source = xml_path;
+    *this = std::move(topology);
+    return true;
+}
+
+// 在空拓扑上按文件内容添加记录，整体校验由调用者完成
+bool SlaveTopology::parseXml(const std::string& content, std::string& error) {
+    XmlElement root;
+    XmlReader reader(content);
+    if (!reader.parse(root, error)) {
+        return false;
+    }
+    if (root.name != "EtherCATConfig") {
+        error = at(root) + "根元素应为 <EtherCATConfig>";
+        return false;
+    }
+    const XmlElement* config = root.child("Config");
+    if (!config) {
+        error = at(root) + "缺少 <Config>";
+        return false;
+    }
+
+    uint32_t order = 0;
+    for (const auto& node : config->children) {
+        if (node.name != "Slave") continue;
+
+        const XmlElement* info = node.child("Info");
+        if (!info) {
+            error = at(node) + "缺少 <Info>";
+            return false;
+        }
+        uint32_t vendor_id = 0;
+        uint32_t product_code = 0;
+        uint32_t alias = 0;
+        uint32_t position = order;
+        if (!childNumber(*info, "VendorId", 0xffffffffu, true, vendor_id, error) ||
+            !childNumber(*info, "ProductCode", 0xffffffffu, true, product_code, error) ||
+            !childNumber(*info, "Alias", 0xffff, false, alias, error) ||
+            !childNumber(*info, "Position", 0xffff, false, position, error)) {
+            return false;
+        }
+        const XmlElement* name = info->child("Name");
+        bool optional = false;
+        const std::string* optional_attr = node.attribute("Optional");
+        if (optional_attr && !parseBool(*optional_attr, optional)) {
+            error = at(node) + "属性 Optional 应为 true 或 false";
+            return false;
+        }
+        addSlave(name ? trim(name->text) : "#" + std::to_string(position),
+                          static_cast<uint16_t>(alias), static_cast<uint16_t>(position),
+                          vendor_id, product_code, optional);
+        order++;
+
+        const XmlElement* process_data = node.child("ProcessData");
+        if (!process_data) continue;
+
+        // 按同步管理器号汇总显式声明和 PDO 所属的同步管理器
+        struct SmDraft {
+            ec_direction_t dir;
+            ec_watchdog_mode_t watchdog;
+            std::vector<const XmlElement*> pdos;
+        };
+        std::map<uint32_t, SmDraft> sms;
+        for (const auto& item : process_data->children) {
+            if (item.name == "Sm") {
+                uint32_t index = 0;
+                if (!attributeNumber(item, "Index", 0xfe, true, index, error)) return false;
+                const std::string* dir = item.attribute("Dir");
+                if (!dir || (*dir != "Input" && *dir != "Output")) {
+                    error = at(item) + "属性 Dir 应为 Input 或 Output";
+                    return false;
+                }
+                ec_direction_t sm_dir = *dir == "Input" ? EC_DIR_INPUT : EC_DIR_OUTPUT;
+                ec_watchdog_mode_t watchdog = EC_WD_DEFAULT;
+                const std::string* wd = item.attribute("Watchdog");
+                if (wd) {
+                    bool enabled = false;
+                    if (!parseBool(*wd, enabled)) {
+                        error = at(item) + "属性 Watchdog 应为 true 或 false";
+                        return false;
+                    }
+                    watchdog = enabled ? EC_WD_ENABLE : EC_WD_DISABLE;
+                }
+                auto it = sms.find(index);
+                if (it != sms.end() && it->second.dir != sm_dir) {
+                    error = at(item) + "同步管理器 " + std::to_string(index) + " 方向冲突";
+                    return false;
+                }
+                SmDraft& sm = sms[index];
+                sm.dir = sm_dir;
+                sm.watchdog = watchdog;
+            } else if (item.name == "TxPdo" || item.name == "RxPdo") {
+                uint32_t sm_index = 0;
+                if (!attributeNumber(item, "Sm", 0xfe, true, sm_index, error)) return false;
+                ec_direction_t pdo_dir = item.name == "TxPdo" ? EC_DIR_INPUT : EC_DIR_OUTPUT;
+                auto it = sms.find(sm_index);
+                if (it == sms.end()) {
+                    SmDraft sm;
+                    sm.dir = pdo_dir;
+                    sm.watchdog = EC_WD_DEFAULT;
+                    it = sms.emplace(sm_index, sm).first;
+                } else if (it->second.dir != pdo_dir) {
+                    error = at(item) + "PDO 方向与同步管理器 " + std::to_string(sm_index) + " 不一致";
+                    return false;
+                }
+                it->second.pdos.push_back(&item);
+            }
+        }
+
+        for (const auto& sm : sms) {
+            addSync(static_cast<uint8_t>(sm.first), sm.second.dir, sm.second.watchdog);
+            for (const XmlElement* pdo : sm.second.pdos) {
+                uint32_t pdo_index = 0;
+                if (!childNumber(*pdo, "Index", 0xffff, true, pdo_index, error)) return false;
+                addPdo(static_cast<uint16_t>(pdo_index));
+                for (const auto& entry : pdo->children) {
+                    if (entry.name != "Entry") continue;
+                    uint32_t index = 0;
+                    uint32_t subindex = 0;
+                    uint32_t bit_length = 0;
+                    if (!childNumber(entry, "Index", 0xffff, true, index, error) ||
+                        !childNumber(entry, "SubIndex", 0xff, false, subindex, error) ||
+                        !childNumber(entry, "BitLen", 0xff, true, bit_length, error)) {
+                        return false;
+                    }
+                    if (bit_length == 0) {
+                        error = at(entry) + "BitLen 不能为 0";
+                        return false;
+                    }
+                    addEntry(static_cast<uint16_t>(index), static_cast<uint8_t>(subindex),
+                                      static_cast<uint8_t>(bit_length));
+                }
+            }
+        }
+    }
+
+    const XmlElement* image = config->child("ProcessImage");
+    if (image) {
+        for (const auto& var : image->children) {
+            if (var.name != "Variable") continue;
+            const std::string* domain_name = var.attribute("Domain");
+            size_t domain = TOPOLOGY_DOMAIN_COUNT;
+            for (size_t i = 0; domain_name && i < TOPOLOGY_DOMAIN_COUNT; i++) {
+                if (*domain_name == TOPOLOGY_DOMAIN_NAMES[i]) domain = i;
+            }
+            if (domain == TOPOLOGY_DOMAIN_COUNT) {
+                error = at(var) + "属性 Domain 应为 analog_in、digital_in 或 relay_out";
+                return false;
+            }
+            uint32_t channel = 0;
+            uint32_t alias = 0;
+            uint32_t position = 0;
+            uint32_t index = 0;
+            uint32_t subindex = 0;
+            if (!attributeNumber(var, "Channel", 0xff, true, channel, error) ||
+                !attributeNumber(var, "Alias", 0xffff, false, alias, error) ||
+                !attributeNumber(var, "Position", 0xffff, true, position, error) ||
+                !attributeNumber(var, "Index", 0xffff, true, index, error) ||
+                !attributeNumber(var, "SubIndex", 0xff, false, subindex, error)) {
+                return false;
+            }
+            const TopologySlave* slave = findSlave(static_cast<uint16_t>(alias), static_cast<uint16_t>(position));
+            if (!slave) {
+                error = at(var) + "位置 " + std::to_string(alias) + ":" + std::to_string(position) + " 没有从站";
+                return false;
+            }
+            addBinding(static_cast<uint8_t>(domain), static_cast<uint8_t>(channel),
+                                static_cast<uint32_t>(slave - slaves.data()),
+                                static_cast<uint16_t>(index), static_cast<uint8_t>(subindex));
+        }
+    }
+
+    return true;
+}
+
+// ==================== 二进制缓存 ====================
+bool SlaveTopology::load(const std::string& xml_path, const std::string& cache_path, std::string& error) {
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+    if (!statFile(xml_path, size, mtime_ns)) {
+        error = "拓扑文件不存在: " + xml_path;
+        return false;
+    }
+    if (!cache_path.empty() && loadCache(cache_path, size, mtime_ns)) {
+        source = xml_path;
+        return true;
+    }
+    if (!loadXml(xml_path, error)) {
+        return false;
+    }
+    if (!cache_path.empty()) {
+        std::string cache_error;
+        if (!saveCache(cache_path, cache_error)) {
+            std::cerr << "警告: " << cache_error << std::endl;
+        }
+    }
+    return true;
+}
+
+bool SlaveTopology::saveCache(const std::string& cache_path, std::string& error) const {
+    std::string strings;
+    std::vector<uint8_t> out;
+    out.reserve(CACHE_HEADER_SIZE + slaves.size() * CACHE_SLAVE_SIZE + sync_records.size() * CACHE_SYNC_SIZE +
+                pdo_records.size() * CACHE_PDO_SIZE + entries.size() * CACHE_ENTRY_SIZE +
+                bindings.size() * CACHE_BINDING_SIZE);
+
+    out.insert(out.end(), SLAVE_TOPOLOGY_CACHE_MAGIC, SLAVE_TOPOLOGY_CACHE_MAGIC + sizeof(SLAVE_TOPOLOGY_CACHE_MAGIC));
+    putU16(out, SLAVE_TOPOLOGY_CACHE_VERSION);
+    putU16(out, 0);
+    putU64(out, source_size);
+    putU64(out, static_cast<uint64_t>(source_mtime_ns));
+    size_t string_bytes = 0;
+    for (const auto& slave : slaves) {
+        string_bytes += std::min<size_t>(slave.name.size(), 0xffff);
+    }
+    putU32(out, static_cast<uint32_t>(slaves.size()));
+    putU32(out, static_cast<uint32_t>(sync_records.size()));
+    putU32(out, static_cast<uint32_t>(pdo_records.size()));
+    putU32(out, static_cast<uint32_t>(entries.size()));
+    putU32(out, static_cast<uint32_t>(bindings.size()));
+    putU32(out, static_cast<uint32_t>(string_bytes));
+
+    for (const auto& slave : slaves) {
+        size_t length = std::min<size_t>(slave.name.size(), 0xffff);
+        putU16(out, slave.alias);
+        putU16(out, slave.position);
+        putU32(out, slave.vendor_id);
+        putU32(out, slave.product_code);
+        putU8(out, slave.optional ? 1 : 0);
+        putU32(out, slave.first_sync);
+        putU32(out, slave.sync_count);
+        putU32(out, static_cast<uint32_t>(strings.size()));
+        putU16(out, static_cast<uint16_t>(length));
+        strings.append(slave.name, 0, length);
+    }
+    for (const auto& sync : sync_records) {
+        putU8(out, sync.index);
+        putU8(out, sync.dir);
+        putU8(out, sync.watchdog);
+        putU32(out, sync.first_pdo);
+        putU32(out, sync.pdo_count);
+    }
+    for (const auto& pdo : pdo_records) {
+        putU16(out, pdo.index);
+        putU32(out, pdo.first_entry);
+        putU32(out, pdo.entry_count);
+    }
+    for (const auto& entry : entries) {
+        putU16(out, entry.index);
+        putU8(out, entry.subindex);
+        putU8(out, entry.bit_length);
+    }
+    for (const auto& b : bindings) {
+        putU8(out, b.domain);
+        putU8(out, b.channel);
+        putU32(out, b.slave);
+        putU16(out, b.index);
+        putU8(out, b.subindex);
+    }
+    out.insert(out.end(), strings.begin(), strings.end());
+
+    // 先写临时文件再改名，避免并发启动读到写了一半的缓存
+    std::string tmp_path = cache_path + ".tmp";
+    FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        error = "无法写入拓扑缓存 " + tmp_path + ": " + std::strerror(errno);
+        return false;
+    }
+    bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    written = (std::fclose(file) == 0) && written;
+    if (!written || std::rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+        error = "无法写入拓扑缓存 " + cache_path + ": " + std::strerror(errno);
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 缓存缺失、损坏或与源文件不一致时返回 false，由调用方重新解析 XML
+bool SlaveTopology::loadCache(const std::string& cache_path, uint64_t expected_size, int64_t expected_mtime_ns) {
+    std::string content;
+    if (!readFile(cache_path, content) || content.size() < CACHE_HEADER_SIZE) {
+        return false;
+    }
+    CacheReader in = {reinterpret_cast<const uint8_t*>(content.data()), content.size(), true};
+    if (std::memcmp(in.p, SLAVE_TOPOLOGY_CACHE_MAGIC, sizeof(SLAVE_TOPOLOGY_CACHE_MAGIC)) != 0) {
+        return false;
+    }
+    in.p += 4;
+    in.left -= 4;
+    if (in.u16() != SLAVE_TOPOLOGY_CACHE_VERSION) {
+        return false;
+    }
+    in.u16();
+
+    SlaveTopology topology;
+    topology.source_size = in.u64();
+    topology.source_mtime_ns = static_cast<int64_t>(in.u64());
+    if (topology.source_size != expected_size || topology.source_mtime_ns != expected_mtime_ns) {
+        return false;
+    }
+    uint32_t slave_count = in.u32();
+    uint32_t sync_count = in.u32();
+    uint32_t pdo_count = in.u32();
+    uint32_t entry_count = in.u32();
+    uint32_t binding_count = in.u32();
+    uint32_t string_bytes = in.u32();
+    uint64_t body = static_cast<uint64_t>(slave_count) * CACHE_SLAVE_SIZE +
+                    static_cast<uint64_t>(sync_count) * CACHE_SYNC_SIZE +
+                    static_cast<uint64_t>(pdo_count) * CACHE_PDO_SIZE +
+                    static_cast<uint64_t>(entry_count) * CACHE_ENTRY_SIZE +
+                    static_cast<uint64_t>(binding_count) * CACHE_BINDING_SIZE + string_bytes;
+    if (!in.ok || body != in.left) {
+        return false;
+    }
+    const char* strings = reinterpret_cast<const char*>(in.p) + (in.left - string_bytes);
+
+    topology.slaves.resize(slave_count);
+    for (auto& slave : topology.slaves) {
+        slave.alias = in.u16();
+        slave.position = in.u16();
+        slave.vendor_id = in.u32();
+        slave.product_code = in.u32();
+        slave.optional = in.u8() != 0;
+        slave.first_sync = in.u32();
+        slave.sync_count = in.u32();
+        uint32_t name_offset = in.u32();
+        uint16_t name_length = in.u16();
+        if (static_cast<uint64_t>(name_offset) + name_length > string_bytes) {
+            return false;
+        }
+        slave.name.assign(strings + name_offset, name_length);
+    }
+    topology.sync_records.resize(sync_count);
+    for (auto& sync : topology.sync_records) {
+        sync.index = in.u8();
+        sync.dir = in.u8();
+        sync.watchdog = in.u8();
+        sync.first_pdo = in.u32();
+        sync.pdo_count = in.u32();
+    }
+    topology.pdo_records.resize(pdo_count);
+    for (auto& pdo : topology.pdo_records) {
+        pdo.index = in.u16();
+        pdo.first_entry = in.u32();
+        pdo.entry_count = in.u32();
+    }
+    topology.entries.resize(entry_count);
+    for (auto& entry : topology.entries) {
+        entry.index = in.u16();
+        entry.subindex = in.u8();
+        entry.bit_length = in.u8();
+    }
+    topology.bindings.resize(binding_count);
+    for (auto& b : topology.bindings) {
+        b.domain = in.u8();
+        b.channel = in.u8();
+        b.slave = in.u32();
+        b.index = in.u16();
+        b.subindex = in.u8();
+    }
+
+    std::string error;
+    if (!in.ok || !topology.validate(error)) {
+        return false;
+    }
+    topology.link();
+    topology.from_cache = true;
+    *this = std::move(topology);
+    return true;
+}
@@ -8,8 +8,12 @@
 #include <QScrollBar>
 #include <QCoreApplication>
 #include <QDebug>
+#include <QTableWidgetItem>
+#include <QHeaderView>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -17,16 +21,19 @@ MainWindow::MainWindow(QWidget *parent)
     , updateTimer(new QTimer(this))
     , reliabilityTestTimer(new QTimer(this))
 {
+    startupElapsed.start();
     ui->setupUi(this);
     
+    setupCycleTimingPanel();
+    
     // 设置信号槽连接
     setupConnections();
     
     // 确保窗口显示
     show();
     
-    // 延迟初始化，让窗口先完全显示（500ms）
-    QTimer::singleShot(500, this, &MainWindow::initializeSystem);
+    // 事件循环开始后立即初始化，主站在启动线程中初始化和启动，界面保持响应
+    QTimer::singleShot(0, this, &MainWindow::initializeSystem);
 }
 
 MainWindow::~MainWindow()
@@ -38,7 +45,11 @@ MainWindow::~MainWindow()
         reliabilityTestTimer->stop();
     }
     
-    if (master && masterRunning) {
+    // 启动尚未完成时等待启动线程返回（start() 最长阻塞到进入 OP 超时）
+    if (startupThread.joinable()) {
+        startupThread.join();
+    }
+    if (master) {
         master->stop();
     }
     
@@ -56,6 +67,68 @@ void MainWindow::initializeSystem()
     
     master = std::make_unique<EtherCATMaster>();
     
+    // ETHERCAT_BACKEND=raw 时使用原始套接字后端，网卡由 ETHERCAT_INTERFACE 指定
+    // ETHERCAT_BACKEND=replay 时回放 ETHERCAT_REPLAY_FILE；ETHERCAT_RECORD 指定记录文件
+    const char* backend_env = std::getenv("ETHERCAT_BACKEND");
+    if (backend_env && std::string(backend_env) == "raw") {
+        const char* interface_env = std::getenv("ETHERCAT_INTERFACE");
+        master->setFieldbusBackend(FieldbusBackendType::BACKEND_RAW_SOCKET, interface_env ? interface_env : "eth0");
+    } else if (backend_env && std::string(backend_env) == "replay") {
+        const char* replay_env = std::getenv("ETHERCAT_REPLAY_FILE");
+        master->setFieldbusBackend(FieldbusBackendType::BACKEND_REPLAY, replay_env ? replay_env : "");
+    }
+    const char* record_env = std::getenv("ETHERCAT_RECORD");
+    if (record_env && *record_env) {
+        master->enableProcessImageRecording(record_env);
+    }
+#if !(defined(__linux__) && WITH_IGH_ETHERCAT)
+    // 模拟总线上接入液压对象模型，使支撑/收回测试有压力响应；ETHERCAT_PLANT=off 关闭
+    const char* plant_env = std::getenv("ETHERCAT_PLANT");
+    if (master->getFieldbusBackendType() == FieldbusBackendType::BACKEND_IGH &&
+        !(plant_env && std::string(plant_env) == "off")) {
+        HydraulicPlantConfig plant_config;
+        plant_config.step_ns = RealtimeOptions().cycle_period_ns;
+        plant_config.spread = 0.1f;
+        plant = std::make_unique<HydraulicPlant>(plant_config);
+        plant->attach(SimulatedBus::instance());
+        appendLog("模拟总线已接入液压对象模型", "INFO");
+    }
+#endif
+    // ETHERCAT_CLOCK=virtual 时使用虚拟时钟，可靠性测试快于实时运行（仅模拟总线和回放）
+    const char* clock_env = std::getenv("ETHERCAT_CLOCK");
+    if (clock_env && std::string(clock_env) == "virtual") {
+        bool simulated_bus = master->getFieldbusBackendType() == FieldbusBackendType::BACKEND_REPLAY;
+#if !(defined(__linux__) && WITH_IGH_ETHERCAT)
+        simulated_bus = simulated_bus || master->getFieldbusBackendType() == FieldbusBackendType::BACKEND_IGH;
+#endif
+        if (simulated_bus) {
+            master->setClock(std::make_shared<VirtualClock>());
+            appendLog("使用虚拟时钟", "INFO");
+        } else {
+            appendLog("真实总线不支持虚拟时钟，使用系统时钟", "WARNING");
+        }
+    }
+    appendLog(QString("现场总线后端: %1").arg(QString::fromStdString(master->getFieldbusBackendName())), "INFO");
+
+    // ETHERCAT_TOPOLOGY 指定从站拓扑文件，未设置时使用内置的试验台拓扑
+    const char* topology_env = std::getenv("ETHERCAT_TOPOLOGY");
+    if (topology_env && *topology_env && !master->loadTopology(topology_env)) {
+        appendLog(QString("无法加载从站拓扑 %1，使用内置拓扑").arg(topology_env), "WARNING");
+    }
+    
+    // ETHERCAT_WARM_CACHE 指定热启动缓存文件，配置未变时跳过重复的从站配置；未设置时不使用缓存
+    const char* warm_env = std::getenv("ETHERCAT_WARM_CACHE");
+    if (warm_env && *warm_env) {
+        master->setWarmStartCache(warm_env);
+        appendLog(QString("热启动缓存: %1").arg(warm_env), "INFO");
+    }
+    
+    // ETHERCAT_CALIBRATION 指定压力通道标定文件，未设置时全部通道按量程线性换算
+    const char* calibration_env = std::getenv("ETHERCAT_CALIBRATION");
+    if (calibration_env && *calibration_env && !master->loadPressureCalibration(calibration_env)) {
+        appendLog(QString("无法加载压力标定 %1，按量程线性换算").arg(calibration_env), "WARNING");
+    }
+    
     // 设置日志回调
     master->setLogCallback([this](const LogEntry& log) {
         QMetaObject::invokeMethod(this, [this, log]() {
@@ -63,22 +136,49 @@ void MainWindow::initializeSystem()
         }, Qt::QueuedConnection);
     });
     
+    ui->lblSystemStatus->setText("● 启动中");
+    ui->lblSystemStatus->setStyleSheet("color: #333333; font-weight: bold; font-size: 16px;");
+    
+    // 初始化和启动在启动线程中执行，结果经排队连接回到界面线程
     std::cout << "[UI] 开始初始化主站..." << std::endl;
+    startupThread = std::thread([this]() {
+        bool initialized = master->initialize();
+        bool started = initialized && master->start();
+        emit startupFinished(initialized, started);
+    });
+}
+
+void MainWindow::onStartupFinished(bool initialized, bool started)
+{
+    if (startupThread.joinable()) {
+        startupThread.join();
+    }
     
-    // 初始化主站
-    if (master->initialize()) {
+    if (initialized) {
         masterInitialized = true;
         std::cout << "[UI] 主站初始化成功" << std::endl;
         appendLog("EtherCAT 主站初始化成功", "INFO");
+        setupChannelDisplays();
         
-        std::cout << "[UI] 开始启动主站..." << std::endl;
-        // 启动主站
-        if (master->start()) {
+        if (started) {
             masterRunning = true;
             std::cout << "[UI] 主站启动成功, masterRunning=" << masterRunning << std::endl;
             ui->lblSystemStatus->setText("● 运行中");
             ui->lblSystemStatus->setStyleSheet("color: #2563eb; font-weight: bold; font-size: 16px;");
             appendLog("EtherCAT 主站已启动", "INFO");
+            
+            // 启动耗时：从窗口构造到进入 OP，以及主站各阶段
+            StartupTiming timing = master->getStartupTiming();
+            appendLog(QString("启动耗时 %1ms（%2）：请求主站 %3ms，扫描 %4ms，配置 %5ms，激活 %6ms，进入 OP %7")
+                      .arg(startupElapsed.elapsed())
+                      .arg(timing.warm_start ? "热启动" : "冷启动")
+                      .arg(timing.request_master_us / 1000.0, 0, 'f', 1)
+                      .arg(timing.scan_us / 1000.0, 0, 'f', 1)
+                      .arg(timing.configure_us / 1000.0, 0, 'f', 1)
+                      .arg(timing.activate_us / 1000.0, 0, 'f', 1)
+                      .arg(timing.time_to_op_us < 0 ? QString("未完成")
+                                                    : QString("%1ms").arg(timing.time_to_op_us / 1000.0, 0, 'f', 1)),
+                      timing.time_to_op_us < 0 ? "WARNING" : "INFO");
             setControlsEnabled(true);
         } else {
             std::cout << "[UI] 主站启动失败" << std::endl;
@@ -110,6 +210,9 @@ void MainWindow::initializeSystem()
 
 void MainWindow::setupConnections()
 {
+    // 主站启动完成：启动线程发出，排队到界面线程处理
+    connect(this, &MainWindow::startupFinished, this, &MainWindow::onStartupFinished, Qt::QueuedConnection);
+    
     // 继电器控制按钮
     connect(ui->btnRelay1, &QPushButton::toggled, this, &MainWindow::onRelay1Toggled);
     connect(ui->btnRelay2, &QPushButton::toggled, this, &MainWindow::onRelay2Toggled);
@@ -128,6 +231,9 @@ void MainWindow::setupConnections()
     connect(ui->btnExportLog, &QPushButton::clicked, this, &MainWindow::onExportLog);
     connect(ui->btnExportReport, &QPushButton::clicked, this, &MainWindow::onExportReport);
     
+    // 周期计时
+    connect(ui->btnResetCycleTiming, &QPushButton::clicked, this, &MainWindow::onResetCycleTiming);
+    
     // 菜单动作
     connect(ui->actionSupportTest, &QAction::triggered, this, &MainWindow::onSupportTest);
     connect(ui->actionRetractTest, &QAction::triggered, this, &MainWindow::onRetractTest);
@@ -425,39 +531,43 @@ void MainWindow::onUpdateTimer()
                   << " masterRunning=" << masterRunning << std::endl;
     }
     
-    // 从真实硬件读取压力
+    // 从真实硬件读取压力（所有通道取自同一周期的快照）
     if (master && masterRunning) {
+        ProcessImageSnapshot snapshot = master->getProcessImageSnapshot();
+        
         // 每5秒打印一次详细调试信息
         static int debugCounter = 0;
         debugCounter++;
+        const size_t analogCount = std::min<size_t>(snapshot.analog_count, pressureRows.size());
+        const size_t digitalCount = std::min<size_t>(snapshot.digital_count, digitalInputLabels.size());
+        
+        // 全部通道一次换算出电流、压力和状态
+        master->convertAnalogBlock(snapshot, analogBlock);
         if (debugCounter % 50 == 0) {
-            std::cout << "===== [UI] 读取传感器数据 =====" << std::endl;
-            auto currents = master->readAllAnalogInputsAsCurrent();
-            for (size_t i = 0; i < currents.size(); i++) {
-                std::cout << "  通道 " << (i+1) << " 电流: " << currents[i] << " mA" << std::endl;
+            std::cout << "===== [UI] 读取传感器数据 (周期 " << snapshot.cycle << ") =====" << std::endl;
+            for (size_t i = 0; i < analogCount; i++) {
+                std::cout << "  通道 " << (i+1) << " 电流: " << analogBlock.currents[i] << " mA" << std::endl;
             }
         }
-        
-        auto pressures = master->readAllAnalogInputsAsPressure();
+        std::copy(analogBlock.pressures, analogBlock.pressures + analogCount, pressureValues.begin());
         
         // 每秒打印一次压力值
         if (timerCounter % 10 == 0) {
             std::cout << "[UI] 压力值: ";
-            for (size_t i = 0; i < pressures.size(); i++) {
-                std::cout << "P" << (i+1) << "=" << pressures[i] << "bar ";
+            for (size_t i = 0; i < analogCount; i++) {
+                std::cout << "P" << (i+1) << "=" << pressureValues[i] << "bar ";
             }
             std::cout << std::endl;
         }
         
-        for (size_t i = 0; i < pressures.size() && i < 4; i++) {
-            auto status = master->checkPressureStatus(i + 1);
+        for (size_t i = 0; i < analogCount; i++) {
+            auto status = analogBlock.status(i);
             QString statusStr = QString::fromStdString(master->getPressureStatusString(status));
-            updatePressureDisplay(i + 1, pressures[i], statusStr);
+            updatePressureDisplay(static_cast<int>(i) + 1, pressureValues[i], statusStr);
         }
         
-        auto digitalInputs = master->readAllDigitalInputs();
-        for (size_t i = 0; i < digitalInputs.size() && i < 8; i++) {
-            updateDigitalInputDisplay(i + 1, digitalInputs[i]);
+        for (size_t i = 0; i < digitalCount; i++) {
+            updateDigitalInputDisplay(static_cast<int>(i) + 1, snapshot.digitalInput(i));
         }
     } else {
         if (timerCounter % 10 == 0) {
@@ -468,25 +578,129 @@ void MainWindow::onUpdateTimer()
     
     updateSystemUptime();
     
+    // 周期计时面板每秒刷新一次
+    if (timerCounter % 10 == 0) {
+        updateCycleTimingPanel();
+    }
+    
     if (master && master->isReliabilityTestRunning()) {
         updateTestStats();
     }
 }
 
+// ==================== 周期计时 ====================
+void MainWindow::setupCycleTimingPanel()
+{
+    const QStringList headers = {"样本数", "P50", "P99", "P99.9", "最大"};
+    ui->tblCycleTiming->setColumnCount(headers.size());
+    ui->tblCycleTiming->setHorizontalHeaderLabels(headers);
+    ui->tblCycleTiming->setRowCount(static_cast<int>(CYCLE_METRIC_COUNT));
+    
+    QStringList rowNames;
+    for (size_t i = 0; i < CYCLE_METRIC_COUNT; i++) {
+        rowNames << QString::fromStdString(
+            EtherCATMaster::getCycleMetricName(static_cast<CycleMetric>(i)));
+        for (int col = 0; col < headers.size(); col++) {
+            auto *item = new QTableWidgetItem("-");
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            ui->tblCycleTiming->setItem(static_cast<int>(i), col, item);
+        }
+    }
+    ui->tblCycleTiming->setVerticalHeaderLabels(rowNames);
+    ui->tblCycleTiming->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+}
+
+void MainWindow::updateCycleTimingPanel()
+{
+    if (!master || !masterRunning) {
+        return;
+    }
+    
+    CycleTimingReport report = master->getCycleTimingReport();
+    auto toUs = [](uint64_t ns) { return QString::number(ns / 1000.0, 'f', 1); };
+    
+    for (size_t i = 0; i < CYCLE_METRIC_COUNT; i++) {
+        const CycleMetricSummary& summary = report.metrics[i];
+        int row = static_cast<int>(i);
+        ui->tblCycleTiming->item(row, 0)->setText(QString::number(summary.count));
+        ui->tblCycleTiming->item(row, 1)->setText(toUs(summary.p50_ns));
+        ui->tblCycleTiming->item(row, 2)->setText(toUs(summary.p99_ns));
+        ui->tblCycleTiming->item(row, 3)->setText(toUs(summary.p999_ns));
+        ui->tblCycleTiming->item(row, 4)->setText(toUs(summary.max_ns));
+    }
+    
+    CycleOverrunStats overruns = master->getCycleOverrunStats();
+    QString info = QString("周期: %1 µs  超时: %2 次 (最长连续 %3)")
+                       .arg(report.cycle_period_ns / 1000)
+                       .arg(overruns.overrun_count)
+                       .arg(overruns.max_consecutive_overruns);
+    if (overruns.safe_outputs_active) {
+        info += "  [安全输出]";
+    }
+    ui->lblCycleTimingInfo->setText(info);
+}
+
+void MainWindow::onResetCycleTiming()
+{
+    if (master) {
+        master->resetCycleTiming();
+        appendLog("周期计时统计已清零", "INFO");
+    }
+}
+
 // ==================== 辅助函数 ====================
-void MainWindow::updatePressureDisplay(int channel, float pressure, const QString& status)
+void MainWindow::setupChannelDisplays()
 {
-    QProgressBar* progress = nullptr;
-    QLabel* valueLabel = nullptr;
-    QLabel* statusLabel = nullptr;
+    // 通道数由从站拓扑决定：每个压力通道一行，数字输入每行 4 个
+    const size_t analogCount = master->getAnalogChannelCount();
+    const size_t digitalCount = master->getDigitalInputCount();
+    
+    pressureRows.clear();
+    for (size_t i = 0; i < analogCount; i++) {
+        int row = static_cast<int>(i);
+        auto *title = new QLabel(QString("通道 %1").arg(i + 1), ui->grpPressure);
+        title->setStyleSheet("color: #333333; font-weight: bold;");
+        
+        PressureRow pressureRow;
+        pressureRow.progress = new QProgressBar(ui->grpPressure);
+        pressureRow.progress->setMaximum(100);
+        pressureRow.progress->setValue(0);
+        pressureRow.progress->setMinimumWidth(150);
+        pressureRow.value = new QLabel("0.00 bar", ui->grpPressure);
+        pressureRow.value->setMinimumWidth(80);
+        pressureRow.value->setStyleSheet("color: #333333; font-size: 16px; font-weight: bold;");
+        pressureRow.status = new QLabel("正常", ui->grpPressure);
+        pressureRow.status->setStyleSheet("color: #333333;");
+        
+        ui->pressureLayout->addWidget(title, row, 0);
+        ui->pressureLayout->addWidget(pressureRow.progress, row, 1);
+        ui->pressureLayout->addWidget(pressureRow.value, row, 2);
+        ui->pressureLayout->addWidget(pressureRow.status, row, 3);
+        pressureRows.push_back(pressureRow);
+    }
+    pressureValues.assign(analogCount, 0.0f);
+    
+    digitalInputLabels.clear();
+    for (size_t i = 0; i < digitalCount; i++) {
+        auto *label = new QLabel(QString("DI%1: OFF").arg(i + 1), ui->grpDigitalInput);
+        label->setAlignment(Qt::AlignCenter);
+        label->setStyleSheet("background-color: #f3f4f6; padding: 8px; border-radius: 4px; color: #666666;");
+        ui->diLayout->addWidget(label, static_cast<int>(i / 4), static_cast<int>(i % 4));
+        digitalInputLabels.push_back(label);
+    }
     
-    switch (channel) {
-        case 1: progress = ui->progressP1; valueLabel = ui->lblP1Value; statusLabel = ui->lblP1Status; break;
-        case 2: progress = ui->progressP2; valueLabel = ui->lblP2Value; statusLabel = ui->lblP2Status; break;
-        case 3: progress = ui->progressP3; valueLabel = ui->lblP3Value; statusLabel = ui->lblP3Status; break;
-        case 4: progress = ui->progressP4; valueLabel = ui->lblP4Value; statusLabel = ui->lblP4Status; break;
-        default: return;
+    ui->grpPressure->setTitle(QString("压力传感器监控 (EL3074 × %1)").arg(analogCount / El3074::channel_count));
+    ui->grpDigitalInput->setTitle(QString("数字输入状态 (EL1008 × %1)").arg(digitalCount / El1008::channel_count));
+}
+
+void MainWindow::updatePressureDisplay(int channel, float pressure, const QString& status)
+{
+    if (channel < 1 || channel > static_cast<int>(pressureRows.size())) {
+        return;
     }
+    QProgressBar* progress = pressureRows[channel - 1].progress;
+    QLabel* valueLabel = pressureRows[channel - 1].value;
+    QLabel* statusLabel = pressureRows[channel - 1].status;
     
     if (progress && valueLabel && statusLabel) {
         progress->setValue(static_cast<int>(pressure));
@@ -499,18 +713,10 @@ void MainWindow::updatePressureDisplay(int channel, float pressure, const QStrin
 
 void MainWindow::updateDigitalInputDisplay(int channel, bool state)
 {
-    QLabel* label = nullptr;
-    switch (channel) {
-        case 1: label = ui->lblDI1; break;
-        case 2: label = ui->lblDI2; break;
-        case 3: label = ui->lblDI3; break;
-        case 4: label = ui->lblDI4; break;
-        case 5: label = ui->lblDI5; break;
-        case 6: label = ui->lblDI6; break;
-        case 7: label = ui->lblDI7; break;
-        case 8: label = ui->lblDI8; break;
-        default: return;
+    if (channel < 1 || channel > static_cast<int>(digitalInputLabels.size())) {
+        return;
     }
+    QLabel* label = digitalInputLabels[channel - 1];
     
     if (label) {
         label->setText(QString("DI%1: %2").arg(channel).arg(state ? "ON" : "OFF"));
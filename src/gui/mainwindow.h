@@ -4,8 +4,15 @@
 #include <QMainWindow>
 #include <QTimer>
 #include <QElapsedTimer>
+#include <QLabel>
+#include <QProgressBar>
 #include <memory>
+#include <thread>
+#include <vector>
 #include "ethercat/EtherCATMaster.h"
+#if !(defined(__linux__) && WITH_IGH_ETHERCAT)
+#include "ethercat/HydraulicPlant.h"
+#endif
 
 // 前向声明 UI 命名空间
 QT_BEGIN_NAMESPACE
@@ -23,6 +30,10 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override;
 
+signals:
+    // 启动线程完成主站初始化和启动（跨线程，排队投递到界面线程）
+    void startupFinished(bool initialized, bool started);
+
 private slots:
     // 继电器控制
     void onRelay1Toggled(bool checked);
@@ -42,6 +53,12 @@ private slots:
     void onExportLog();
     void onExportReport();
     
+    // 周期计时
+    void onResetCycleTiming();
+    
+    // 主站启动完成
+    void onStartupFinished(bool initialized, bool started);
+    
     // 定时器
     void onUpdateTimer();
     void onReliabilityTestTimer();
@@ -55,12 +72,19 @@ private:
     // 定时器
     QTimer *updateTimer;           // 界面更新定时器
     QTimer *reliabilityTestTimer;  // 可靠性测试定时器
+    QElapsedTimer startupElapsed;  // 窗口构造到主站进入运行的耗时
     QElapsedTimer systemUptime;    // 系统运行时间
     QElapsedTimer testUptime;      // 测试运行时间
     QElapsedTimer phaseTimer;      // 当前阶段计时
 
+#if !(defined(__linux__) && WITH_IGH_ETHERCAT)
+    // 模拟模式的液压对象模型（声明在主站之前，主站停止后才移除总线回调）
+    std::unique_ptr<HydraulicPlant> plant;
+#endif
+
     // EtherCAT 主站
     std::unique_ptr<EtherCATMaster> master;
+    std::thread startupThread;     // initialize()/start()：start() 最长阻塞到必需从站进入 OP，不占用界面线程
     bool masterInitialized = false;
     bool masterRunning = false;
     
@@ -70,15 +94,29 @@ private:
     int supportTimeoutMs = 15000;
     int retractTimeoutMs = 15000;
     
+    // 通道显示控件，按主站初始化后的通道数生成
+    struct PressureRow {
+        QProgressBar* progress;
+        QLabel* value;
+        QLabel* status;
+    };
+    std::vector<PressureRow> pressureRows;
+    std::vector<QLabel*> digitalInputLabels;
+    std::vector<float> pressureValues;             // 批量换算的压力值，与 pressureRows 对应
+    EtherCATMaster::AnalogBlock analogBlock;       // 每次刷新整块换算的电流、压力和状态
+    
     // 辅助函数
     void setupConnections();
     void initializeSystem();
+    void setupChannelDisplays();
     void updatePressureDisplay(int channel, float pressure, const QString& status);
     void updateDigitalInputDisplay(int channel, bool state);
     void updateTestStats();
     void updateSystemUptime();
     void appendLog(const QString& message, const QString& level = "INFO");
     void setControlsEnabled(bool enabled);
+    void setupCycleTimingPanel();
+    void updateCycleTimingPanel();
     
     // EtherCAT 回调处理
     void onReliabilityProgress(const ReliabilityTestStats& stats);
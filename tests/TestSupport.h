@@ -0,0 +1,63 @@
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * 单元测试用的最小断言：失败时打印位置并计数，不中断后续检查。
+ * 每个测试程序在 main() 中依次调用各测试函数，最后返回 testResult()，由 ctest 判断成败。
+ */
+inline int& testFailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void testFail(const char* file, int line, const std::string& message) {
+    std::fprintf(stderr, "%s:%d: 失败: %s\n", file, line, message.c_str());
+    testFailureCount()++;
+}
+
+inline int testResult() {
+    if (testFailureCount() > 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", testFailureCount());
+        return 1;
+    }
+    std::printf("全部通过\n");
+    return 0;
+}
+
+// 轮询等待条件成立（墙钟），超时返回 false
+inline bool waitFor(const std::function<bool()>& condition, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+#define CHECK(condition)                                                   \
+    do {                                                                   \
+        if (!(condition)) {                                                \
+            testFail(__FILE__, __LINE__, #condition);                      \
+        }                                                                  \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                         \
+    do {                                                                   \
+        auto actual_value_ = (actual);                                     \
+        auto expected_value_ = (expected);                                 \
+        if (!(actual_value_ == expected_value_)) {                         \
+            testFail(__FILE__, __LINE__, #actual " == " #expected " (实际 " + \
+                     std::to_string(actual_value_) + "，期望 " +            \
+                     std::to_string(expected_value_) + ")");                \
+        }                                                                  \
+    } while (0)
+
+#endif // TESTSUPPORT_H
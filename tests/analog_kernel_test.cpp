@@ -0,0 +1,174 @@
+/**
+ * 模拟输入换算内核：当前 CPU 上每个实现（AVX2/SSE2/标量）与逐通道路径按位一致
+ *
+ * 逐通道路径为 convertAnalogToCurrent → convertCurrentToPressure → evaluatePressureStatus。
+ * 覆盖 0-64 的每个通道数（向量主体加各种尾部）、全部 int16 原始值、全部状态字和不对齐的输入输出。
+ */
+#include "TestSupport.h"
+#include "ethercat/AnalogKernel.h"
+#include "ethercat/EtherCATMaster.h"
+
+#include <cstring>
+#include <random>
+#include <set>
+
+namespace {
+
+constexpr size_t SNAPSHOTS_PER_COUNT = 64;
+constexpr uint8_t SENTINEL = 0xA5;          // 输出缓冲的填充字节，检查 count 之后没有被写
+
+// 比 MAX_ANALOG_CHANNELS 多一项，输出从第 offset 项开始时仍能放下 64 个通道
+struct Result {
+    float currents[MAX_ANALOG_CHANNELS + 1];
+    float pressures[MAX_ANALOG_CHANNELS + 1];
+    uint8_t statuses[MAX_ANALOG_CHANNELS + 1];
+};
+
+void convertPerChannel(EtherCATMaster& master, const ProcessImageSnapshot& snapshot, Result& out) {
+    for (size_t i = 0; i < snapshot.analog_count; i++) {
+        float current = master.convertAnalogToCurrent(snapshot.analog_raw[i]);
+        out.currents[i] = current;
+        out.pressures[i] = master.convertCurrentToPressure(current);
+        out.statuses[i] = static_cast<uint8_t>(EtherCATMaster::evaluatePressureStatus(snapshot, i));
+    }
+}
+
+// offset 为 1 时输入和输出都从不对齐的地址开始
+bool kernelMatches(const AnalogKernel& kernel, EtherCATMaster& master, const ProcessImageSnapshot& snapshot,
+                   size_t offset) {
+    size_t count = snapshot.analog_count;
+    Result expected;
+    convertPerChannel(master, snapshot, expected);
+
+    int16_t raw[MAX_ANALOG_CHANNELS + 1];
+    uint16_t status_words[MAX_ANALOG_CHANNELS + 1];
+    std::memcpy(raw + offset, snapshot.analog_raw, count * sizeof(int16_t));
+    std::memcpy(status_words + offset, snapshot.analog_status, count * sizeof(uint16_t));
+
+    Result actual;
+    std::memset(&actual, SENTINEL, sizeof(actual));
+    kernel.convert(raw + offset, status_words + offset, snapshot.analog_stale, count,
+                   actual.currents + offset, actual.pressures + offset, actual.statuses + offset);
+
+    if (std::memcmp(expected.currents, actual.currents + offset, count * sizeof(float)) != 0 ||
+        std::memcmp(expected.pressures, actual.pressures + offset, count * sizeof(float)) != 0 ||
+        std::memcmp(expected.statuses, actual.statuses + offset, count) != 0) {
+        return false;
+    }
+    // count 之后的输出保持不变
+    uint32_t untouched;
+    std::memset(&untouched, SENTINEL, sizeof(untouched));
+    for (size_t i = offset + count; i <= MAX_ANALOG_CHANNELS; i++) {
+        if (actual.statuses[i] != SENTINEL || std::memcmp(&actual.currents[i], &untouched, sizeof(float)) != 0 ||
+            std::memcmp(&actual.pressures[i], &untouched, sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void checkAllKernels(EtherCATMaster& master, const ProcessImageSnapshot& snapshot, const char* what) {
+    for (const auto& kernel : availableAnalogKernels()) {
+        for (size_t offset : {0u, 1u}) {
+            if (!kernelMatches(kernel, master, snapshot, offset)) {
+                testFail(__FILE__, __LINE__, std::string(kernel.name) + " 与逐通道结果不一致: " + what +
+                         "，" + std::to_string(snapshot.analog_count) + " 通道，偏移 " + std::to_string(offset));
+                return;
+            }
+        }
+    }
+}
+
+ProcessImageSnapshot emptySnapshot(uint32_t count) {
+    ProcessImageSnapshot snapshot;
+    std::memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.cycle = 1;
+    snapshot.analog_count = count;
+    return snapshot;
+}
+
+void testKernelList() {
+    auto kernels = availableAnalogKernels();
+    CHECK(!kernels.empty());
+    if (kernels.empty()) {
+        return;
+    }
+    CHECK(std::string(kernels[0].name) == "scalar");
+
+    std::set<std::string> names;
+    for (const auto& kernel : kernels) {
+        CHECK(kernel.convert != nullptr);
+        names.insert(kernel.name);
+    }
+    CHECK_EQ(names.size(), kernels.size());
+
+    // 默认内核是可用实现中的一个，且是列表中最后（最快）的一个
+    CHECK(analogKernel().convert == kernels.back().convert);
+    CHECK(std::string(EtherCATMaster::getAnalogKernelName()) == analogKernel().name);
+    std::printf("可用内核:");
+    for (const auto& kernel : kernels) {
+        std::printf(" %s", kernel.name);
+    }
+    std::printf("\n");
+}
+
+// 每个通道数下随机原始值、状态字和停滞位
+void testRandomSnapshots(EtherCATMaster& master) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> any_raw(INT16_MIN, INT16_MAX);
+    std::uniform_int_distribution<int> any_word(0, 0xFFFF);
+    for (uint32_t count = 0; count <= MAX_ANALOG_CHANNELS; count++) {
+        for (size_t n = 0; n < SNAPSHOTS_PER_COUNT; n++) {
+            ProcessImageSnapshot snapshot = emptySnapshot(count);
+            for (uint32_t i = 0; i < count; i++) {
+                snapshot.analog_raw[i] = static_cast<int16_t>(any_raw(rng));
+                // 约一半通道状态字清零，保证正常状态也有足够样本
+                snapshot.analog_status[i] = (rng() & 0x01) ? static_cast<uint16_t>(any_word(rng)) : 0;
+            }
+            uint64_t a = static_cast<uint64_t>(rng()) << 32 | rng();
+            uint64_t b = static_cast<uint64_t>(rng()) << 32 | rng();
+            // 约四分之一通道停滞；count 之后的位也会置位，内核不能受它影响
+            snapshot.analog_stale = a & b;
+            checkAllKernels(master, snapshot, "随机快照");
+        }
+    }
+}
+
+// 全部 65536 个原始值，状态正常
+void testAllRawValues(EtherCATMaster& master) {
+    int32_t raw = INT16_MIN;
+    while (raw <= INT16_MAX) {
+        ProcessImageSnapshot snapshot = emptySnapshot(MAX_ANALOG_CHANNELS);
+        for (size_t i = 0; i < MAX_ANALOG_CHANNELS; i++, raw++) {
+            snapshot.analog_raw[i] = static_cast<int16_t>(raw);
+        }
+        checkAllKernels(master, snapshot, "全部原始值");
+    }
+}
+
+// 全部 65536 个状态字，无停滞和有停滞各一遍
+void testAllStatusWords(EtherCATMaster& master) {
+    for (uint64_t stale : {0ull, 0x5555555555555555ull}) {
+        uint32_t word = 0;
+        while (word <= 0xFFFF) {
+            ProcessImageSnapshot snapshot = emptySnapshot(MAX_ANALOG_CHANNELS);
+            snapshot.analog_stale = stale;
+            for (size_t i = 0; i < MAX_ANALOG_CHANNELS; i++, word++) {
+                snapshot.analog_status[i] = static_cast<uint16_t>(word);
+                snapshot.analog_raw[i] = static_cast<int16_t>(word * 7);
+            }
+            checkAllKernels(master, snapshot, "全部状态字");
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    EtherCATMaster master;
+    testKernelList();
+    testRandomSnapshots(master);
+    testAllRawValues(master);
+    testAllStatusWords(master);
+    return testResult();
+}
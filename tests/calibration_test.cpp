@@ -0,0 +1,244 @@
+/**
+ * 压力标定：标定文件解析、查表编译，以及主站按通道换算和整块换算中的查表覆盖
+ */
+#include "TestSupport.h"
+#include "ethercat/EtherCATMaster.h"
+#include "ethercat/PressureCalibration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace {
+
+const std::string EXAMPLE_CALIBRATION = std::string(TEST_SOURCE_DIR) + "/examples/pressure_calibration.txt";
+
+// 覆盖量程两端、零点附近和中间的原始值
+const int16_t SAMPLE_RAWS[] = {INT16_MIN, -32767, -16384, -1, 0, 1, 2048, 8191, 16384, 24575, 32766, INT16_MAX};
+
+bool near(double actual, double expected) {
+    return std::fabs(actual - expected) < 1e-9;
+}
+
+bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+// 解析应失败，且错误信息包含 expected
+void expectParseError(const std::string& content, const std::string& expected) {
+    PressureCalibration calibration;
+    std::string error;
+    if (calibration.parse(content, error)) {
+        testFail(__FILE__, __LINE__, "应解析失败: " + content);
+        return;
+    }
+    if (!contains(error, expected)) {
+        testFail(__FILE__, __LINE__, "错误信息 \"" + error + "\" 中没有 \"" + expected + "\"");
+    }
+}
+
+// 查表值应等于按 convertAnalogToCurrent 换算电流后求值再限幅
+float expectedTableValue(EtherCATMaster& master, const ChannelCalibration& calibration, int16_t raw) {
+    double pressure = calibration.evaluate(master.convertAnalogToCurrent(raw));
+    return static_cast<float>(std::max(pressure, static_cast<double>(PRESSURE_RANGE_MIN)));
+}
+
+void testExample() {
+    PressureCalibration calibration;
+    std::string error;
+    CHECK(calibration.load(EXAMPLE_CALIBRATION, error));
+    CHECK(calibration.getSource() == EXAMPLE_CALIBRATION);
+
+    const auto& channels = calibration.getChannels();
+    CHECK_EQ(channels.size(), 4u);
+    if (channels.size() != 4) {
+        return;
+    }
+    CHECK_EQ(channels[0].channel, 1);
+    CHECK(channels[0].kind == CalibrationKind::CALIBRATION_LINEAR);
+    CHECK_EQ(channels[0].points.size(), 5u);
+    CHECK_EQ(channels[1].points.size(), 3u);
+    CHECK(channels[2].kind == CalibrationKind::CALIBRATION_POLYNOMIAL);
+    CHECK_EQ(channels[2].coefficients.size(), 3u);
+    CHECK_EQ(channels[3].channel, 4);
+    CHECK_EQ(channels[3].points.size(), 2u);
+
+    // 标定点上取标定值，段内线性插值
+    const ChannelCalibration& leg1 = channels[0];
+    CHECK(near(leg1.evaluate(4.02), 0.0));
+    CHECK(near(leg1.evaluate(12.00), 49.8));
+    CHECK(near(leg1.evaluate(19.97), 100.2));
+    CHECK(near(leg1.evaluate(10.005), (25.1 + 49.8) / 2));
+
+    // 范围之外沿首末两段外推（未限幅）
+    CHECK(near(leg1.evaluate(3.0), (3.0 - 4.02) * 25.1 / (8.01 - 4.02)));
+    CHECK(near(leg1.evaluate(20.5), 75.3 + (20.5 - 16.03) * (100.2 - 75.3) / (19.97 - 16.03)));
+
+    // 多项式低次在前
+    CHECK(near(channels[2].evaluate(12.0), -25.42 + 6.31 * 12.0 - 0.0042 * 144.0));
+}
+
+void testParseErrors() {
+    expectParseError("", "没有通道标定");
+    expectParseError("# 只有注释\n\n", "没有通道标定");
+    expectParseError("channel 0 linear\n", "第 1 行: 应为 \"channel <1-64> linear|poly\"");
+    expectParseError("channel 65 linear\n", "第 1 行: 应为");
+    expectParseError("channel 1.5 linear\n", "第 1 行: 应为");
+    expectParseError("channel 2\n", "第 1 行: 应为");
+    expectParseError("channel 1 linear extra\n", "第 1 行: 标定方式应为");
+    expectParseError("channel 1 poly\n", "第 1 行: 标定方式应为");
+    expectParseError("channel 1 spline\n", "第 1 行: 标定方式应为");
+    expectParseError("channel 1 poly 1 x\n", "第 1 行: 无效的多项式系数 \"x\"");
+    expectParseError("channel 1 poly 1 2 3 4 5 6 7\n", "第 1 行: 通道 1 的多项式超过 6 项");
+    expectParseError("4.0 0.0\n", "第 1 行: 标定点之前应有");
+    expectParseError("channel 1 poly 0 6.25\n4.0 0.0\n", "第 2 行: 标定点之前应有");
+    expectParseError("channel 1 linear\n4.0 0.0 1.0\n", "第 2 行: 标定点应为");
+    expectParseError("channel 1 linear\n4.0 nan\n", "第 2 行: 标定点应为");
+    expectParseError("channel 1 linear\n4.0 0.0\n", "第 1 行: 通道 1 需要 2-64 个标定点");
+    expectParseError("channel 1 linear\n4.0 0.0\n4.0 10.0\n", "第 1 行: 通道 1 的标定点电流应严格递增");
+    // 前一个通道在下一个 channel 行处校验，行号仍指向它自己的 channel 行
+    expectParseError("\nchannel 3 linear\n4.0 0.0\nchannel 5 poly 0 6.25\n", "第 2 行: 通道 3 需要");
+    expectParseError("channel 1 linear\n4 0\n20 100\nchannel 1 linear\n4 0\n20 100\n", "第 4 行: 通道 1 重复标定");
+
+    std::string points;
+    for (size_t i = 0; i <= CALIBRATION_MAX_POINTS; i++) {
+        points += std::to_string(4.0 + i * 0.2) + " " + std::to_string(i) + "\n";
+    }
+    expectParseError("channel 1 linear\n" + points, "需要 2-64 个标定点");
+
+    // 注释、空行和行尾注释被忽略
+    PressureCalibration calibration;
+    std::string error;
+    CHECK(calibration.parse("# 注释\nchannel 64 linear  # 最后一个通道\n\n4 0\n20 100 # 满量程\n", error));
+    CHECK_EQ(calibration.getChannels().size(), 1u);
+
+    // 解析失败不改变已有内容
+    CHECK(!calibration.parse("channel 1 linear\n4 0\n", error));
+    CHECK_EQ(calibration.getChannels().size(), 1u);
+    CHECK_EQ(calibration.getChannels()[0].channel, 64);
+
+    CHECK(!calibration.load(std::string(TEST_OUTPUT_DIR) + "/no_such_calibration.txt", error));
+    CHECK(contains(error, "无法读取标定文件"));
+}
+
+void testCompile() {
+    PressureCalibration calibration;
+    std::string error;
+    CHECK(calibration.load(EXAMPLE_CALIBRATION, error));
+    std::unique_ptr<PressureCalibrationSet> set = calibration.compile();
+
+    CHECK_EQ(set->getChannelMask(), 0xFull);
+    CHECK(set->getSource() == EXAMPLE_CALIBRATION);
+    CHECK(set->table(4) == nullptr);
+    CHECK(set->table(MAX_ANALOG_CHANNELS - 1) == nullptr);
+    CHECK(set->table(MAX_ANALOG_CHANNELS) == nullptr);
+
+    EtherCATMaster master;
+    for (const auto& channel : calibration.getChannels()) {
+        const PressureLookupTable* table = set->table(channel.channel - 1);
+        CHECK(table != nullptr);
+        if (!table) {
+            continue;
+        }
+        // 全部原始值逐个比较，结果应按位相同
+        size_t mismatches = 0;
+        for (int32_t raw = INT16_MIN; raw <= INT16_MAX; raw++) {
+            if (table->lookup(static_cast<int16_t>(raw)) !=
+                expectedTableValue(master, channel, static_cast<int16_t>(raw))) {
+                mismatches++;
+            }
+        }
+        CHECK_EQ(mismatches, 0u);
+        // 负电流一侧限幅为 PRESSURE_RANGE_MIN，满量程一侧保留外推
+        CHECK_EQ(table->lookup(INT16_MIN), PRESSURE_RANGE_MIN);
+        CHECK(table->lookup(INT16_MAX) > 0.0f);
+    }
+}
+
+void testMasterConversion() {
+    EtherCATMaster master;
+    CHECK_EQ(master.getCalibratedChannelMask(), 0ull);
+    CHECK(!master.loadPressureCalibration(std::string(TEST_OUTPUT_DIR) + "/no_such_calibration.txt"));
+    CHECK_EQ(master.getCalibratedChannelMask(), 0ull);
+
+    CHECK(master.loadPressureCalibration(EXAMPLE_CALIBRATION));
+    CHECK_EQ(master.getCalibratedChannelMask(), 0xFull);
+    CHECK(master.getPressureCalibrationSource() == EXAMPLE_CALIBRATION);
+
+    PressureCalibration calibration;
+    std::string error;
+    CHECK(calibration.load(EXAMPLE_CALIBRATION, error));
+    std::unique_ptr<PressureCalibrationSet> set = calibration.compile();
+
+    // 单通道：已标定的通道查表，其余按量程线性换算
+    for (int16_t raw : SAMPLE_RAWS) {
+        for (size_t index = 0; index < 8; index++) {
+            const PressureLookupTable* table = set->table(index);
+            float expected = table ? table->lookup(raw) : master.convertAnalogToPressure(raw);
+            CHECK_EQ(master.convertChannelToPressure(index, raw), expected);
+        }
+    }
+
+    // 批量版本与单通道一致
+    int16_t raws[MAX_ANALOG_CHANNELS];
+    float pressures[MAX_ANALOG_CHANNELS];
+    for (size_t i = 0; i < MAX_ANALOG_CHANNELS; i++) {
+        raws[i] = SAMPLE_RAWS[i % (sizeof(SAMPLE_RAWS) / sizeof(SAMPLE_RAWS[0]))];
+    }
+    master.convertChannelsToPressure(raws, pressures, MAX_ANALOG_CHANNELS);
+    for (size_t i = 0; i < MAX_ANALOG_CHANNELS; i++) {
+        CHECK_EQ(pressures[i], master.convertChannelToPressure(i, raws[i]));
+    }
+
+    // 整块换算：只覆盖已标定通道的压力，电流和状态不变
+    ProcessImageSnapshot snapshot;
+    std::memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.cycle = 1;
+    snapshot.analog_count = 8;
+    std::mt19937 rng(20251016);
+    std::uniform_int_distribution<int> any_raw(INT16_MIN, INT16_MAX);
+    for (size_t i = 0; i < snapshot.analog_count; i++) {
+        snapshot.analog_raw[i] = static_cast<int16_t>(any_raw(rng));
+    }
+    snapshot.analog_status[1] = AI_STATUS_FAULT;
+
+    EtherCATMaster::AnalogBlock calibrated;
+    EtherCATMaster::AnalogBlock linear;
+    master.convertAnalogBlock(snapshot, calibrated);
+    master.clearPressureCalibration();
+    master.convertAnalogBlock(snapshot, linear);
+    CHECK_EQ(calibrated.count, 8u);
+    for (size_t i = 0; i < calibrated.count; i++) {
+        CHECK_EQ(calibrated.currents[i], linear.currents[i]);
+        CHECK_EQ(calibrated.statuses[i], linear.statuses[i]);
+        float expected = i < 4 ? set->table(i)->lookup(snapshot.analog_raw[i]) : linear.pressures[i];
+        CHECK_EQ(calibrated.pressures[i], expected);
+    }
+
+    // 清除后恢复线性换算
+    CHECK_EQ(master.getCalibratedChannelMask(), 0ull);
+    CHECK(master.getPressureCalibrationSource().empty());
+    for (int16_t raw : SAMPLE_RAWS) {
+        CHECK_EQ(master.convertChannelToPressure(0, raw), master.convertAnalogToPressure(raw));
+    }
+
+    // 加载失败保留当前标定
+    std::string invalid = std::string(TEST_OUTPUT_DIR) + "/invalid_calibration.txt";
+    std::ofstream(invalid) << "channel 1 linear\n4 0\n";
+    CHECK(master.loadPressureCalibration(EXAMPLE_CALIBRATION));
+    CHECK(!master.loadPressureCalibration(invalid));
+    CHECK_EQ(master.getCalibratedChannelMask(), 0xFull);
+    CHECK(master.getPressureCalibrationSource() == EXAMPLE_CALIBRATION);
+}
+
+} // namespace
+
+int main() {
+    testExample();
+    testParseErrors();
+    testCompile();
+    testMasterConversion();
+    return testResult();
+}
@@ -0,0 +1,169 @@
+/**
+ * 延迟直方图：桶边界换算、相对误差、溢出桶，以及快照的统计量和百分位
+ */
+#include "TestSupport.h"
+#include "ethercat/LatencyHistogram.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+namespace {
+
+using Histogram = LatencyHistogram;
+
+constexpr size_t LAST_BUCKET = Histogram::BUCKET_COUNT - 1;
+constexpr uint64_t OVERFLOW_START = 1ull << Histogram::MAX_EXPONENT;
+
+void testBucketBounds() {
+    // 小于 16 的值每个值一个桶
+    for (uint64_t value = 0; value < Histogram::SUB_BUCKETS; value++) {
+        CHECK_EQ(Histogram::bucketIndex(value), value);
+        CHECK_EQ(Histogram::bucketLowerBound(value), value);
+        CHECK_EQ(Histogram::bucketUpperBound(value), value);
+    }
+
+    // 桶首尾相接，上下界都落回本桶
+    CHECK_EQ(Histogram::bucketLowerBound(0), 0ull);
+    size_t broken = 0;
+    for (size_t i = 0; i < Histogram::BUCKET_COUNT; i++) {
+        uint64_t lower = Histogram::bucketLowerBound(i);
+        uint64_t upper = Histogram::bucketUpperBound(i);
+        if (lower > upper || Histogram::bucketIndex(lower) != i || Histogram::bucketIndex(upper) != i) {
+            broken++;
+        }
+        if (i + 1 < Histogram::BUCKET_COUNT && Histogram::bucketLowerBound(i + 1) != upper + 1) {
+            broken++;
+        }
+        // 对数段内桶宽不超过下界的 1/16（最后一个桶收纳溢出值，不受限）
+        if (i >= Histogram::SUB_BUCKETS && i < LAST_BUCKET && (upper - lower + 1) * Histogram::SUB_BUCKETS > lower) {
+            broken++;
+        }
+    }
+    CHECK_EQ(broken, 0u);
+
+    // 每个 2 的幂起点都是一个桶的下界
+    for (unsigned exponent = Histogram::SUB_BUCKET_BITS; exponent < Histogram::MAX_EXPONENT; exponent++) {
+        uint64_t power = 1ull << exponent;
+        CHECK_EQ(Histogram::bucketLowerBound(Histogram::bucketIndex(power)), power);
+    }
+
+    // 随机值落在所在桶的上下界之间
+    std::mt19937_64 rng(7);
+    size_t outside = 0;
+    for (size_t n = 0; n < 100000; n++) {
+        uint64_t value = rng() >> (rng() % 64);
+        size_t index = Histogram::bucketIndex(value);
+        if (index >= Histogram::BUCKET_COUNT || value < Histogram::bucketLowerBound(index) ||
+            value > Histogram::bucketUpperBound(index)) {
+            outside++;
+        }
+    }
+    CHECK_EQ(outside, 0u);
+}
+
+void testOverflow() {
+    CHECK_EQ(Histogram::bucketIndex(OVERFLOW_START - 1), LAST_BUCKET);
+    CHECK_EQ(Histogram::bucketIndex(OVERFLOW_START), LAST_BUCKET);
+    CHECK_EQ(Histogram::bucketIndex(UINT64_MAX), LAST_BUCKET);
+    CHECK_EQ(Histogram::bucketUpperBound(LAST_BUCKET), UINT64_MAX);
+
+    Histogram histogram;
+    histogram.record(OVERFLOW_START * 4);
+    auto snapshot = histogram.snapshot();
+    CHECK_EQ(snapshot.buckets[LAST_BUCKET], 1ull);
+    // 百分位不超过实际最大值
+    CHECK_EQ(snapshot.percentile(99.0), OVERFLOW_START * 4);
+}
+
+void testSnapshot() {
+    Histogram histogram;
+    auto empty = histogram.snapshot();
+    CHECK_EQ(empty.count, 0ull);
+    CHECK_EQ(empty.min, 0ull);
+    CHECK_EQ(empty.max, 0ull);
+    CHECK_EQ(empty.mean(), 0.0);
+    CHECK_EQ(empty.percentile(50.0), 0ull);
+
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value * 1000);
+    }
+    auto snapshot = histogram.snapshot();
+    CHECK_EQ(snapshot.count, 1000ull);
+    CHECK_EQ(snapshot.sum, 500500000ull);
+    CHECK_EQ(snapshot.min, 1000ull);
+    CHECK_EQ(snapshot.max, 1000000ull);
+    CHECK_EQ(snapshot.mean(), 500500.0);
+
+    // 百分位为所在桶的上界：不低于真实值，误差不超过 1/16
+    for (double percentile : {1.0, 10.0, 50.0, 90.0, 99.0, 99.9}) {
+        uint64_t exact = static_cast<uint64_t>(percentile * 10.0 + 0.5) * 1000;
+        uint64_t value = snapshot.percentile(percentile);
+        CHECK(value >= exact);
+        CHECK(value <= exact + exact / Histogram::SUB_BUCKETS);
+    }
+    CHECK_EQ(snapshot.percentile(0.0), Histogram::bucketUpperBound(Histogram::bucketIndex(1000)));
+    CHECK_EQ(snapshot.percentile(100.0), 1000000ull);
+
+    uint64_t previous = 0;
+    for (double percentile = 0.0; percentile <= 100.0; percentile += 0.5) {
+        uint64_t value = snapshot.percentile(percentile);
+        CHECK(value >= previous);
+        previous = value;
+    }
+
+    histogram.reset();
+    auto cleared = histogram.snapshot();
+    CHECK_EQ(cleared.count, 0ull);
+    CHECK_EQ(cleared.sum, 0ull);
+    CHECK_EQ(cleared.min, 0ull);
+    CHECK_EQ(cleared.max, 0ull);
+
+    histogram.record(0);
+    CHECK_EQ(histogram.snapshot().buckets[0], 1ull);
+    CHECK_EQ(histogram.snapshot().percentile(50.0), 0ull);
+}
+
+// 写者持续记录时读者取快照：计数只增不减，且只出现在写入值所在的桶
+void testConcurrentSnapshot() {
+    constexpr uint64_t RECORDS = 2000000;
+    constexpr uint64_t VALUE = 123456;
+    Histogram histogram;
+    std::atomic<bool> done(false);
+
+    std::thread writer([&] {
+        for (uint64_t n = 0; n < RECORDS; n++) {
+            histogram.record(VALUE);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    size_t index = Histogram::bucketIndex(VALUE);
+    uint64_t previous = 0;
+    size_t bad = 0;
+    while (!done.load(std::memory_order_acquire)) {
+        auto snapshot = histogram.snapshot();
+        if (snapshot.count < previous || snapshot.count > RECORDS || snapshot.buckets[index] != snapshot.count) {
+            bad++;
+        }
+        // min/max 与桶计数之间没有先后保证，只能是尚未写入或写入值
+        if ((snapshot.min != 0 && snapshot.min != VALUE) || (snapshot.max != 0 && snapshot.max != VALUE)) {
+            bad++;
+        }
+        previous = snapshot.count;
+    }
+    writer.join();
+    CHECK_EQ(bad, 0u);
+    CHECK_EQ(histogram.snapshot().count, RECORDS);
+    CHECK_EQ(histogram.snapshot().sum, RECORDS * VALUE);
+}
+
+} // namespace
+
+int main() {
+    testBucketBounds();
+    testOverflow();
+    testSnapshot();
+    testConcurrentSnapshot();
+    return testResult();
+}
@@ -0,0 +1,126 @@
+/**
+ * 有界无锁队列：先进先出、满/空、序号回绕，以及多生产者单消费者下不丢不重且各生产者内保序
+ */
+#include "TestSupport.h"
+#include "ethercat/LockFreeQueue.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Item {
+    uint32_t producer;
+    uint32_t serial;
+};
+
+void testFifo() {
+    LockFreeQueue<int, 8> queue;
+    CHECK_EQ(queue.capacity(), 8u);
+
+    int value = -1;
+    CHECK(!queue.tryPop(value));
+    CHECK_EQ(value, -1);
+
+    for (int i = 0; i < 8; i++) {
+        CHECK(queue.tryPush(i));
+    }
+    // 满时入队失败，不覆盖已有元素
+    CHECK(!queue.tryPush(100));
+    for (int i = 0; i < 8; i++) {
+        CHECK(queue.tryPop(value));
+        CHECK_EQ(value, i);
+    }
+    CHECK(!queue.tryPop(value));
+
+    // 出队一个后可以再入队一个
+    for (int i = 0; i < 8; i++) {
+        CHECK(queue.tryPush(i));
+    }
+    CHECK(queue.tryPop(value));
+    CHECK(queue.tryPush(8));
+    CHECK(!queue.tryPush(9));
+    for (int i = 1; i <= 8; i++) {
+        CHECK(queue.tryPop(value));
+        CHECK_EQ(value, i);
+    }
+}
+
+// 位置计数远超容量后仍保持顺序（每个槽位被重复使用多次）
+void testWraparound() {
+    LockFreeQueue<uint32_t, 4> queue;
+    uint32_t next_push = 0;
+    uint32_t next_pop = 0;
+    size_t out_of_order = 0;
+    for (size_t round = 0; round < 100000; round++) {
+        size_t pushes = 1 + round % 4;
+        for (size_t i = 0; i < pushes && queue.tryPush(next_push); i++) {
+            next_push++;
+        }
+        size_t pops = 1 + (round * 7) % 4;
+        uint32_t value = 0;
+        for (size_t i = 0; i < pops && queue.tryPop(value); i++) {
+            if (value != next_pop) {
+                out_of_order++;
+            }
+            next_pop++;
+        }
+    }
+    CHECK_EQ(out_of_order, 0u);
+    CHECK(next_push - next_pop <= 4);
+    CHECK(next_pop > 100000);
+}
+
+void testMultipleProducers() {
+    constexpr uint32_t PRODUCERS = 4;
+    constexpr uint32_t ITEMS = 200000;
+    LockFreeQueue<Item, 64> queue;
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p] {
+            for (uint32_t serial = 0; serial < ITEMS; serial++) {
+                while (!queue.tryPush(Item{p, serial})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // 单消费者：每个生产者的序号依次出现，总数等于入队数
+    std::vector<uint32_t> expected(PRODUCERS, 0);
+    size_t received = 0;
+    size_t bad = 0;
+    while (received < static_cast<size_t>(PRODUCERS) * ITEMS) {
+        Item item;
+        if (!queue.tryPop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item.producer >= PRODUCERS || item.serial != expected[item.producer]) {
+            bad++;
+        } else {
+            expected[item.producer]++;
+        }
+        received++;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    CHECK_EQ(bad, 0u);
+    for (uint32_t p = 0; p < PRODUCERS; p++) {
+        CHECK_EQ(expected[p], ITEMS);
+    }
+    Item item;
+    CHECK(!queue.tryPop(item));
+}
+
+} // namespace
+
+int main() {
+    testFifo();
+    testWraparound();
+    testMultipleProducers();
+    return testResult();
+}
@@ -0,0 +1,114 @@
+/**
+ * 压力目标（模拟总线 + 液压对象模型）
+ *
+ * 液压对象按继电器输出推进压力，越过目标的那个周期里周期线程清除所选继电器位，
+ * 该周期发出的帧上继电器已断开：事件记录的周期号即是继电器断开的那一帧。
+ */
+#include "TestSupport.h"
+#include "ethercat/EtherCATMaster.h"
+#include "ethercat/HydraulicPlant.h"
+#include "ethercat/SimulatedBus.h"
+
+#include <array>
+#include <atomic>
+
+namespace {
+
+constexpr size_t FRAME_HISTORY = 1024;
+constexpr int TARGET_WAIT_MS = 5000;
+constexpr float SUPPORT_TARGET = 40.0f;
+constexpr float RETRACT_TARGET = 10.0f;
+
+// 每帧的继电器输出，按主站周期号保存：项为 (周期号 << 8) | 输出位
+struct FrameLog {
+    std::atomic<uint64_t> cycle{0};             // 周期钩子写入，随后同一周期的 send() 中由总线回调读取
+    std::array<std::atomic<uint64_t>, FRAME_HISTORY> frames{};
+
+    void record(uint8_t outputs) {
+        uint64_t current = cycle.load(std::memory_order_relaxed);
+        frames[current % FRAME_HISTORY].store(current << 8 | outputs, std::memory_order_release);
+    }
+
+    // 该周期的帧尚未记录或已被覆盖时返回 false
+    bool outputsAt(uint64_t frame_cycle, uint8_t& outputs) const {
+        uint64_t entry = frames[frame_cycle % FRAME_HISTORY].load(std::memory_order_acquire);
+        if ((entry >> 8) != frame_cycle) {
+            return false;
+        }
+        outputs = static_cast<uint8_t>(entry & 0xFF);
+        return true;
+    }
+};
+
+void recordCycle(CycleHookContext& context, void* user_data) {
+    static_cast<FrameLog*>(user_data)->cycle.store(context.cycle, std::memory_order_relaxed);
+}
+
+// 越过目标的帧上所选继电器已断开，前一帧仍通电；事件中的输入全部越过目标
+void checkCrossingFrame(EtherCATMaster& master, const FrameLog& log, const PressureTargetEvent& event,
+                        uint8_t relay_bit, bool below, float target) {
+    CHECK(event.cycle > 1);
+    CHECK_EQ(event.relay_outputs & relay_bit, 0);
+
+    uint8_t outputs = 0;
+    CHECK(log.outputsAt(event.cycle, outputs));
+    CHECK_EQ(outputs & relay_bit, 0);
+    CHECK(log.outputsAt(event.cycle - 1, outputs));
+    CHECK_EQ(outputs & relay_bit, relay_bit);
+
+    // 默认监视通道 1-4，即四条支腿
+    for (size_t i = 0; i < HYDRAULIC_LEG_COUNT; i++) {
+        float pressure = master.convertCurrentToPressure(master.convertAnalogToCurrent(event.analog_raw[i]));
+        CHECK(below ? pressure < target : pressure >= target);
+    }
+}
+
+void testCrossingClearsRelayInSameFrame() {
+    SimulatedBus& bus = SimulatedBus::instance();
+    bus.reset();
+    HydraulicPlant plant;
+    FrameLog log;
+    // 总线回调在写入输出之后、采样输入之前执行：记录本帧的继电器输出，再按它推进对象
+    bus.setCycleCallback([&](SimulatedBus& cycle_bus) {
+        log.record(cycle_bus.getRelayOutputs());
+        plant.step(cycle_bus);
+    });
+
+    EtherCATMaster master;
+    CHECK(master.registerCycleHook("frame_log", recordCycle, &log) >= 0);
+    CHECK(master.initialize());
+    CHECK(master.start());
+
+    // 支撑：继电器 1 通电，压力升过目标后断开
+    CHECK(master.setRelayChannelConfirmed(1, true, TARGET_WAIT_MS));
+    uint32_t support_id = master.armPressureTarget(PressureTargetMode::TARGET_ALL_ABOVE, SUPPORT_TARGET, 0x01);
+    CHECK(support_id != 0);
+    PressureTargetEvent support;
+    CHECK(waitFor([&] { return master.getPressureTargetEvent(support_id, support); }, TARGET_WAIT_MS));
+    CHECK_EQ(support.arm_id, support_id);
+    checkCrossingFrame(master, log, support, 0x01, false, SUPPORT_TARGET);
+    CHECK_EQ(master.getRelayStates() & 0x01, 0);
+    CHECK(plant.getLegPressure(0) >= SUPPORT_TARGET - 1.0f);
+
+    // 收回：继电器 2 通电，压力降到目标以下后断开
+    CHECK(master.setRelayChannelConfirmed(2, true, TARGET_WAIT_MS));
+    uint32_t retract_id = master.armPressureTarget(PressureTargetMode::TARGET_ALL_BELOW, RETRACT_TARGET, 0x02);
+    CHECK(retract_id != 0);
+    CHECK(retract_id != support_id);
+    PressureTargetEvent retract;
+    CHECK(waitFor([&] { return master.getPressureTargetEvent(retract_id, retract); }, TARGET_WAIT_MS));
+    checkCrossingFrame(master, log, retract, 0x02, true, RETRACT_TARGET);
+    CHECK(retract.cycle > support.cycle);
+    CHECK_EQ(master.getRelayStates(), 0);
+
+    master.stop();
+    // 回调引用本函数的局部对象，返回前移除
+    bus.setCycleCallback(nullptr);
+}
+
+} // namespace
+
+int main() {
+    testCrossingClearsRelayInSameFrame();
+    return testResult();
+}
@@ -0,0 +1,96 @@
+/**
+ * 热重配置（模拟总线）
+ *
+ * 必需从站掉线后以另一身份回到总线：重配置因拓扑不符失败，周期线程保持停住，stop() 仍须回收全部线程；
+ * 身份恢复后下一次重试重建配置并回到 OP。期间另一线程持续读取配置结果和快照。
+ */
+#include "TestSupport.h"
+#include "ethercat/EtherCATMaster.h"
+#include "ethercat/SimulatedBus.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+constexpr uint16_t SWAPPED_POSITION = 2;    // 默认拓扑中的 EL3074，必需从站
+
+void swapIdentity(SimulatedBus& bus) {
+    std::lock_guard<std::mutex> lock(bus.mutex());
+    bus.findSlave(SWAPPED_POSITION)->product_code ^= 0x1;
+}
+
+// 从站换成另一身份后回到总线，等待第一次重配置失败
+bool interruptWithSwappedSlave(SimulatedBus& bus, EtherCATMaster& master) {
+    bus.setSlaveResponding(SWAPPED_POSITION, false);
+    if (!waitFor([&] { return master.getBusInterruptionStats().active; }, 2000)) {
+        return false;
+    }
+    swapIdentity(bus);
+    bus.setSlaveResponding(SWAPPED_POSITION, true);
+    int64_t timeout_ms = BUS_RECONFIGURE_DELAY_NS / 1000000 + 3000;
+    return waitFor([&] { return master.getBusInterruptionStats().reconfigurations > 0; }, static_cast<int>(timeout_ms)) &&
+           waitFor([&] { return !master.getTopologyCheck().verified; }, 1000);
+}
+
+void testStopAfterFailedReconfiguration() {
+    SimulatedBus& bus = SimulatedBus::instance();
+    bus.reset();
+    EtherCATMaster master;
+    CHECK(master.initialize());
+    CHECK(master.start());
+    CHECK(interruptWithSwappedSlave(bus, master));
+    CHECK(master.isRunning());
+    CHECK(master.getBusInterruptionStats().active);
+
+    // 线程仍在运行，stop() 必须回收（否则析构时 std::terminate）
+    master.stop();
+    CHECK(!master.isRunning());
+    master.stop();
+}
+
+void testRetryAfterIdentityRestored() {
+    SimulatedBus& bus = SimulatedBus::instance();
+    bus.reset();
+    EtherCATMaster master;
+    CHECK(master.initialize());
+    CHECK(master.start());
+    size_t analog_channels = master.getAnalogChannelCount();
+
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> reads(0);
+    std::thread reader([&] {
+        while (!done) {
+            master.getTopologyCheck();
+            master.getAnalogChannelCount();
+            master.readAllAnalogInputsAsPressure();
+            master.readAllDigitalInputs();
+            reads++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    CHECK(interruptWithSwappedSlave(bus, master));
+    swapIdentity(bus);
+    int64_t timeout_ms = BUS_RECONFIGURE_DELAY_NS / 1000000 + 5000;
+    CHECK(waitFor([&] { return !master.getBusInterruptionStats().active; }, static_cast<int>(timeout_ms)));
+    BusInterruptionStats stats = master.getBusInterruptionStats();
+    CHECK(stats.reconfigurations >= 2);
+    CHECK(master.getTopologyCheck().verified);
+    CHECK_EQ(master.getAnalogChannelCount(), analog_channels);
+
+    done = true;
+    reader.join();
+    CHECK(reads > 0);
+    master.stop();
+    CHECK(!master.isRunning());
+}
+
+} // namespace
+
+int main() {
+    testStopAfterFailedReconfiguration();
+    testRetryAfterIdentityRestored();
+    return testResult();
+}
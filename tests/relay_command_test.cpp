@@ -0,0 +1,120 @@
+/**
+ * 继电器命令队列（模拟总线）
+ *
+ * 命令由周期线程在周期边界取出并随继电器域的帧发送，下一次回帧的域WKC确认：
+ * 完成结果带发送和确认的周期号；继电器端子不响应（域WKC为 0）时按超时完成。
+ * stop() 在清除运行状态之前关闭全部继电器，总线上的输出随之断开。
+ */
+#include "TestSupport.h"
+#include "ethercat/EtherCATMaster.h"
+#include "ethercat/SimulatedBus.h"
+
+#include <future>
+
+namespace {
+
+constexpr uint16_t RELAY_POSITION = 3;      // 默认拓扑中的 EL2634
+constexpr int COMMAND_WAIT_MS = 1000;
+
+bool completed(std::future<RelayCommandResult>& future) {
+    return waitFor([&] { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; },
+                   COMMAND_WAIT_MS);
+}
+
+void testConfirmedCommands() {
+    SimulatedBus& bus = SimulatedBus::instance();
+    bus.reset();
+    EtherCATMaster master;
+    CHECK(master.initialize());
+    CHECK(master.start());
+
+    std::future<RelayCommandResult> future = master.submitRelayCommand(0x05, 0x05);
+    CHECK(completed(future));
+    RelayCommandResult result = future.get();
+    CHECK(result.status == RelayCommandStatus::RELAY_CMD_CONFIRMED);
+    CHECK(result.sent_cycle > 0);
+    CHECK(result.confirmed_cycle > 0);
+    CHECK(result.confirmed_cycle >= result.sent_cycle);
+    CHECK_EQ(result.outputs, 0x05);
+    // 确认时该帧已写到端子
+    CHECK_EQ(bus.getRelayOutputs(), 0x05);
+    CHECK_EQ(master.getRelayStates(), 0x05);
+
+    // 翻转：后一条命令在前一条之后的周期发送
+    std::future<RelayCommandResult> toggled = master.submitRelayCommand(0x03, 0x00, nullptr, true);
+    CHECK(completed(toggled));
+    RelayCommandResult toggle_result = toggled.get();
+    CHECK(toggle_result.confirmed());
+    CHECK(toggle_result.sent_cycle > result.sent_cycle);
+    CHECK(toggle_result.confirmed_cycle >= toggle_result.sent_cycle);
+    CHECK_EQ(toggle_result.outputs, 0x06);
+    CHECK_EQ(bus.getRelayOutputs(), 0x06);
+
+    // 同步接口返回同样的结果
+    RelayCommandResult channel_result;
+    CHECK(master.setRelayChannelConfirmed(4, true, COMMAND_WAIT_MS, &channel_result));
+    CHECK(channel_result.confirmed());
+    CHECK(channel_result.confirmed_cycle >= channel_result.sent_cycle);
+    CHECK_EQ(channel_result.outputs, 0x0E);
+
+    // 回调与 future 收到同一结果
+    std::promise<RelayCommandResult> callback_result;
+    std::future<RelayCommandResult> callback_future = callback_result.get_future();
+    std::future<RelayCommandResult> with_callback = master.submitRelayCommand(
+        0x08, 0x00, [&](const RelayCommandResult& r) { callback_result.set_value(r); });
+    CHECK(completed(callback_future));
+    CHECK(completed(with_callback));
+    RelayCommandResult from_callback = callback_future.get();
+    RelayCommandResult from_future = with_callback.get();
+    CHECK_EQ(from_callback.command_id, from_future.command_id);
+    CHECK_EQ(from_callback.sent_cycle, from_future.sent_cycle);
+    CHECK_EQ(from_callback.confirmed_cycle, from_future.confirmed_cycle);
+
+    // stop() 关闭仍通电的继电器
+    CHECK_EQ(bus.getRelayOutputs(), 0x06);
+    master.stop();
+    CHECK_EQ(bus.getRelayOutputs(), 0x00);
+
+    // 停止后提交的命令直接拒绝
+    std::future<RelayCommandResult> rejected = master.submitRelayCommand(0x01, 0x01);
+    CHECK(rejected.get().status == RelayCommandStatus::RELAY_CMD_REJECTED);
+}
+
+void testTimeoutWhenWkcDropped() {
+    SimulatedBus& bus = SimulatedBus::instance();
+    bus.reset();
+    EtherCATMaster master;
+    CHECK(master.initialize());
+    CHECK(master.start());
+    CHECK(master.setRelayChannelConfirmed(1, true, COMMAND_WAIT_MS));
+
+    // 继电器端子不再响应：命令照常发送，继电器域WKC为 0，RELAY_CONFIRM_TIMEOUT_NS 后超时
+    bus.setSlaveResponding(RELAY_POSITION, false);
+    std::future<RelayCommandResult> future = master.submitRelayCommand(0x02, 0x02);
+    CHECK(completed(future));
+    RelayCommandResult result = future.get();
+    CHECK(result.status == RelayCommandStatus::RELAY_CMD_TIMEOUT);
+    CHECK(result.sent_cycle > 0);
+    CHECK_EQ(result.confirmed_cycle, 0ull);
+    int64_t timeout_cycles = RELAY_CONFIRM_TIMEOUT_NS / master.getRealtimeOptions().cycle_period_ns;
+    CHECK(master.getProcessImageSnapshot().cycle >= result.sent_cycle + static_cast<uint64_t>(timeout_cycles));
+
+    // 端子恢复后新命令重新得到确认；重配置后继电器输出从断开开始，之前的通道 1 不再保持
+    bus.setSlaveResponding(RELAY_POSITION, true);
+    CHECK(waitFor([&] {
+        std::future<RelayCommandResult> retry = master.submitRelayCommand(0x02, 0x02);
+        return completed(retry) && retry.get().confirmed();
+    }, 5000));
+    CHECK_EQ(master.getRelayStates(), 0x02);
+    CHECK_EQ(bus.getRelayOutputs(), 0x02);
+    master.stop();
+    CHECK_EQ(bus.getRelayOutputs(), 0x00);
+}
+
+} // namespace
+
+int main() {
+    testConfirmedCommands();
+    testTimeoutWhenWkcDropped();
+    return testResult();
+}
@@ -0,0 +1,156 @@
+/**
+ * 过程数据回放：记录文件头中的域大小和 PDO 条目位置须落在域内，否则拒绝回放
+ */
+#include "TestSupport.h"
+#include "ethercat/EtherCATMaster.h"
+#include "ethercat/ReplayBackend.h"
+#include "ethercat/SimulatedBus.h"
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+constexpr uint16_t SLAVE_POSITION = 2;
+constexpr uint32_t SLAVE_VENDOR = 0x2;
+constexpr uint32_t SLAVE_PRODUCT = 0x0c023052;
+constexpr uint16_t ENTRY_INDEX = 0x6000;
+constexpr uint8_t ENTRY_SUBINDEX = 0x11;
+
+struct RecordedEntry {
+    uint32_t offset;
+    uint8_t bit_position;
+};
+
+void putU16(std::string& out, uint16_t value) {
+    out += static_cast<char>(value & 0xFF);
+    out += static_cast<char>(value >> 8);
+}
+
+void putU32(std::string& out, uint32_t value) {
+    putU16(out, static_cast<uint16_t>(value & 0xFFFF));
+    putU16(out, static_cast<uint16_t>(value >> 16));
+}
+
+// 一个域、一个注册项的记录文件，附一条周期记录
+std::string writeRecording(const std::string& name, uint32_t domain_size, const RecordedEntry& entry) {
+    std::string content(PROCESS_IMAGE_RECORD_MAGIC, sizeof(PROCESS_IMAGE_RECORD_MAGIC));
+    putU16(content, PROCESS_IMAGE_RECORD_VERSION);
+    putU16(content, 1);
+    putU32(content, domain_size);
+    putU16(content, 1);
+    putU16(content, 0);
+    putU16(content, SLAVE_POSITION);
+    putU32(content, SLAVE_VENDOR);
+    putU32(content, SLAVE_PRODUCT);
+    putU16(content, ENTRY_INDEX);
+    content += static_cast<char>(ENTRY_SUBINDEX);
+    putU32(content, entry.offset);
+    content += static_cast<char>(entry.bit_position);
+
+    content += static_cast<char>(0x01);
+    putU16(content, 1);
+    content += static_cast<char>(EC_WC_COMPLETE);
+    content += std::string(domain_size < 64 ? domain_size : 64, '\0');
+
+    std::string path = std::string(TEST_OUTPUT_DIR) + "/" + name;
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+    return path;
+}
+
+// 按主站的顺序配置从站（条目位宽为 bit_length）并注册该条目
+bool registerEntry(ReplayBackend& backend, uint8_t bit_length, bool bit_addressed) {
+    ec_pdo_entry_info_t entries[] = {{ENTRY_INDEX, ENTRY_SUBINDEX, bit_length}};
+    ec_pdo_info_t pdos[] = {{0x1A00, 1, entries}};
+    ec_sync_info_t syncs[] = {
+        {3, EC_DIR_INPUT, 1, pdos, EC_WD_DEFAULT},
+        {0xff, EC_DIR_INVALID, 0, nullptr, EC_WD_DEFAULT},
+    };
+    int domain = backend.createDomain();
+    if (domain < 0 || !backend.configureSlave(0, SLAVE_POSITION, SLAVE_VENDOR, SLAVE_PRODUCT, syncs)) {
+        return false;
+    }
+    unsigned int offset = 0;
+    unsigned int bit_position = 0;
+    ec_pdo_entry_reg_t regs[] = {
+        {0, SLAVE_POSITION, SLAVE_VENDOR, SLAVE_PRODUCT, ENTRY_INDEX, ENTRY_SUBINDEX, &offset,
+         bit_addressed ? &bit_position : nullptr},
+        {},
+    };
+    return backend.registerPdoEntries(domain, regs);
+}
+
+void testValidRecording() {
+    ReplayBackend backend(writeRecording("replay_valid.ecpi", 4, {2, 0}));
+    CHECK(backend.requestMaster(0));
+    CHECK(registerEntry(backend, 16, false));
+    CHECK(backend.activate());
+    CHECK_EQ(backend.getDomainSize(0), 4u);
+}
+
+void testHeaderBounds() {
+    // 偏移在域外
+    ReplayBackend offset_outside(writeRecording("replay_offset.ecpi", 4, {4, 0}));
+    CHECK(!offset_outside.requestMaster(0));
+    CHECK(!offset_outside.isMasterRequested());
+
+    // 位位置超过 7
+    ReplayBackend bad_bit(writeRecording("replay_bit.ecpi", 4, {0, 8}));
+    CHECK(!bad_bit.requestMaster(0));
+
+    // 域大小超过文件长度（例如损坏的文件头要求 4 GiB）
+    ReplayBackend huge(writeRecording("replay_huge.ecpi", 0xFFFFFFFFu, {0, 0}));
+    CHECK(!huge.requestMaster(0));
+}
+
+void testEntryWidth() {
+    // 16 位条目从最后一个字节开始，越出 4 字节的域
+    ReplayBackend wide(writeRecording("replay_wide.ecpi", 4, {3, 0}));
+    CHECK(wide.requestMaster(0));
+    CHECK(!registerEntry(wide, 16, false));
+
+    // 同一位置的 8 位条目正好放下
+    ReplayBackend fits(writeRecording("replay_fits.ecpi", 4, {3, 0}));
+    CHECK(fits.requestMaster(0));
+    CHECK(registerEntry(fits, 8, false));
+
+    // 位寻址条目：最后一个字节的第 7 位可以，跨出字节的 2 位条目不行
+    ReplayBackend last_bit(writeRecording("replay_last_bit.ecpi", 4, {3, 7}));
+    CHECK(last_bit.requestMaster(0));
+    CHECK(registerEntry(last_bit, 1, true));
+    ReplayBackend two_bits(writeRecording("replay_two_bits.ecpi", 4, {3, 7}));
+    CHECK(two_bits.requestMaster(0));
+    CHECK(!registerEntry(two_bits, 2, true));
+}
+
+// 模拟总线上录下的文件可以完整回放：真实记录不会被越界检查拒绝
+void testRecordedOnSimulatedBus() {
+    std::string path = std::string(TEST_OUTPUT_DIR) + "/replay_recorded.ecpi";
+    SimulatedBus::instance().reset();
+    {
+        EtherCATMaster master;
+        CHECK(master.enableProcessImageRecording(path));
+        CHECK(master.initialize());
+        CHECK(master.start());
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        master.stop();
+    }
+
+    EtherCATMaster replay;
+    CHECK(replay.setFieldbusBackend(FieldbusBackendType::BACKEND_REPLAY, path));
+    CHECK(replay.initialize());
+    CHECK(replay.start());
+    CHECK_EQ(replay.getAnalogChannelCount(), 4u);
+    replay.stop();
+}
+
+} // namespace
+
+int main() {
+    testValidRecording();
+    testHeaderBounds();
+    testEntryWidth();
+    testRecordedOnSimulatedBus();
+    return testResult();
+}
@@ -0,0 +1,129 @@
+/**
+ * 顺序锁：存取和版本号，以及写者持续发布时多个读者只看到完整的副本
+ */
+#include "TestSupport.h"
+#include "ethercat/SeqLock.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 大小不是 8 的倍数，检查按 64 位字保存时的尾部
+struct OddSized {
+    uint8_t bytes[13];
+};
+
+// 各字段都由 serial 推出，读到混合了两次写入的副本时必然不一致
+struct Redundant {
+    uint64_t serial;
+    uint64_t words[14];
+    uint64_t inverted;
+
+    static Redundant make(uint64_t serial) {
+        Redundant value;
+        value.serial = serial;
+        for (size_t i = 0; i < 14; i++) {
+            value.words[i] = serial * (i + 1);
+        }
+        value.inverted = ~serial;
+        return value;
+    }
+
+    bool consistent() const {
+        for (size_t i = 0; i < 14; i++) {
+            if (words[i] != serial * (i + 1)) {
+                return false;
+            }
+        }
+        return inverted == ~serial;
+    }
+};
+
+void testStoreLoad() {
+    SeqLock<Redundant> lock;
+    CHECK_EQ(lock.version(), 0u);
+    Redundant initial = lock.load();
+    CHECK_EQ(initial.serial, 0ull);
+    CHECK_EQ(initial.inverted, 0ull);
+
+    for (uint64_t serial = 1; serial <= 5; serial++) {
+        lock.store(Redundant::make(serial));
+        CHECK_EQ(lock.version(), serial);
+        // 没有写者并发时 tryLoad 必然成功；失败时 value 未被写入，不再检查字段
+        Redundant value;
+        bool loaded = lock.tryLoad(value);
+        CHECK(loaded);
+        if (loaded) {
+            CHECK_EQ(value.serial, serial);
+            CHECK(value.consistent());
+        }
+    }
+
+    SeqLock<OddSized> odd;
+    OddSized written;
+    for (size_t i = 0; i < sizeof(written.bytes); i++) {
+        written.bytes[i] = static_cast<uint8_t>(0xF0 + i);
+    }
+    odd.store(written);
+    OddSized read = odd.load();
+    CHECK(std::memcmp(read.bytes, written.bytes, sizeof(written.bytes)) == 0);
+    CHECK_EQ(odd.version(), 1u);
+}
+
+void testConcurrentReaders() {
+    constexpr uint64_t STORES = 1000000;
+    constexpr size_t READERS = 3;
+    SeqLock<Redundant> lock;
+    std::atomic<bool> done(false);
+    std::atomic<size_t> torn(0);
+    std::atomic<size_t> backwards(0);
+    std::atomic<uint64_t> loads(0);
+    // 构造时的初值全为 0，不满足 inverted == ~serial，先发布一个一致的初值
+    lock.store(Redundant::make(0));
+
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < READERS; r++) {
+        readers.emplace_back([&] {
+            uint64_t previous = 0;
+            uint64_t count = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                Redundant value = lock.load();
+                if (!value.consistent()) {
+                    torn++;
+                }
+                // 同一读者看到的序号只增不减
+                if (value.serial < previous) {
+                    backwards++;
+                }
+                previous = value.serial;
+                count++;
+            }
+            loads += count;
+        });
+    }
+
+    for (uint64_t serial = 1; serial <= STORES; serial++) {
+        lock.store(Redundant::make(serial));
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    CHECK_EQ(torn.load(), 0u);
+    CHECK_EQ(backwards.load(), 0u);
+    CHECK(loads.load() > 0);
+    CHECK_EQ(lock.version(), static_cast<uint32_t>(STORES + 1));
+    CHECK_EQ(lock.load().serial, STORES);
+}
+
+} // namespace
+
+int main() {
+    testStoreLoad();
+    testConcurrentReaders();
+    return testResult();
+}
@@ -0,0 +1,248 @@
+/**
+ * 从站拓扑：XML 解析、二进制缓存和总线扫描比对
+ */
+#include "TestSupport.h"
+#include "ethercat/SlaveTopology.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const std::string EXAMPLE_XML = std::string(TEST_SOURCE_DIR) + "/examples/rig_topology.xml";
+
+std::string outputPath(const std::string& name) {
+    return std::string(TEST_OUTPUT_DIR) + "/" + name;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+// 只有一个 EL1008 的拓扑，variable 为 ProcessImage 中的内容
+std::string singleSlaveXml(const std::string& slave_attributes, const std::string& variable) {
+    return "<?xml version=\"1.0\"?>\n"
+           "<EtherCATConfig><Config>\n"
+           "  <Slave" + slave_attributes + ">\n"
+           "    <Info><Name>EL1008</Name><VendorId>#x2</VendorId><ProductCode>#x03f03052</ProductCode>"
+           "<Position>1</Position></Info>\n"
+           "  </Slave>\n"
+           "  <ProcessImage>\n" + variable + "\n  </ProcessImage>\n"
+           "</Config></EtherCATConfig>\n";
+}
+
+bool loadText(const std::string& content, std::string& error) {
+    std::string path = outputPath("topology_case.xml");
+    writeFile(path, content);
+    SlaveTopology topology;
+    error.clear();
+    return topology.loadXml(path, error);
+}
+
+bool sameTopology(const SlaveTopology& a, const SlaveTopology& b) {
+    if (a.getSlaves().size() != b.getSlaves().size() || a.getBindings().size() != b.getBindings().size() ||
+        a.fingerprint() != b.fingerprint()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.getSlaves().size(); i++) {
+        const TopologySlave& x = a.getSlaves()[i];
+        const TopologySlave& y = b.getSlaves()[i];
+        if (x.name != y.name || x.alias != y.alias || x.position != y.position || x.vendor_id != y.vendor_id ||
+            x.product_code != y.product_code || x.optional != y.optional || x.sync_count != y.sync_count) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.getBindings().size(); i++) {
+        const TopologyBinding& x = a.getBindings()[i];
+        const TopologyBinding& y = b.getBindings()[i];
+        if (x.domain != y.domain || x.channel != y.channel || x.slave != y.slave || x.index != y.index ||
+            x.subindex != y.subindex) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按拓扑生成总线扫描结果（位置与拓扑相同，身份一致）
+std::vector<ec_slave_info_t> busFor(const SlaveTopology& topology) {
+    std::vector<ec_slave_info_t> bus;
+    for (const auto& slave : topology.getSlaves()) {
+        ec_slave_info_t info;
+        std::memset(&info, 0, sizeof(info));
+        info.position = slave.position;
+        info.vendor_id = slave.vendor_id;
+        info.product_code = slave.product_code;
+        std::snprintf(info.name, sizeof(info.name), "%s", slave.name.c_str());
+        bus.push_back(info);
+    }
+    return bus;
+}
+
+void testExampleMatchesDefault() {
+    SlaveTopology topology;
+    std::string error;
+    CHECK(topology.loadXml(EXAMPLE_XML, error));
+    CHECK(error.empty());
+
+    // 示例文件描述的就是内置的试验台拓扑
+    SlaveTopology builtin = SlaveTopology::createDefault();
+    CHECK(sameTopology(topology, builtin));
+    CHECK_EQ(topology.getSlaves().size(), static_cast<size_t>(6));
+    CHECK(topology.getSlaves()[0].name == "EK1100");
+    CHECK(topology.getSyncs(topology.getSlaves()[0]) == nullptr);      // 未写 ProcessData：默认 PDO 分配
+
+    const TopologySlave* el3074 = topology.findSlave(0, 2);
+    CHECK(el3074 && el3074->name == "EL3074" && el3074->product_code == 0x0c023052);
+    const ec_sync_info_t* syncs = el3074 ? topology.getSyncs(*el3074) : nullptr;
+    CHECK(syncs != nullptr);
+    size_t sync_count = 0;
+    while (syncs && syncs[sync_count].index != 0xff) {
+        sync_count++;
+    }
+    CHECK_EQ(sync_count, static_cast<size_t>(4));
+    CHECK(topology.findSlave(0, 4) && topology.findSlave(0, 4)->optional);
+    CHECK(topology.findSlave(0, 9) == nullptr);
+
+    // 4 路模拟输入、8 路数字输入、4 路继电器
+    size_t per_domain[TOPOLOGY_DOMAIN_COUNT] = {};
+    for (const auto& binding : topology.getBindings()) {
+        per_domain[binding.domain]++;
+    }
+    CHECK_EQ(per_domain[0], static_cast<size_t>(4));
+    CHECK_EQ(per_domain[1], static_cast<size_t>(8));
+    CHECK_EQ(per_domain[2], static_cast<size_t>(4));
+}
+
+void testCache() {
+    std::string xml_path = outputPath("rig_topology.xml");
+    std::string cache_path = xml_path + ".cache";
+    writeFile(xml_path, readFile(EXAMPLE_XML));
+    std::remove(cache_path.c_str());
+
+    SlaveTopology parsed;
+    std::string error;
+    CHECK(parsed.load(xml_path, cache_path, error));
+    CHECK(!parsed.isFromCache());
+    CHECK(readFile(cache_path).compare(0, 4, std::string(SLAVE_TOPOLOGY_CACHE_MAGIC, 4)) == 0);
+
+    // 源文件未变：直接读缓存，内容与解析结果相同
+    SlaveTopology cached;
+    CHECK(cached.load(xml_path, cache_path, error));
+    CHECK(cached.isFromCache());
+    CHECK(sameTopology(parsed, cached));
+    CHECK(cached.getSource() == xml_path);
+
+    // 截断的缓存被丢弃，重新解析并重写
+    std::string bytes = readFile(cache_path);
+    writeFile(cache_path, bytes.substr(0, bytes.size() / 2));
+    SlaveTopology truncated;
+    CHECK(truncated.load(xml_path, cache_path, error));
+    CHECK(!truncated.isFromCache());
+    CHECK(sameTopology(parsed, truncated));
+    CHECK(readFile(cache_path) == bytes);
+
+    // 源文件大小变化后缓存失效
+    writeFile(xml_path, readFile(EXAMPLE_XML) + "<!-- 修改 -->\n");
+    SlaveTopology modified;
+    CHECK(modified.load(xml_path, cache_path, error));
+    CHECK(!modified.isFromCache());
+    CHECK(sameTopology(parsed, modified));
+
+    SlaveTopology missing;
+    CHECK(!missing.load(outputPath("no_such_topology.xml"), cache_path, error));
+    CHECK(error.find("不存在") != std::string::npos);
+}
+
+void testParseErrors() {
+    const std::string variable = "<Variable Domain=\"digital_in\" Channel=\"1\" Position=\"1\" Index=\"#x6000\" SubIndex=\"1\"/>";
+    std::string error;
+    CHECK(loadText(singleSlaveXml("", variable), error));
+
+    CHECK(!loadText("<Config></Config>", error));
+    CHECK(error.find("<EtherCATConfig>") != std::string::npos);
+
+    CHECK(!loadText(singleSlaveXml(" Optional=\"maybe\"", variable), error));
+    CHECK(error.find("Optional") != std::string::npos);
+    CHECK(error.find("第 3 行") != std::string::npos);
+
+    CHECK(!loadText(singleSlaveXml("", "<Variable Domain=\"analog\" Channel=\"1\" Position=\"1\" Index=\"#x6000\" SubIndex=\"1\"/>"),
+                    error));
+    CHECK(error.find("Domain") != std::string::npos);
+
+    CHECK(!loadText(singleSlaveXml("", "<Variable Domain=\"digital_in\" Channel=\"1\" Position=\"7\" Index=\"#x6000\" SubIndex=\"1\"/>"),
+                    error));
+    CHECK(error.find("没有从站") != std::string::npos);
+
+    CHECK(!loadText(singleSlaveXml("", variable + variable), error));
+    CHECK(error.find("重复") != std::string::npos);
+
+    CHECK(!loadText(singleSlaveXml("", "<Variable Domain=\"digital_in\" Channel=\"1\" Position=\"1\" Index=\"#x6000\" SubIndex=\"zz\"/>"),
+                    error));
+    CHECK(error.find("SubIndex") != std::string::npos);
+
+    CHECK(!loadText("<EtherCATConfig><Config><Slave><Info><Name>x</Name></Info>", error));
+    CHECK(!error.empty());
+}
+
+void testBusCheck() {
+    SlaveTopology topology = SlaveTopology::createDefault();
+    std::vector<ec_slave_info_t> bus = busFor(topology);
+
+    TopologyCheck check = topology.check(bus);
+    CHECK(check.scanned && check.verified);
+    CHECK_EQ(check.bus_slave_count, 6u);
+    CHECK(check.find(2) && check.find(2)->result == SlaveCheckResult::SLAVE_OK);
+
+    // 必需从站身份不符：不一致
+    std::vector<ec_slave_info_t> swapped = bus;
+    swapped[2].product_code ^= 1;
+    check = topology.check(swapped);
+    CHECK(!check.verified);
+    CHECK(check.find(2) && check.find(2)->result == SlaveCheckResult::SLAVE_MISMATCH);
+    CHECK_EQ(check.find(2)->product_code, swapped[2].product_code);
+
+    // 可选从站不在位：仍一致
+    std::vector<ec_slave_info_t> without_optional(bus.begin(), bus.begin() + 5);
+    check = topology.check(without_optional);
+    CHECK(check.verified);
+    CHECK(check.find(5) && check.find(5)->result == SlaveCheckResult::SLAVE_MISSING);
+
+    // 必需从站不在位：不一致
+    std::vector<ec_slave_info_t> without_required = bus;
+    without_required.erase(without_required.begin() + 3);
+    check = topology.check(without_required);
+    CHECK(!check.verified);
+    CHECK(check.find(3) && check.find(3)->result == SlaveCheckResult::SLAVE_MISSING);
+
+    // 拓扑之外的从站只报告，不影响结果；按位置排序
+    std::vector<ec_slave_info_t> extra = bus;
+    extra.push_back(bus[1]);
+    extra.back().position = 6;
+    check = topology.check(extra);
+    CHECK(check.verified);
+    CHECK_EQ(check.entries.size(), static_cast<size_t>(7));
+    CHECK(check.entries.back().result == SlaveCheckResult::SLAVE_UNEXPECTED && check.entries.back().expected == -1);
+    for (size_t i = 1; i < check.entries.size(); i++) {
+        CHECK(check.entries[i - 1].position <= check.entries[i].position);
+    }
+}
+
+} // namespace
+
+int main() {
+    testExampleMatchesDefault();
+    testCache();
+    testParseErrors();
+    testBusCheck();
+    return testResult();
+}